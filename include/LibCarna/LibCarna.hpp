@@ -63,20 +63,26 @@ namespace LibCarna
         class  BaseBuffer;
         class  BlendFunction;
         class  BoundingBox;
+        class  BoundingSphere;
         class  BoundingVolume;
+        class  BoundingVolumeHierarchy;
         class  Camera;
         class  CameraControl;
         class  Color;
         struct ColoredVertex;
         class  ColorMap;
         class  Framebuffer;
+        class  FramebufferReadback;
         class  FrameRenderer;
+        class  FrameUniformBuffer;
         class  Geometry;
         class  GeometryFeature;
         class  GLContext;
+        struct GLStatistics;
         struct HUV;
         struct HUVOffset;
         class  IndexBufferBase;
+        class  IntensityVolume;
         class  LibCarnaException;
         class  Log;
         class  ManagedMeshBase;
@@ -90,6 +96,8 @@ namespace LibCarna
         class  NodeListener;
         class  NormalMap3D;
         class  NormalMap3DTexture;
+        class  OBJReader;
+        class  PLYReader;
         struct PCVertex;
         struct PNVertex;
         class  ProjectionControl;
@@ -100,9 +108,11 @@ namespace LibCarna
         class  RenderStageListener;
         class  RenderStageSequence;
         class  RenderState;
+        class  RenderTargetPool;
         class  RenderTask;
         class  RotatingColor;
         class  Sampler;
+        class  STLReader;
         class  Shader;
         class  ShaderCompilationError;
         class  ShaderManager;
@@ -168,6 +178,7 @@ namespace LibCarna
             template< typename ValueType > class VectorField;
             template< typename T > class Span;
             template< typename VectorType, typename ScalarType = typename VectorType::Scalar > class RayPlaneHitTest;
+            template< typename VectorType, typename ScalarType = typename VectorType::Scalar > class RaySphereHitTest;
 
         }
         
@@ -205,6 +216,7 @@ namespace LibCarna
     {
 
         class PointMarkerHelper;
+        class RayPickingHelper;
         class DefaultRenderStageOrder;
         class VolumeGridHelperBase;
 
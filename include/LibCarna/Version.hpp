@@ -0,0 +1,82 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#ifndef VERSION_H_6014714286
+#define VERSION_H_6014714286
+
+/** \file
+  * \brief  Defines the macros \ref LIBCARNA_MAJOR_VERSION, \ref LIBCARNA_MINOR_VERSION, \ref LIBCARNA_PATCH_VERSION
+  * and \ref LIBCARNA_ASSERT_API_VERSION.
+  *
+  * \attention
+  * This file is automatically generated from `misc/Version.h.in`, thus do not modify this file directly.
+  */
+
+
+
+// ----------------------------------------------------------------------------------
+// LIBCARNA_MAJOR_VERSION
+// ----------------------------------------------------------------------------------
+
+/** \brief
+  * Defines the \ref VersioningPolicies "API major version number".
+  */
+#define LIBCARNA_MAJOR_VERSION 3
+
+
+
+// ----------------------------------------------------------------------------------
+// LIBCARNA_MINOR_VERSION
+// ----------------------------------------------------------------------------------
+
+/** \brief
+  * Defines the \ref VersioningPolicies "API minor version number".
+  */
+#define LIBCARNA_MINOR_VERSION 4
+
+
+
+// ----------------------------------------------------------------------------------
+// LIBCARNA_PATCH_VERSION
+// ----------------------------------------------------------------------------------
+
+/** \brief
+  * Defines the \ref VersioningPolicies "API patch version number".
+  */
+#define LIBCARNA_PATCH_VERSION 0
+
+
+
+// ----------------------------------------------------------------------------------
+// LIBCARNA_ASSERT_API_VERSION
+// ----------------------------------------------------------------------------------
+
+/** \brief  Fails if current Carna implementation does not support the requested API version.
+  *
+  * The build only succeeds if:
+  *
+  * - The real major version number is the same as the requested major version number.
+  * - The real minor version number is the same as the requested minor version number.
+  * - The real patch version number is at least the requested patch version number.
+  */
+#define LIBCARNA_ASSERT_API_VERSION( expected_major_version, expected_minor_version, expected_patch_version ) \
+    static_assert( \
+            expected_major_version == LIBCARNA_MAJOR_VERSION && \
+            expected_minor_version == LIBCARNA_MINOR_VERSION && \
+            expected_patch_version >= LIBCARNA_PATCH_VERSION, \
+            "Incompatible Carna Version!" );
+
+
+
+#endif // VERSION_H_6014714286
@@ -81,6 +81,10 @@ public:
 
     virtual void computeClosemostPoint( math::Vector3f& out, const math::Vector3f& reference ) const override;
 
+    virtual void computeAxisAlignedBox( math::Vector3f& lower, math::Vector3f& upper, const math::Matrix4f& modelTransform ) const override;
+
+    virtual bool computeRayHit( math::Vector3f& out, const math::Ray3f& ray ) const override;
+
 }; // BoundingBox
 
 
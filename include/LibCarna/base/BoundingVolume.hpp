@@ -67,6 +67,25 @@ public:
       * that is also in model space.
       */
     virtual void computeClosemostPoint( math::Vector3f& out, const math::Vector3f& reference ) const = 0;
+
+    /** \brief
+      * Computes the axis-aligned box that encloses this bounding volume after it was
+      * mapped from model space by \a modelTransform. The box is described by its
+      * \a lower and \a upper corners.
+      *
+      * The default implementation yields an infinite box. The
+      * \ref BoundingVolumeHierarchy treats such bounding volumes like missing ones.
+      */
+    virtual void computeAxisAlignedBox( math::Vector3f& lower, math::Vector3f& upper, const math::Matrix4f& modelTransform ) const;
+
+    /** \brief
+      * Computes the location \a out where \a ray hits this bounding volume first.
+      * Both, the ray and the hit location, are in model space. Tells `false` if
+      * the ray does not hit this bounding volume.
+      *
+      * The default implementation always tells `false`.
+      */
+    virtual bool computeRayHit( math::Vector3f& out, const math::Ray3f& ray ) const;
     
     /** \brief
       * Sets the transform from the local coordinate system of this bounding volume
@@ -0,0 +1,155 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#ifndef BOUNDINGVOLUMEHIERARCHY_H_6014714286
+#define BOUNDINGVOLUMEHIERARCHY_H_6014714286
+
+#include <LibCarna/LibCarna.hpp>
+#include <LibCarna/base/NodeListener.hpp>
+#include <LibCarna/base/noncopyable.hpp>
+#include <LibCarna/base/math.hpp>
+#include <functional>
+#include <memory>
+
+/** \file
+  * \brief
+  * Defines \ref LibCarna::base::BoundingVolumeHierarchy.
+  */
+
+namespace LibCarna
+{
+
+namespace base
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// BoundingVolumeHierarchy
+// ----------------------------------------------------------------------------------
+
+/** \brief
+  * Spatial index over the \ref Geometry nodes of a \ref SceneGraph "scene graph"
+  * that answers frustum and ray queries in logarithmic rather than linear time.
+  *
+  * The hierarchy is a binary tree of axis-aligned boxes in world space. Its leaves
+  * enclose the \ref Geometry::setBoundingVolume "bounding volumes" of the
+  * geometry nodes. Geometry nodes without a bounding volume are not indexed:
+  * Frustum queries always report them, while ray queries never do.
+  *
+  * The hierarchy is \ref NodeListener "listening" to the root node of the scene
+  * graph. When the tree structure changes or a subtree is
+  * \ref Spatial::invalidate "invalidated", the next \ref update rebuilds the
+  * hierarchy. Otherwise, \ref update only refits the boxes of those geometry nodes
+  * whose world transforms have changed, and of their ancestors. Invalidate the
+  * geometry node after changing its bounding volume.
+  *
+  * \author Leonid Kostrykin
+  */
+class LIBCARNA BoundingVolumeHierarchy : public NodeListener
+{
+
+    NON_COPYABLE
+
+    struct Details;
+    const std::unique_ptr< Details > pimpl;
+
+public:
+
+    /** \brief
+      * Defines the callback that frustum queries invoke once per geometry node.
+      */
+    typedef std::function< void( const Geometry& ) > GeometryVisitor;
+
+    /** \brief
+      * Instantiates the hierarchy for the geometry nodes beneath \a root. The
+      * hierarchy is built by the first \ref update call.
+      */
+    explicit BoundingVolumeHierarchy( Node& root );
+
+    /** \brief
+      * Deletes.
+      */
+    virtual ~BoundingVolumeHierarchy();
+
+    /** \brief
+      * Rebuilds the hierarchy if the scene graph has changed since the last call.
+      * Refits it to the current world transforms otherwise.
+      *
+      * The geometry nodes to refit are found through
+      * \ref Spatial::hasWorldTransformChanged, thus this must be called after each
+      * \ref Spatial::updateWorldTransform "update of the world transforms".
+      *
+      * \pre
+      * The world transforms of the scene graph are
+      * \ref Spatial::updateWorldTransform "up to date".
+      */
+    void update();
+
+    /** \brief
+      * Tells the number of geometry nodes indexed by the hierarchy.
+      */
+    std::size_t size() const;
+
+    /** \brief
+      * Tells the number of geometry nodes whose boxes were recomputed by the last
+      * \ref update call. Equals \ref size if the hierarchy was rebuilt.
+      */
+    std::size_t updatedGeometriesCount() const;
+
+    /** \brief
+      * Invokes \a visit once on each geometry node that possibly intersects the
+      * frustum, that \a viewProjection maps to clipping coordinates.
+      *
+      * \pre
+      * The hierarchy has been \ref update "updated" since the scene graph has last
+      * changed.
+      */
+    void queryFrustum( const math::Matrix4f& viewProjection, const GeometryVisitor& visit ) const;
+
+    /** \brief
+      * Tells the geometry node whose bounding volume is hit by \a ray first. Writes
+      * the world space location of the hit to \a hitLocation. Tells `nullptr` if
+      * no bounding volume is hit.
+      *
+      * \pre
+      * The hierarchy has been \ref update "updated" since the scene graph has last
+      * changed.
+      */
+    const Geometry* queryRay( math::Vector3f& hitLocation, const math::Ray3f& ray ) const;
+
+    /** \brief
+      * Stops observing the root node if it is \a node.
+      */
+    virtual void onNodeDelete( const Node& node ) override;
+
+    /** \brief
+      * Denotes that the hierarchy must be rebuilt.
+      */
+    virtual void onTreeChange( Node& node, bool inThisSubtree ) override;
+
+    /** \brief
+      * Denotes that the hierarchy must be rebuilt.
+      */
+    virtual void onTreeInvalidated( Node& subtree ) override;
+
+}; // BoundingVolumeHierarchy
+
+
+
+}  // namespace LibCarna :: base
+
+}  // namespace LibCarna
+
+#endif // BOUNDINGVOLUMEHIERARCHY_H_6014714286
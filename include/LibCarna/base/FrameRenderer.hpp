@@ -20,7 +20,9 @@
 #include <LibCarna/base/Aggregation.hpp>
 #include <LibCarna/base/noncopyable.hpp>
 #include <LibCarna/base/math.hpp>
+#include <LibCarna/base/GLStatistics.hpp>
 #include <string>
+#include <vector>
 
 /** \file
   * \brief
@@ -111,12 +113,40 @@ public:
       * Represents the OpenGL context that this renderer is associated with.
       */
     GLContext& glContext() const;
+
+    /** \brief
+      * References the \ref FrameUniformBuffer "uniform buffer", that provides the
+      * data to shaders, that is constant throughout a \ref RenderTask.
+      */
+    FrameUniformBuffer& frameUniforms() const;
+
+    /** \brief
+      * References the \ref RenderTargetPool "pool", that the rendering stages lease
+      * their transient render targets from. Targets, that were not leased during a
+      * frame, are released at the end of the frame.
+      */
+    RenderTargetPool& renderTargets() const;
     
     /** \brief
       * Activates \ref glContext and deletes all stages from the rendering stages
       * sequence.
       */
     virtual void clearStages() override;
+
+    /** \brief
+      * Builds the shaders, that the rendering stages will need for rendering the
+      * scene beneath \a root, in advance. This avoids stalls while rendering the
+      * first frames. Tells the names of the shaders.
+      *
+      * The shaders are \ref ShaderManager::prewarmShaders "prewarmed" at once, so
+      * that the driver can build them in parallel. They remain acquired until this
+      * method is called again or this renderer is deleted. The time spent building
+      * each shader is reported by \ref ShaderManager::shaderBuildTime.
+      *
+      * \pre
+      * The rendering stages were \ref appendStage "appended" already.
+      */
+    std::vector< std::string > prewarmShaders( const Node& root );
     
     /** \brief
       * Tells the current frame width. Value is changed through \ref reshape.
@@ -248,10 +278,42 @@ public:
       */
     const math::Statistics< double >& framesPerSecond() const;
 
+    /** \brief
+      * Holds the OpenGL calls, that the last frame has cost.
+      */
+    struct FrameStatistics
+    {
+        /** \brief
+          * Holds the OpenGL calls of the whole frame.
+          */
+        GLStatistics total;
+
+        /** \brief
+          * Holds the OpenGL calls of each \ref stageAt "rendering stage". The
+          * calls of stages, that were rendered by other stages, e.g. through
+          * forked \ref RenderTask "render tasks", are also included by the latter.
+          */
+        std::vector< GLStatistics > stages;
+    };
+
+    /** \brief
+      * Tells the OpenGL calls, that the last frame has cost. The statistics are
+      * only recorded if \ref GLContext::setStatisticsEnabled "enabled" for the
+      * \ref glContext.
+      */
+    const FrameStatistics& frameStatistics() const;
+
 private:
 
     void render( Camera& cam, Node& root, const Viewport& vp ) const;
 
+    friend class RenderTask;
+
+    /** \brief
+      * Adds \a statistics to the \ref frameStatistics of the stage \a stageIdx.
+      */
+    void recordStageStatistics( std::size_t stageIdx, const GLStatistics& statistics ) const;
+
 }; // FrameRenderer
 
 
@@ -0,0 +1,122 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#ifndef FRAMEUNIFORMBUFFER_H_6014714286
+#define FRAMEUNIFORMBUFFER_H_6014714286
+
+#include <LibCarna/LibCarna.hpp>
+#include <LibCarna/base/noncopyable.hpp>
+#include <LibCarna/base/math.hpp>
+#include <memory>
+
+/** \file
+  * \brief
+  * Defines \ref LibCarna::base::FrameUniformBuffer.
+  */
+
+namespace LibCarna
+{
+
+namespace base
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// FrameUniformBuffer
+// ----------------------------------------------------------------------------------
+
+/** \brief
+  * Maintains the OpenGL uniform buffer object, that provides the data to shaders,
+  * that is constant throughout a \ref RenderTask. Realizes the RAII-idiom.
+  *
+  * The buffer is laid out according to the `std140` rules and bound to the
+  * \ref BINDING_POINT "binding point", that the \ref ShaderProgram "shader programs"
+  * bind their uniform block named \ref BLOCK_NAME to, when they are linked. Shaders
+  * access the buffer by declaring:
+  *
+  * \code
+  * layout( std140 ) uniform FrameUniforms
+  * {
+  *     mat4 projection;
+  *     mat4 viewTransform;
+  *     vec4 viewport;
+  * };
+  * \endcode
+  *
+  * The `viewport` holds the left and top margins, the width, and the height of the
+  * \ref Viewport, that the render task is rendered with. Per-object transforms,
+  * like the `modelView` matrix, are still uploaded as regular uniforms, and the
+  * shaders concatenate those with `projection`.
+  *
+  * Each \ref FrameRenderer maintains a single instance, that the
+  * \ref RenderTask "render tasks" \ref update before each rendering stage.
+  *
+  * \author Leonid Kostrykin
+  */
+class LIBCARNA FrameUniformBuffer
+{
+
+    NON_COPYABLE
+
+    struct Details;
+    const std::unique_ptr< Details > pimpl;
+
+public:
+
+    /** \brief
+      * Holds the uniform buffer binding point, that the buffer is bound to.
+      */
+    const static unsigned int BINDING_POINT = 0;
+
+    /** \brief
+      * Holds the name of the uniform block, that shaders declare to access the
+      * buffer.
+      */
+    const static std::string BLOCK_NAME;
+
+    /** \brief
+      * Creates the buffer object.
+      *
+      * \pre
+      * The OpenGL context, that the buffer will be used with, is current.
+      */
+    FrameUniformBuffer();
+
+    /** \brief
+      * Deletes the buffer object.
+      */
+    ~FrameUniformBuffer();
+
+    /** \brief
+      * Writes \a projection, \a viewTransform, and \a viewport to the buffer and
+      * binds it to \ref BINDING_POINT. The buffer is only written if the data has
+      * changed since the last call.
+      */
+    void update( const math::Matrix4f& projection, const math::Matrix4f& viewTransform, const Viewport& viewport );
+
+    /** \brief
+      * Tells how many times the buffer was written so far.
+      */
+    std::size_t uploadsCount() const;
+
+}; // FrameUniformBuffer
+
+
+
+}  // namespace LibCarna :: base
+
+}  // namespace LibCarna
+
+#endif // FRAMEUNIFORMBUFFER_H_6014714286
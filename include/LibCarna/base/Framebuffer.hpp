@@ -63,6 +63,20 @@ public:
       */
     const static unsigned int MAXIMUM_ALLOWED_COLOR_COMPONENTS = 8;
 
+    /** \brief
+      * Lists the formats of render textures.
+      */
+    enum RenderTextureFormat
+    {
+        rgba8,   ///< Four unsigned normalized 8-bit channels.
+        rgba16f, ///< Four 16-bit floating point channels.
+        rgba32f, ///< Four 32-bit floating point channels.
+        rg16f,   ///< Two 16-bit floating point channels.
+        rg32f,   ///< Two 32-bit floating point channels.
+        r16f,    ///< A single 16-bit floating point channel.
+        r32f     ///< A single 32-bit floating point channel.
+    };
+
     /** \brief
       * Acquires framebuffer object with depth buffer and attaches \a renderTexture
       * as the first color attachment. The \a renderTexture is resized automatically
@@ -75,9 +89,20 @@ public:
       *
       * \param floatingPoint
       *     sets whether `float`-based pixels shall be used instead of unsigned byte.
+      *     Creates a texture of the \ref rgba16f format if set, and of the
+      *     \ref rgba8 format otherwise.
       */
     static Texture< 2 >* createRenderTexture( bool floatingPoint = false );
 
+    /** \brief
+      * Creates render texture of \a format.
+      *
+      * Single-channel formats, like \ref r32f, are stored in the red channel. When
+      * the texture is sampled, the green and blue channels read as \f$0\f$, and the
+      * alpha channel reads as \f$1\f$.
+      */
+    static Texture< 2 >* createRenderTexture( RenderTextureFormat format );
+
     /** \brief
       * Deletes the maintained framebuffer object and its depth buffer.
       */
@@ -266,6 +291,57 @@ public:
     }; // Framebuffer :: Binding
 
     // ------------------------------------------------------------------------------
+    // Framebuffer :: SharedDepthAttachment
+    // ------------------------------------------------------------------------------
+
+    /** \brief
+      * Provides the depth buffer of the currently bound framebuffer to another
+      * framebuffer in a RAII-manner. This allows rendering to a dedicated render
+      * texture with depth-testing against the depth of the output.
+      *
+      * The depth buffer is attached to the other framebuffer directly, instead of
+      * its own depth buffer, if the currently bound framebuffer is a
+      * \ref Framebuffer object of the same size and the source viewport covers it
+      * entirely. Otherwise, e.g. if the main framebuffer is bound, the depth buffer
+      * is \ref copyDepthAttachment "copied" as a fallback.
+      *
+      * The depth buffer must not be written to while rendering to the other
+      * framebuffer, since writes would alter the depth of the output if it is
+      * shared. Disable \ref RenderState::setDepthWrite "depth writes" explicitly,
+      * since they are enabled by default.
+      *
+      * \author Leonid Kostrykin
+      */
+    class LIBCARNA SharedDepthAttachment
+    {
+
+        NON_COPYABLE
+
+        Framebuffer& dst;
+        bool shared;
+
+    public:
+
+        /** \brief
+          * Provides the depth buffer of the currently bound framebuffer within
+          * \a src to \a dst. The depth is either shared or copied.
+          */
+        SharedDepthAttachment( Framebuffer& dst, const Viewport& src );
+
+        /** \brief
+          * Re-attaches the own depth buffer of the framebuffer, if the depth buffer
+          * was shared.
+          */
+        ~SharedDepthAttachment();
+
+        /** \brief
+          * Tells whether the depth buffer is shared, as opposed to copied.
+          */
+        bool isShared() const;
+
+    }; // Framebuffer :: SharedDepthAttachment
+
+    // ------------------------------------------------------------------------------
 
 private:
 
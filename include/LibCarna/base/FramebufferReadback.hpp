@@ -0,0 +1,181 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#ifndef FRAMEBUFFERREADBACK_H_6014714286
+#define FRAMEBUFFERREADBACK_H_6014714286
+
+#include <LibCarna/LibCarna.hpp>
+#include <LibCarna/base/noncopyable.hpp>
+#include <functional>
+#include <memory>
+
+/** \file
+  * \brief
+  * Defines \ref LibCarna::base::FramebufferReadback.
+  */
+
+namespace LibCarna
+{
+
+namespace base
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// FramebufferReadback
+// ----------------------------------------------------------------------------------
+
+/** \brief
+  * Reads rendered frames back to the CPU without stalling the rendering pipeline.
+  *
+  * Reading the pixels of a frame through `glReadPixels` directly forces the CPU to
+  * wait until the GPU has finished rendering the frame. Instead, \ref read copies
+  * the pixels into the next of a ring of pixel buffer objects asynchronously. The
+  * pixels are delivered to the \ref FrameCallback "callback" by \ref poll once the
+  * copy has completed, what is typically the case a few frames later. The number
+  * of pixel buffer objects limits the number of frames in flight: If all of them
+  * are still pending, \ref read waits for the oldest one.
+  *
+  * Example:
+  *
+  * \code
+  * FramebufferReadback readback( width, height, FramebufferReadback::rgba8, 3,
+  *     []( std::size_t frameIndex, const void* pixels )
+  *     {
+  *         // stream the pixels
+  *     }
+  * );
+  * while( streaming )
+  * {
+  *     frameRenderer.render( camera, root );
+  *     readback.read();
+  *     readback.poll();
+  * }
+  * readback.finish();
+  * \endcode
+  *
+  * The pixels are delivered row by row, starting with the bottom row, as
+  * `glReadPixels` does.
+  *
+  * \author Leonid Kostrykin
+  */
+class LIBCARNA FramebufferReadback
+{
+
+    NON_COPYABLE
+
+    struct Details;
+    const std::unique_ptr< Details > pimpl;
+
+public:
+
+    /** \brief
+      * Lists the supported formats of the delivered pixels.
+      */
+    enum PixelFormat
+    {
+
+        /** \brief
+          * Four 8-bit unsigned integer components per pixel.
+          */
+        rgba8,
+
+        /** \brief
+          * Four 32-bit floating point components per pixel.
+          */
+        rgba32f,
+
+        /** \brief
+          * A single 32-bit floating point component per pixel, that is read from
+          * the red channel.
+          */
+        r32f
+
+    }; // PixelFormat
+
+    /** \brief
+      * Receives the pixels of the frame, that was \ref read as the
+      * \a frameIndex-th one. The \a pixels are only valid during the call.
+      */
+    typedef std::function< void( std::size_t frameIndex, const void* pixels ) > FrameCallback;
+
+    /** \brief
+      * Instantiates for frames of \a width and \a height in \a pixelFormat, with up
+      * to \a framesInFlight frames being read simultaneously. The pixels are
+      * delivered to \a callback.
+      *
+      * \pre `framesInFlight >= 1`
+      */
+    FramebufferReadback
+        ( unsigned int width
+        , unsigned int height
+        , PixelFormat pixelFormat
+        , std::size_t framesInFlight
+        , const FrameCallback& callback );
+
+    /** \brief
+      * Waits until all pending frames are delivered and deletes the pixel buffer
+      * objects.
+      */
+    ~FramebufferReadback();
+
+    /** \brief
+      * Tells the width of the frames read.
+      */
+    unsigned int width() const;
+
+    /** \brief
+      * Tells the height of the frames read.
+      */
+    unsigned int height() const;
+
+    /** \brief
+      * Tells the size of a single frame in bytes.
+      */
+    std::size_t frameSize() const;
+
+    /** \brief
+      * Tells the number of frames, that were read, but not delivered yet.
+      */
+    std::size_t pendingFrames() const;
+
+    /** \brief
+      * Starts reading the pixels of the currently bound framebuffer, from the
+      * `glReadBuffer` that is currently selected. Waits for the oldest pending
+      * frame to be delivered, if `pendingFrames()` equals the number of frames in
+      * flight. Tells the index of the frame.
+      */
+    std::size_t read();
+
+    /** \brief
+      * Delivers the frames, that have been read completely, to the callback, without
+      * waiting for the others. Tells the number of frames delivered.
+      */
+    std::size_t poll();
+
+    /** \brief
+      * Waits until all pending frames are delivered to the callback.
+      */
+    void finish();
+
+}; // FramebufferReadback
+
+
+
+}  // namespace LibCarna :: base
+
+}  // namespace LibCarna
+
+#endif // FRAMEBUFFERREADBACK_H_6014714286
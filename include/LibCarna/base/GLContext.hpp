@@ -18,6 +18,7 @@
 #include <LibCarna/LibCarna.hpp>
 #include <LibCarna/base/LibCarnaException.hpp>
 #include <LibCarna/base/noncopyable.hpp>
+#include <LibCarna/base/GLStatistics.hpp>
 #include <LibCarna/base/Log.hpp>
 #include <memory>
 
@@ -60,6 +61,11 @@ namespace base
   * %Carna-related code must be run on the same thread. The states are maintained
   * through the \ref RenderState class.
   *
+  * The textures and samplers bound to each texture unit are tracked, so that
+  * \ref Texture::bind and \ref Sampler::bind only issue OpenGL calls if the
+  * bindings actually change. This requires that textures and samplers are not bound
+  * directly through OpenGL.
+  *
   * \author Leonid Kostrykin
   */
 class LIBCARNA GLContext
@@ -94,6 +100,44 @@ protected:
       */
     const RenderState& currentRenderState() const;
 
+    /** \brief
+      * References the render state that mirrors the actual state of the OpenGL
+      * context.
+      */
+    RenderState& appliedRenderState();
+
+
+    template< unsigned int dimension >
+    friend void bindGLTextureObject( unsigned int unit, unsigned int id );
+
+    friend class TextureBase;
+
+    friend class Sampler;
+
+    /** \brief
+      * Binds the texture object \a id to \a target of texture \a unit, unless it
+      * is bound already. Also makes \a unit the active texture unit.
+      */
+    void bindTexture( unsigned int unit, unsigned int target, unsigned int id );
+
+    /** \brief
+      * Binds the sampler object \a id to texture \a unit, unless it is bound
+      * already.
+      */
+    void bindSampler( unsigned int unit, unsigned int id );
+
+    /** \brief
+      * Forgets the bindings of the texture object \a id within all OpenGL contexts.
+      * Must be called when the texture object is deleted.
+      */
+    static void forgetTexture( unsigned int id );
+
+    /** \brief
+      * Forgets the bindings of the sampler object \a id within all OpenGL
+      * contexts. Must be called when the sampler object is deleted.
+      */
+    static void forgetSampler( unsigned int id );
+
 public:
 
     const static unsigned int DEPTH_BUFFER_BIT; ///< Wraps `GL_DEPTH_BUFFER_BIT`.
@@ -146,6 +190,39 @@ public:
       * \ref DEPTH_BUFFER_BIT is supplied.
       */
     void clearBuffers( unsigned int flags );
+
+    /** \brief
+      * Commits those parts of the \ref currentRenderState "current render state",
+      * that differ from the actual OpenGL state. This is done automatically before
+      * meshes are rendered and buffers are cleared, but must be called explicitly
+      * before issuing draw calls directly through OpenGL.
+      * \pre `isCurrent() == true`
+      */
+    void commitRenderState();
+
+    /** \brief
+      * Enables or disables the recording of \ref statistics. Recording is disabled
+      * by default.
+      */
+    void setStatisticsEnabled( bool enabled );
+
+    /** \brief
+      * Tells whether \ref statistics are recorded.
+      */
+    bool isStatisticsEnabled() const;
+
+    /** \brief
+      * Tells the OpenGL calls, that were recorded while
+      * \ref setStatisticsEnabled "recording was enabled".
+      */
+    const GLStatistics& statistics() const;
+
+    /** \brief
+      * Adds \a count to the \a counter of the \ref statistics, if recording is
+      * \ref setStatisticsEnabled "enabled". This is used by the classes, that issue
+      * OpenGL calls.
+      */
+    void record( std::size_t GLStatistics::*counter, std::size_t count = 1 );
     
 protected:
 
@@ -0,0 +1,127 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#ifndef GLSTATISTICS_H_6014714286
+#define GLSTATISTICS_H_6014714286
+
+#include <LibCarna/LibCarna.hpp>
+#include <cstddef>
+
+/** \file
+  * \brief
+  * Defines \ref LibCarna::base::GLStatistics.
+  */
+
+namespace LibCarna
+{
+
+namespace base
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// GLStatistics
+// ----------------------------------------------------------------------------------
+
+/** \brief
+  * Counts the OpenGL calls, that were issued through %Carna, and the resources
+  * they have cost. The counts are recorded by the \ref GLContext if
+  * \ref GLContext::setStatisticsEnabled "enabled".
+  *
+  * \author Leonid Kostrykin
+  */
+struct LIBCARNA GLStatistics
+{
+
+    /** \brief
+      * Instantiates with all counts set to zero.
+      */
+    GLStatistics();
+
+    /** \brief
+      * Counts the draw calls issued by \ref MeshBase::render and
+      * \ref MeshBase::renderInstanced.
+      */
+    std::size_t drawCalls;
+
+    /** \brief
+      * Counts the primitives, e.g. triangles, that were drawn. Each instance of an
+      * instanced draw call is counted separately.
+      */
+    std::size_t primitives;
+
+    /** \brief
+      * Counts the state changes, that were issued to OpenGL by
+      * \ref RenderState instances.
+      */
+    std::size_t stateChanges;
+
+    /** \brief
+      * Counts the state changes, that were requested through \ref RenderState
+      * instances, regardless of whether they were issued to OpenGL.
+      */
+    std::size_t requestedStateChanges;
+
+    /** \brief
+      * Counts the textures, that were bound to texture units.
+      */
+    std::size_t textureBinds;
+
+    /** \brief
+      * Counts the samplers, that were bound to texture units.
+      */
+    std::size_t samplerBinds;
+
+    /** \brief
+      * Counts the framebuffers, that were bound, including the system framebuffer.
+      */
+    std::size_t framebufferBinds;
+
+    /** \brief
+      * Counts the uniform values, that were uploaded to shaders.
+      */
+    std::size_t uniformUploads;
+
+    /** \brief
+      * Counts the bytes, that were uploaded to textures.
+      */
+    std::size_t uploadedTextureBytes;
+
+    /** \brief
+      * Tells the number of state changes, that were requested through
+      * \ref RenderState instances, but were suppressed, because they were not
+      * effective.
+      */
+    std::size_t suppressedStateChanges() const;
+
+    /** \brief
+      * Tells the counts, that were recorded after \a other was recorded.
+      */
+    GLStatistics operator-( const GLStatistics& other ) const;
+
+    /** \brief
+      * Adds the counts of \a other.
+      */
+    GLStatistics& operator+=( const GLStatistics& other );
+
+}; // GLStatistics
+
+
+
+}  // namespace LibCarna :: base
+
+}  // namespace LibCarna
+
+#endif // GLSTATISTICS_H_6014714286
@@ -89,7 +89,7 @@ public:
 
     /** \brief
       * Adds the \a feature to this geometry node using \a role in
-      * \f$\mathcal O\left(\log n\right)\f$. The concept of geometry features and
+      * \f$\mathcal O\left(n\right)\f$. The concept of geometry features and
       * roles is explained \ref GeometryFeatures "here".
       *
       * \post `hasFeature(feature) == true`
@@ -106,7 +106,7 @@ public:
 
     /** \brief
       * Removes \a feature from this geometry node in
-      * \f$\mathcal O\left(\log n\right)\f$. The concept of geometry features and
+      * \f$\mathcal O\left(n\right)\f$. The concept of geometry features and
       * roles is explained \ref GeometryFeatures "here".
       *
       * Nothing happens if \a feature was not added to this geometry node previously.
@@ -116,7 +116,7 @@ public:
 
     /** \brief
       * Removes the \ref GeometryFeatures "geometry feature" from this node that is
-      * associated with \a role in \f$\mathcal O\left(\log n\right)\f$.
+      * associated with \a role in \f$\mathcal O\left(n\right)\f$.
       *
       * Nothing happens if no feature is associated with \a role at the moment.
       * \ref Spatial::invalidate "Invalidates" all parent subtrees otherwise.
@@ -133,7 +133,7 @@ public:
 
     /** \brief
       * Tells whether \a feature is attached to this node in
-      * \f$\mathcal O\left(\log n\right)\f$.
+      * \f$\mathcal O\left(n\right)\f$.
       */
     bool hasFeature( const GeometryFeature& feature ) const;
 
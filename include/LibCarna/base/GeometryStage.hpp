@@ -19,9 +19,12 @@
 #include <LibCarna/base/RenderStage.hpp>
 #include <LibCarna/base/RenderQueue.hpp>
 #include <LibCarna/base/GeometryFeature.hpp>
+#include <LibCarna/base/NodeListener.hpp>
+#include <LibCarna/base/Node.hpp>
 #include <LibCarna/base/math.hpp>
 #include <memory>
 #include <map>
+#include <set>
 
 /** \file
   * \brief
@@ -52,6 +55,12 @@ namespace base
   * Override \ref updateRenderQueues and \ref rewindRenderQueues if you require
   * further rendering queues.
   *
+  * The rendering queues persist across frames. They are only rebuilt when the
+  * scene graph notifies this stage, that is \ref NodeListener "listening" to the
+  * root node, about changes of the tree structure or invalidated subtrees. On all
+  * other frames merely the \ref ViewSpace "model-view transforms" are recomputed and
+  * the queues are re-ordered, if their order is view-dependent.
+  *
   * \see
   * Refer to the documentation of the \ref RenderingProcess "rendering process" for
   * further notes on how rendering stages operate.
@@ -59,15 +68,19 @@ namespace base
   * \author Leonid Kostrykin
   */
 template< typename RenderableCompare >
-class GeometryStage : public RenderStage
+class GeometryStage : public RenderStage, public NodeListener
 {
 
     typedef GeometryFeature::ManagedInterface VideoResource;
 
     Node* root;
+    Node* observedRoot;
+    bool renderQueuesOutdated;
     std::size_t passesRendered;
     std::map< GeometryFeature*, VideoResource* > acquiredFeatures;
 
+    void acquireVideoResources();
+
 protected:
 
     /** \brief
@@ -101,6 +114,26 @@ public:
 
     virtual void renderPass( const math::Matrix4f& viewTransform, RenderTask& rt, const Viewport& vp ) override;
 
+    /** \brief
+      * Stops observing the root node if it is \a node.
+      */
+    virtual void onNodeDelete( const Node& node ) override;
+
+    /** \brief
+      * Denotes that the rendering queues must be rebuilt.
+      */
+    virtual void onTreeChange( Node& node, bool inThisSubtree ) override;
+
+    /** \brief
+      * Denotes that the rendering queues must be rebuilt.
+      */
+    virtual void onTreeInvalidated( Node& subtree ) override;
+
+    /** \brief
+      * Enforces the rendering queues to be rebuilt on the next frame.
+      */
+    void invalidateRenderQueues();
+
     /** \brief
       * Tells the number of \ref renderPass "passes rendered so far" since the
       * \ref prepareFrame "beginning of the current frame".
@@ -128,7 +161,8 @@ protected:
     void activateGLContext() const;
     
     /** \brief
-      * Builds the rendering queues of this stage.
+      * Builds the rendering queues of this stage. This is only done on the first
+      * frame and after the scene graph has changed.
       */
     virtual void buildRenderQueues( Node& root, const math::Matrix4f& viewTransform );
 
@@ -154,6 +188,8 @@ protected:
 template< typename RenderableCompare >
 GeometryStage< RenderableCompare >::GeometryStage( unsigned int geometryType, unsigned int geometryTypeMask )
     : root( nullptr )
+    , observedRoot( nullptr )
+    , renderQueuesOutdated( true )
     , passesRendered( 0 )
     , rq( geometryType, geometryTypeMask )
     , geometryType( geometryType )
@@ -165,6 +201,10 @@ GeometryStage< RenderableCompare >::GeometryStage( unsigned int geometryType, un
 template< typename RenderableCompare >
 GeometryStage< RenderableCompare >::~GeometryStage()
 {
+    if( observedRoot != nullptr )
+    {
+        observedRoot->removeNodeListener( *this );
+    }
     activateGLContext();
     std::for_each( acquiredFeatures.begin(), acquiredFeatures.end(),
         [&]( const std::pair< GeometryFeature*, VideoResource* >& entry )
@@ -194,6 +234,52 @@ void GeometryStage< RenderableCompare >::prepareFrame( Node& root )
     RenderStage::prepareFrame( root );
     this->root = &root;
     this->passesRendered = 0;
+
+    /* Observe the root node, so that the rendering queues are only rebuilt if the
+     * scene graph changes.
+     */
+    if( observedRoot != &root )
+    {
+        if( observedRoot != nullptr )
+        {
+            observedRoot->removeNodeListener( *this );
+        }
+        observedRoot = &root;
+        observedRoot->addNodeListener( *this );
+        renderQueuesOutdated = true;
+    }
+}
+
+
+template< typename RenderableCompare >
+void GeometryStage< RenderableCompare >::onNodeDelete( const Node& node )
+{
+    if( &node == observedRoot )
+    {
+        observedRoot = nullptr;
+        renderQueuesOutdated = true;
+    }
+}
+
+
+template< typename RenderableCompare >
+void GeometryStage< RenderableCompare >::onTreeChange( Node&, bool )
+{
+    renderQueuesOutdated = true;
+}
+
+
+template< typename RenderableCompare >
+void GeometryStage< RenderableCompare >::onTreeInvalidated( Node& )
+{
+    renderQueuesOutdated = true;
+}
+
+
+template< typename RenderableCompare >
+void GeometryStage< RenderableCompare >::invalidateRenderQueues()
+{
+    renderQueuesOutdated = true;
 }
 
 
@@ -230,63 +316,72 @@ void GeometryStage< RenderableCompare >::renderPass( const math::Matrix4f& viewT
 {
     const bool isFirstPass = passesRendered == 0;
     
-    /* Maintain the render queues.
+    /* Maintain the render queues. They only need to be rebuilt if the scene graph
+     * has changed since they were built the last time.
      */
-    if( isFirstPass )
+    if( isFirstPass && renderQueuesOutdated )
     {
         buildRenderQueues( *root, viewTransform );
+        acquireVideoResources();
+        renderQueuesOutdated = false;
     }
     else
     {
         rewindRenderQueues();
-        if( isViewTransformFixed() )
+        if( isFirstPass || isViewTransformFixed() )
         {
             updateRenderQueues( viewTransform );
         }
     }
 
-    std::set< GeometryFeature* > usedFeatures;
     while( !rq.isEmpty() )
     {
         const Renderable& renderable = rq.poll();
-        if( isFirstPass )
-        {
-            renderable.geometry().visitFeatures( [&]( GeometryFeature& gf, unsigned int role )
-                {
-                    /* Denote that the geometry feature was used.
-                     */
-                    usedFeatures.insert( &gf );
-
-                    /* Check whether video resources need to be acquired.
-                     */
-                    if( acquiredFeatures.find( &gf ) == acquiredFeatures.end() )
-                    {
-                        VideoResource* const vr = gf.acquireVideoResource();
-                        acquiredFeatures[ &gf ] = vr;
-                    }
-                }
-            );
-        }
         render( renderable );
     }
-    if( isFirstPass )
+}
+
+
+template< typename RenderableCompare >
+void GeometryStage< RenderableCompare >::acquireVideoResources()
+{
+    std::set< GeometryFeature* > usedFeatures;
+    while( !rq.isEmpty() )
     {
-        /* Release unused video resources.
-         */
-        for( auto itr = acquiredFeatures.begin(); itr != acquiredFeatures.end(); )
-        {
-            if( usedFeatures.find( itr->first ) == usedFeatures.end() )
+        const Renderable& renderable = rq.poll();
+        renderable.geometry().visitFeatures( [&]( GeometryFeature& gf, unsigned int role )
             {
-                if( itr->second != nullptr )
+                /* Denote that the geometry feature was used.
+                 */
+                usedFeatures.insert( &gf );
+
+                /* Check whether video resources need to be acquired.
+                 */
+                if( acquiredFeatures.find( &gf ) == acquiredFeatures.end() )
                 {
-                    delete itr->second;
+                    VideoResource* const vr = gf.acquireVideoResource();
+                    acquiredFeatures[ &gf ] = vr;
                 }
-                acquiredFeatures.erase( itr++ );
             }
-            else
+        );
+    }
+    rq.rewind();
+
+    /* Release unused video resources.
+     */
+    for( auto itr = acquiredFeatures.begin(); itr != acquiredFeatures.end(); )
+    {
+        if( usedFeatures.find( itr->first ) == usedFeatures.end() )
+        {
+            if( itr->second != nullptr )
             {
-                ++itr;
+                delete itr->second;
             }
+            acquiredFeatures.erase( itr++ );
+        }
+        else
+        {
+            ++itr;
         }
     }
 }
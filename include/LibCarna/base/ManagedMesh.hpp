@@ -18,6 +18,7 @@
 #include <LibCarna/base/Mesh.hpp>
 #include <LibCarna/base/GeometryFeature.hpp>
 #include <LibCarna/base/ManagedMeshInterface.hpp>
+#include <LibCarna/base/math.hpp>
 #include <memory>
 #include <vector>
 
@@ -104,6 +105,13 @@ protected:
       */
     const MeshBase& mesh() const;
 
+    /** \brief
+      * Writes the model space vertices of the triangles of this mesh to
+      * \a vertices, three per triangle. The default implementation writes nothing
+      * and logs a warning, so that \ref computeRayHit never reports a hit.
+      */
+    virtual void loadTriangles( std::vector< math::Vector3f >& vertices ) const;
+
 public:
 
     /** \brief
@@ -126,6 +134,22 @@ public:
 
     virtual ManagedMeshInterface* acquireVideoResource() override;
 
+    /** \brief
+      * Computes the location \a out where \a ray hits a triangle of this mesh
+      * first. Both, the ray and the hit location, are in model space. Tells `false`
+      * if no triangle is hit.
+      *
+      * The triangles are indexed by a bounding volume hierarchy in CPU memory,
+      * that the first call builds from \ref loadTriangles. Each further call
+      * takes \f$\mathcal O\left(\log n\right)\f$ time on average, where \f$n\f$
+      * is the number of triangles.
+      *
+      * \attention
+      * Although this method is `const`, the first call modifies this object. Thus
+      * it is not thread-safe, unless the hierarchy was already built.
+      */
+    bool computeRayHit( math::Vector3f& out, const math::Ray3f& ray ) const;
+
 }; // ManagedMeshBase
 
 
@@ -164,6 +188,14 @@ protected:
     
     virtual IndexBufferBase* loadIndexBuffer() override;
 
+    /** \brief
+      * Writes the triangles of this mesh to \a vertices, if its primitive type is
+      * either \ref IndexBufferBase::PRIMITIVE_TYPE_TRIANGLES,
+      * \ref IndexBufferBase::PRIMITIVE_TYPE_TRIANGLE_STRIP or
+      * \ref IndexBufferBase::PRIMITIVE_TYPE_TRIANGLE_FAN.
+      */
+    virtual void loadTriangles( std::vector< math::Vector3f >& vertices ) const override;
+
 public:
 
     typedef VertexType Vertex;  ///< Holds the element type of the vertex buffer.
@@ -214,6 +246,50 @@ IndexBufferBase* ManagedMesh< VertexType, IndexType >::loadIndexBuffer()
 }
 
 
+template< typename VertexType, typename IndexType >
+void ManagedMesh< VertexType, IndexType >::loadTriangles( std::vector< math::Vector3f >& out ) const
+{
+    const auto vertexAt = [this]( std::size_t index )
+    {
+        const VertexType& vertex = vertices[ indices[ index ] ];
+        return math::Vector3f( vertex.x, vertex.y, vertex.z );
+    };
+    for( std::size_t index = 2; index < indices.size(); )
+    {
+        if( primitiveType == IndexBufferBase::PRIMITIVE_TYPE_TRIANGLES )
+        {
+            out.push_back( vertexAt( index - 2 ) );
+            out.push_back( vertexAt( index - 1 ) );
+            out.push_back( vertexAt( index - 0 ) );
+            index += 3;
+        }
+        else
+        if( primitiveType == IndexBufferBase::PRIMITIVE_TYPE_TRIANGLE_STRIP )
+        {
+            /* Every other triangle of a strip is flipped to retain the winding.
+             */
+            const bool isOdd = index % 2 == 1;
+            out.push_back( vertexAt( index - ( isOdd ? 1 : 2 ) ) );
+            out.push_back( vertexAt( index - ( isOdd ? 2 : 1 ) ) );
+            out.push_back( vertexAt( index ) );
+            index += 1;
+        }
+        else
+        if( primitiveType == IndexBufferBase::PRIMITIVE_TYPE_TRIANGLE_FAN )
+        {
+            out.push_back( vertexAt( 0 ) );
+            out.push_back( vertexAt( index - 1 ) );
+            out.push_back( vertexAt( index ) );
+            index += 1;
+        }
+        else
+        {
+            break;
+        }
+    }
+}
+
+
 template< typename VertexType, typename IndexType >
 ManagedMesh< VertexType, IndexType >& ManagedMesh< VertexType, IndexType >::create
     ( unsigned int primitiveType
@@ -21,6 +21,7 @@
 #include <LibCarna/base/ShaderUniform.hpp>
 #include <LibCarna/base/noncopyable.hpp>
 #include <string>
+#include <vector>
 
 /** \file
   * \brief
@@ -124,6 +125,11 @@ namespace base
   *   - `modelViewProjection` is the concatenation of `projection` and `modelView`.
   *     It maps from model space to clipping coordinates.
   *
+  * The built-in shaders read the projection matrix from the uniform block, that the
+  * \ref FrameUniformBuffer provides, and compute `projection * modelView` instead.
+  * That way, only `modelView` has to be uploaded per geometry node, whereas the
+  * uniforms, that a shader does not declare, cost no OpenGL calls.
+  *
   * \subsection GLSL_Frag Fragment Shaders
   *
   * Lets take a look at an exemplary fragment shader:
@@ -170,6 +176,19 @@ namespace base
   * The suffixes `.vert` and `.frag` are important. You will be able to reference the
   * shader from a `%Material` object by setting its `shaderName` to `myShader`.
   *
+  * \subsection InstancedShaders Instanced Shaders
+  *
+  * If a shader named like the material's shader, but suffixed with `_instanced`,
+  * is available, then the \ref MeshRenderingStage renders consecutive geometry
+  * nodes, that share the same mesh and
+  * \ref isInstancingCompatible "compatible materials", using a single instanced
+  * draw call. Instead of the `modelView` and `modelViewProjection` uniforms, the
+  * instanced shader reads the per-instance attributes `instanceModelView`,
+  * `instanceNormalsView`, and `instanceColor` from the locations that
+  * \ref MeshRenderingMixin defines. The projection matrix is read from the
+  * \ref FrameUniformBuffer, or from the `projection` uniform, that is still set. The
+  * `instanceColor` attribute takes the `color` parameter of the material.
+  *
   * \author Leonid Kostrykin
   */
 class LIBCARNA Material : public GeometryFeature
@@ -181,6 +200,7 @@ class LIBCARNA Material : public GeometryFeature
     const std::unique_ptr< Details > pimpl;
 
     const ShaderProgram* shader;
+    const ShaderProgram* instancedShader;
     
 protected:
 
@@ -209,6 +229,11 @@ public:
       *
       * Any previously set parameters with the same
       * \ref ShaderUniformBase::name "name" are overriden.
+      *
+      * The parameters are only uploaded if they are not still in effect, i.e. if
+      * the shader was used with a different material in between, or if the
+      * parameters of this material have changed. Thus \a uniform must not be
+      * modified after it was added. Add a new parameter instead.
       */
     void addParameter( ShaderUniformBase* uniform );
     
@@ -238,10 +263,33 @@ public:
       */
     const ShaderUniformBase& parameter( const std::string& name ) const;
 
+    /** \brief
+      * Tells how many times any material has uploaded its parameters to a shader so
+      * far. \ref addParameter "Uploads" of parameters that are still in effect are
+      * skipped and not counted.
+      */
+    static std::size_t parameterUploadsCount();
+
     float lineWidth() const;
 
     void setLineWidth( float lineWidth );
 
+    /** \brief
+      * Tells whether geometry nodes with this material and geometry nodes with
+      * \a other can be rendered within a single instanced draw call. This is the
+      * case if both use the same shader, line width, and parameters, except for the
+      * `color` parameter, that is passed per instance.
+      */
+    bool isInstancingCompatible( const Material& other ) const;
+
+    /** \brief
+      * Appends the names of the shaders to \a shaderNames, that are acquired along
+      * with the video resources of this material. This is the \ref shaderName and
+      * the name of its \ref InstancedShaders "instanced variant", if available.
+      * Names that \a shaderNames contains already are not appended again.
+      */
+    void collectShaderNames( std::vector< std::string >& shaderNames ) const;
+
     /** \brief
       * Instantiates. Call \ref release when you do not need the object any longer.
       */
@@ -291,6 +339,28 @@ public:
           * References the shader of \ref material "this material".
           */
         const ShaderProgram& shader() const;
+
+        /** \brief
+          * Tells whether an \ref InstancedShaders "instanced variant" of the
+          * \ref shader "shader" is available.
+          */
+        bool hasInstancedShader() const;
+
+        /** \brief
+          * References the \ref InstancedShaders "instanced variant" of the
+          * \ref shader "shader".
+          *
+          * \pre `hasInstancedShader() == true`
+          */
+        const ShaderProgram& instancedShader() const;
+
+        /** \brief
+          * Does the same as \ref activate, but sets the
+          * \ref instancedShader "instanced variant" of the shader.
+          *
+          * \pre `hasInstancedShader() == true`
+          */
+        void activateInstanced( RenderState& renderState ) const;
     
         /** \brief
           * References the material.
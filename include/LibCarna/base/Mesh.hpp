@@ -108,6 +108,14 @@ public:
       */
     void render() const;
 
+    /** \brief
+      * Renders \a instancesCount instances of the mesh using a single draw call.
+      * The per-instance vertex attributes must be configured on the
+      * \ref bind "bound" vertex array before.
+      * \pre `&GLContext::current() == &glContext`
+      */
+    void renderInstanced( unsigned int instancesCount ) const;
+
     const VertexBufferBase& vertexBuffer() const;   ///< References the mesh's vertex buffer.
     const  IndexBufferBase&  indexBuffer() const;   ///< References the mesh's  index buffer.
     
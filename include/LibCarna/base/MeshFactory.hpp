@@ -21,14 +21,15 @@
 #include <LibCarna/base/IndexBuffer.hpp>
 #include <LibCarna/base/ManagedMesh.hpp>
 #include <LibCarna/base/Vertex.hpp>
+#include <LibCarna/base/OBJReader.hpp>
+#include <LibCarna/base/PLYReader.hpp>
+#include <LibCarna/base/STLReader.hpp>
 #include <LibCarna/base/math.hpp>
 #include <cstdint>
-#include <unordered_set>
-#include <functional>
 #include <memory>
 #include <istream>
-#include <ios>
 #include <string>
+#include <vector>
 
 /** \file
   * \brief
@@ -63,6 +64,12 @@ class MeshFactory
     template< typename VectorType >
     static VertexType vertex( const VectorType& position, const VectorType& normal = VectorType(), const VectorType& color = VectorType() );
 
+    static ManagedMesh< VertexType, uint32_t >& createFromArrays
+        ( const std::vector< math::Vector3f >& positions
+        , const std::vector< math::Vector3f >& normals
+        , const std::vector< math::Vector4f >& colors
+        , const std::vector< uint32_t >& indices );
+
 public:
 
     /** \brief
@@ -92,16 +99,70 @@ public:
     static ManagedMesh< VertexType, uint16_t >& createLineStrip( const std::vector< math::Vector3f >& points );
 
     /** \brief
-      * Creates mesh from an STL file.
+      * Creates mesh from a binary or ASCII STL file. Corners with equal positions
+      * are merged, as described for the \ref STLReader. Face normals are
+      * discarded.
+      *
+      * \throws AssertionFailure thrown if the file cannot be read or is malformed.
       *
       * \author Tim Schroeder
       */
-    inline static ManagedMesh< VertexType, uint32_t >& createFromSTL( const std::string& path );
+    static ManagedMesh< VertexType, uint32_t >& createFromSTL( const std::string& path );
 
     /** \overload
-     */
+      *
+      * Reads \a stlStream from its current position until the end.
+      */
     static ManagedMesh< VertexType, uint32_t >& createFromSTL( std::istream& stlStream );
 
+    /** \overload
+      *
+      * Creates the mesh from the data last read by \a reader.
+      */
+    static ManagedMesh< VertexType, uint32_t >& createFromSTL( const STLReader& reader );
+
+    /** \brief
+      * Creates mesh from an ASCII or binary PLY file, as described for the
+      * \ref PLYReader. Normals and colors are used, if both the file and the
+      * \a VertexType have them.
+      *
+      * \throws AssertionFailure thrown if the file cannot be read or is malformed.
+      */
+    static ManagedMesh< VertexType, uint32_t >& createFromPLY( const std::string& path );
+
+    /** \overload
+      *
+      * Reads \a plyStream from its current position until the end.
+      */
+    static ManagedMesh< VertexType, uint32_t >& createFromPLY( std::istream& plyStream );
+
+    /** \overload
+      *
+      * Creates the mesh from the data last read by \a reader.
+      */
+    static ManagedMesh< VertexType, uint32_t >& createFromPLY( const PLYReader& reader );
+
+    /** \brief
+      * Creates mesh from a Wavefront OBJ file, as described for the
+      * \ref OBJReader. Normals and colors are used, if both the file and the
+      * \a VertexType have them.
+      *
+      * \throws AssertionFailure thrown if the file cannot be read or is malformed.
+      */
+    static ManagedMesh< VertexType, uint32_t >& createFromOBJ( const std::string& path );
+
+    /** \overload
+      *
+      * Reads \a objStream from its current position until the end.
+      */
+    static ManagedMesh< VertexType, uint32_t >& createFromOBJ( std::istream& objStream );
+
+    /** \overload
+      *
+      * Creates the mesh from the data last read by \a reader.
+      */
+    static ManagedMesh< VertexType, uint32_t >& createFromOBJ( const OBJReader& reader );
+
 }; // MeshFactory
 
 
@@ -273,98 +334,114 @@ ManagedMesh< VertexType, uint8_t >& MeshFactory< VertexType >::createPoint()
 
 
 template< typename VertexType >
-inline ManagedMesh< VertexType, uint32_t >& MeshFactory< VertexType >::createFromSTL(const std::string& path)
+ManagedMesh< VertexType, uint32_t >& MeshFactory< VertexType >::createFromArrays
+    ( const std::vector< math::Vector3f >& positions
+    , const std::vector< math::Vector3f >& normals
+    , const std::vector< math::Vector4f >& colors
+    , const std::vector< uint32_t >& indices )
 {
-    return createFromSTL( std::fstream(path, std::ios::in | std::ios::binary) );
+    typedef ManagedMesh< VertexType, uint32_t > MeshInstance;
+    typedef typename MeshInstance::Vertex Vertex;
+
+    LIBCARNA_ASSERT_EX( !indices.empty(), "Mesh data contains no triangles!" );
+
+    /* Normals and colors are optional. The vertex type ignores them, if it has no
+     * corresponding components.
+     */
+    std::unique_ptr< Vertex[] > vertices( new Vertex[ positions.size() ] );
+    for( std::size_t vertexIndex = 0; vertexIndex < positions.size(); ++vertexIndex )
+    {
+        Vertex& vertex = vertices[ vertexIndex ];
+        vertex.setPosition( positions[ vertexIndex ] );
+        if( !normals.empty() )
+        {
+            vertex.setNormal( normals[ vertexIndex ] );
+        }
+        if( !colors.empty() )
+        {
+            vertex.setColor( colors[ vertexIndex ] );
+        }
+    }
+
+    return MeshInstance::create
+        ( IndexBufferBase::PRIMITIVE_TYPE_TRIANGLES
+        , vertices.get(), positions.size()
+        , indices.data(), indices.size() );
+}
+
+
+template< typename VertexType >
+ManagedMesh< VertexType, uint32_t >& MeshFactory< VertexType >::createFromSTL( const STLReader& reader )
+{
+    return createFromArrays( reader.positions(), std::vector< math::Vector3f >(), std::vector< math::Vector4f >(), reader.indices() );
+}
+
+
+template< typename VertexType >
+ManagedMesh< VertexType, uint32_t >& MeshFactory< VertexType >::createFromSTL( const std::string& path )
+{
+    STLReader reader;
+    reader.read( path );
+    return createFromSTL( reader );
 }
 
+
 template< typename VertexType >
 ManagedMesh< VertexType, uint32_t >& MeshFactory< VertexType >::createFromSTL( std::istream& stlStream )
 {
-    auto origExceptMask = stlStream.exceptions();
-    stlStream.exceptions(std::istream::failbit | std::istream::badbit | std::istream::eofbit);
+    STLReader reader;
+    reader.read( stlStream );
+    return createFromSTL( reader );
+}
 
-    uint32_t amountTriangles;
 
-    //discard first 80 bytes
-    stlStream.seekg(stlStream.beg + 80);
+template< typename VertexType >
+ManagedMesh< VertexType, uint32_t >& MeshFactory< VertexType >::createFromPLY( const PLYReader& reader )
+{
+    return createFromArrays( reader.positions(), reader.normals(), reader.colors(), reader.indices() );
+}
 
-    //read amount of triangles (32bit-uint)
-    stlStream.read(reinterpret_cast<char*>(&amountTriangles), 4);
-    
-    typedef ManagedMesh< VertexType, uint32_t > MeshInstance;
-    typedef typename MeshInstance::Vertex Vertex;
-    typedef typename MeshInstance::Index  Index;
-    typedef typename std::pair< Vertex, std::size_t > VertexIndexPair;
-
-    std::size_t indicesCount = amountTriangles * 3;
-    std::unique_ptr<Index[]>  indices (new Index  [indicesCount]);
-    std::unique_ptr<Vertex[]> vertices(new Vertex [indicesCount]);
-    
-    std::function<std::size_t(const VertexIndexPair&)> vertexHash =
-    [](const VertexIndexPair& vertAndIndex) -> std::size_t
-    {
-        //creates combined hash value of the 3 public members "x","y","z" of a Vertex object; ignores the second member of pair
-        //This hash-combine-technique is taken from : http://www.open-std.org/jtc1/sc22/wg21/docs/papers/2014/n3876.pdf (Page 2)
-        std::size_t hashVal = std::hash<decltype(vertAndIndex.first.x)>()(vertAndIndex.first.x);
-        hashVal ^= std::hash<decltype(vertAndIndex.first.y)>()(vertAndIndex.first.y) + 0x9e3779b9 + (hashVal << 6) + (hashVal >> 2);
-        hashVal ^= std::hash<decltype(vertAndIndex.first.z)> ()(vertAndIndex.first.z) + 0x9e3779b9 + (hashVal << 6) + (hashVal >> 2);
-        return hashVal;
-    };
-
-    std::function<std::size_t(const VertexIndexPair&, const VertexIndexPair&)> vertexComp =
-    [](const VertexIndexPair& vertAndIndex1, const VertexIndexPair& vertAndIndex2) -> bool
-    {
-        //checks whether the members "x", "y", "z" of two Vertex objects are equal
-        return ((vertAndIndex1.first.x) == (vertAndIndex2.first.x)) && ((vertAndIndex1.first.y) == (vertAndIndex2.first.y)) && ((vertAndIndex1.first.z) == (vertAndIndex2.first.z));
-    };
 
-    std::unordered_set< VertexIndexPair, decltype(vertexHash), decltype(vertexComp) > vertsWithArrIndices(amountTriangles * 3, vertexHash, vertexComp);
+template< typename VertexType >
+ManagedMesh< VertexType, uint32_t >& MeshFactory< VertexType >::createFromPLY( const std::string& path )
+{
+    PLYReader reader;
+    reader.read( path );
+    return createFromPLY( reader );
+}
+
 
-    std::size_t indicesItCount = 0;
-    std::size_t verticesItCount = 0;
+template< typename VertexType >
+ManagedMesh< VertexType, uint32_t >& MeshFactory< VertexType >::createFromPLY( std::istream& plyStream )
+{
+    PLYReader reader;
+    reader.read( plyStream );
+    return createFromPLY( reader );
+}
 
-    //read triangles
-    for (unsigned int i = 0; i < amountTriangles; i++)
-    {
-        //discard normal
-        stlStream.seekg(12, std::ios_base::cur);
-        
-        //read vertices
-        for (unsigned int j = 0; j < 3; j++)    //read 3 vertices
-        {
-            float x, y, z;
-            
-            //read 1 vertex
-            stlStream.read(reinterpret_cast<char*>(&x), 4);
-            stlStream.read(reinterpret_cast<char*>(&y), 4);
-            stlStream.read(reinterpret_cast<char*>(&z), 4);
-
-            Vertex vert;
-            vert.x = x;
-            vert.y = y;
-            vert.z = z;
-            //vert gets invalidated here
-            auto emplRes = vertsWithArrIndices.emplace(std::piecewise_construct, std::forward_as_tuple(std::move(vert)), std::forward_as_tuple(verticesItCount));
-
-            if (emplRes.second)
-            {
-                vertices[verticesItCount++] = (emplRes.first)->first;
-            }
-
-            indices[indicesItCount++] = (emplRes.first)->second;
-        }
 
-        //discard 2 bytes
-        stlStream.seekg(2, std::ios_base::cur);
-    }
+template< typename VertexType >
+ManagedMesh< VertexType, uint32_t >& MeshFactory< VertexType >::createFromOBJ( const OBJReader& reader )
+{
+    return createFromArrays( reader.positions(), reader.normals(), reader.colors(), reader.indices() );
+}
 
-    stlStream.exceptions(origExceptMask);
 
-    return MeshInstance::create
-        (IndexBufferBase::PRIMITIVE_TYPE_TRIANGLES
-        , vertices.get(), verticesItCount
-        , indices.get(), indicesCount);
+template< typename VertexType >
+ManagedMesh< VertexType, uint32_t >& MeshFactory< VertexType >::createFromOBJ( const std::string& path )
+{
+    OBJReader reader;
+    reader.read( path );
+    return createFromOBJ( reader );
+}
+
+
+template< typename VertexType >
+ManagedMesh< VertexType, uint32_t >& MeshFactory< VertexType >::createFromOBJ( std::istream& objStream )
+{
+    OBJReader reader;
+    reader.read( objStream );
+    return createFromOBJ( reader );
 }
 
 
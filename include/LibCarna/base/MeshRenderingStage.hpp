@@ -22,6 +22,8 @@
 #include <LibCarna/base/ShaderUniform.hpp>
 #include <LibCarna/base/Material.hpp>
 #include <LibCarna/base/ManagedMesh.hpp>
+#include <LibCarna/base/noncopyable.hpp>
+#include <memory>
 
 /** \file
   * \brief
@@ -43,11 +45,21 @@ namespace base
 /** \brief
   * Defines \ref MeshRenderingStage class template instance invariants.
   *
+  * Also implements the batching of consecutive \ref Renderable "renderables" that
+  * share the same mesh and \ref Material::isInstancingCompatible "compatible"
+  * materials into single instanced draw calls. This requires that the material's
+  * shader has an \ref InstancedShaders "instanced variant".
+  *
   * \author Leonid Kostrykin
   */
 class LIBCARNA MeshRenderingMixin
 {
 
+    NON_COPYABLE
+
+    struct Details;
+    const std::unique_ptr< Details > pimpl;
+
 public:
 
     /** \brief
@@ -76,12 +88,83 @@ public:
       */
     const static unsigned int DEFAULT_ROLE_MATERIAL = 1;
 
+    /** \brief
+      * Holds the location of the `mat4 instanceModelView` vertex attribute of
+      * \ref InstancedShaders "instanced shaders". It occupies four locations.
+      */
+    const static unsigned int ATTRIBUTE_LOCATION_INSTANCE_MODELVIEW = 4;
+
+    /** \brief
+      * Holds the location of the `mat4 instanceNormalsView` vertex attribute of
+      * \ref InstancedShaders "instanced shaders". It occupies four locations.
+      */
+    const static unsigned int ATTRIBUTE_LOCATION_INSTANCE_NORMALSVIEW = 8;
+
+    /** \brief
+      * Holds the location of the `vec4 instanceColor` vertex attribute of
+      * \ref InstancedShaders "instanced shaders".
+      */
+    const static unsigned int ATTRIBUTE_LOCATION_INSTANCE_COLOR = 12;
+
     /** \brief
       * Holds the \ref QuickStart_FrameRenderer "geometry type" rendered by this
       * \ref MeshRenderingStage.
       */
     const unsigned int geometryType;
 
+    /** \brief
+      * Enables or disables instanced rendering. It is enabled by default.
+      */
+    void setInstancingEnabled( bool instancingEnabled );
+
+    /** \brief
+      * Tells whether instanced rendering is enabled.
+      */
+    bool isInstancingEnabled() const;
+
+    /** \brief
+      * Tells the number of draw calls issued by the last render pass.
+      */
+    std::size_t drawCallsCount() const;
+
+protected:
+
+    /** \brief
+      * Denotes the beginning of a render pass.
+      */
+    void beginBatches();
+
+    /** \brief
+      * Renders \a renderable with \a material and \a mesh. The draw call is
+      * deferred, so that it can be batched with subsequent renderables.
+      */
+    void renderBatched
+        ( const Renderable& renderable
+        , const Material::ManagedInterface& material
+        , const ManagedMeshBase::ManagedInterface& mesh
+        , const math::Matrix4f& projection );
+
+    /** \brief
+      * Issues the draw call of the pending batch, if there is any.
+      */
+    void flushBatch();
+
+    /** \brief
+      * Releases the video resources used for batching.
+      *
+      * \pre
+      * The OpenGL context, that the batches were rendered with, is current.
+      */
+    void releaseBatchResources();
+
+    /** \brief
+      * Appends the \ref Material::collectShaderNames "shader names" of the
+      * materials to \a shaderNames, that are attached to the geometry nodes
+      * beneath \a root, whose type *AND*-linked with \a geometryTypeMask equals
+      * \ref geometryType.
+      */
+    void collectMaterialShaderNames( const Node& root, unsigned int geometryTypeMask, std::vector< std::string >& shaderNames ) const;
+
 }; // MeshRenderingMixin
 
 
@@ -104,6 +187,11 @@ public:
   * - \ref DEFAULT_ROLE_MESH must be a \ref Mesh object.
   * - \ref DEFAULT_ROLE_MATERIAL must be a \ref Material object.
   *
+  * Consecutive geometry nodes, that share the same mesh and
+  * \ref Material::isInstancingCompatible "compatible materials", are rendered using
+  * a single instanced draw call, if the shader of the material has an
+  * \ref InstancedShaders "instanced variant".
+  *
   * \author Leonid Kostrykin
   */
 template< typename RenderableCompare >
@@ -122,8 +210,19 @@ public:
       */
     MeshRenderingStage( unsigned int geometryType );
 
+    /** \brief
+      * Releases acquired video resources.
+      */
+    virtual ~MeshRenderingStage();
+
     virtual void renderPass( const math::Matrix4f& viewTransform, RenderTask& rt, const Viewport& vp ) override;
 
+    /** \brief
+      * Appends the shader names of the materials, that are attached to the geometry
+      * nodes beneath \a root, to \a shaderNames.
+      */
+    virtual void collectShaderNames( const Node& root, std::vector< std::string >& shaderNames ) const override;
+
 protected:
 
     /** \copydoc LibCarna::base::GeometryStage::render
@@ -141,29 +240,38 @@ MeshRenderingStage< RenderableCompare >::MeshRenderingStage( unsigned int geomet
 }
 
 
+template< typename RenderableCompare >
+MeshRenderingStage< RenderableCompare >::~MeshRenderingStage()
+{
+    this->activateGLContext();
+    this->releaseBatchResources();
+}
+
+
 template< typename RenderableCompare >
 void MeshRenderingStage< RenderableCompare >::renderPass( const math::Matrix4f& viewTransform, RenderTask& rt, const Viewport& vp )
 {
     renderTask = &rt;
+    this->beginBatches();
     GeometryStage< RenderableCompare >::renderPass( viewTransform, rt, vp );
+    this->flushBatch();
     renderTask = nullptr;
 }
 
 
 template< typename RenderableCompare >
-void MeshRenderingStage< RenderableCompare >::render( const Renderable& renderable )
+void MeshRenderingStage< RenderableCompare >::collectShaderNames( const Node& root, std::vector< std::string >& shaderNames ) const
 {
-    RenderState rs;
-    const Material& material = static_cast< Material& >( renderable.geometry().feature( DEFAULT_ROLE_MATERIAL ) );
-    this->videoResource( material ).activate( rs );
+    this->collectMaterialShaderNames( root, this->geometryTypeMask, shaderNames );
+}
 
-    ShaderUniform< math::Matrix4f >( "modelView", renderable.modelViewTransform() ).upload();
-    ShaderUniform< math::Matrix4f >( "projection", renderTask->projection ).upload();
-    ShaderUniform< math::Matrix4f >( "modelViewProjection", renderTask->projection * renderable.modelViewTransform() ).upload();
-    ShaderUniform< math::Matrix4f >( "normalsView", renderable.viewModelTransform().transpose() ).upload();
 
+template< typename RenderableCompare >
+void MeshRenderingStage< RenderableCompare >::render( const Renderable& renderable )
+{
+    const Material& material = static_cast< Material& >( renderable.geometry().feature( DEFAULT_ROLE_MATERIAL ) );
     const ManagedMeshBase& mesh = static_cast< ManagedMeshBase& >( renderable.geometry().feature( DEFAULT_ROLE_MESH ) );
-    this->videoResource( mesh ).get().render();
+    this->renderBatched( renderable, this->videoResource( material ), this->videoResource( mesh ), renderTask->projection );
 }
 
 
@@ -84,16 +84,18 @@ public:
     void invalidate() override;
 
     /** \brief
-      * Attaches \a child to this node in \f$\mathcal O\left(\log n\right)\f$ and
-      * takes it's possession.
+      * Attaches \a child to this node in amortized \f$\mathcal O\left(1\right)\f$
+      * and takes it's possession.
       *
       * If \a child already has another parent, it is first detached from that one.
+      * The children are visited in the order they were attached.
       */
     void attachChild( Spatial* child );
     
     /** \brief
-      * Detaches \a child from this node in \f$\mathcal O\left(\log n\right)\f$. The
-      * caller takes possession of the child.
+      * Detaches \a child from this node in \f$\mathcal O\left(n\right)\f$. The
+      * caller takes possession of the child. The order of the remaining children is
+      * preserved.
       *
       * \returns
       * Possessing pointer to the child if it has successfully been detached or \c nullptr
@@ -103,7 +105,7 @@ public:
 
     /** \brief
       * Tells whether \a child is among the children of this node in
-      * \f$\mathcal O\left(\log n\right)\f$.
+      * \f$\mathcal O\left(1\right)\f$.
       */
     bool hasChild( const Spatial& child ) const;
     
@@ -133,6 +135,13 @@ public:
       */
     virtual void updateWorldTransform() override;
 
+    /** \brief
+      * Tells the number of spatials within this subtree, including this node, whose
+      * world transformations have \ref Spatial::hasWorldTransformChanged "changed"
+      * during the last \ref updateWorldTransform call.
+      */
+    std::size_t changedWorldTransformsCount() const;
+
 }; // Node
 
 
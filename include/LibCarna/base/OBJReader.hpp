@@ -0,0 +1,138 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#ifndef OBJREADER_H_6014714286
+#define OBJREADER_H_6014714286
+
+#include <LibCarna/LibCarna.hpp>
+#include <LibCarna/base/noncopyable.hpp>
+#include <LibCarna/base/math.hpp>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+/** \file
+  * \brief
+  * Defines \ref LibCarna::base::OBJReader.
+  */
+
+namespace LibCarna
+{
+
+namespace base
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// OBJReader
+// ----------------------------------------------------------------------------------
+
+/** \brief
+  * Reads indexed triangle meshes from Wavefront OBJ data. This is used by
+  * \ref MeshFactory::createFromOBJ.
+  *
+  * The positions are read from the `v` statements. Positions followed by three
+  * further components, as some exporters write them, also define the colors.
+  * The normals are read from the `vn` statements. The faces are read from the
+  * `f` statements, where negative indices are relative to the end. Polygons are
+  * split into triangle fans. All other statements are skipped.
+  *
+  * OBJ indexes positions and normals separately. If the faces reference normals,
+  * each unique pair of position and normal becomes a vertex. Otherwise, the
+  * vertices are the positions in the order of their definition.
+  *
+  * The data is read into memory at once and then parsed in place, independently
+  * of the current locale.
+  *
+  * \author Leonid Kostrykin
+  */
+class LIBCARNA OBJReader
+{
+
+    NON_COPYABLE
+
+    struct Details;
+    const std::unique_ptr< Details > pimpl;
+
+public:
+
+    /** \brief
+      * Instantiates a reader, that has not read any data yet.
+      */
+    OBJReader();
+
+    /** \brief
+      * Deletes.
+      */
+    ~OBJReader();
+
+    /** \brief
+      * Reads the OBJ data of \a size bytes, that starts at \a data. Replaces
+      * previously read meshes.
+      *
+      * \throws AssertionFailure thrown if the data is malformed.
+      */
+    void read( const char* data, std::size_t size );
+
+    /** \overload
+      *
+      * Reads \a stream from its current position until the end.
+      */
+    void read( std::istream& stream );
+
+    /** \overload
+      *
+      * Reads the file at \a path.
+      */
+    void read( const std::string& path );
+
+    /** \brief
+      * Tells the number of triangles of the last data read.
+      */
+    std::size_t trianglesCount() const;
+
+    /** \brief
+      * References the vertex positions of the last data read.
+      */
+    const std::vector< math::Vector3f >& positions() const;
+
+    /** \brief
+      * References the vertex normals of the last data read. This is empty if the
+      * data has no normals.
+      */
+    const std::vector< math::Vector3f >& normals() const;
+
+    /** \brief
+      * References the vertex colors of the last data read. This is empty if the
+      * data has no colors.
+      */
+    const std::vector< math::Vector4f >& colors() const;
+
+    /** \brief
+      * References the indices of the vertex \ref positions, three per triangle.
+      */
+    const std::vector< uint32_t >& indices() const;
+
+}; // OBJReader
+
+
+
+}  // namespace LibCarna :: base
+
+}  // namespace LibCarna
+
+#endif // OBJREADER_H_6014714286
@@ -0,0 +1,141 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#ifndef PLYREADER_H_6014714286
+#define PLYREADER_H_6014714286
+
+#include <LibCarna/LibCarna.hpp>
+#include <LibCarna/base/noncopyable.hpp>
+#include <LibCarna/base/math.hpp>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+/** \file
+  * \brief
+  * Defines \ref LibCarna::base::PLYReader.
+  */
+
+namespace LibCarna
+{
+
+namespace base
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// PLYReader
+// ----------------------------------------------------------------------------------
+
+/** \brief
+  * Reads indexed triangle meshes from ASCII and binary PLY data. This is used by
+  * \ref MeshFactory::createFromPLY.
+  *
+  * The vertices are read from the `vertex` element. Its `x`, `y` and `z`
+  * properties are the positions. The `nx`, `ny` and `nz` properties are the
+  * normals, and the `red`, `green`, `blue` and `alpha` properties are the colors.
+  * Integral color components are normalized to \f$\left[0, 1\right]\f$. The
+  * faces are read from the `vertex_indices` or `vertex_index` list of the `face`
+  * element. Polygons are split into triangle fans. Other elements and properties
+  * are skipped.
+  *
+  * The data is read into memory at once and then decoded into flat arrays, that
+  * are allocated once from the element counts in the header.
+  *
+  * \author Leonid Kostrykin
+  */
+class LIBCARNA PLYReader
+{
+
+    NON_COPYABLE
+
+    struct Details;
+    const std::unique_ptr< Details > pimpl;
+
+public:
+
+    /** \brief
+      * Instantiates a reader, that has not read any data yet.
+      */
+    PLYReader();
+
+    /** \brief
+      * Deletes.
+      */
+    ~PLYReader();
+
+    /** \brief
+      * Reads the PLY data of \a size bytes, that starts at \a data. Replaces
+      * previously read meshes.
+      *
+      * \throws AssertionFailure thrown if the data is malformed.
+      */
+    void read( const char* data, std::size_t size );
+
+    /** \overload
+      *
+      * Reads \a stream from its current position until the end.
+      */
+    void read( std::istream& stream );
+
+    /** \overload
+      *
+      * Reads the file at \a path.
+      */
+    void read( const std::string& path );
+
+    /** \brief
+      * Tells whether the last data read was binary PLY.
+      */
+    bool isBinary() const;
+
+    /** \brief
+      * Tells the number of triangles of the last data read.
+      */
+    std::size_t trianglesCount() const;
+
+    /** \brief
+      * References the vertex positions of the last data read.
+      */
+    const std::vector< math::Vector3f >& positions() const;
+
+    /** \brief
+      * References the vertex normals of the last data read. This is empty if the
+      * data has no normals.
+      */
+    const std::vector< math::Vector3f >& normals() const;
+
+    /** \brief
+      * References the vertex colors of the last data read. This is empty if the
+      * data has no colors.
+      */
+    const std::vector< math::Vector4f >& colors() const;
+
+    /** \brief
+      * References the indices of the vertex \ref positions, three per triangle.
+      */
+    const std::vector< uint32_t >& indices() const;
+
+}; // PLYReader
+
+
+
+}  // namespace LibCarna :: base
+
+}  // namespace LibCarna
+
+#endif // PLYREADER_H_6014714286
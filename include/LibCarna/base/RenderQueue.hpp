@@ -22,9 +22,12 @@
 #include <LibCarna/base/math.hpp>
 #include <LibCarna/base/LibCarnaException.hpp>
 #include <LibCarna/base/noncopyable.hpp>
+#include <LibCarna/base/Stopwatch.hpp>
 #include <vector>
 #include <algorithm>
 #include <climits>
+#include <cstdint>
+#include <functional>
 
 /** \file
   * \brief
@@ -51,7 +54,17 @@ namespace base
   *     Binary function that establishes partial order on `%Renderable` objects.
   *     Typical choices are \ref Renderable::BackToFront,
   *     \ref Renderable::FrontToBack or \ref Renderable::VideoResourcesOrder. Use
-  *     `void` if no particular order is required.
+  *     `void` if no particular order is required. Orders that provide a static
+  *     `computeSortKeys` function instead, like \ref Renderable::StateOrder and
+  *     \ref Renderable::DepthStateOrder, are established by radix sort on the keys,
+  *     which scales linearly with the number of renderables.
+  *
+  * The model-view transforms, the eye distances, and the order of the renderables
+  * are computed in parallel, if the library is built with OpenMP support. The
+  * number of threads is controlled through OpenMP, e.g., by the `OMP_NUM_THREADS`
+  * environment variable. The resulting order does not depend on the number of
+  * threads: Renderables that are equivalent w.r.t. \a RenderableCompare retain the
+  * order, in which they were gathered from the scene graph.
   *
   * The geometry nodes are only enqueued if their geometry type matches. The matching
   * is done as follows. First a bit-wise *AND* operation is applied to the node's
@@ -70,6 +83,9 @@ class RenderQueue
 
     std::vector< Renderable > renderables;
     std::size_t nextRenderableIndex;
+    double lastSortTime;
+
+    void sort( bool skipIfViewDependent );
 
 public:
 
@@ -147,6 +163,13 @@ public:
       */
     const Renderable& last() const;
 
+    /** \brief
+      * Tells the time in seconds spent on ordering the renderables, when the queue
+      * was \ref build "built" or \ref updateModelViewTransforms "updated" the last
+      * time.
+      */
+    double sortTime() const;
+
 }; // RenderQueue
 
 
@@ -156,20 +179,79 @@ const unsigned int RenderQueue< RenderableCompare >::EXACT_MATCH_GEOMETRY_TYPE_M
 
 template< typename RenderableCompare >
 RenderQueue< RenderableCompare >::RenderQueue( unsigned int geometryType, unsigned int geometryTypeMask )
-    : geometryType( geometryType )
+    : nextRenderableIndex( 0 )
+    , lastSortTime( 0 )
+    , geometryType( geometryType )
     , geometryTypeMask( geometryTypeMask )
 {
 }
 
 
-template< typename RenderableCompare >
+/** \brief
+  * Stably orders \a renderables by ascending \a keys using radix sort.
+  *
+  * \pre `renderables.size() == keys.size()`
+  */
+void LIBCARNA sortRenderablesByKeys( std::vector< Renderable >& renderables, const std::vector< std::uint64_t >& keys );
+
+
+/** \brief
+  * Stably orders \a renderables w.r.t. \a less. Fixed-size blocks are sorted in
+  * parallel and merged pairwise, also in parallel. Renderables that are equivalent
+  * w.r.t. \a less retain their relative order, so the result does not depend on
+  * the number of threads.
+  */
+void LIBCARNA sortRenderables
+    ( std::vector< Renderable >& renderables
+    , const std::function< bool( const Renderable&, const Renderable& ) >& less );
+
+
+/** \brief
+  * Sets the \ref Renderable::modelViewTransform "model-view transform" of each
+  * of the \a renderables to the product of \a viewTransform and the world
+  * transform of its geometry node. The renderables are processed in parallel.
+  */
+void LIBCARNA computeModelViewTransforms( std::vector< Renderable >& renderables, const math::Matrix4f& viewTransform );
+
+
+/** \brief
+  * Computes the \ref Renderable::eyeDistance2 "eye distances" of \a renderables
+  * in parallel, so that they are cached when the renderables are ordered.
+  */
+void LIBCARNA computeEyeDistances( const std::vector< Renderable >& renderables );
+
+
+template< typename RenderableCompare, typename = void >
 struct RenderableSort
 {
     static void sort( std::vector< Renderable >& renderables, bool skipIfViewDependent )
     {
         if( renderables.size() >= 2 && ( RenderableCompare::isViewDependent || !skipIfViewDependent ) )
         {
-            std::sort( renderables.begin(), renderables.end(), RenderableCompare() );
+            if( RenderableCompare::isViewDependent )
+            {
+                computeEyeDistances( renderables );
+            }
+            sortRenderables( renderables, RenderableCompare() );
+        }
+    }
+};
+
+
+template< typename RenderableCompare >
+struct RenderableSort< RenderableCompare, decltype( void( &RenderableCompare::computeSortKeys ) ) >
+{
+    static void sort( std::vector< Renderable >& renderables, bool skipIfViewDependent )
+    {
+        if( renderables.size() >= 2 && ( RenderableCompare::isViewDependent || !skipIfViewDependent ) )
+        {
+            if( RenderableCompare::isViewDependent )
+            {
+                computeEyeDistances( renderables );
+            }
+            std::vector< std::uint64_t > keys;
+            RenderableCompare::computeSortKeys( renderables, keys );
+            sortRenderablesByKeys( renderables, keys );
         }
     }
 };
@@ -190,22 +272,35 @@ void RenderQueue< RenderableCompare >::build( const Node& root, const math::Matr
     renderables.clear();
     nextRenderableIndex = 0;
     
-    /* Collect all geometries.
+    /* Collect all geometries. The model-view transforms are computed afterwards, in
+     * parallel.
      */
     root.visitChildren( true, [&]( const Spatial& spatial )
         {
-            const Geometry* const geom = dynamic_cast< const Geometry* >( &spatial );
-            if( geom != nullptr && ( geom->geometryType & geometryTypeMask ) == geometryType )
+            if( spatial.isGeometry() )
             {
-                const math::Matrix4f modelViewTransform = viewTransform * geom->worldTransform();
-                renderables.push_back( Renderable( *geom, modelViewTransform ) );
+                const Geometry& geom = static_cast< const Geometry& >( spatial );
+                if( ( geom.geometryType & geometryTypeMask ) == geometryType )
+                {
+                    renderables.push_back( Renderable( geom, geom.worldTransform() ) );
+                }
             }
         }
     );
+    computeModelViewTransforms( renderables, viewTransform );
     
     /* Order geometries as required. Do not skip anything.
      */
-    RenderableSort< RenderableCompare >::sort( renderables, false );
+    sort( false );
+}
+
+
+template< typename RenderableCompare >
+void RenderQueue< RenderableCompare >::sort( bool skipIfViewDependent )
+{
+    Stopwatch stopwatch;
+    RenderableSort< RenderableCompare >::sort( renderables, skipIfViewDependent );
+    lastSortTime = stopwatch.result();
 }
 
 
@@ -221,16 +316,11 @@ void RenderQueue< RenderableCompare >::updateModelViewTransforms( const math::Ma
 {
     /* Recompute the model-view transforms.
      */
-    std::for_each( renderables.begin(), renderables.end(),
-        [&viewTransform]( Renderable& r )
-        {
-            r.setModelViewTransform( viewTransform * r.geometry().worldTransform() );
-        }
-    );
+    computeModelViewTransforms( renderables, viewTransform );
     
     /* Order geometries as required. Skip if the order is not view-dependent.
      */
-    RenderableSort< RenderableCompare >::sort( renderables, true );
+    sort( true );
 }
 
 
@@ -265,6 +355,13 @@ const Renderable& RenderQueue< RenderableCompare >::last() const
 }
 
 
+template< typename RenderableCompare >
+double RenderQueue< RenderableCompare >::sortTime() const
+{
+    return lastSortTime;
+}
+
+
 
 }  // namespace LibCarna :: base
 
@@ -18,6 +18,8 @@
 #include <LibCarna/LibCarna.hpp>
 #include <LibCarna/base/noncopyable.hpp>
 #include <LibCarna/base/math.hpp>
+#include <string>
+#include <vector>
 
 /** \file
   * \brief
@@ -103,6 +105,13 @@ public:
       */
     virtual void prepareFrame( Node& root );
 
+    /** \brief
+      * Appends the names of the \ref ShaderManager "shaders" to \a shaderNames, that this stage will acquire when
+      * rendering the scene beneath \a root. This is used to \ref FrameRenderer::prewarmShaders "prewarm" them. The
+      * default implementation appends nothing.
+      */
+    virtual void collectShaderNames( const Node& root, std::vector< std::string >& shaderNames ) const;
+
     /** \brief
       * Called once per pass.
       *
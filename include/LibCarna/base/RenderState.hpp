@@ -83,6 +83,13 @@ namespace base
   * `render1` does not affect `render2`. Note that it is forbidden to modify a render
   * state that is not the current one.
   *
+  * The \ref GLContext keeps track of the actual OpenGL state, so that changes are
+  * only issued if they are effective. Restoring the previous state, when a render
+  * state is destroyed, is deferred until the next draw call or buffer clearing, so
+  * that the blend function of `render1` is only reverted once `renderSomething` is
+  * drawn by `render2`. Code that issues draw calls directly
+  * through OpenGL must call \ref GLContext::commitRenderState first.
+  *
   * \author Leonid Kostrykin
   */
 class LIBCARNA RenderState
@@ -99,14 +106,23 @@ protected:
 
     /** \brief
       * Creates the root instance of \a glContext. For internal usage only.
+      *
+      * If \a isApplied is `true`, the instance is not made the current one.
+      * Instead, it mirrors the actual state of the OpenGL context.
       */
-    explicit RenderState( GLContext& glContext );
+    explicit RenderState( GLContext& glContext, bool isApplied = false );
 
     /** \brief
       * Commits the full state. For internal usage only.
       */
     void commit() const;
 
+    /** \brief
+      * Commits those parts of the state, that differ from the actual state of the
+      * OpenGL context. For internal usage only.
+      */
+    void commitPending() const;
+
 public:
 
     /** \brief
@@ -161,6 +177,13 @@ public:
       */
     void setDepthTestFunction( int dtf );
 
+    /** \brief
+      * Enables or disables writing to the color buffer.
+      *
+      * This is the equivalent of `glColorMask` with all components set alike.
+      */
+    void setColorWrite( bool cw );
+
     /** \brief
       * Enables or disables alpha blending. Alpha blending is configured through
       * \ref setBlendFunction and \ref setBlendEquation.
@@ -202,6 +225,21 @@ public:
       */
     void setLineWidth( float lineWidth );
 
+    /** \brief
+      * Enables or disables the scissor test. The scissor test is configured through
+      * \ref setScissorBox.
+      */
+    void setScissorTest( bool st );
+
+    /** \brief
+      * Restricts rendering to the rectangle with the lower left corner at \a x and
+      * \a y. The scissor box only applies if \ref setScissorTest "the scissor test
+      * is activated."
+      *
+      * This is the equivalent of `glScissor`.
+      */
+    void setScissorBox( int x, int y, int width, int height );
+
 private:
 
     void commitDepthTest() const;
@@ -210,6 +248,8 @@ private:
 
     void commitDepthTestFunction() const;
 
+    void commitColorWrite() const;
+
     void commitBlend() const;
 
     void commitBlendFunction() const;
@@ -224,6 +264,10 @@ private:
 
     void commitLineWidth() const;
 
+    void commitScissorTest() const;
+
+    void commitScissorBox() const;
+
 }; // RenderState
 
 
@@ -0,0 +1,174 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#ifndef RENDERTARGETPOOL_H_6014714286
+#define RENDERTARGETPOOL_H_6014714286
+
+#include <LibCarna/LibCarna.hpp>
+#include <LibCarna/base/noncopyable.hpp>
+#include <LibCarna/base/Framebuffer.hpp>
+#include <memory>
+
+/** \file
+  * \brief
+  * Defines \ref LibCarna::base::RenderTargetPool.
+  */
+
+namespace LibCarna
+{
+
+namespace base
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// RenderTargetPool
+// ----------------------------------------------------------------------------------
+
+/** \brief
+  * Hands out transient render targets, i.e. \ref Framebuffer objects with a depth
+  * buffer and a single render texture, by format and size.
+  *
+  * Rendering stages, that only need an off-screen render target during their
+  * \ref RenderStage::renderPass "rendering pass", should \ref Lease "lease" it
+  * from the \ref FrameRenderer::renderTargets "pool of the frame renderer",
+  * instead of allocating it permanently. A target is returned to the pool, when
+  * its lease ends, so that subsequent stages can lease the same target. This way,
+  * stages that do not render at the same time share the same video memory. Stages
+  * that render nested, like the \ref presets::OccludedRenderingStage and the
+  * stages it renders, are handed out different targets.
+  *
+  * The contents of a target are undefined when it is leased.
+  *
+  * The \ref FrameRenderer \ref releaseUnused "releases" the targets, that were not
+  * leased during a frame, at the end of the frame. Targets of outdated sizes are
+  * thus released after the first frame rendered with the new size.
+  *
+  * \author Leonid Kostrykin
+  */
+class LIBCARNA RenderTargetPool
+{
+
+    NON_COPYABLE
+
+    struct Details;
+    const std::unique_ptr< Details > pimpl;
+
+    struct Target;
+
+    Target& acquire( unsigned int width, unsigned int height, Framebuffer::RenderTextureFormat format );
+
+public:
+
+    class Lease;
+
+    /** \brief
+      * Instantiates an empty pool.
+      */
+    RenderTargetPool();
+
+    /** \brief
+      * Deletes all targets.
+      *
+      * \pre
+      * The OpenGL context, that the targets were created with, is current.
+      *
+      * \pre
+      * No target is leased.
+      */
+    ~RenderTargetPool();
+
+    /** \brief
+      * Tells the number of targets, that the pool maintains, including the leased
+      * ones.
+      */
+    std::size_t size() const;
+
+    /** \brief
+      * Tells the number of targets, that are currently leased.
+      */
+    std::size_t leasedCount() const;
+
+    /** \brief
+      * Tells the number of targets, that were created so far.
+      */
+    std::size_t createdCount() const;
+
+    /** \brief
+      * Deletes the targets, that were not leased since the last call.
+      *
+      * \pre
+      * The OpenGL context, that the targets were created with, is current.
+      */
+    void releaseUnused();
+
+}; // RenderTargetPool
+
+
+
+// ----------------------------------------------------------------------------------
+// RenderTargetPool :: Lease
+// ----------------------------------------------------------------------------------
+
+/** \brief
+  * Leases a target from a \ref RenderTargetPool in a RAII-manner.
+  *
+  * \author Leonid Kostrykin
+  */
+class LIBCARNA RenderTargetPool::Lease
+{
+
+    NON_COPYABLE
+
+    Target& target;
+
+public:
+
+    /** \brief
+      * Leases a target of \a width and \a height from \a pool, whose render
+      * texture has \a format. Creates the target if none with matching format and
+      * size is available.
+      */
+    Lease
+        ( RenderTargetPool& pool
+        , unsigned int width
+        , unsigned int height
+        , Framebuffer::RenderTextureFormat format = Framebuffer::rgba8 );
+
+    /** \brief
+      * Returns the target to the pool.
+      */
+    ~Lease();
+
+    /** \brief
+      * References the framebuffer of the leased target.
+      */
+    Framebuffer& framebuffer() const;
+
+    /** \brief
+      * References the render texture, that is the first color attachment of the
+      * \ref framebuffer.
+      */
+    Texture< 2 >& renderTexture() const;
+
+}; // RenderTargetPool :: Lease
+
+
+
+}  // namespace LibCarna :: base
+
+}  // namespace LibCarna
+
+#endif // RENDERTARGETPOOL_H_6014714286
@@ -38,6 +38,10 @@ namespace base
 /** \brief
   * Invokes the rendering stages of the frame renderer successively.
   *
+  * The \ref FrameRenderer::frameUniforms "frame uniform buffer" is updated with the
+  * projection matrix, the view matrix, and the viewport of the task, before each
+  * stage is rendered.
+  *
   * \author Leonid Kostrykin
   */
 class LIBCARNA RenderTask
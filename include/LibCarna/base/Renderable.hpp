@@ -18,6 +18,8 @@
 #include <LibCarna/LibCarna.hpp>
 #include <LibCarna/base/GeometryFeature.hpp>
 #include <LibCarna/base/math.hpp>
+#include <cstdint>
+#include <vector>
 
 /** \file
   * \brief
@@ -159,6 +161,75 @@ public:
         bool operator()( const Renderable& l, const Renderable& r ) const;
     };
 
+    /** \brief
+      * Establishes order for renderables s.t. geometries with the same shader are
+      * grouped together, within those the geometries with the same mesh, and within
+      * those the geometries with the same material. This minimizes the state
+      * changes and maximizes the opportunities for instanced rendering.
+      *
+      * In contrast to the comparison-based orders, the \ref RenderQueue establishes
+      * this order by radix sort on 64-bit keys, that \ref computeSortKeys yields.
+      */
+    template< unsigned int materialRole, unsigned int meshRole >
+    struct StateOrder
+    {
+        /** \brief
+          * Indicates that this order does not depend on the
+          * \ref ViewSpace "view transform".
+          */
+        const static bool isViewDependent = false;
+
+        /** \brief
+          * Computes the sort key of each renderable.
+          */
+        static void computeSortKeys( const std::vector< Renderable >& renderables, std::vector< std::uint64_t >& keys );
+    };
+
+    /** \brief
+      * Establishes order for renderables w.r.t. to their depth in eye space, like
+      * \ref DepthOrder does. Renderables of equal depth are ordered like
+      * \ref StateOrder does.
+      *
+      * In contrast to the comparison-based orders, the \ref RenderQueue establishes
+      * this order by radix sort on 64-bit keys, that \ref computeSortKeys yields.
+      *
+      * \param order
+      *     establishes order back-to-front for positive \a order and front-to-back
+      *     for negative \a order.
+      */
+    template< int order, unsigned int materialRole, unsigned int meshRole >
+    struct DepthStateOrder
+    {
+        /** \brief
+          * Indicates that this order depends on the
+          * \ref ViewSpace "view transform".
+          */
+        const static bool isViewDependent = true;
+
+        /** \brief
+          * Computes the sort key of each renderable.
+          */
+        static void computeSortKeys( const std::vector< Renderable >& renderables, std::vector< std::uint64_t >& keys );
+    };
+
+    /** \brief
+      * Computes the 64-bit sort keys of \a renderables for \ref StateOrder if
+      * \a depthOrder is zero, and for \ref DepthStateOrder otherwise.
+      *
+      * The state is identified by the shader of the \ref Material with
+      * \a materialRole, the feature with \a meshRole, and the feature with
+      * \a materialRole, in this order of significance. Each is mapped to a dense
+      * number, in the order of first occurrence. If depth is included, it occupies
+      * the 32 most significant bits, so that the state bits only break ties. Shaders,
+      * meshes, and materials beyond the capacity of their bits share the last number.
+      */
+    static void computeSortKeys
+        ( const std::vector< Renderable >& renderables
+        , std::vector< std::uint64_t >& keys
+        , unsigned int materialRole
+        , unsigned int meshRole
+        , int depthOrder );
+
 }; // Renderable
 
 
@@ -169,6 +240,24 @@ bool Renderable::DepthOrder< order >::operator()( const Renderable& l, const Ren
 }
 
 
+template< unsigned int materialRole, unsigned int meshRole >
+void Renderable::StateOrder< materialRole, meshRole >::computeSortKeys
+    ( const std::vector< Renderable >& renderables
+    , std::vector< std::uint64_t >& keys )
+{
+    Renderable::computeSortKeys( renderables, keys, materialRole, meshRole, 0 );
+}
+
+
+template< int order, unsigned int materialRole, unsigned int meshRole >
+void Renderable::DepthStateOrder< order, materialRole, meshRole >::computeSortKeys
+    ( const std::vector< Renderable >& renderables
+    , std::vector< std::uint64_t >& keys )
+{
+    Renderable::computeSortKeys( renderables, keys, materialRole, meshRole, order );
+}
+
+
 template< unsigned int role >
 bool Renderable::VideoResourcesOrder< role >::operator()( const Renderable& l, const Renderable& r ) const
 {
@@ -0,0 +1,132 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#ifndef STLREADER_H_6014714286
+#define STLREADER_H_6014714286
+
+#include <LibCarna/LibCarna.hpp>
+#include <LibCarna/base/noncopyable.hpp>
+#include <LibCarna/base/math.hpp>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+/** \file
+  * \brief
+  * Defines \ref LibCarna::base::STLReader.
+  */
+
+namespace LibCarna
+{
+
+namespace base
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// STLReader
+// ----------------------------------------------------------------------------------
+
+/** \brief
+  * Reads triangle meshes from binary and ASCII STL data into an indexed
+  * representation. This is used by \ref MeshFactory::createFromSTL.
+  *
+  * STL stores each triangle with its own three corners. Corners with equal
+  * positions are merged into a single vertex, so that the vertices are unique. The
+  * vertices are ordered by their first occurrence. Face normals and attribute
+  * bytes are discarded.
+  *
+  * The data is read into memory at once and then parsed in place. Corners are
+  * merged using a flat hash table with open addressing, that is sized w.r.t. the
+  * number of triangles and grows only if the mesh has unusually many vertices.
+  *
+  * Binary STL is detected by its size, that is fully determined by the number of
+  * triangles in its header. Otherwise, data that starts with `solid` is read as
+  * ASCII STL, and any other data is read as binary STL. ASCII STL is parsed
+  * independently of the current locale.
+  *
+  * \author Leonid Kostrykin
+  */
+class LIBCARNA STLReader
+{
+
+    NON_COPYABLE
+
+    struct Details;
+    const std::unique_ptr< Details > pimpl;
+
+public:
+
+    /** \brief
+      * Instantiates a reader, that has not read any data yet.
+      */
+    STLReader();
+
+    /** \brief
+      * Deletes.
+      */
+    ~STLReader();
+
+    /** \brief
+      * Reads the STL data of \a size bytes, that starts at \a data. Replaces
+      * previously read meshes.
+      *
+      * \throws AssertionFailure thrown if the data is malformed.
+      */
+    void read( const char* data, std::size_t size );
+
+    /** \overload
+      *
+      * Reads \a stream from its current position until the end.
+      */
+    void read( std::istream& stream );
+
+    /** \overload
+      *
+      * Reads the file at \a path.
+      */
+    void read( const std::string& path );
+
+    /** \brief
+      * Tells whether the last data read was binary STL.
+      */
+    bool isBinary() const;
+
+    /** \brief
+      * Tells the number of triangles of the last data read.
+      */
+    std::size_t trianglesCount() const;
+
+    /** \brief
+      * References the unique vertex positions of the last data read.
+      */
+    const std::vector< math::Vector3f >& positions() const;
+
+    /** \brief
+      * References the indices of the vertex \ref positions, three per triangle.
+      */
+    const std::vector< uint32_t >& indices() const;
+
+}; // STLReader
+
+
+
+}  // namespace LibCarna :: base
+
+}  // namespace LibCarna
+
+#endif // STLREADER_H_6014714286
@@ -75,10 +75,22 @@ public:
       * \param src
       *     references the shader source code.
       *
+      * \param deferErrorCheck
+      *     postpones querying the compilation result until \ref checkErrors is
+      *     called. Drivers, that compile shaders in parallel, do not have to finish
+      *     the compilation until then.
+      *
       * \throw AssertionFailure thrown when creation of OpenGL shader object fails.
       * \throw ShaderCompilationError thrown when shader compilation fails.
       */
-    Shader( unsigned int type, const std::string& src );
+    Shader( unsigned int type, const std::string& src, bool deferErrorCheck = false );
+
+    /** \brief
+      * Waits for the compilation to finish and queries its result.
+      *
+      * \throw ShaderCompilationError thrown when shader compilation failed.
+      */
+    void checkErrors() const;
 
     /** \brief
       * Deletes the maintained OpenGL shader object.
@@ -23,7 +23,9 @@
 #include <LibCarna/LibCarna.hpp>
 #include <LibCarna/base/Singleton.hpp>
 #include <LibCarna/base/noncopyable.hpp>
+#include <map>
 #include <string>
+#include <vector>
 
 namespace LibCarna
 {
@@ -41,6 +43,26 @@ namespace base
   * Ensures that each \ref ShaderProgram "shader" is built just once and not each
   * time someone requests it.
   *
+  * Optionally, the binaries of the built shader programs are cached on disk, so that
+  * subsequent runs do not have to compile and link them again. The cache is enabled
+  * by \ref setProgramBinaryCacheDirectory. Each cached binary is associated with a
+  * hash of the shader sources, and of the \ref GLContext::vendor "vendor" and the
+  * \ref GLContext::renderer "renderer" of the OpenGL context. The shader program is
+  * built from its sources as usual, if the hash does not match, if the driver
+  * rejects the binary, or if the OpenGL context does not support
+  * \ref ShaderProgram::isBinarySupported "program binaries" at all.
+  *
+  * \subsection ShaderVariants Shader Variants
+  *
+  * Specialized variants of a shader are obtained by passing preprocessor macro
+  * \ref Defines "definitions" to \ref acquireShader. The definitions are inserted
+  * into the sources of each shader stage, right after the `#version` directive.
+  * This allows shaders to decide on features at compile time rather than branching
+  * at runtime, e.g. `dvr` with `LIGHTING` defined as `0` or `1`. Each variant is
+  * built and cached separately. Variants are identified by
+  * \ref variantName "names" like `dvr[LIGHTING=1]`, that also can be used with
+  * any method that expects a shader name.
+  *
   * \author Leonid Kostrykin
   */
 class LIBCARNA ShaderManager : public Singleton< ShaderManager >
@@ -82,6 +104,32 @@ public:
       */
     const ShaderProgram& acquireShader( const std::string& shaderName );
 
+    /** \brief
+      * Maps names of preprocessor macros to their definitions.
+      */
+    typedef std::map< std::string, std::string > Defines;
+
+    /** \brief
+      * References the \ref ShaderVariants "variant" of the shader named
+      * \a shaderName, that is specialized by \a defines.
+      */
+    const ShaderProgram& acquireShader( const std::string& shaderName, const Defines& defines );
+
+    /** \brief
+      * Tells the name of the \ref ShaderVariants "variant" of the shader named
+      * \a shaderName, that is specialized by \a defines. This is \a shaderName,
+      * followed by the comma-separated definitions in square brackets, e.g.
+      * `dvr[LIGHTING=1]`. Tells \a shaderName if \a defines is empty.
+      */
+    static std::string variantName( const std::string& shaderName, const Defines& defines );
+
+    /** \brief
+      * Tells whether \ref acquireShader "acquiring" the shader named \a shaderName
+      * would succeed, i.e. whether it is loaded already, or whether its vertex and
+      * fragment shader sources were either \ref setSource "specified" or built in.
+      */
+    bool hasShader( const std::string& shaderName ) const;
+
     /** \brief
       * Releases \ref acquireShader "previously acquired" \a shader.
       *
@@ -102,6 +150,52 @@ public:
       */
     void removeSource( const std::string& srcName );
 
+    /** \brief
+      * Enables caching the binaries of shader programs in \a directory, that must
+      * exist. Disables the cache if \a directory is empty, what is the default.
+      */
+    void setProgramBinaryCacheDirectory( const std::string& directory );
+
+    /** \brief
+      * Tells the directory, that the binaries of shader programs are cached in. Tells
+      * an empty string if the cache is disabled.
+      */
+    const std::string& programBinaryCacheDirectory() const;
+
+    /** \brief
+      * Tells how many shader programs were loaded from the cache instead of being
+      * built from their sources so far.
+      */
+    std::size_t programBinaryCacheHitsCount() const;
+
+    /** \brief
+      * \ref acquireShader "Acquires" each shader named in \a shaderNames, so that
+      * no shaders need to be built while rendering later on. Tells the acquired
+      * shaders, in the same order. Each of them must be
+      * \ref releaseShader "released" eventually.
+      *
+      * The compilation and linking of all shaders that are not loaded yet is issued
+      * before waiting for the result of any of them. Drivers that support
+      * `GL_KHR_parallel_shader_compile` or `GL_ARB_parallel_shader_compile` are
+      * permitted to use as many compiler threads as they deem suitable. Other
+      * drivers might still build the shaders in the background.
+      *
+      * If any shader fails to build, none of the shaders remain acquired.
+      */
+    std::vector< const ShaderProgram* > prewarmShaders( const std::vector< std::string >& shaderNames );
+
+    /** \brief
+      * Tells the time in seconds, that the last build of the shader named
+      * \a shaderName has blocked the calling thread, including compilation and
+      * linking, or loading it from the \ref setProgramBinaryCacheDirectory "cache".
+      * Tells zero if the shader was never built.
+      *
+      * When shaders are \ref prewarmShaders "prewarmed", the driver might build
+      * them concurrently. Thus the build time of one shader might include waiting
+      * for others, while the build times of the others might be underestimated.
+      */
+    double shaderBuildTime( const std::string& shaderName ) const;
+
 }; // ShaderManager
 
 
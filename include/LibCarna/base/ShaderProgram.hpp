@@ -22,7 +22,11 @@
 
 #include <LibCarna/base/math.hpp>
 #include <LibCarna/base/noncopyable.hpp>
+#include <cstdint>
 #include <stack>
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace LibCarna
 {
@@ -39,6 +43,12 @@ namespace base
 /** \brief
   * Maintains an OpenGL shader program. Realizes the RAII-idiom.
   *
+  * The locations of the active uniforms are queried once, when the shader program
+  * is linked, and \ref uniformLocation "looked up" from a hash table afterwards.
+  * This spares the string lookups by the driver, that each \ref ShaderUniform
+  * upload would require otherwise. The uniform block of the
+  * \ref FrameUniformBuffer is bound to its binding point, if it is declared.
+  *
   * \see
   * The concept of shaders is explained \ref RenderingPipeline "here".
   *
@@ -48,6 +58,9 @@ class LIBCARNA ShaderProgram
 {
 
     NON_COPYABLE
+
+    struct Details;
+    const std::unique_ptr< Details > pimpl;
     
     ShaderProgram();
 
@@ -99,6 +112,12 @@ public:
           * \pre `shader.type == Shader::TYPE_FRAGMENT_SHADER`
           */
         void setFragmentShader( const Shader& shader );
+
+        /** \brief
+          * Hints the driver that the \ref ShaderProgram::queryBinary "binary" of the
+          * shader program will be retrieved. Disabled by default.
+          */
+        void setBinaryRetrievable( bool binaryRetrievable );
         
         /** \brief
           * Creates new OpenGL shader program.
@@ -108,6 +127,14 @@ public:
           *     objects fails.
           */
         ShaderProgram* create() const;
+
+        /** \brief
+          * Creates new OpenGL shader program like \ref create does, but returns
+          * without waiting for the driver to finish linking. This allows drivers to
+          * link multiple shader programs in parallel. \ref ShaderProgram::finishLinking
+          * must be called before the shader program is used.
+          */
+        ShaderProgram* createDeferred() const;
         
     }; // ShaderProgram :: Factory
 
@@ -123,6 +150,70 @@ public:
       */
     const unsigned int id;
 
+    /** \brief
+      * Waits for the driver to finish linking a shader program, that was
+      * \ref Factory::createDeferred "created deferred", and queries the result.
+      *
+      * \throw ShaderCompilationError
+      *     thrown when the linking of the shader objects failed.
+      */
+    void finishLinking();
+
+    /** \brief
+      * Tells the location of the active uniform \a name, or `-1` if this shader
+      * program has no such active uniform.
+      */
+    int uniformLocation( const std::string& name ) const;
+
+    /** \brief
+      * Records that the uniforms at \a locations were uploaded on behalf of
+      * \a owner, e.g. a \ref Material, in its \a revision. As long as
+      * \ref isUniformsOwner tells `true` for the same \a owner and \a revision, the
+      * uniforms still hold the uploaded values and need not be uploaded again.
+      * \ref ShaderUniformBase::upload "Uploading" any of the uniforms otherwise
+      * revokes the record.
+      */
+    void setUniformsOwner( const void* owner, std::uint64_t revision, const std::vector< int >& locations ) const;
+
+    /** \brief
+      * Tells whether the uniforms were \ref setUniformsOwner "uploaded" on behalf
+      * of \a owner in its \a revision, and were not overridden since.
+      */
+    bool isUniformsOwner( const void* owner, std::uint64_t revision ) const;
+
+    /** \brief
+      * Revokes the record of the \ref setUniformsOwner "uniforms owner", if it
+      * includes the uniform at \a location.
+      */
+    void revokeUniformsOwner( int location ) const;
+
+    /** \brief
+      * Tells whether the current OpenGL context supports retrieving and loading the
+      * binaries of shader programs.
+      */
+    static bool isBinarySupported();
+
+    /** \brief
+      * Retrieves the binary of this shader program, that \ref createFromBinary
+      * accepts later, and the driver-specific format of the binary. Tells `false`
+      * if no binary is available.
+      */
+    bool queryBinary( unsigned int& binaryFormat, std::vector< char >& binary ) const;
+
+    /** \brief
+      * Creates new OpenGL shader program from the \a binary, that was previously
+      * \ref queryBinary "retrieved" from a shader program. Returns `nullptr` if the
+      * driver rejects the binary, e.g. because the driver was updated meanwhile.
+      */
+    static ShaderProgram* createFromBinary( unsigned int binaryFormat, const std::vector< char >& binary );
+
+    /** \brief
+      * Tells how many times the location of a uniform was queried from OpenGL by
+      * any shader program so far. Only the linking of shader programs should
+      * increase this number.
+      */
+    static std::size_t uniformLocationQueriesCount();
+
 private:
 
     /** \brief
@@ -130,6 +221,12 @@ private:
       */
     void checkErrors() const;
 
+    /** \brief
+      * Queries the locations of the active uniforms of this shader program, and
+      * binds its uniform blocks.
+      */
+    void reflect();
+
 }; // ShaderProgram
 
 
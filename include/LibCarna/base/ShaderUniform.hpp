@@ -101,6 +101,12 @@ public:
       */
     bool upload() const;
 
+    /** \brief
+      * Tells whether \a other is a uniform of the same type, name and value. This
+      * implementation conservatively tells `false`.
+      */
+    virtual bool hasSameValue( const ShaderUniformBase& other ) const;
+
 protected:
 
     /** \brief
@@ -184,6 +190,8 @@ public:
       */
     ValueType value;
 
+    virtual bool hasSameValue( const ShaderUniformBase& other ) const override;
+
 protected:
 
     virtual void uploadTo( int location ) const override;
@@ -199,6 +207,14 @@ ShaderUniform< ValueType >::ShaderUniform( const std::string& name, const ValueT
 }
 
 
+template< typename ValueType >
+bool ShaderUniform< ValueType >::hasSameValue( const ShaderUniformBase& other ) const
+{
+    const ShaderUniform< ValueType >* const otherTyped = dynamic_cast< const ShaderUniform< ValueType >* >( &other );
+    return otherTyped != nullptr && otherTyped->name == name && otherTyped->value == value;
+}
+
+
 template< typename ValueType >
 void ShaderUniform< ValueType >::uploadTo( int location ) const
 {
@@ -49,8 +49,42 @@ class LIBCARNA Spatial
 
     NON_COPYABLE
 
+public:
+
+    /** \brief
+      * Lists the built-in types of spatials that can be told apart without run-time
+      * type information, e.g. during hot scene graph traversals.
+      */
+    enum Kind
+    {
+
+        /** \brief
+          * Neither a \ref Node nor a \ref Geometry.
+          */
+        kindSpatial,
+
+        /** \brief
+          * Instance of \ref Node or a derived class.
+          */
+        kindNode,
+
+        /** \brief
+          * Instance of \ref Geometry or a derived class.
+          */
+        kindGeometry
+
+    }; // Kind
+
+private:
+
+    const Kind myKind;
     Node* myParent;
     math::Matrix4f myWorldTransform;
+    math::Matrix4f myLastLocalTransform;
+    std::size_t myWorldTransformRevision;
+    std::size_t myParentWorldTransformRevision;
+    bool isWorldTransformValid;
+    bool myWorldTransformChanged;
     const void* myUserData;
     bool movable;
     std::string myTag;
@@ -65,6 +99,12 @@ public:
       * \param tag is an arbitrary string that may be used to identify this node.
       */
     explicit Spatial( const std::string& tag = "" );
+
+    /** \brief
+      * Instantiates a spatial of the built-in \a kind. This is meant to be used by
+      * the constructors of \ref Node and \ref Geometry only.
+      */
+    Spatial( const std::string& tag, Kind kind );
     
     /** \brief
       * Does nothing.
@@ -81,6 +121,23 @@ public:
       */
     typedef std::function< void( const Spatial& ) > ImmutableVisitor;
     
+    /** \brief
+      * Tells the built-in type of this spatial in \f$\mathcal O\left(1\right)\f$.
+      */
+    Kind kind() const;
+
+    /** \brief
+      * Tells whether this spatial is a \ref Node. Other than `dynamic_cast`, this
+      * requires no run-time type information.
+      */
+    bool isNode() const;
+
+    /** \brief
+      * Tells whether this spatial is a \ref Geometry. Other than `dynamic_cast`,
+      * this requires no run-time type information.
+      */
+    bool isGeometry() const;
+
     /** \brief
       * Tells whether this spatial has a parent node.
       */
@@ -138,7 +195,10 @@ public:
       * Computes the transformation to world space for this spatial.
       *
       * The default implementation concatenates the parent's world transformation
-      * with the \ref localTransform "local transformation" of this spatial.
+      * with the \ref localTransform "local transformation" of this spatial. The
+      * computation is skipped if neither the \ref localTransform "local
+      * transformation" nor the world transformation of the parent have changed
+      * since the world transformation of this spatial was computed the last time.
       */
     virtual void updateWorldTransform();
     
@@ -148,6 +208,18 @@ public:
       */
     const math::Matrix4f& worldTransform() const;
 
+    /** \brief
+      * Tells whether the last \ref updateWorldTransform call has actually
+      * recomputed the world transformation of this spatial.
+      */
+    bool hasWorldTransformChanged() const;
+
+    /** \brief
+      * Forces the world transformation of this spatial to be recomputed by the next
+      * \ref updateWorldTransform call.
+      */
+    void invalidateWorldTransform();
+
     /** \brief
       * Links an arbitrary object with this \c %Spatial instance.
       *
@@ -222,6 +294,24 @@ public:
 }; // Spatial
 
 
+inline Spatial::Kind Spatial::kind() const
+{
+    return myKind;
+}
+
+
+inline bool Spatial::isNode() const
+{
+    return myKind == kindNode;
+}
+
+
+inline bool Spatial::isGeometry() const
+{
+    return myKind == kindGeometry;
+}
+
+
 template< typename UserDataType >
 void Spatial::setUserData( const UserDataType& userData )
 {
@@ -112,11 +112,42 @@ template< typename VectorType, typename ScalarType >
 void RaySphereHitTest< VectorType, ScalarType >::compute( const Ray< VectorType >& ray, ScalarType radius )
 {
     LIBCARNA_ASSERT( isEqual< ScalarType >( ray.direction.norm(), 1 ) );
-    LIBCARNA_ASSERT( isEqual< ScalarType >(  planeNormal.norm(), 1 ) );
-    LIBCARNA_ASSERT( ray.direction.rows() == ray.origin.rows() && ray.origin.rows() == planeNormal.rows() );
-    LIBCARNA_ASSERT( ray.direction.cols() == ray.origin.cols() && ray.origin.cols() == planeNormal.cols() && planeNormal.cols() == 1 );
-
-    ;
+    LIBCARNA_ASSERT( ray.direction.rows() == ray.origin.rows() );
+    LIBCARNA_ASSERT( ray.direction.cols() == ray.origin.cols() && ray.origin.cols() == 1 );
+    LIBCARNA_ASSERT( radius >= 0 );
+
+    /* Solve 'length^2 + 2 * b * length + c = 0' for the ray length, where the
+     * squared distance of 'origin + direction * length' to the center equals the
+     * squared radius.
+     */
+    const ScalarType b = ray.origin.dot( ray.direction );
+    const ScalarType c = ray.origin.dot( ray.origin ) - radius * radius;
+    const ScalarType discriminant = b * b - c;
+    if( discriminant < 0 )
+    {
+        myHitExists = false;
+    }
+    else
+    {
+        /* Prefer the entry point. Use the exit point if the ray starts within the
+         * sphere.
+         */
+        const ScalarType root = std::sqrt( discriminant );
+        ScalarType rayLength = -b - root;
+        if( rayLength < 0 )
+        {
+            rayLength = -b + root;
+        }
+        if( rayLength < 0 )
+        {
+            myHitExists = false;
+        }
+        else
+        {
+            myHitExists = true;
+            myHitLocation = ray.origin + ray.direction * rayLength;
+        }
+    }
 }
 
 
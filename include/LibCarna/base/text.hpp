@@ -16,8 +16,11 @@
 #define TEXT_H_6014714286
 
 #include <LibCarna/LibCarna.hpp>
+#include <cstdint>
+#include <istream>
 #include <string>
 #include <sstream>
+#include <vector>
 
 /** \file
   * \brief
@@ -49,6 +52,49 @@ std::string LIBCARNA cat( const std::string& file );
 
 
 
+// ----------------------------------------------------------------------------------
+// readAll
+// ----------------------------------------------------------------------------------
+
+/** \brief
+  * Reads \a stream from its current position until the end into \a buffer. The
+  * data is read at once, if the size of the stream is known.
+  *
+  * \throws AssertionFailure thrown if reading fails.
+  */
+void LIBCARNA readAll( std::istream& stream, std::vector< char >& buffer );
+
+
+
+// ----------------------------------------------------------------------------------
+// parseDouble
+// ----------------------------------------------------------------------------------
+
+/** \brief
+  * Parses the decimal number from \a first to \a last into \a value. Unlike
+  * `strtod`, this does not regard the current locale.
+  *
+  * \returns
+  * `false` if the text is not a number.
+  */
+bool LIBCARNA parseDouble( const char* first, const char* last, double& value );
+
+
+
+// ----------------------------------------------------------------------------------
+// parseInt
+// ----------------------------------------------------------------------------------
+
+/** \brief
+  * Parses the decimal integer from \a first to \a last into \a value.
+  *
+  * \returns
+  * `false` if the text is not an integer or out of range.
+  */
+bool LIBCARNA parseInt( const char* first, const char* last, int64_t& value );
+
+
+
 // ----------------------------------------------------------------------------------
 // lexical_cast
 // ----------------------------------------------------------------------------------
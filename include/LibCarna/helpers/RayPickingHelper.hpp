@@ -0,0 +1,159 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#ifndef RAYPICKINGHELPER_H_6014714286
+#define RAYPICKINGHELPER_H_6014714286
+
+#include <LibCarna/LibCarna.hpp>
+#include <LibCarna/base/noncopyable.hpp>
+#include <LibCarna/base/math.hpp>
+#include <LibCarna/base/BufferedVectorFieldTexture.hpp>
+#include <LibCarna/base/IntensityVolume.hpp>
+#include <functional>
+#include <memory>
+
+/** \file
+  * \brief
+  * Defines \ref LibCarna::helpers::RayPickingHelper.
+  */
+
+namespace LibCarna
+{
+
+namespace helpers
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// RayPickingHelper
+// ----------------------------------------------------------------------------------
+
+/** \brief
+  * Maps rays to the \ref base::Geometry objects they hit first, entirely on the
+  * CPU. This is an alternative to the \ref presets::MeshColorCodingStage, that
+  * requires no rendering pass and also supports volumetric data.
+  *
+  * Meshes are intersected triangle-wise, accelerated by a bounding volume
+  * hierarchy per mesh, that is built by \ref base::ManagedMeshBase::computeRayHit
+  * the first time the mesh is tested. Volumes are marched along the ray at half the
+  * voxel size, until the first voxel above a threshold is found. Volumes are
+  * expected to be represented like \ref VolumeGridHelper does, i.e. each segment of
+  * the \ref base::VolumeGrid is a geometry node whose model space is the unit cube
+  * centered in the origin.
+  *
+  * Rays in world space are obtained through \ref base::math::Ray3f::fromEye from
+  * \ref FrameCoordinates "frame coordinates".
+  *
+  * \author Leonid Kostrykin
+  */
+class LIBCARNA RayPickingHelper
+{
+
+    NON_COPYABLE
+
+    struct Details;
+    const std::unique_ptr< Details > pimpl;
+
+public:
+
+    /** \brief
+      * Maps \ref base::GeometryFeature objects to the intensity volumes they
+      * represent. Returns `nullptr` for any other object.
+      */
+    typedef std::function< const base::IntensityVolume*( const base::GeometryFeature& ) > IntensitiesSelector;
+
+    /** \brief
+      * Instantiates.
+      */
+    RayPickingHelper();
+
+    /** \brief
+      * Deletes.
+      */
+    ~RayPickingHelper();
+
+    /** \brief
+      * Activates \a geometryType. Meshes with \a meshRole attached to geometry nodes
+      * with \a geometryType will be intersected with the rays.
+      *
+      * If \a geometryType was activated previously, its configuration is
+      * overridden.
+      */
+    void putMeshGeometryType( unsigned int geometryType, unsigned int meshRole );
+
+    /** \brief
+      * Activates \a geometryType. Intensity volumes of \a SegmentIntensityVolumeType
+      * with \a intensitiesRole attached to geometry nodes with \a geometryType will
+      * be marched along the rays. The first voxel whose intensity is greater than
+      * \a threshold is hit.
+      *
+      * If \a geometryType was activated previously, its configuration is
+      * overridden.
+      */
+    template< typename SegmentIntensityVolumeType >
+    void putVolumeGeometryType( unsigned int geometryType, unsigned int intensitiesRole, float threshold );
+
+    /** \overload
+      */
+    void putVolumeGeometryType
+        ( unsigned int geometryType
+        , unsigned int intensitiesRole
+        , float threshold
+        , const IntensitiesSelector& selectIntensities );
+
+    /** \brief
+      * Deactivates \a geometryType.
+      */
+    void removeGeometryType( unsigned int geometryType );
+
+    /** \brief
+      * Deactivates all geometry types.
+      */
+    void clearGeometryTypes();
+
+    /** \brief
+      * Tells the geometry node beneath \a root that is hit by \a ray first. Writes
+      * the world space location of the hit to \a hitLocation. Tells `nullptr` if no
+      * geometry node of an activated geometry type is hit.
+      *
+      * \pre
+      * The world transforms of the scene graph are
+      * \ref base::Spatial::updateWorldTransform "up to date".
+      */
+    const base::Geometry* pick( const base::Node& root, const base::math::Ray3f& ray, base::math::Vector3f& hitLocation ) const;
+
+}; // RayPickingHelper
+
+
+template< typename SegmentIntensityVolumeType >
+void RayPickingHelper::putVolumeGeometryType( unsigned int geometryType, unsigned int intensitiesRole, float threshold )
+{
+    typedef base::BufferedVectorFieldTexture< SegmentIntensityVolumeType > IntensityTexture;
+    putVolumeGeometryType( geometryType, intensitiesRole, threshold,
+        []( const base::GeometryFeature& feature ) -> const base::IntensityVolume*
+        {
+            const IntensityTexture* const texture = dynamic_cast< const IntensityTexture* >( &feature );
+            return texture == nullptr ? nullptr : &texture->field;
+        }
+    );
+}
+
+
+
+}  // namespace LibCarna :: helpers
+
+}  // namespace LibCarna
+
+#endif // RAYPICKINGHELPER_H_6014714286
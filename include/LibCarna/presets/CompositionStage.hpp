@@ -116,6 +116,10 @@ public:
         ( const base::math::Matrix4f& viewTransform
         , base::RenderTask& rt
         , const base::Viewport& vp ) override;
+
+    /** \copydoc base::RenderStage::collectShaderNames
+      */
+    virtual void collectShaderNames( const base::Node& root, std::vector< std::string >& shaderNames ) const override;
         
 protected:
 
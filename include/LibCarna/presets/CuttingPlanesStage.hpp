@@ -101,6 +101,10 @@ public:
         , base::RenderTask& rt
         , const base::Viewport& vp ) override;
 
+    /** \copydoc base::RenderStage::collectShaderNames
+      */
+    virtual void collectShaderNames( const base::Node& root, std::vector< std::string >& shaderNames ) const override;
+
     /** \brief
       * Sets windowing level to \a windowingLevel.
       */
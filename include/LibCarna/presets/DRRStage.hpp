@@ -138,8 +138,6 @@ public:
       */
     virtual ~DRRStage();
 
-    virtual void reshape( base::FrameRenderer& fr, unsigned int width, unsigned int height ) override;
-
     /** \brief
       * Computes the digital radiograph reconstruct like described
       * \ref DRRStageBackground "here".
@@ -149,6 +147,10 @@ public:
         , base::RenderTask& rt
         , const base::Viewport& vp ) override;
 
+    /** \copydoc base::RenderStage::collectShaderNames
+      */
+    virtual void collectShaderNames( const base::Node& root, std::vector< std::string >& shaderNames ) const override;
+
     /** \brief
       * Tells \f$\mu_\text{water}\f$. The parameters are described
       * \ref DRRStageBackground "here".
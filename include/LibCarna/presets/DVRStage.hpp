@@ -150,13 +150,15 @@ public:
       */
     virtual ~DVRStage();
 
-    virtual void reshape( base::FrameRenderer& fr, unsigned int width, unsigned int height ) override;
-
     virtual void renderPass
         ( const base::math::Matrix4f& viewTransform
         , base::RenderTask& rt
         , const base::Viewport& vp ) override;
 
+    /** \copydoc base::RenderStage::collectShaderNames
+      */
+    virtual void collectShaderNames( const base::Node& root, std::vector< std::string >& shaderNames ) const override;
+
     /** \brief
       * The color map used for the rendering.
       */
@@ -206,6 +208,12 @@ protected:
       */
     virtual const base::ShaderProgram& acquireShader() override;
 
+    /** \brief
+      * Tells the variant of the shader with lighting for volumes that have a
+      * \ref ROLE_NORMALS "normal map", and the variant without lighting otherwise.
+      */
+    virtual const base::ShaderProgram& selectShader( const base::Renderable& renderable ) override;
+
     /** \brief
       * Maps \ref ROLE_INTENSITIES to `intensities` and \ref ROLE_NORMALS to `normalMap`.
       */
@@ -92,13 +92,15 @@ public:
       */
     base::ColorMap colorMap;
 
-    virtual void reshape( base::FrameRenderer& fr, unsigned int width, unsigned int height ) override;
-
     virtual void renderPass
         ( const base::math::Matrix4f& viewTransform
         , base::RenderTask& rt
         , const base::Viewport& vp ) override;
 
+    /** \copydoc base::RenderStage::collectShaderNames
+      */
+    virtual void collectShaderNames( const base::Node& root, std::vector< std::string >& shaderNames ) const override;
+
 protected:
 
     virtual unsigned int loadVideoResources() override;
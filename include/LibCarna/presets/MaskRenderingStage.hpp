@@ -97,6 +97,10 @@ public:
         , base::RenderTask& rt
         , const base::Viewport& vp ) override;
 
+    /** \copydoc base::RenderStage::collectShaderNames
+      */
+    virtual void collectShaderNames( const base::Node& root, std::vector< std::string >& shaderNames ) const override;
+
     /** \brief
       * Tells the rendering color.
       */
@@ -128,6 +132,12 @@ protected:
       */
     virtual const base::ShaderProgram& acquireShader() override;
 
+    /** \brief
+      * Tells the variant of the shader, that either uses the \ref setColor "color"
+      * or ignores it, depending on whether \ref setFilling "filling" is enabled.
+      */
+    virtual const base::ShaderProgram& selectShader( const base::Renderable& renderable ) override;
+
     /** \brief
       * Maps \ref maskRole to `mask`.
       */
@@ -18,6 +18,7 @@
 #include <LibCarna/LibCarna.hpp>
 #include <LibCarna/base/GeometryStage.hpp>
 #include <LibCarna/base/Aggregation.hpp>
+#include <functional>
 
 /** \file
   * \brief
@@ -53,6 +54,14 @@ namespace presets
   * After rendering the frame, we can query the `%MeshColorCodingStage` object for
   * meshes at particular frame coordinates using its \ref pick method.
   *
+  * The \ref pick method reads the pixel synchronously, what stalls the rendering
+  * pipeline. Alternatively, a batch of frame coordinates can be
+  * \ref requestPick "requested" before the frame is rendered. The stage then reads
+  * back the pixels at all requested coordinates asynchronously, and
+  * \ref resolvePicks delivers the results later. If the stage is made
+  * \ref setLazy "lazy", it only renders if picks are requested, and only the
+  * region that spans the requested coordinates.
+  *
   * \note
   * In the \ref RenderingProcess "rendering process" this stage can be inserted
   * *anywhere*.
@@ -139,6 +148,10 @@ public:
 
     virtual void renderPass( const base::math::Matrix4f& viewTransform, base::RenderTask& rt, const base::Viewport& vp ) override;
 
+    /** \copydoc base::RenderStage::collectShaderNames
+      */
+    virtual void collectShaderNames( const base::Node& root, std::vector< std::string >& shaderNames ) const override;
+
     /** \brief
       * Maps the \ref FrameCoordinates "frame coordinates" \a x and \a y to the
       * \ref base::Geometry object that was rendered at the queried location. If no
@@ -150,10 +163,68 @@ public:
       */
     base::Aggregation< const base::Geometry > pick( const base::math::Vector2ui& ) const;
 
+    /** \brief
+      * Sets whether the stage only renders when picks are
+      * \ref requestPick "requested". Rendering is also restricted to the region,
+      * that spans the requested frame coordinates, through the scissor test. Thus
+      * \ref pick is only supported for requested frame coordinates, if the stage is
+      * lazy. The stage is not lazy by default.
+      */
+    void setLazy( bool lazy );
+
+    /** \brief
+      * Tells whether the stage only renders when picks are
+      * \ref requestPick "requested".
+      */
+    bool isLazy() const;
+
+    /** \brief
+      * Requests the \ref base::Geometry object, that will be rendered at the
+      * \ref FrameCoordinates "frame coordinates" \a x and \a y by the next frame.
+      * All picks requested until the frame is rendered are read back in a single
+      * batch. If the read back of the previous batch has not completed when the
+      * frame is rendered, the picks are deferred to the frame after.
+      */
+    void requestPick( unsigned int x, unsigned int y );
+
+    /** \overload
+      */
+    void requestPick( const base::math::Vector2ui& );
+
+    /** \brief
+      * Tells the number of \ref requestPick "requested" picks, that were not
+      * \ref resolvePicks "resolved" yet.
+      */
+    std::size_t pendingPicks() const;
+
+    /** \brief
+      * Receives the \ref base::Geometry object, that was rendered at the
+      * \ref FrameCoordinates "frame coordinates" \a location, or `nullptr` if no
+      * object was rendered there.
+      */
+    typedef std::function< void( const base::math::Vector2ui& location, const base::Geometry* geometry ) > PickCallback;
+
+    /** \brief
+      * Delivers the results of those \ref requestPick "requested" picks, that have
+      * been read back, to \a callback. If \a wait is `true`, waits for the picks
+      * of the last rendered frame to be read back. Tells the number of results
+      * delivered.
+      *
+      * The geometry objects must not have been deleted since the frame was
+      * rendered.
+      */
+    std::size_t resolvePicks( const PickCallback& callback, bool wait = false );
+
 protected:
 
     virtual void render( const base::Renderable& renderable ) override;
 
+private:
+
+    void issuePickBatch();
+
+    void finishPickBatch( bool wait );
+
 }; // MeshColorCodingStage
 
 
@@ -118,8 +118,6 @@ public:
       * translucent.
       */
     float occlusionTranslucency() const;
-
-    virtual void reshape( base::FrameRenderer& fr, unsigned int width, unsigned int height ) override;
     
     virtual void prepareFrame( base::Node& root ) override;
 
@@ -128,6 +126,10 @@ public:
         , base::RenderTask& rt
         , const base::Viewport& vp ) override;
 
+    /** \copydoc base::RenderStage::collectShaderNames
+      */
+    virtual void collectShaderNames( const base::Node& root, std::vector< std::string >& shaderNames ) const override;
+
 }; // OccludedRenderingStage
 
 
@@ -56,11 +56,15 @@ namespace presets
   * The concept of materials, meshes and other geometry feature is explained
   * \ref GeometryFeatures "here".
   *
+  * The geometries are ordered s.t. state changes are minimized, i.e. they are
+  * grouped by shaders, meshes, and materials.
+  *
   * \image html OpaqueRenderingStageTest/fromFront.png "exemplary rendering of two box meshes from code above"
   *
   * \author Leonid Kostrykin
   */
-typedef base::MeshRenderingStage< base::Renderable::VideoResourcesOrder< base::MeshRenderingMixin::DEFAULT_ROLE_MATERIAL > >
+typedef base::MeshRenderingStage
+    < base::Renderable::StateOrder< base::MeshRenderingMixin::DEFAULT_ROLE_MATERIAL, base::MeshRenderingMixin::DEFAULT_ROLE_MESH > >
     OpaqueRenderingStage;
 
 
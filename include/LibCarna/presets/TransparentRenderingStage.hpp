@@ -56,11 +56,15 @@ namespace presets
   * The concept of materials, meshes and other geometry feature is explained
   * \ref GeometryFeatures "here".
   *
+  * The geometries are rendered back-to-front. Geometries of equal depth are
+  * ordered s.t. state changes are minimized.
+  *
   * \image html TransparentRenderingStageTest/transparentFromFront.png "exemplary rendering of two box meshes from code above"
   *
   * \author Leonid Kostrykin
   */
-class LIBCARNA TransparentRenderingStage : public base::MeshRenderingStage< base::Renderable::BackToFront >
+class LIBCARNA TransparentRenderingStage : public base::MeshRenderingStage
+    < base::Renderable::DepthStateOrder< +1, base::MeshRenderingMixin::DEFAULT_ROLE_MATERIAL, base::MeshRenderingMixin::DEFAULT_ROLE_MESH > >
 {
 
 public:
@@ -278,6 +278,10 @@ namespace presets
   * }
   * \endcode
   *
+  * The `modelView` uniform is also set. The built-in shaders use it together with
+  * the projection matrix from the \ref base::FrameUniformBuffer "frame uniforms"
+  * instead of `modelViewProjection`.
+  *
   * \subsubsection VolumeRenderingFragmentShader Fragment Shader
   *
   * The fragment shader must declare the following GLSL version and uniform
@@ -356,6 +360,40 @@ public:
       */
     unsigned int sampleRate() const;
 
+    /** \brief
+      * Enables or disables occlusion culling of volume segments. Disabled by default.
+      *
+      * If enabled, the bounding box of each volume segment is rendered against the
+      * depth buffer with a `GL_ANY_SAMPLES_PASSED` occlusion query, before the
+      * segments are rendered. Segments whose bounding boxes did not pass the depth
+      * test, e.g. because they are covered entirely by opaque geometry rendered by a
+      * previous stage, are skipped. The results of the queries are used not before
+      * the next frame, so that rendering is never stalled by waiting for them. This
+      * means that a segment, which becomes visible, shows up with one frame delay.
+      *
+      * The queries are issued separately for each pass of a frame, e.g. for each
+      * eye of a \ref ParallaxStage or each \ref base::RenderTask "render task",
+      * that is forked from the main one. Thus, a segment that is occluded in one
+      * view is not skipped in the others. This requires the passes to be rendered
+      * in the same order on each frame.
+      */
+    void setOcclusionCullingEnabled( bool occlusionCulling );
+
+    /** \brief
+      * Tells whether occlusion culling of volume segments is enabled.
+      */
+    bool isOcclusionCullingEnabled() const;
+
+    /** \brief
+      * Tells the number of volume segments skipped by occlusion culling during the
+      * last rendered pass.
+      */
+    std::size_t occludedSegmentsCount() const;
+
+    /** \copydoc base::GeometryStage::prepareFrame
+      */
+    virtual void prepareFrame( base::Node& root ) override;
+
     /** \brief
       * Triggers the \ref VolumeRenderingApproach "volume rendering".
       */
@@ -364,6 +402,10 @@ public:
         , base::RenderTask& rt
         , const base::Viewport& vp ) override;
 
+    /** \copydoc base::RenderStage::collectShaderNames
+      */
+    virtual void collectShaderNames( const base::Node& root, std::vector< std::string >& shaderNames ) const override;
+
 protected:
 
     /** \brief
@@ -376,6 +418,20 @@ protected:
       */
     virtual unsigned int loadVideoResources();
 
+    /** \brief
+      * Builds the rendering queue and issues the occlusion queries of the enqueued
+      * volume segments, if \ref setOcclusionCullingEnabled "occlusion culling" is
+      * enabled.
+      */
+    virtual void buildRenderQueues( base::Node& root, const base::math::Matrix4f& viewTransform ) override;
+
+    /** \brief
+      * Updates the rendering queue and issues the occlusion queries of the enqueued
+      * volume segments, if \ref setOcclusionCullingEnabled "occlusion culling" is
+      * enabled.
+      */
+    virtual void updateRenderQueues( const base::math::Matrix4f& viewTransform ) override;
+
     virtual void render( const base::Renderable& ) override;
 
     /** \brief
@@ -390,6 +446,16 @@ protected:
       */
     virtual const base::ShaderProgram& acquireShader() = 0;
 
+    /** \brief
+      * Tells the shader to be used for rendering the slices of \a renderable. This
+      * allows choosing between \ref base::ShaderVariants "shader variants" on a
+      * per-volume level. When the shader changes between two volumes, the per-pass
+      * \ref configureShader is repeated for the new shader. The default
+      * implementation tells the shader, that was \ref acquireShader "acquired"
+      * previously.
+      */
+    virtual const base::ShaderProgram& selectShader( const base::Renderable& renderable );
+
     /** \brief
       * Tells the name of the uniform variable, that the \a role texture is to be bound to.
       * Use \ref configureShader for custom shader configuration that goes beyond that.
@@ -13,6 +13,8 @@
  */
 
 #include <LibCarna/base/BoundingBox.hpp>
+#include <LibCarna/base/math/Ray.hpp>
+#include <LibCarna/base/math/RayPlaneHitTest.hpp>
 
 namespace LibCarna
 {
@@ -57,6 +59,12 @@ BoundingBox::~BoundingBox()
 }
 
 
+const math::Vector3f& BoundingBox::size() const
+{
+    return pimpl->size;
+}
+
+
 void BoundingBox::setSize( const math::Vector3f& size )
 {
     LIBCARNA_ASSERT( size.x() > 0 && size.y() > 0 && size.z() > 0 );
@@ -87,6 +95,74 @@ void BoundingBox::computeClosemostPoint( math::Vector3f& out, const math::Vector
 }
 
 
+void BoundingBox::computeAxisAlignedBox( math::Vector3f& lower, math::Vector3f& upper, const math::Matrix4f& modelTransform ) const
+{
+    /* Each corner of the box is the center plus a signed combination of the
+     * transformed half edges. The extent along each axis thus is the sum of the
+     * absolute half edges, projected onto that axis.
+     */
+    const math::Matrix4f localToTarget = modelTransform * transform();
+    const math::Vector3f center = localToTarget.block< 3, 1 >( 0, 3 );
+    const math::Vector3f extent = localToTarget.block< 3, 3 >( 0, 0 ).cwiseAbs() * ( pimpl->size / 2 );
+    lower = center - extent;
+    upper = center + extent;
+}
+
+
+bool BoundingBox::computeRayHit( math::Vector3f& out, const math::Ray3f& ray ) const
+{
+    /* Transform 'ray' from model space to local coordinate system.
+     */
+    math::Ray< math::Vector3f > rayLocal;
+    rayLocal.origin    = math::vector3< float, 4 >( inverseTransform() * math::vector4( ray.origin, 1 ) );
+    rayLocal.direction = math::vector3< float, 4 >( inverseTransform() * math::vector4( ray.direction, 0 ) ).normalized();
+
+    /* Test the ray against each of the six faces and keep the close-most hit.
+     */
+    const math::Vector3f halfSize = pimpl->size / 2;
+    math::RayPlaneHitTest< math::Vector3f > hitTest;
+    bool hitExists = false;
+    float hitDistance2 = 0;
+    for( unsigned int axis = 0; axis < 3; ++axis )
+    {
+        for( int sign = -1; sign <= 1; sign += 2 )
+        {
+            math::Vector3f normal( 0, 0, 0 );
+            normal[ axis ] = static_cast< float >( sign );
+            hitTest.compute( rayLocal, normal, halfSize[ axis ] );
+            if( !hitTest.hitExists() )
+            {
+                continue;
+            }
+
+            /* Discard hits outside of the face.
+             */
+            const math::Vector3f& hit = hitTest.hitLocation();
+            if( ( hit.cwiseAbs() - halfSize ).maxCoeff() > math::epsilon< float >() )
+            {
+                continue;
+            }
+
+            const float distance2 = ( hit - rayLocal.origin ).squaredNorm();
+            if( !hitExists || distance2 < hitDistance2 )
+            {
+                hitExists = true;
+                hitDistance2 = distance2;
+                out = hit;
+            }
+        }
+    }
+
+    /* Transform 'out' from local coordinate system to model space.
+     */
+    if( hitExists )
+    {
+        out = math::vector3< float, 4 >( transform() * math::vector4( out, 1 ) );
+    }
+    return hitExists;
+}
+
+
 
 }  // namespace LibCarna :: base
 
@@ -13,6 +13,8 @@
  */
 
 #include <LibCarna/base/BoundingSphere.hpp>
+#include <LibCarna/base/math/Ray.hpp>
+#include <LibCarna/base/math/RaySphereHitTest.hpp>
 
 namespace LibCarna
 {
@@ -88,6 +90,41 @@ void BoundingSphere::computeClosemostPoint( math::Vector3f& out, const math::Vec
 }
 
 
+void BoundingSphere::computeAxisAlignedBox( math::Vector3f& lower, math::Vector3f& upper, const math::Matrix4f& modelTransform ) const
+{
+    /* The transformed sphere is an ellipsoid. Its extent along each axis is the
+     * radius, scaled by the norm of the corresponding row of the linear part.
+     */
+    const math::Matrix4f localToTarget = modelTransform * transform();
+    const math::Vector3f center = localToTarget.block< 3, 1 >( 0, 3 );
+    const math::Vector3f extent = localToTarget.block< 3, 3 >( 0, 0 ).rowwise().norm() * pimpl->radius;
+    lower = center - extent;
+    upper = center + extent;
+}
+
+
+bool BoundingSphere::computeRayHit( math::Vector3f& out, const math::Ray3f& ray ) const
+{
+    /* Transform 'ray' from model space to local coordinate system.
+     */
+    math::Ray< math::Vector3f > rayLocal;
+    rayLocal.origin    = math::vector3< float, 4 >( inverseTransform() * math::vector4( ray.origin, 1 ) );
+    rayLocal.direction = math::vector3< float, 4 >( inverseTransform() * math::vector4( ray.direction, 0 ) ).normalized();
+
+    math::RaySphereHitTest< math::Vector3f > hitTest;
+    hitTest.compute( rayLocal, pimpl->radius );
+    if( !hitTest.hitExists() )
+    {
+        return false;
+    }
+    
+    /* Transform the hit location from local coordinate system to model space.
+     */
+    out = math::vector3< float, 4 >( transform() * math::vector4( hitTest.hitLocation(), 1 ) );
+    return true;
+}
+
+
 
 }  // namespace LibCarna :: base
 
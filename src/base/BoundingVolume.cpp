@@ -13,6 +13,7 @@
  */
 
 #include <LibCarna/base/BoundingVolume.hpp>
+#include <limits>
 
 namespace LibCarna
 {
@@ -60,9 +61,24 @@ BoundingVolume::~BoundingVolume()
 }
 
 
+void BoundingVolume::computeAxisAlignedBox( math::Vector3f& lower, math::Vector3f& upper, const math::Matrix4f& ) const
+{
+    const float infinity = std::numeric_limits< float >::infinity();
+    lower.setConstant( -infinity );
+    upper.setConstant( +infinity );
+}
+
+
+bool BoundingVolume::computeRayHit( math::Vector3f&, const math::Ray3f& ) const
+{
+    return false;
+}
+
+
 void BoundingVolume::setTransform( const math::Matrix4f& transform )
 {
     pimpl->transform = transform;
+    pimpl->isInverseTransformDirty = true;
 }
 
 
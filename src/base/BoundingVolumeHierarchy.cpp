@@ -0,0 +1,473 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#include <LibCarna/base/BoundingVolumeHierarchy.hpp>
+#include <LibCarna/base/BoundingVolume.hpp>
+#include <LibCarna/base/Geometry.hpp>
+#include <LibCarna/base/Node.hpp>
+#include <LibCarna/base/LibCarnaException.hpp>
+#include <LibCarna/base/math/Ray.hpp>
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace LibCarna
+{
+
+namespace base
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// BoundingVolumeHierarchy :: Details
+// ----------------------------------------------------------------------------------
+
+struct BoundingVolumeHierarchy::Details
+{
+    Details( Node& root );
+
+    Node* root;
+    bool isOutdated;
+    std::size_t updatedGeometriesCount;
+
+    const static std::size_t NO_LEAF   = std::numeric_limits< std::size_t >::max();
+    const static std::size_t NO_PARENT = std::numeric_limits< std::size_t >::max();
+
+    struct Box
+    {
+        math::Vector3f lower;
+        math::Vector3f upper;
+
+        void merge( const Box& other );
+        math::Vector3f center() const;
+    };
+
+    struct Leaf
+    {
+        const Geometry* geometry;
+        math::Matrix4f worldTransform;
+        Box box;
+        std::size_t nodeIndex;
+
+        void computeBox();
+    };
+
+    /* The nodes are stored in depth-first order, so the root is the first one.
+     */
+    struct TreeNode
+    {
+        Box box;
+        std::size_t parent;
+        std::size_t left;
+        std::size_t right;
+        std::size_t leaf;
+    };
+
+    std::vector< Leaf > leaves;
+    std::vector< TreeNode > nodes;
+    std::vector< const Geometry* > unboundedGeometries;
+
+    void rebuild();
+    void refit();
+    std::size_t buildSubtree( std::vector< std::size_t >& leafIndices, std::size_t begin, std::size_t end );
+};
+
+
+BoundingVolumeHierarchy::Details::Details( Node& root )
+    : root( &root )
+    , isOutdated( true )
+    , updatedGeometriesCount( 0 )
+{
+}
+
+
+void BoundingVolumeHierarchy::Details::Box::merge( const Box& other )
+{
+    lower = lower.cwiseMin( other.lower );
+    upper = upper.cwiseMax( other.upper );
+}
+
+
+math::Vector3f BoundingVolumeHierarchy::Details::Box::center() const
+{
+    return ( lower + upper ) / 2;
+}
+
+
+void BoundingVolumeHierarchy::Details::Leaf::computeBox()
+{
+    worldTransform = geometry->worldTransform();
+    geometry->boundingVolume().computeAxisAlignedBox( box.lower, box.upper, worldTransform );
+}
+
+
+void BoundingVolumeHierarchy::Details::rebuild()
+{
+    leaves.clear();
+    nodes.clear();
+    unboundedGeometries.clear();
+
+    /* Collect all geometries.
+     */
+    if( root != nullptr )
+    {
+        root->visitChildren( true, [&]( const Spatial& spatial )
+            {
+                if( spatial.isGeometry() )
+                {
+                    const Geometry& geom = static_cast< const Geometry& >( spatial );
+                    Leaf leaf;
+                    leaf.geometry = &geom;
+                    if( geom.hasBoundingVolume() )
+                    {
+                        leaf.computeBox();
+                    }
+
+                    /* Bounding volumes that do not implement 'computeAxisAlignedBox'
+                     * yield infinite boxes, so they are treated like missing ones.
+                     */
+                    if( geom.hasBoundingVolume() && leaf.box.lower.allFinite() && leaf.box.upper.allFinite() )
+                    {
+                        leaves.push_back( leaf );
+                    }
+                    else
+                    {
+                        unboundedGeometries.push_back( &geom );
+                    }
+                }
+            }
+        );
+    }
+
+    /* Build the tree top-down.
+     */
+    if( !leaves.empty() )
+    {
+        std::vector< std::size_t > leafIndices( leaves.size() );
+        for( std::size_t leafIndex = 0; leafIndex < leaves.size(); ++leafIndex )
+        {
+            leafIndices[ leafIndex ] = leafIndex;
+        }
+        nodes.reserve( 2 * leaves.size() - 1 );
+        buildSubtree( leafIndices, 0, leaves.size() );
+    }
+    updatedGeometriesCount = leaves.size();
+}
+
+
+std::size_t BoundingVolumeHierarchy::Details::buildSubtree
+    ( std::vector< std::size_t >& leafIndices, std::size_t begin, std::size_t end )
+{
+    LIBCARNA_ASSERT( begin < end );
+    const std::size_t nodeIndex = nodes.size();
+    nodes.push_back( TreeNode() );
+    nodes[ nodeIndex ].parent = NO_PARENT;
+
+    /* Create a leaf node if there is only one geometry left.
+     */
+    if( end - begin == 1 )
+    {
+        Leaf& leaf = leaves[ leafIndices[ begin ] ];
+        leaf.nodeIndex = nodeIndex;
+        nodes[ nodeIndex ].box  = leaf.box;
+        nodes[ nodeIndex ].leaf = leafIndices[ begin ];
+        return nodeIndex;
+    }
+
+    /* Split at the median along the axis where the box centers are spread widest.
+     */
+    Box centers;
+    centers.lower = centers.upper = leaves[ leafIndices[ begin ] ].box.center();
+    for( std::size_t idx = begin + 1; idx < end; ++idx )
+    {
+        const math::Vector3f center = leaves[ leafIndices[ idx ] ].box.center();
+        centers.lower = centers.lower.cwiseMin( center );
+        centers.upper = centers.upper.cwiseMax( center );
+    }
+    unsigned int axis;
+    ( centers.upper - centers.lower ).maxCoeff( &axis );
+
+    const std::size_t middle = begin + ( end - begin ) / 2;
+    std::nth_element( leafIndices.begin() + begin, leafIndices.begin() + middle, leafIndices.begin() + end,
+        [&]( std::size_t leafIndex1, std::size_t leafIndex2 )
+        {
+            return leaves[ leafIndex1 ].box.center()[ axis ] < leaves[ leafIndex2 ].box.center()[ axis ];
+        }
+    );
+
+    /* The vector of nodes might be reallocated by the recursion, hence no
+     * references are kept.
+     */
+    const std::size_t left  = buildSubtree( leafIndices, begin, middle );
+    const std::size_t right = buildSubtree( leafIndices, middle, end );
+    nodes[ left  ].parent = nodeIndex;
+    nodes[ right ].parent = nodeIndex;
+    TreeNode& node = nodes[ nodeIndex ];
+    node.left  = left;
+    node.right = right;
+    node.leaf  = NO_LEAF;
+    node.box   = nodes[ left ].box;
+    node.box.merge( nodes[ right ].box );
+    return nodeIndex;
+}
+
+
+void BoundingVolumeHierarchy::Details::refit()
+{
+    updatedGeometriesCount = 0;
+
+    /* Recompute the boxes of the geometries whose world transforms have changed
+     * with the last update of the scene graph, and the boxes of their ancestors.
+     */
+    for( auto leafItr = leaves.begin(); leafItr != leaves.end(); ++leafItr )
+    {
+        Leaf& leaf = *leafItr;
+        if( !leaf.geometry->hasWorldTransformChanged() )
+        {
+            continue;
+        }
+        leaf.computeBox();
+        nodes[ leaf.nodeIndex ].box = leaf.box;
+        ++updatedGeometriesCount;
+
+        for( std::size_t nodeIndex = nodes[ leaf.nodeIndex ].parent; nodeIndex != NO_PARENT; nodeIndex = nodes[ nodeIndex ].parent )
+        {
+            TreeNode& node = nodes[ nodeIndex ];
+            node.box = nodes[ node.left ].box;
+            node.box.merge( nodes[ node.right ].box );
+        }
+    }
+}
+
+
+
+// ----------------------------------------------------------------------------------
+// BoundingVolumeHierarchy
+// ----------------------------------------------------------------------------------
+
+BoundingVolumeHierarchy::BoundingVolumeHierarchy( Node& root )
+    : pimpl( new Details( root ) )
+{
+    root.addNodeListener( *this );
+}
+
+
+BoundingVolumeHierarchy::~BoundingVolumeHierarchy()
+{
+    if( pimpl->root != nullptr )
+    {
+        pimpl->root->removeNodeListener( *this );
+    }
+}
+
+
+void BoundingVolumeHierarchy::update()
+{
+    if( pimpl->isOutdated )
+    {
+        pimpl->rebuild();
+        pimpl->isOutdated = false;
+    }
+    else
+    {
+        pimpl->refit();
+    }
+}
+
+
+std::size_t BoundingVolumeHierarchy::size() const
+{
+    return pimpl->leaves.size();
+}
+
+
+std::size_t BoundingVolumeHierarchy::updatedGeometriesCount() const
+{
+    return pimpl->updatedGeometriesCount;
+}
+
+
+void BoundingVolumeHierarchy::queryFrustum( const math::Matrix4f& viewProjection, const GeometryVisitor& visit ) const
+{
+    LIBCARNA_ASSERT( !pimpl->isOutdated );
+
+    /* Extract the six clipping planes from the rows of the matrix. A point 'p' is
+     * within the frustum if 'plane.dot( p, 1 ) >= 0' holds for each plane.
+     */
+    const math::Vector4f planes[ 6 ] =
+        { viewProjection.row( 3 ) + viewProjection.row( 0 )
+        , viewProjection.row( 3 ) - viewProjection.row( 0 )
+        , viewProjection.row( 3 ) + viewProjection.row( 1 )
+        , viewProjection.row( 3 ) - viewProjection.row( 1 )
+        , viewProjection.row( 3 ) + viewProjection.row( 2 )
+        , viewProjection.row( 3 ) - viewProjection.row( 2 ) };
+
+    /* Geometries without bounding volumes cannot be culled.
+     */
+    std::for_each( pimpl->unboundedGeometries.begin(), pimpl->unboundedGeometries.end(),
+        [&visit]( const Geometry* geom )
+        {
+            visit( *geom );
+        }
+    );
+    if( pimpl->nodes.empty() )
+    {
+        return;
+    }
+
+    /* Traverse the tree depth-first. A node is culled if its box is entirely on the
+     * negative side of any plane. Subtrees that are entirely on the positive sides
+     * of all planes are reported without further tests.
+     */
+    std::vector< std::pair< std::size_t, bool > > stack;
+    stack.push_back( std::make_pair( static_cast< std::size_t >( 0 ), false ) );
+    while( !stack.empty() )
+    {
+        const std::size_t nodeIndex = stack.back().first;
+        bool isInside = stack.back().second;
+        stack.pop_back();
+        const Details::TreeNode& node = pimpl->nodes[ nodeIndex ];
+
+        if( !isInside )
+        {
+            bool isOutside = false;
+            isInside = true;
+            for( unsigned int planeIndex = 0; planeIndex < 6 && !isOutside; ++planeIndex )
+            {
+                const math::Vector4f& plane = planes[ planeIndex ];
+                const math::Vector3f normal = math::vector3< float, 4 >( plane );
+                const math::Vector3f positive = ( normal.array() >= 0 ).select( node.box.upper, node.box.lower );
+                const math::Vector3f negative = ( normal.array() >= 0 ).select( node.box.lower, node.box.upper );
+                isOutside = normal.dot( positive ) + plane.w() < 0;
+                isInside  = isInside && normal.dot( negative ) + plane.w() >= 0;
+            }
+            if( isOutside )
+            {
+                continue;
+            }
+        }
+
+        if( node.leaf == Details::NO_LEAF )
+        {
+            stack.push_back( std::make_pair( node.right, isInside ) );
+            stack.push_back( std::make_pair( node.left , isInside ) );
+        }
+        else
+        {
+            visit( *pimpl->leaves[ node.leaf ].geometry );
+        }
+    }
+}
+
+
+const Geometry* BoundingVolumeHierarchy::queryRay( math::Vector3f& hitLocation, const math::Ray3f& ray ) const
+{
+    LIBCARNA_ASSERT( !pimpl->isOutdated );
+    if( pimpl->nodes.empty() )
+    {
+        return nullptr;
+    }
+
+    const math::Vector3f direction = ray.direction.normalized();
+    const math::Vector3f inverseDirection = direction.cwiseInverse();
+
+    /* Computes the ray length where the ray enters the box, or the infinity if the
+     * box is missed.
+     */
+    const float infinity = std::numeric_limits< float >::infinity();
+    const auto computeEntry = [&]( const Details::Box& box )
+    {
+        const math::Vector3f t1 = ( box.lower - ray.origin ).cwiseProduct( inverseDirection );
+        const math::Vector3f t2 = ( box.upper - ray.origin ).cwiseProduct( inverseDirection );
+        const float tEnter = std::max( t1.cwiseMin( t2 ).maxCoeff(), 0.f );
+        const float tLeave = t1.cwiseMax( t2 ).minCoeff();
+        return tEnter <= tLeave ? tEnter : infinity;
+    };
+
+    const Geometry* hitGeometry = nullptr;
+    float hitDistance = infinity;
+    std::vector< std::size_t > stack;
+    stack.push_back( 0 );
+    while( !stack.empty() )
+    {
+        const Details::TreeNode& node = pimpl->nodes[ stack.back() ];
+        stack.pop_back();
+        if( computeEntry( node.box ) >= hitDistance )
+        {
+            continue;
+        }
+
+        if( node.leaf == Details::NO_LEAF )
+        {
+            /* Visit the closer child first, so that the farther might be skipped.
+             */
+            const bool isLeftCloser = computeEntry( pimpl->nodes[ node.left ].box ) <= computeEntry( pimpl->nodes[ node.right ].box );
+            stack.push_back( isLeftCloser ? node.right : node.left  );
+            stack.push_back( isLeftCloser ? node.left  : node.right );
+        }
+        else
+        {
+            /* Test the actual bounding volume in model space.
+             */
+            const Details::Leaf& leaf = pimpl->leaves[ node.leaf ];
+            const math::Matrix4f inverseWorldTransform = leaf.worldTransform.inverse();
+            math::Ray3f rayModel;
+            rayModel.origin    = math::vector3< float, 4 >( inverseWorldTransform * math::vector4( ray.origin, 1 ) );
+            rayModel.direction = math::vector3< float, 4 >( inverseWorldTransform * math::vector4( direction, 0 ) );
+
+            math::Vector3f hitModel;
+            if( leaf.geometry->boundingVolume().computeRayHit( hitModel, rayModel ) )
+            {
+                const math::Vector3f hitWorld = math::vector3< float, 4 >( leaf.worldTransform * math::vector4( hitModel, 1 ) );
+                const float distance = ( hitWorld - ray.origin ).norm();
+                if( distance < hitDistance )
+                {
+                    hitDistance = distance;
+                    hitGeometry = leaf.geometry;
+                    hitLocation = hitWorld;
+                }
+            }
+        }
+    }
+    return hitGeometry;
+}
+
+
+void BoundingVolumeHierarchy::onNodeDelete( const Node& node )
+{
+    if( &node == pimpl->root )
+    {
+        pimpl->root = nullptr;
+        pimpl->isOutdated = true;
+    }
+}
+
+
+void BoundingVolumeHierarchy::onTreeChange( Node&, bool )
+{
+    pimpl->isOutdated = true;
+}
+
+
+void BoundingVolumeHierarchy::onTreeInvalidated( Node& )
+{
+    pimpl->isOutdated = true;
+}
+
+
+
+}  // namespace LibCarna :: base
+
+}  // namespace LibCarna
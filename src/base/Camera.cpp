@@ -35,7 +35,10 @@ Camera::Camera()
 void Camera::updateWorldTransform()
 {
     Spatial::updateWorldTransform();
-    myViewTransform = worldTransform().inverse();
+    if( hasWorldTransformChanged() )
+    {
+        myViewTransform = worldTransform().inverse();
+    }
 }
 
 
@@ -15,6 +15,8 @@
 #include <LibCarna/base/glew.hpp>
 #include <LibCarna/base/glError.hpp>
 #include <LibCarna/base/FrameRenderer.hpp>
+#include <LibCarna/base/FrameUniformBuffer.hpp>
+#include <LibCarna/base/RenderTargetPool.hpp>
 #include <LibCarna/base/Camera.hpp>
 #include <LibCarna/base/RenderTask.hpp>
 #include <LibCarna/base/RenderStage.hpp>
@@ -29,6 +31,8 @@
 #include <LibCarna/base/Sampler.hpp>
 #include <LibCarna/base/Stopwatch.hpp>
 #include <LibCarna/base/Composition.hpp>
+#include <algorithm>
+#include <set>
 #include <vector>
 
 namespace LibCarna
@@ -197,15 +201,33 @@ struct FrameRenderer::Details
     const std::unique_ptr< MeshBase > fullFrameQuadMesh;
     const ShaderProgram& fullFrameQuadShader;
 
+    const std::unique_ptr< FrameUniformBuffer > frameUniforms;
+    const std::unique_ptr< RenderTargetPool > renderTargets;
+
+    std::vector< const ShaderProgram* > prewarmedShaders;
+    void releasePrewarmedShaders();
+
     float backgroundColor[ 4 ];
     bool backgroundColorChanged;
     
     math::Statistics< double > fpsStatistics;
     circular_buffer< double > fpsData;
     void updateFpsStatistics();
+
+    FrameStatistics frameStatistics;
 };
 
 
+void FrameRenderer::Details::releasePrewarmedShaders()
+{
+    for( auto shaderItr = prewarmedShaders.begin(); shaderItr != prewarmedShaders.end(); ++shaderItr )
+    {
+        ShaderManager::instance().releaseShader( **shaderItr );
+    }
+    prewarmedShaders.clear();
+}
+
+
 FrameRenderer::Details::Details( GLContext& glContext, unsigned int width, unsigned int height )
     : width( width )
     , height( height )
@@ -214,6 +236,8 @@ FrameRenderer::Details::Details( GLContext& glContext, unsigned int width, unsig
     , fullFrameQuadSampler( createFullFrameQuadSampler() )
     , fullFrameQuadMesh( createFullFrameQuadMesh() )
     , fullFrameQuadShader( ShaderManager::instance().acquireShader( "full_frame_quad" ) )
+    , frameUniforms( new FrameUniformBuffer() )
+    , renderTargets( new RenderTargetPool() )
     , backgroundColorChanged( true )
     , fpsStatistics( 0, 0 )
     , fpsData( 10 )
@@ -259,6 +283,7 @@ FrameRenderer::~FrameRenderer()
      * quad mesh and shader can be cleaned up properly.
      */
     clearStages();
+    pimpl->releasePrewarmedShaders();
     ShaderManager::instance().releaseShader( pimpl->fullFrameQuadShader );
 }
 
@@ -278,6 +303,18 @@ GLContext& FrameRenderer::glContext() const
     return *pimpl->glContext;
 }
 
+
+FrameUniformBuffer& FrameRenderer::frameUniforms() const
+{
+    return *pimpl->frameUniforms;
+}
+
+
+RenderTargetPool& FrameRenderer::renderTargets() const
+{
+    return *pimpl->renderTargets;
+}
+
     
 void FrameRenderer::clearStages()
 {
@@ -286,6 +323,35 @@ void FrameRenderer::clearStages()
 }
 
 
+std::vector< std::string > FrameRenderer::prewarmShaders( const Node& root )
+{
+    pimpl->glContext->makeCurrent();
+
+    /* Collect the names of the shaders from all stages, without duplicates.
+     */
+    std::vector< std::string > shaderNames;
+    for( std::size_t rsIdx = 0; rsIdx < stages(); ++rsIdx )
+    {
+        stageAt( rsIdx ).collectShaderNames( root, shaderNames );
+    }
+    std::set< std::string > uniqueShaderNames;
+    shaderNames.erase( std::remove_if( shaderNames.begin(), shaderNames.end(),
+        [&uniqueShaderNames]( const std::string& shaderName )
+        {
+            return !uniqueShaderNames.insert( shaderName ).second;
+        }
+    ), shaderNames.end() );
+
+    /* Acquire the new shaders before releasing the previous ones, so that shaders,
+     * that are prewarmed again, are not built twice.
+     */
+    const std::vector< const ShaderProgram* > shaders = ShaderManager::instance().prewarmShaders( shaderNames );
+    pimpl->releasePrewarmedShaders();
+    pimpl->prewarmedShaders = shaders;
+    return shaderNames;
+}
+
+
 unsigned int FrameRenderer::width() const
 {
     return pimpl->width;
@@ -344,6 +410,8 @@ void FrameRenderer::render( Camera& cam, Node& root, const Viewport& vp ) const
     /* Start time measurement.
      */
     Stopwatch stopwatch;
+    const GLStatistics statistics0 = pimpl->glContext->statistics();
+    pimpl->frameStatistics.stages.assign( stages(), GLStatistics() );
 
     /* Check for errors.
      */
@@ -390,6 +458,16 @@ void FrameRenderer::render( Camera& cam, Node& root, const Viewport& vp ) const
     RenderTask task( *this, cam.projection(), cam.viewTransform() );
     task.render( vp, GLContext::COLOR_BUFFER_BIT | GLContext::DEPTH_BUFFER_BIT );
 
+    /* Restore the render state the frame was started with, so that subsequent
+     * OpenGL code is not affected by deferred state changes.
+     */
+    pimpl->glContext->commitRenderState();
+
+    /* Release the render targets, that no stage has used during this frame.
+     */
+    pimpl->renderTargets->releaseUnused();
+    pimpl->frameStatistics.total = pimpl->glContext->statistics() - statistics0;
+
     /* Check for errors.
      */
     REPORT_GL_ERROR;
@@ -431,6 +509,21 @@ const math::Statistics< double >& FrameRenderer::framesPerSecond() const
 }
 
 
+const FrameRenderer::FrameStatistics& FrameRenderer::frameStatistics() const
+{
+    return pimpl->frameStatistics;
+}
+
+
+void FrameRenderer::recordStageStatistics( std::size_t stageIdx, const GLStatistics& statistics ) const
+{
+    if( stageIdx < pimpl->frameStatistics.stages.size() )
+    {
+        pimpl->frameStatistics.stages[ stageIdx ] += statistics;
+    }
+}
+
+
 
 }  // namespace LibCarna :: base
 
@@ -0,0 +1,116 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#include <LibCarna/base/glew.hpp>
+#include <LibCarna/base/FrameUniformBuffer.hpp>
+#include <LibCarna/base/Viewport.hpp>
+#include <algorithm>
+#include <cstring>
+
+namespace LibCarna
+{
+
+namespace base
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// FrameUniformBuffer :: Details
+// ----------------------------------------------------------------------------------
+
+struct FrameUniformBuffer::Details
+{
+    Details();
+
+    /* Two column-major 4x4 matrices and one 4-vector, what conforms to the 'std140'
+     * layout rules without any padding.
+     */
+    const static std::size_t FLOATS_COUNT = 16 + 16 + 4;
+
+    GLuint id;
+    float data[ FLOATS_COUNT ];
+    bool isWritten;
+    std::size_t uploadsCount;
+};
+
+
+FrameUniformBuffer::Details::Details()
+    : id( 0 )
+    , isWritten( false )
+    , uploadsCount( 0 )
+{
+    std::fill( data, data + FLOATS_COUNT, 0.f );
+}
+
+
+
+// ----------------------------------------------------------------------------------
+// FrameUniformBuffer
+// ----------------------------------------------------------------------------------
+
+const std::string FrameUniformBuffer::BLOCK_NAME = "FrameUniforms";
+
+
+FrameUniformBuffer::FrameUniformBuffer()
+    : pimpl( new Details() )
+{
+    glGenBuffers( 1, &pimpl->id );
+    glBindBuffer( GL_UNIFORM_BUFFER, pimpl->id );
+    glBufferData( GL_UNIFORM_BUFFER, sizeof( pimpl->data ), nullptr, GL_DYNAMIC_DRAW );
+    glBindBuffer( GL_UNIFORM_BUFFER, 0 );
+}
+
+
+FrameUniformBuffer::~FrameUniformBuffer()
+{
+    glDeleteBuffers( 1, &pimpl->id );
+}
+
+
+void FrameUniformBuffer::update( const math::Matrix4f& projection, const math::Matrix4f& viewTransform, const Viewport& viewport )
+{
+    float data[ Details::FLOATS_COUNT ];
+    std::copy( projection.data(), projection.data() + 16, data );
+    std::copy( viewTransform.data(), viewTransform.data() + 16, data + 16 );
+    data[ 32 ] = static_cast< float >( viewport.marginLeft() );
+    data[ 33 ] = static_cast< float >( viewport.marginTop() );
+    data[ 34 ] = static_cast< float >( viewport.width() );
+    data[ 35 ] = static_cast< float >( viewport.height() );
+
+    /* Only write the buffer if its contents change.
+     */
+    if( !pimpl->isWritten || std::memcmp( data, pimpl->data, sizeof( data ) ) != 0 )
+    {
+        std::copy( data, data + Details::FLOATS_COUNT, pimpl->data );
+        glBindBuffer( GL_UNIFORM_BUFFER, pimpl->id );
+        glBufferSubData( GL_UNIFORM_BUFFER, 0, sizeof( data ), data );
+        glBindBuffer( GL_UNIFORM_BUFFER, 0 );
+        pimpl->isWritten = true;
+        ++pimpl->uploadsCount;
+    }
+    glBindBufferBase( GL_UNIFORM_BUFFER, BINDING_POINT, pimpl->id );
+}
+
+
+std::size_t FrameUniformBuffer::uploadsCount() const
+{
+    return pimpl->uploadsCount;
+}
+
+
+
+}  // namespace LibCarna :: base
+
+}  // namespace LibCarna
@@ -18,6 +18,7 @@
 #include <LibCarna/base/Framebuffer.hpp>
 #include <LibCarna/base/Viewport.hpp>
 #include <LibCarna/base/LibCarnaException.hpp>
+#include <LibCarna/base/Log.hpp>
 #include <LibCarna/base/Texture.hpp>
 #include <LibCarna/base/text.hpp>
 #include <stdexcept>
@@ -64,6 +65,7 @@ static inline unsigned int createGlDepthbufferObject()
 static void bindSystemFramebuffer()
 {
     glBindFramebufferEXT( GL_FRAMEBUFFER_EXT, 0 );
+    GLContext::current().record( &GLStatistics::framebufferBinds );
     if( GLContext::current().isDoubleBuffered )
     {
         glDrawBuffer( GL_BACK );
@@ -247,9 +249,40 @@ Framebuffer::~Framebuffer()
 
 Texture< 2 >* Framebuffer::createRenderTexture( bool floatingPoint )
 {
-    const unsigned int internalFormat = floatingPoint ? GL_RGBA16F : GL_RGBA8;
-    const unsigned int    pixelFormat = GL_RGBA;
-    return new Texture< 2 >( internalFormat, pixelFormat );
+    return createRenderTexture( floatingPoint ? rgba16f : rgba8 );
+}
+
+
+Texture< 2 >* Framebuffer::createRenderTexture( RenderTextureFormat format )
+{
+    switch( format )
+    {
+
+    case rgba8:
+        return new Texture< 2 >( GL_RGBA8, GL_RGBA );
+
+    case rgba16f:
+        return new Texture< 2 >( GL_RGBA16F, GL_RGBA );
+
+    case rgba32f:
+        return new Texture< 2 >( GL_RGBA32F, GL_RGBA );
+
+    case rg16f:
+        return new Texture< 2 >( GL_RG16F, GL_RG );
+
+    case rg32f:
+        return new Texture< 2 >( GL_RG32F, GL_RG );
+
+    case r16f:
+        return new Texture< 2 >( GL_R16F, GL_RED );
+
+    case r32f:
+        return new Texture< 2 >( GL_R32F, GL_RED );
+
+    default:
+        LIBCARNA_FAIL( "Unknown render texture format!" );
+
+    }
 }
 
 
@@ -358,6 +391,7 @@ void Framebuffer::copy
      */
     glBindFramebufferEXT( GL_READ_FRAMEBUFFER, idFrom );
     glBindFramebufferEXT( GL_DRAW_FRAMEBUFFER, idTo   );
+    GLContext::current().record( &GLStatistics::framebufferBinds, 2 );
     
     /* Setup color attachments to be copied in case 'flags' wants us to do so.
      */
@@ -368,8 +402,10 @@ void Framebuffer::copy
     }
 
     /* Do the copying. The lower bounds of the rectangles passed to
-     * 'glBlitFramebuffer' are inclusive, while the upper bounds are exclusive.
+     * 'glBlitFramebuffer' are inclusive, while the upper bounds are exclusive. The
+     * copying is subject to the scissor test, thus the render state is committed.
      */
+    GLContext::current().commitRenderState();
     glBlitFramebufferEXT
         ( srcX0, srcY0, srcX0 + srcWidth, srcY0 + srcHeight
         , dstX0, dstY0, dstX0 + dstWidth, dstY0 + dstHeight
@@ -421,6 +457,7 @@ Framebuffer::MinimalBinding::~MinimalBinding()
 void Framebuffer::MinimalBinding::bindFBO() const
 {
     glBindFramebufferEXT( GL_FRAMEBUFFER_EXT, fbo.id );
+    GLContext::current().record( &GLStatistics::framebufferBinds );
     REPORT_GL_ERROR;
 }
 
@@ -566,6 +603,72 @@ void Framebuffer::Binding::refresh()
 
 
 
+// ----------------------------------------------------------------------------------
+// Framebuffer::SharedDepthAttachment
+// ----------------------------------------------------------------------------------
+
+Framebuffer::SharedDepthAttachment::SharedDepthAttachment( Framebuffer& dst, const Viewport& src )
+    : dst( dst )
+{
+    const Framebuffer* const srcFBO = BindingStack::empty() ? nullptr : &( BindingStack::top().framebuffer() );
+
+    /* The depth buffer can only be shared if the pixels, that 'src' covers, are at
+     * the same locations within 'dst', because the depth buffer is not copied.
+     */
+    shared = srcFBO != nullptr && srcFBO != &dst
+        && srcFBO->size == dst.size
+        && src.marginLeft() == 0 && src.marginTop() == 0
+        && src.width() == dst.width() && src.height() == dst.height();
+
+    if( shared )
+    {
+        MinimalBinding binding( dst );
+        glFramebufferRenderbufferEXT( GL_FRAMEBUFFER_EXT
+                                    , GL_DEPTH_ATTACHMENT_EXT
+                                    , GL_RENDERBUFFER_EXT
+                                    , srcFBO->depthBuffer );
+        REPORT_GL_ERROR;
+    }
+    else
+    {
+        copyDepthAttachment( currentId(), dst.id, src, Viewport( dst ) );
+    }
+}
+
+
+Framebuffer::SharedDepthAttachment::~SharedDepthAttachment()
+{
+    if( shared )
+    {
+        MinimalBinding binding( dst );
+        glFramebufferRenderbufferEXT( GL_FRAMEBUFFER_EXT
+                                    , GL_DEPTH_ATTACHMENT_EXT
+                                    , GL_RENDERBUFFER_EXT
+                                    , dst.depthBuffer );
+
+        /* Destructors must not throw, thus errors are only logged.
+         */
+#ifndef NO_GL_ERROR_CHECKING
+        const unsigned int err = glGetError();
+        if( err != GL_NO_ERROR )
+        {
+            std::stringstream msg;
+            msg << "GL Error State in " << __func__ << ": "
+                << reinterpret_cast< const char* >( gluErrorString( err ) ) << " [" << err << "]";
+            Log::instance().record( Log::error, msg.str() );
+        }
+#endif
+    }
+}
+
+
+bool Framebuffer::SharedDepthAttachment::isShared() const
+{
+    return shared;
+}
+
+
+
 }  // namespace LibCarna :: base
 
 }  // namespace LibCarna
@@ -0,0 +1,249 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#include <LibCarna/base/glew.hpp>
+#include <LibCarna/base/glError.hpp>
+#include <LibCarna/base/FramebufferReadback.hpp>
+#include <LibCarna/base/LibCarnaException.hpp>
+#include <vector>
+
+namespace LibCarna
+{
+
+namespace base
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// Types & Globals
+// ----------------------------------------------------------------------------------
+
+/* Bounds the time a single 'glClientWaitSync' call blocks, in nanoseconds.
+ */
+const static GLuint64 READBACK_WAIT_TIMEOUT = 1000000000;
+
+
+
+// ----------------------------------------------------------------------------------
+// FramebufferReadback :: Details
+// ----------------------------------------------------------------------------------
+
+struct FramebufferReadback::Details
+{
+    Details( unsigned int width, unsigned int height, PixelFormat pixelFormat, std::size_t framesInFlight, const FrameCallback& callback );
+
+    const unsigned int width;
+    const unsigned int height;
+    GLenum glPixelFormat;
+    GLenum glPixelType;
+    std::size_t frameSize;
+    const FrameCallback callback;
+
+    std::vector< GLuint > buffers;
+    std::vector< GLsync > fences;
+    std::size_t nextBuffer;
+    std::size_t pendingFrames;
+    std::size_t nextFrameIndex;
+
+    /* Delivers the oldest pending frame. Returns 'false' without delivering it, if
+     * 'wait' is 'false' and reading the frame has not completed yet.
+     */
+    bool deliverOldest( bool wait );
+};
+
+
+FramebufferReadback::Details::Details
+        ( unsigned int width
+        , unsigned int height
+        , PixelFormat pixelFormat
+        , std::size_t framesInFlight
+        , const FrameCallback& callback )
+    : width( width )
+    , height( height )
+    , callback( callback )
+    , buffers( framesInFlight, 0 )
+    , fences( framesInFlight, nullptr )
+    , nextBuffer( 0 )
+    , pendingFrames( 0 )
+    , nextFrameIndex( 0 )
+{
+    std::size_t pixelSize;
+    switch( pixelFormat )
+    {
+
+    case rgba8:
+        glPixelFormat = GL_RGBA;
+        glPixelType   = GL_UNSIGNED_BYTE;
+        pixelSize     = 4;
+        break;
+
+    case rgba32f:
+        glPixelFormat = GL_RGBA;
+        glPixelType   = GL_FLOAT;
+        pixelSize     = 4 * sizeof( float );
+        break;
+
+    case r32f:
+        glPixelFormat = GL_RED;
+        glPixelType   = GL_FLOAT;
+        pixelSize     = sizeof( float );
+        break;
+
+    default:
+        LIBCARNA_FAIL( "Unknown pixel format." );
+
+    }
+    frameSize = std::size_t( width ) * height * pixelSize;
+}
+
+
+bool FramebufferReadback::Details::deliverOldest( bool wait )
+{
+    LIBCARNA_ASSERT( pendingFrames > 0 );
+    const std::size_t bufferIdx = ( nextBuffer + buffers.size() - pendingFrames ) % buffers.size();
+
+    /* Check whether reading the frame has completed.
+     */
+    GLenum status;
+    do
+    {
+        status = glClientWaitSync( fences[ bufferIdx ], GL_SYNC_FLUSH_COMMANDS_BIT, wait ? READBACK_WAIT_TIMEOUT : 0 );
+        LIBCARNA_ASSERT_EX( status != GL_WAIT_FAILED, "Waiting for frame readback failed." );
+    }
+    while( wait && status == GL_TIMEOUT_EXPIRED );
+    if( status == GL_TIMEOUT_EXPIRED )
+    {
+        return false;
+    }
+    glDeleteSync( fences[ bufferIdx ] );
+    fences[ bufferIdx ] = nullptr;
+
+    /* Deliver the pixels.
+     */
+    const std::size_t frameIndex = nextFrameIndex - pendingFrames;
+    --pendingFrames;
+    glBindBuffer( GL_PIXEL_PACK_BUFFER, buffers[ bufferIdx ] );
+    const void* const pixels = glMapBufferRange( GL_PIXEL_PACK_BUFFER, 0, frameSize, GL_MAP_READ_BIT );
+    LIBCARNA_ASSERT_EX( pixels != nullptr, "Mapping the pixel buffer object failed." );
+    callback( frameIndex, pixels );
+    glUnmapBuffer( GL_PIXEL_PACK_BUFFER );
+    glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+    REPORT_GL_ERROR;
+    return true;
+}
+
+
+
+// ----------------------------------------------------------------------------------
+// FramebufferReadback
+// ----------------------------------------------------------------------------------
+
+FramebufferReadback::FramebufferReadback
+        ( unsigned int width
+        , unsigned int height
+        , PixelFormat pixelFormat
+        , std::size_t framesInFlight
+        , const FrameCallback& callback )
+    : pimpl( new Details( width, height, pixelFormat, framesInFlight, callback ) )
+{
+    LIBCARNA_ASSERT( framesInFlight >= 1 );
+    glGenBuffers( static_cast< GLsizei >( framesInFlight ), &pimpl->buffers.front() );
+    for( std::size_t bufferIdx = 0; bufferIdx < framesInFlight; ++bufferIdx )
+    {
+        glBindBuffer( GL_PIXEL_PACK_BUFFER, pimpl->buffers[ bufferIdx ] );
+        glBufferData( GL_PIXEL_PACK_BUFFER, pimpl->frameSize, nullptr, GL_STREAM_READ );
+    }
+    glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+    REPORT_GL_ERROR;
+}
+
+
+FramebufferReadback::~FramebufferReadback()
+{
+    finish();
+    glDeleteBuffers( static_cast< GLsizei >( pimpl->buffers.size() ), &pimpl->buffers.front() );
+}
+
+
+unsigned int FramebufferReadback::width() const
+{
+    return pimpl->width;
+}
+
+
+unsigned int FramebufferReadback::height() const
+{
+    return pimpl->height;
+}
+
+
+std::size_t FramebufferReadback::frameSize() const
+{
+    return pimpl->frameSize;
+}
+
+
+std::size_t FramebufferReadback::pendingFrames() const
+{
+    return pimpl->pendingFrames;
+}
+
+
+std::size_t FramebufferReadback::read()
+{
+    if( pimpl->pendingFrames == pimpl->buffers.size() )
+    {
+        pimpl->deliverOldest( true );
+    }
+
+    /* Issue the copy to the next pixel buffer object and mark its completion.
+     */
+    const std::size_t bufferIdx = pimpl->nextBuffer;
+    glBindBuffer( GL_PIXEL_PACK_BUFFER, pimpl->buffers[ bufferIdx ] );
+    glReadPixels( 0, 0, pimpl->width, pimpl->height, pimpl->glPixelFormat, pimpl->glPixelType, nullptr );
+    glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+    pimpl->fences[ bufferIdx ] = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+    REPORT_GL_ERROR;
+
+    pimpl->nextBuffer = ( bufferIdx + 1 ) % pimpl->buffers.size();
+    ++pimpl->pendingFrames;
+    return pimpl->nextFrameIndex++;
+}
+
+
+std::size_t FramebufferReadback::poll()
+{
+    std::size_t deliveredFrames = 0;
+    while( pimpl->pendingFrames > 0 && pimpl->deliverOldest( false ) )
+    {
+        ++deliveredFrames;
+    }
+    return deliveredFrames;
+}
+
+
+void FramebufferReadback::finish()
+{
+    while( pimpl->pendingFrames > 0 )
+    {
+        pimpl->deliverOldest( true );
+    }
+}
+
+
+
+}  // namespace LibCarna :: base
+
+}  // namespace LibCarna
@@ -18,8 +18,11 @@
 #include <LibCarna/base/ShaderProgram.hpp>
 #include <LibCarna/base/RenderState.hpp>
 #include <LibCarna/base/LibCarnaException.hpp>
+#include <algorithm>
+#include <limits>
 #include <set>
 #include <stack>
+#include <vector>
 
 namespace LibCarna
 {
@@ -40,18 +43,79 @@ struct GLContext::Details
     const std::string renderer;
     const ShaderProgram* shader;
     std::unique_ptr< RenderState > defaultRenderState;
+    std::unique_ptr< RenderState > appliedRenderState;
     std::stack< const RenderState* > renderStates;
+    bool statisticsEnabled;
+    GLStatistics statistics;
+
+    /* Denotes bindings that are not known, e.g. because the bound object was
+     * deleted while another OpenGL context was current.
+     */
+    const static unsigned int UNKNOWN_BINDING = std::numeric_limits< unsigned int >::max();
+
+    unsigned int activeTextureUnit;
+    std::vector< unsigned int > textureBindings;
+    std::vector< unsigned int > samplerBindings;
+
+    unsigned int& textureBinding( unsigned int unit, unsigned int target );
+    unsigned int& samplerBinding( unsigned int unit );
 };
 
 
+const unsigned int GLContext::Details::UNKNOWN_BINDING;
+
+
 GLContext::Details::Details()
     : vendor  ( reinterpret_cast< const char* >( glGetString( GL_VENDOR   ) ) )
     , renderer( reinterpret_cast< const char* >( glGetString( GL_RENDERER ) ) )
     , shader( nullptr )
+    , statisticsEnabled( false )
+    , activeTextureUnit( UNKNOWN_BINDING )
 {
 }
 
 
+unsigned int& GLContext::Details::textureBinding( unsigned int unit, unsigned int target )
+{
+    unsigned int targetIdx;
+    switch( target )
+    {
+
+    case GL_TEXTURE_1D:
+        targetIdx = 0;
+        break;
+
+    case GL_TEXTURE_2D:
+        targetIdx = 1;
+        break;
+
+    case GL_TEXTURE_3D:
+        targetIdx = 2;
+        break;
+
+    default:
+        LIBCARNA_FAIL( "Unsupported texture target." );
+
+    }
+    const std::size_t bindingIdx = 3 * unit + targetIdx;
+    if( bindingIdx >= textureBindings.size() )
+    {
+        textureBindings.resize( bindingIdx + 1, UNKNOWN_BINDING );
+    }
+    return textureBindings[ bindingIdx ];
+}
+
+
+unsigned int& GLContext::Details::samplerBinding( unsigned int unit )
+{
+    if( unit >= samplerBindings.size() )
+    {
+        samplerBindings.resize( unit + 1, UNKNOWN_BINDING );
+    }
+    return samplerBindings[ unit ];
+}
+
+
 
 // ----------------------------------------------------------------------------------
 // GLContext
@@ -70,6 +134,7 @@ GLContext::GLContext( bool isDoubleBuffered )
     : pimpl( new Details() )
     , isDoubleBuffered( isDoubleBuffered )
 {
+    pimpl->appliedRenderState.reset( new RenderState( *this, true ) );
     pimpl->defaultRenderState.reset( new RenderState( *this ) );
     RenderState& defaultRenderState = *pimpl->defaultRenderState;
 
@@ -83,6 +148,10 @@ GLContext::GLContext( bool isDoubleBuffered )
     defaultRenderState.setDepthTest( true );
     defaultRenderState.setDepthTestFunction( GL_LEQUAL );
 
+    /* Setup color-write.
+     */
+    defaultRenderState.setColorWrite( true );
+
     /* Setup blending.
      */
     defaultRenderState.setBlend( false );
@@ -102,6 +171,10 @@ GLContext::GLContext( bool isDoubleBuffered )
      */
     defaultRenderState.setLineWidth( 1.f );
 
+    /* Setup scissor test.
+     */
+    defaultRenderState.setScissorTest( false );
+
     /* Set default render state.
      */
     defaultRenderState.commit();
@@ -162,6 +235,90 @@ const RenderState& GLContext::currentRenderState() const
 }
 
 
+RenderState& GLContext::appliedRenderState()
+{
+    return *pimpl->appliedRenderState;
+}
+
+
+void GLContext::setStatisticsEnabled( bool enabled )
+{
+    pimpl->statisticsEnabled = enabled;
+}
+
+
+bool GLContext::isStatisticsEnabled() const
+{
+    return pimpl->statisticsEnabled;
+}
+
+
+const GLStatistics& GLContext::statistics() const
+{
+    return pimpl->statistics;
+}
+
+
+void GLContext::record( std::size_t GLStatistics::*counter, std::size_t count )
+{
+    if( pimpl->statisticsEnabled )
+    {
+        pimpl->statistics.*counter += count;
+    }
+}
+
+
+void GLContext::bindTexture( unsigned int unit, unsigned int target, unsigned int id )
+{
+    LIBCARNA_ASSERT( isCurrent() );
+    if( pimpl->activeTextureUnit != unit )
+    {
+        pimpl->activeTextureUnit = unit;
+        glActiveTexture( GL_TEXTURE0 + unit );
+    }
+    unsigned int& binding = pimpl->textureBinding( unit, target );
+    if( binding != id )
+    {
+        binding = id;
+        glBindTexture( target, id );
+        record( &GLStatistics::textureBinds );
+    }
+}
+
+
+void GLContext::bindSampler( unsigned int unit, unsigned int id )
+{
+    LIBCARNA_ASSERT( isCurrent() );
+    unsigned int& binding = pimpl->samplerBinding( unit );
+    if( binding != id )
+    {
+        binding = id;
+        glBindSampler( unit, id );
+        record( &GLStatistics::samplerBinds );
+    }
+}
+
+
+void GLContext::forgetTexture( unsigned int id )
+{
+    for( auto glcItr = glContextInstances.begin(); glcItr != glContextInstances.end(); ++glcItr )
+    {
+        std::vector< unsigned int >& bindings = ( **glcItr ).pimpl->textureBindings;
+        std::replace( bindings.begin(), bindings.end(), id, static_cast< unsigned int >( Details::UNKNOWN_BINDING ) );
+    }
+}
+
+
+void GLContext::forgetSampler( unsigned int id )
+{
+    for( auto glcItr = glContextInstances.begin(); glcItr != glContextInstances.end(); ++glcItr )
+    {
+        std::vector< unsigned int >& bindings = ( **glcItr ).pimpl->samplerBindings;
+        std::replace( bindings.begin(), bindings.end(), id, static_cast< unsigned int >( Details::UNKNOWN_BINDING ) );
+    }
+}
+
+
 GLContext& GLContext::current()
 {
     LIBCARNA_ASSERT( currentGLContext != nullptr );
@@ -209,10 +366,22 @@ void GLContext::clearBuffers( unsigned int flags )
     {
         rs.setDepthWrite( true );
     }
+    if( flags & GL_COLOR_BUFFER_BIT )
+    {
+        rs.setColorWrite( true );
+    }
+    commitRenderState();
     glClear( flags );
 }
 
 
+void GLContext::commitRenderState()
+{
+    LIBCARNA_ASSERT( isCurrent() );
+    currentRenderState().commitPending();
+}
+
+
 
 }  // namespace LibCarna :: base
 
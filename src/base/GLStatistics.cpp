@@ -0,0 +1,83 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#include <LibCarna/base/GLStatistics.hpp>
+
+namespace LibCarna
+{
+
+namespace base
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// GLStatistics
+// ----------------------------------------------------------------------------------
+
+GLStatistics::GLStatistics()
+    : drawCalls( 0 )
+    , primitives( 0 )
+    , stateChanges( 0 )
+    , requestedStateChanges( 0 )
+    , textureBinds( 0 )
+    , samplerBinds( 0 )
+    , framebufferBinds( 0 )
+    , uniformUploads( 0 )
+    , uploadedTextureBytes( 0 )
+{
+}
+
+
+std::size_t GLStatistics::suppressedStateChanges() const
+{
+    return requestedStateChanges - stateChanges;
+}
+
+
+GLStatistics GLStatistics::operator-( const GLStatistics& other ) const
+{
+    GLStatistics result;
+    result.drawCalls             = drawCalls             - other.drawCalls;
+    result.primitives            = primitives            - other.primitives;
+    result.stateChanges          = stateChanges          - other.stateChanges;
+    result.requestedStateChanges = requestedStateChanges - other.requestedStateChanges;
+    result.textureBinds          = textureBinds          - other.textureBinds;
+    result.samplerBinds          = samplerBinds          - other.samplerBinds;
+    result.framebufferBinds      = framebufferBinds      - other.framebufferBinds;
+    result.uniformUploads        = uniformUploads        - other.uniformUploads;
+    result.uploadedTextureBytes  = uploadedTextureBytes  - other.uploadedTextureBytes;
+    return result;
+}
+
+
+GLStatistics& GLStatistics::operator+=( const GLStatistics& other )
+{
+    drawCalls             += other.drawCalls;
+    primitives            += other.primitives;
+    stateChanges          += other.stateChanges;
+    requestedStateChanges += other.requestedStateChanges;
+    textureBinds          += other.textureBinds;
+    samplerBinds          += other.samplerBinds;
+    framebufferBinds      += other.framebufferBinds;
+    uniformUploads        += other.uniformUploads;
+    uploadedTextureBytes  += other.uploadedTextureBytes;
+    return *this;
+}
+
+
+
+}  // namespace LibCarna :: base
+
+}  // namespace LibCarna
@@ -17,8 +17,8 @@
 #include <LibCarna/base/LibCarnaException.hpp>
 #include <LibCarna/base/Association.hpp>
 #include <LibCarna/base/Node.hpp>
+#include <algorithm>
 #include <vector>
-#include <map>
 
 namespace LibCarna
 {
@@ -34,27 +34,66 @@ namespace base
 
 struct Geometry::Details
 {
-    std::map< unsigned int, GeometryFeature* > featureByRole;
-    std::map< GeometryFeature*, unsigned int > roleByFeature;
+    typedef std::pair< unsigned int, GeometryFeature* > FeatureEntry;
+    typedef std::vector< FeatureEntry > FeatureEntries;
+
+    /* Geometry nodes usually have only few features attached, thus a contiguous
+     * vector that is ordered by the roles is cheaper than associative containers,
+     * both in terms of lookups and memory allocations.
+     */
+    FeatureEntries features;
     std::unique_ptr< BoundingVolume > boundingVolume;
     
+    FeatureEntries::iterator lowerBound( unsigned int role );
+    FeatureEntries::iterator findRole( unsigned int role );
+    FeatureEntries::iterator findFeature( const GeometryFeature& gf );
     void clearFeatures( Geometry& self );
 };
 
 
-void Geometry::Details::clearFeatures( Geometry& self )
+Geometry::Details::FeatureEntries::iterator Geometry::Details::lowerBound( unsigned int role )
 {
-    std::vector< GeometryFeature* > features( featureByRole.size() );
-    unsigned int featureIdx = 0;
-    for( auto featureItr = featureByRole.begin(); featureItr != featureByRole.end(); ++featureItr )
+    return std::lower_bound( features.begin(), features.end(), role,
+        []( const FeatureEntry& entry, unsigned int role )
+        {
+            return entry.first < role;
+        }
+    );
+}
+
+
+Geometry::Details::FeatureEntries::iterator Geometry::Details::findRole( unsigned int role )
+{
+    const auto entryItr = lowerBound( role );
+    if( entryItr != features.end() && entryItr->first == role )
+    {
+        return entryItr;
+    }
+    else
     {
-        features[ featureIdx++ ] = featureItr->second;
+        return features.end();
     }
-    featureByRole.clear();
-    roleByFeature.clear();
-    for( auto featureItr = features.begin(); featureItr != features.end(); ++featureItr )
+}
+
+
+Geometry::Details::FeatureEntries::iterator Geometry::Details::findFeature( const GeometryFeature& gf )
+{
+    return std::find_if( features.begin(), features.end(),
+        [&gf]( const FeatureEntry& entry )
+        {
+            return entry.second == &gf;
+        }
+    );
+}
+
+
+void Geometry::Details::clearFeatures( Geometry& self )
+{
+    FeatureEntries features;
+    features.swap( this->features );
+    for( auto entryItr = features.begin(); entryItr != features.end(); ++entryItr )
     {
-        GeometryFeature* const ga = *featureItr;
+        GeometryFeature* const ga = entryItr->second;
         ga->removeFrom( self );
     }
 }
@@ -66,7 +105,7 @@ void Geometry::Details::clearFeatures( Geometry& self )
 // ----------------------------------------------------------------------------------
 
 Geometry::Geometry( unsigned int geometryType, const std::string& tag )
-    : Spatial( tag )
+    : Spatial( tag, kindGeometry )
     , pimpl( new Details() )
     , geometryType( geometryType )
 {
@@ -81,7 +120,7 @@ Geometry::~Geometry()
 
 void Geometry::clearFeatures()
 {
-    if( !pimpl->featureByRole.empty() )
+    if( !pimpl->features.empty() )
     {
         pimpl->clearFeatures( *this );
         invalidate();
@@ -91,34 +130,33 @@ void Geometry::clearFeatures()
 
 void Geometry::visitFeatures( const std::function< void( GeometryFeature& gf, unsigned int role ) >& visit ) const
 {
-    for( auto featureItr = pimpl->featureByRole.begin(); featureItr != pimpl->featureByRole.end(); ++featureItr )
+    for( auto entryItr = pimpl->features.begin(); entryItr != pimpl->features.end(); ++entryItr )
     {
-        visit( *featureItr->second, featureItr->first );
+        visit( *entryItr->second, entryItr->first );
     }
 }
 
 
 void Geometry::putFeature( unsigned int role, GeometryFeature& gf )
 {
-    const auto featureByRoleItr = pimpl->featureByRole.find( role );
-    if( featureByRoleItr != pimpl->featureByRole.end() && featureByRoleItr->second != &gf )
+    const auto roleItr = pimpl->findRole( role );
+    if( roleItr != pimpl->features.end() && roleItr->second != &gf )
     {
         /* Given role is already occupied by another feature.
          */
         removeFeature( role );
     }
-    const auto roleByFeatureItr = pimpl->roleByFeature.find( &gf );
-    if( roleByFeatureItr != pimpl->roleByFeature.end() && roleByFeatureItr->second != role )
+    const auto featureItr = pimpl->findFeature( gf );
+    if( featureItr != pimpl->features.end() && featureItr->first != role )
     {
         /* Given feature already occupies another role.
          */
         removeFeature( gf );
     }
-    const std::size_t size0 = pimpl->featureByRole.size();
-    pimpl->featureByRole[ role ] = &gf;
-    pimpl->roleByFeature[ &gf ] = role;
-    if( size0 != pimpl->featureByRole.size() )
+    const auto entryItr = pimpl->lowerBound( role );
+    if( entryItr == pimpl->features.end() || entryItr->first != role )
     {
+        pimpl->features.insert( entryItr, Details::FeatureEntry( role, &gf ) );
         gf.addTo( *this, role );
     }
     invalidate();
@@ -127,12 +165,10 @@ void Geometry::putFeature( unsigned int role, GeometryFeature& gf )
 
 void Geometry::removeFeature( GeometryFeature& gf )
 {
-    const auto featureItr = pimpl->roleByFeature.find( &gf );
-    if( featureItr != pimpl->roleByFeature.end() )
+    const auto entryItr = pimpl->findFeature( gf );
+    if( entryItr != pimpl->features.end() )
     {
-        const unsigned int role = featureItr->second;
-        pimpl->roleByFeature.erase( featureItr );
-        pimpl->featureByRole.erase( role );
+        pimpl->features.erase( entryItr );
         gf.removeFrom( *this );
         invalidate();
     }
@@ -141,12 +177,11 @@ void Geometry::removeFeature( GeometryFeature& gf )
 
 void Geometry::removeFeature( unsigned int role )
 {
-    const auto featureItr = pimpl->featureByRole.find( role );
-    if( featureItr != pimpl->featureByRole.end() )
+    const auto entryItr = pimpl->findRole( role );
+    if( entryItr != pimpl->features.end() )
     {
-        GeometryFeature* const gf = featureItr->second;
-        pimpl->roleByFeature.erase( gf );
-        pimpl->featureByRole.erase( featureItr );
+        GeometryFeature* const gf = entryItr->second;
+        pimpl->features.erase( entryItr );
         gf->removeFrom( *this );
         invalidate();
     }
@@ -155,27 +190,27 @@ void Geometry::removeFeature( unsigned int role )
 
 bool Geometry::hasFeature( const GeometryFeature& gf ) const
 {
-    return pimpl->roleByFeature.find( const_cast< GeometryFeature* >( &gf ) ) != pimpl->roleByFeature.end();
+    return pimpl->findFeature( gf ) != pimpl->features.end();
 }
 
 
 bool Geometry::hasFeature( unsigned int role ) const
 {
-    return pimpl->featureByRole.find( role ) != pimpl->featureByRole.end();
+    return pimpl->findRole( role ) != pimpl->features.end();
 }
 
 
 GeometryFeature& Geometry::feature( unsigned int role ) const
 {
-    const auto featureItr = pimpl->featureByRole.find( role );
-    LIBCARNA_ASSERT( featureItr != pimpl->featureByRole.end() );
-    return *featureItr->second;
+    const auto entryItr = pimpl->findRole( role );
+    LIBCARNA_ASSERT( entryItr != pimpl->features.end() );
+    return *entryItr->second;
 }
 
 
 std::size_t Geometry::featuresCount() const
 {
-    return pimpl->featureByRole.size();
+    return pimpl->features.size();
 }
 
 
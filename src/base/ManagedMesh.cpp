@@ -14,6 +14,10 @@
 
 #include <LibCarna/base/ManagedMesh.hpp>
 #include <LibCarna/base/Aggregation.hpp>
+#include <LibCarna/base/Log.hpp>
+#include <LibCarna/base/math/Ray.hpp>
+#include <algorithm>
+#include <limits>
 
 namespace LibCarna
 {
@@ -42,12 +46,123 @@ struct ManagedMeshBase::Details
         GLContextInfo();
     };
     std::map< const GLContext*, GLContextInfo* > acquisitions;
+
+    /* The nodes of the triangle hierarchy are stored in depth-first order, so that
+     * the left child of an inner node always succeeds it.
+     */
+    struct TriangleNode
+    {
+        math::Vector3f lower;
+        math::Vector3f upper;
+        std::size_t right;
+        std::size_t firstTriangle;
+        std::size_t trianglesCount;
+    };
+
+    const static std::size_t MAX_TRIANGLES_PER_LEAF = 4;
+
+    bool isTriangleHierarchyBuilt;
+    std::vector< math::Vector3f > triangleVertices;
+    std::vector< TriangleNode > triangleNodes;
+
+    void buildTriangleHierarchy();
+    std::size_t buildTriangleSubtree( std::vector< std::size_t >& triangles, std::size_t begin, std::size_t end );
+    math::Vector3f triangleCenter( std::size_t triangle ) const;
 };
 
 
 ManagedMeshBase::Details::Details( ManagedMeshBase& self )
     : self( self )
+    , isTriangleHierarchyBuilt( false )
+{
+}
+
+
+math::Vector3f ManagedMeshBase::Details::triangleCenter( std::size_t triangle ) const
+{
+    return ( triangleVertices[ 3 * triangle ] + triangleVertices[ 3 * triangle + 1 ] + triangleVertices[ 3 * triangle + 2 ] ) / 3;
+}
+
+
+void ManagedMeshBase::Details::buildTriangleHierarchy()
 {
+    self.loadTriangles( triangleVertices );
+    const std::size_t trianglesCount = triangleVertices.size() / 3;
+    if( trianglesCount > 0 )
+    {
+        std::vector< std::size_t > triangles( trianglesCount );
+        for( std::size_t triangle = 0; triangle < trianglesCount; ++triangle )
+        {
+            triangles[ triangle ] = triangle;
+        }
+        buildTriangleSubtree( triangles, 0, trianglesCount );
+
+        /* Reorder the triangles, so that those of each leaf are contiguous.
+         */
+        std::vector< math::Vector3f > orderedVertices( triangleVertices.size() );
+        for( std::size_t idx = 0; idx < trianglesCount; ++idx )
+        {
+            std::copy_n( triangleVertices.begin() + 3 * triangles[ idx ], 3, orderedVertices.begin() + 3 * idx );
+        }
+        triangleVertices.swap( orderedVertices );
+    }
+    isTriangleHierarchyBuilt = true;
+}
+
+
+std::size_t ManagedMeshBase::Details::buildTriangleSubtree
+    ( std::vector< std::size_t >& triangles, std::size_t begin, std::size_t end )
+{
+    const std::size_t nodeIndex = triangleNodes.size();
+    triangleNodes.push_back( TriangleNode() );
+
+    /* Compute the bounds of the triangles and of their centers.
+     */
+    math::Vector3f lower = triangleVertices[ 3 * triangles[ begin ] ];
+    math::Vector3f upper = lower;
+    math::Vector3f centersLower = triangleCenter( triangles[ begin ] );
+    math::Vector3f centersUpper = centersLower;
+    for( std::size_t idx = begin; idx < end; ++idx )
+    {
+        for( unsigned int corner = 0; corner < 3; ++corner )
+        {
+            lower = lower.cwiseMin( triangleVertices[ 3 * triangles[ idx ] + corner ] );
+            upper = upper.cwiseMax( triangleVertices[ 3 * triangles[ idx ] + corner ] );
+        }
+        const math::Vector3f center = triangleCenter( triangles[ idx ] );
+        centersLower = centersLower.cwiseMin( center );
+        centersUpper = centersUpper.cwiseMax( center );
+    }
+    triangleNodes[ nodeIndex ].lower = lower;
+    triangleNodes[ nodeIndex ].upper = upper;
+
+    /* Create a leaf node if only few triangles are left.
+     */
+    if( end - begin <= MAX_TRIANGLES_PER_LEAF )
+    {
+        triangleNodes[ nodeIndex ].firstTriangle  = begin;
+        triangleNodes[ nodeIndex ].trianglesCount = end - begin;
+        return nodeIndex;
+    }
+
+    /* Split at the median along the axis where the triangle centers are spread
+     * widest.
+     */
+    unsigned int axis;
+    ( centersUpper - centersLower ).maxCoeff( &axis );
+    const std::size_t middle = begin + ( end - begin ) / 2;
+    std::nth_element( triangles.begin() + begin, triangles.begin() + middle, triangles.begin() + end,
+        [&]( std::size_t triangle1, std::size_t triangle2 )
+        {
+            return triangleCenter( triangle1 )[ axis ] < triangleCenter( triangle2 )[ axis ];
+        }
+    );
+
+    buildTriangleSubtree( triangles, begin, middle );
+    const std::size_t right = buildTriangleSubtree( triangles, middle, end );
+    triangleNodes[ nodeIndex ].right = right;
+    triangleNodes[ nodeIndex ].trianglesCount = 0;
+    return nodeIndex;
 }
 
 
@@ -163,6 +278,107 @@ const MeshBase& ManagedMeshBase::mesh() const
 }
 
 
+void ManagedMeshBase::loadTriangles( std::vector< math::Vector3f >& ) const
+{
+    Log::instance().record( Log::warning, "Ray picking is not supported by this mesh, since it does not load its triangles." );
+}
+
+
+bool ManagedMeshBase::computeRayHit( math::Vector3f& out, const math::Ray3f& ray ) const
+{
+    if( !pimpl->isTriangleHierarchyBuilt )
+    {
+        pimpl->buildTriangleHierarchy();
+    }
+    if( pimpl->triangleNodes.empty() )
+    {
+        return false;
+    }
+
+    /* Computes the ray length where the ray enters the box, or the infinity if the
+     * box is missed. The ray length is measured in multiples of the direction.
+     */
+    const float infinity = std::numeric_limits< float >::infinity();
+    const math::Vector3f inverseDirection = ray.direction.cwiseInverse();
+    const auto computeEntry = [&]( const Details::TriangleNode& node )
+    {
+        const math::Vector3f t1 = ( node.lower - ray.origin ).cwiseProduct( inverseDirection );
+        const math::Vector3f t2 = ( node.upper - ray.origin ).cwiseProduct( inverseDirection );
+        const float tEnter = std::max( t1.cwiseMin( t2 ).maxCoeff(), 0.f );
+        const float tLeave = t1.cwiseMax( t2 ).minCoeff();
+        return tEnter <= tLeave ? tEnter : infinity;
+    };
+
+    float hitLength = infinity;
+    std::vector< std::size_t > stack;
+    stack.push_back( 0 );
+    while( !stack.empty() )
+    {
+        const std::size_t nodeIndex = stack.back();
+        const Details::TriangleNode& node = pimpl->triangleNodes[ nodeIndex ];
+        stack.pop_back();
+        if( computeEntry( node ) >= hitLength )
+        {
+            continue;
+        }
+
+        if( node.trianglesCount == 0 )
+        {
+            /* Visit the closer child first, so that the farther might be skipped.
+             */
+            const std::size_t left  = nodeIndex + 1;
+            const std::size_t right = node.right;
+            const bool isLeftCloser = computeEntry( pimpl->triangleNodes[ left ] ) <= computeEntry( pimpl->triangleNodes[ right ] );
+            stack.push_back( isLeftCloser ? right : left  );
+            stack.push_back( isLeftCloser ? left  : right );
+            continue;
+        }
+
+        /* Test the triangles of the leaf using the Möller-Trumbore algorithm.
+         */
+        for( std::size_t triangle = node.firstTriangle; triangle < node.firstTriangle + node.trianglesCount; ++triangle )
+        {
+            const math::Vector3f& v0 = pimpl->triangleVertices[ 3 * triangle ];
+            const math::Vector3f edge1 = pimpl->triangleVertices[ 3 * triangle + 1 ] - v0;
+            const math::Vector3f edge2 = pimpl->triangleVertices[ 3 * triangle + 2 ] - v0;
+            const math::Vector3f p = ray.direction.cross( edge2 );
+            const float determinant = edge1.dot( p );
+            if( std::abs( determinant ) <= std::numeric_limits< float >::min() )
+            {
+                continue;
+            }
+            const math::Vector3f s = ray.origin - v0;
+            const float u = s.dot( p ) / determinant;
+            if( u < 0 || u > 1 )
+            {
+                continue;
+            }
+            const math::Vector3f q = s.cross( edge1 );
+            const float v = ray.direction.dot( q ) / determinant;
+            if( v < 0 || u + v > 1 )
+            {
+                continue;
+            }
+            const float length = edge2.dot( q ) / determinant;
+            if( length >= 0 && length < hitLength )
+            {
+                hitLength = length;
+            }
+        }
+    }
+
+    if( hitLength == infinity )
+    {
+        return false;
+    }
+    else
+    {
+        out = ray.origin + ray.direction * hitLength;
+        return true;
+    }
+}
+
+
 
 }  // namespace LibCarna :: base
 
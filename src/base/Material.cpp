@@ -16,6 +16,8 @@
 #include <LibCarna/base/ShaderManager.hpp>
 #include <LibCarna/base/GLContext.hpp>
 #include <LibCarna/base/LibCarnaException.hpp>
+#include <algorithm>
+#include <cstdint>
 #include <map>
 
 namespace LibCarna
@@ -26,6 +28,19 @@ namespace base
 
 
 
+// ----------------------------------------------------------------------------------
+// Types & Globals
+// ----------------------------------------------------------------------------------
+
+/* Revisions are unique across all materials, so that a material, that is created
+ * where another one was deleted previously, is never mistaken for it.
+ */
+static std::uint64_t lastMaterialRevision = 0;
+
+static std::size_t materialParameterUploadsCount = 0;
+
+
+
 // ----------------------------------------------------------------------------------
 // Material :: Details
 // ----------------------------------------------------------------------------------
@@ -37,14 +52,61 @@ struct Material::Details
 
     float lineWidth;
 
+    std::uint64_t revision;
+
     Details();
 
+    void activate( const ShaderProgram& shader, RenderState& rs ) const;
+
 }; // Material :: Details
 
 
 Material::Details::Details()
     : lineWidth( 1.0f )
+    , revision( ++lastMaterialRevision )
+{
+}
+
+
+void Material::Details::activate( const ShaderProgram& shader, RenderState& rs ) const
+{
+    /* Ensure the shader is activated.
+     */
+    GLContext& glc = GLContext::current();
+    glc.setShader( shader );
+
+    /* Upload uniform variables, unless they are still in effect, i.e. this material
+     * was the last to upload them to the shader and neither of both has changed.
+     */
+    if( !shader.isUniformsOwner( this, revision ) )
+    {
+        std::vector< int > locations;
+        locations.reserve( uniforms.size() );
+        for( auto uniformItr = uniforms.begin(); uniformItr != uniforms.end(); ++uniformItr )
+        {
+            if( uniformItr->second->upload() )
+            {
+                locations.push_back( shader.uniformLocation( uniformItr->first ) );
+            }
+        }
+        shader.setUniformsOwner( this, revision, locations );
+        ++materialParameterUploadsCount;
+    }
+
+    /* Update render states.
+     */
+    rs.setLineWidth( lineWidth );
+}
+
+
+
+// ----------------------------------------------------------------------------------
+// instancedShaderName
+// ----------------------------------------------------------------------------------
+
+static std::string instancedShaderName( const std::string& shaderName )
 {
+    return shaderName + "_instanced";
 }
 
 
@@ -59,9 +121,15 @@ Material::ManagedInterface::ManagedInterface( Material& material )
 {
     if( material.videoResourceAcquisitionsCount() == 1 )
     {
-        /* Acquire the shader.
+        /* Acquire the shader and its instanced variant, if available.
          */
-        material.shader = &ShaderManager::instance().acquireShader( material.shaderName );
+        ShaderManager& shaderManager = ShaderManager::instance();
+        material.shader = &shaderManager.acquireShader( material.shaderName );
+        const std::string instancedShaderName = base::instancedShaderName( material.shaderName );
+        if( shaderManager.hasShader( instancedShaderName ) )
+        {
+            material.instancedShader = &shaderManager.acquireShader( instancedShaderName );
+        }
     }
 }
 
@@ -74,6 +142,11 @@ Material::ManagedInterface::~ManagedInterface()
          */
         ShaderManager::instance().releaseShader( *material.shader );
         material.shader = nullptr;
+        if( material.instancedShader != nullptr )
+        {
+            ShaderManager::instance().releaseShader( *material.instancedShader );
+            material.instancedShader = nullptr;
+        }
     }
 }
 
@@ -85,23 +158,28 @@ const ShaderProgram& Material::ManagedInterface::shader() const
 }
 
 
+bool Material::ManagedInterface::hasInstancedShader() const
+{
+    return material.instancedShader != nullptr;
+}
+
+
+const ShaderProgram& Material::ManagedInterface::instancedShader() const
+{
+    LIBCARNA_ASSERT( material.instancedShader != nullptr );
+    return *material.instancedShader;
+}
+
+
 void Material::ManagedInterface::activate( RenderState& rs ) const
 {
-    /* Ensure the shader is activated.
-     */
-    GLContext& glc = GLContext::current();
-    glc.setShader( shader() );
+    material.pimpl->activate( shader(), rs );
+}
 
-    /* Upload uniform variables.
-     */
-    for( auto uniformItr = material.pimpl->uniforms.begin(); uniformItr != material.pimpl->uniforms.end(); ++uniformItr )
-    {
-        uniformItr->second->upload();
-    }
 
-    /* Update render states.
-     */
-    rs.setLineWidth( material.pimpl->lineWidth );
+void Material::ManagedInterface::activateInstanced( RenderState& rs ) const
+{
+    material.pimpl->activate( instancedShader(), rs );
 }
 
 
@@ -113,6 +191,7 @@ void Material::ManagedInterface::activate( RenderState& rs ) const
 Material::Material( const std::string& shaderName )
     : pimpl( new Details() )
     , shader( nullptr )
+    , instancedShader( nullptr )
     , shaderName( shaderName )
 {
 }
@@ -153,6 +232,7 @@ void Material::addParameter( ShaderUniformBase* uniform )
         delete uniformItr->second;
     }
     pimpl->uniforms[ uniform->name ] = uniform;
+    pimpl->revision = ++lastMaterialRevision;
 }
 
 
@@ -163,6 +243,7 @@ void Material::clearParameters()
         delete uniformItr->second;
     }
     pimpl->uniforms.clear();
+    pimpl->revision = ++lastMaterialRevision;
 }
 
 
@@ -173,6 +254,7 @@ void Material::removeParameter( const std::string& name )
     {
         delete uniformItr->second;
         pimpl->uniforms.erase( uniformItr );
+        pimpl->revision = ++lastMaterialRevision;
     }
 }
 
@@ -192,6 +274,12 @@ const ShaderUniformBase& Material::parameter( const std::string& name ) const
 }
 
 
+std::size_t Material::parameterUploadsCount()
+{
+    return materialParameterUploadsCount;
+}
+
+
 float Material::lineWidth() const
 {
     return pimpl->lineWidth;
@@ -204,6 +292,50 @@ void Material::setLineWidth( float lineWidth )
 }
 
 
+bool Material::isInstancingCompatible( const Material& other ) const
+{
+    if( &other == this )
+    {
+        return true;
+    }
+    if( other.shaderName != shaderName
+        || other.pimpl->lineWidth != pimpl->lineWidth
+        || other.pimpl->uniforms.size() != pimpl->uniforms.size() )
+    {
+        return false;
+    }
+    for( auto uniformItr = pimpl->uniforms.begin(); uniformItr != pimpl->uniforms.end(); ++uniformItr )
+    {
+        const auto otherUniformItr = other.pimpl->uniforms.find( uniformItr->first );
+        if( otherUniformItr == other.pimpl->uniforms.end() )
+        {
+            return false;
+        }
+        else
+        if( uniformItr->first != "color" && !uniformItr->second->hasSameValue( *otherUniformItr->second ) )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+void Material::collectShaderNames( std::vector< std::string >& shaderNames ) const
+{
+    const std::string instancedShaderName = base::instancedShaderName( shaderName );
+    const bool hasInstancedShader = ShaderManager::instance().hasShader( instancedShaderName );
+    for( unsigned int shaderIdx = 0; shaderIdx < ( hasInstancedShader ? 2u : 1u ); ++shaderIdx )
+    {
+        const std::string& name = shaderIdx == 0 ? shaderName : instancedShaderName;
+        if( std::find( shaderNames.begin(), shaderNames.end(), name ) == shaderNames.end() )
+        {
+            shaderNames.push_back( name );
+        }
+    }
+}
+
+
 Material::ManagedInterface* Material::acquireVideoResource()
 {
     return new ManagedInterface( *this );
@@ -39,6 +39,36 @@ static std::size_t computeVertexStride( const VertexAttributes& vertexAttributes
 
 
 
+// ----------------------------------------------------------------------------------
+// countPrimitives
+// ----------------------------------------------------------------------------------
+
+static std::size_t countPrimitives( unsigned int primitiveType, std::size_t indicesCount )
+{
+    switch( primitiveType )
+    {
+
+    case GL_TRIANGLES:
+        return indicesCount / 3;
+
+    case GL_TRIANGLE_STRIP:
+    case GL_TRIANGLE_FAN:
+        return indicesCount >= 3 ? indicesCount - 2 : 0;
+
+    case GL_LINES:
+        return indicesCount / 2;
+
+    case GL_LINE_STRIP:
+        return indicesCount >= 2 ? indicesCount - 1 : 0;
+
+    default:
+        return indicesCount;
+
+    }
+}
+
+
+
 // ----------------------------------------------------------------------------------
 // createGLVertexArray
 // ----------------------------------------------------------------------------------
@@ -114,7 +144,28 @@ void MeshBase::render() const
 
     this->bind();
     indexBuffer().bind();
+    GLContext& glc = GLContext::current();
+    glc.commitRenderState();
     glDrawElements( indexBuffer().primitiveType, indexBuffer().size(), indexBuffer().type, nullptr );
+    glc.record( &GLStatistics::drawCalls );
+    glc.record( &GLStatistics::primitives, countPrimitives( indexBuffer().primitiveType, indexBuffer().size() ) );
+}
+
+
+void MeshBase::renderInstanced( unsigned int instancesCount ) const
+{
+    LIBCARNA_ASSERT( &GLContext::current() == &glContext );
+    
+    LIBCARNA_ASSERT_EX( vertexBuffer().isValid(), "Vertex buffer is invalid." );
+    LIBCARNA_ASSERT_EX(  indexBuffer().isValid(),  "Index buffer is invalid." );
+
+    this->bind();
+    indexBuffer().bind();
+    GLContext& glc = GLContext::current();
+    glc.commitRenderState();
+    glDrawElementsInstanced( indexBuffer().primitiveType, indexBuffer().size(), indexBuffer().type, nullptr, instancesCount );
+    glc.record( &GLStatistics::drawCalls );
+    glc.record( &GLStatistics::primitives, instancesCount * countPrimitives( indexBuffer().primitiveType, indexBuffer().size() ) );
 }
 
 
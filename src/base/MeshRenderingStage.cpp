@@ -12,7 +12,15 @@
  * 
  */
 
+#include <LibCarna/base/glew.hpp>
 #include <LibCarna/base/MeshRenderingStage.hpp>
+#include <LibCarna/base/Mesh.hpp>
+#include <LibCarna/base/GLContext.hpp>
+#include <LibCarna/base/ShaderProgram.hpp>
+#include <LibCarna/base/Node.hpp>
+#include <LibCarna/base/Geometry.hpp>
+#include <LibCarna/base/Color.hpp>
+#include <vector>
 
 namespace LibCarna
 {
@@ -22,12 +30,172 @@ namespace base
 
 
 
+// ----------------------------------------------------------------------------------
+// MeshRenderingMixin :: Details
+// ----------------------------------------------------------------------------------
+
+struct MeshRenderingMixin::Details
+{
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    Details();
+
+    bool instancingEnabled;
+    std::size_t drawCallsCount;
+
+    /* The pending batch consists of instances that share the same mesh and
+     * compatible materials. Its per-instance attributes are stored consecutively:
+     * The model-view matrix, the normals-view matrix, and the color.
+     */
+    const Material::ManagedInterface* batchMaterial;
+    const ManagedMeshBase::ManagedInterface* batchMesh;
+    math::Matrix4f batchProjection;
+    std::vector< float > batchAttributes;
+    std::size_t batchSize;
+
+    const static std::size_t INSTANCE_ATTRIBUTES_COUNT = 16 + 16 + 4;
+
+    unsigned int instanceBufferId;
+    std::size_t instanceBufferCapacity;
+
+    bool canExtendBatch( const Material::ManagedInterface& material, const ManagedMeshBase::ManagedInterface& mesh ) const;
+    void renderSingle();
+    void renderInstanced();
+
+    static math::Vector4f instanceColor( const Material& material );
+
+}; // MeshRenderingMixin :: Details
+
+
+MeshRenderingMixin::Details::Details()
+    : instancingEnabled( true )
+    , drawCallsCount( 0 )
+    , batchMaterial( nullptr )
+    , batchMesh( nullptr )
+    , batchSize( 0 )
+    , instanceBufferId( 0 )
+    , instanceBufferCapacity( 0 )
+{
+}
+
+
+bool MeshRenderingMixin::Details::canExtendBatch
+    ( const Material::ManagedInterface& material
+    , const ManagedMeshBase::ManagedInterface& mesh ) const
+{
+    return instancingEnabled
+        && &mesh.get() == &batchMesh->get()
+        && material.hasInstancedShader()
+        && material.material.isInstancingCompatible( batchMaterial->material );
+}
+
+
+math::Vector4f MeshRenderingMixin::Details::instanceColor( const Material& material )
+{
+    if( material.hasParameter( "color" ) )
+    {
+        const ShaderUniformBase& color = material.parameter( "color" );
+        if( const ShaderUniform< Color >* const colorUniform = dynamic_cast< const ShaderUniform< Color >* >( &color ) )
+        {
+            return colorUniform->value;
+        }
+        else
+        if( const ShaderUniform< math::Vector4f >* const colorUniform = dynamic_cast< const ShaderUniform< math::Vector4f >* >( &color ) )
+        {
+            return colorUniform->value;
+        }
+    }
+    return math::Vector4f( 1, 1, 1, 1 );
+}
+
+
+void MeshRenderingMixin::Details::renderSingle()
+{
+    RenderState rs;
+    batchMaterial->activate( rs );
+
+    const Eigen::Map< const math::Matrix4f > modelView( batchAttributes.data() );
+    const Eigen::Map< const math::Matrix4f > normalsView( batchAttributes.data() + 16 );
+    ShaderUniform< math::Matrix4f >( "modelView", modelView ).upload();
+    ShaderUniform< math::Matrix4f >( "normalsView", normalsView ).upload();
+
+    /* Only legacy shaders declare the projection and the model-view-projection
+     * matrices. Uniforms that are not declared are skipped by 'upload', but the
+     * product is only worth computing if the shader actually uses it.
+     */
+    ShaderUniform< math::Matrix4f >( "projection", batchProjection ).upload();
+    if( GLContext::current().shader().uniformLocation( "modelViewProjection" ) >= 0 )
+    {
+        ShaderUniform< math::Matrix4f >( "modelViewProjection", batchProjection * modelView ).upload();
+    }
+
+    batchMesh->get().render();
+}
+
+
+void MeshRenderingMixin::Details::renderInstanced()
+{
+    RenderState rs;
+    batchMaterial->activateInstanced( rs );
+    ShaderUniform< math::Matrix4f >( "projection", batchProjection ).upload();
+
+    /* Upload the per-instance attributes. The buffer is orphaned, so that uploading
+     * does not need to wait for previous draw calls that might still use it.
+     */
+    if( instanceBufferId == 0 )
+    {
+        glGenBuffers( 1, &instanceBufferId );
+    }
+    const std::size_t bufferSize = batchAttributes.size() * sizeof( float );
+    glBindBuffer( GL_ARRAY_BUFFER, instanceBufferId );
+    if( bufferSize > instanceBufferCapacity )
+    {
+        instanceBufferCapacity = bufferSize;
+    }
+    glBufferData( GL_ARRAY_BUFFER, instanceBufferCapacity, nullptr, GL_STREAM_DRAW );
+    glBufferSubData( GL_ARRAY_BUFFER, 0, bufferSize, batchAttributes.data() );
+
+    /* Attach the per-instance attributes to the vertex array of the mesh.
+     */
+    const MeshBase& mesh = batchMesh->get();
+    mesh.bind();
+    const std::size_t stride = INSTANCE_ATTRIBUTES_COUNT * sizeof( float );
+    const unsigned int locations[] =
+        { ATTRIBUTE_LOCATION_INSTANCE_MODELVIEW,   ATTRIBUTE_LOCATION_INSTANCE_MODELVIEW   + 1
+        , ATTRIBUTE_LOCATION_INSTANCE_MODELVIEW   + 2, ATTRIBUTE_LOCATION_INSTANCE_MODELVIEW   + 3
+        , ATTRIBUTE_LOCATION_INSTANCE_NORMALSVIEW, ATTRIBUTE_LOCATION_INSTANCE_NORMALSVIEW + 1
+        , ATTRIBUTE_LOCATION_INSTANCE_NORMALSVIEW + 2, ATTRIBUTE_LOCATION_INSTANCE_NORMALSVIEW + 3
+        , ATTRIBUTE_LOCATION_INSTANCE_COLOR };
+    for( unsigned int column = 0; column < 9; ++column )
+    {
+        glEnableVertexAttribArray( locations[ column ] );
+        glVertexAttribPointer( locations[ column ], 4, GL_FLOAT, false, stride, static_cast< float* >( nullptr ) + 4 * column );
+        glVertexAttribDivisor( locations[ column ], 1 );
+    }
+
+    mesh.renderInstanced( batchSize );
+
+    /* Detach the per-instance attributes, so that the vertex array remains usable
+     * by other shaders.
+     */
+    for( unsigned int column = 0; column < 9; ++column )
+    {
+        glVertexAttribDivisor( locations[ column ], 0 );
+        glDisableVertexAttribArray( locations[ column ] );
+    }
+    glBindVertexArray( 0 );
+}
+
+
+
 // ----------------------------------------------------------------------------------
 // MeshRenderingMixin
 // ----------------------------------------------------------------------------------
 
 MeshRenderingMixin::MeshRenderingMixin( unsigned int geometryType )
-    : geometryType( geometryType )
+    : pimpl( new Details() )
+    , geometryType( geometryType )
 {
 }
 
@@ -37,6 +205,109 @@ MeshRenderingMixin::~MeshRenderingMixin()
 }
 
 
+void MeshRenderingMixin::setInstancingEnabled( bool instancingEnabled )
+{
+    pimpl->instancingEnabled = instancingEnabled;
+}
+
+
+bool MeshRenderingMixin::isInstancingEnabled() const
+{
+    return pimpl->instancingEnabled;
+}
+
+
+std::size_t MeshRenderingMixin::drawCallsCount() const
+{
+    return pimpl->drawCallsCount;
+}
+
+
+void MeshRenderingMixin::beginBatches()
+{
+    pimpl->drawCallsCount = 0;
+    pimpl->batchSize = 0;
+    pimpl->batchAttributes.clear();
+}
+
+
+void MeshRenderingMixin::renderBatched
+    ( const Renderable& renderable
+    , const Material::ManagedInterface& material
+    , const ManagedMeshBase::ManagedInterface& mesh
+    , const math::Matrix4f& projection )
+{
+    if( pimpl->batchSize > 0 && !pimpl->canExtendBatch( material, mesh ) )
+    {
+        flushBatch();
+    }
+    if( pimpl->batchSize == 0 )
+    {
+        pimpl->batchMaterial   = &material;
+        pimpl->batchMesh       = &mesh;
+        pimpl->batchProjection = projection;
+    }
+
+    /* Record the per-instance attributes.
+     */
+    const math::Matrix4f normalsView = renderable.viewModelTransform().transpose();
+    const math::Vector4f color = Details::instanceColor( material.material );
+    pimpl->batchAttributes.insert( pimpl->batchAttributes.end(), renderable.modelViewTransform().data(), renderable.modelViewTransform().data() + 16 );
+    pimpl->batchAttributes.insert( pimpl->batchAttributes.end(), normalsView.data(), normalsView.data() + 16 );
+    pimpl->batchAttributes.insert( pimpl->batchAttributes.end(), color.data(), color.data() + 4 );
+    ++pimpl->batchSize;
+}
+
+
+void MeshRenderingMixin::flushBatch()
+{
+    if( pimpl->batchSize == 1 )
+    {
+        pimpl->renderSingle();
+    }
+    else
+    if( pimpl->batchSize > 1 )
+    {
+        pimpl->renderInstanced();
+    }
+    else
+    {
+        return;
+    }
+    ++pimpl->drawCallsCount;
+    pimpl->batchSize = 0;
+    pimpl->batchAttributes.clear();
+}
+
+
+void MeshRenderingMixin::releaseBatchResources()
+{
+    if( pimpl->instanceBufferId != 0 )
+    {
+        glDeleteBuffers( 1, &pimpl->instanceBufferId );
+        pimpl->instanceBufferId = 0;
+        pimpl->instanceBufferCapacity = 0;
+    }
+}
+
+
+void MeshRenderingMixin::collectMaterialShaderNames( const Node& root, unsigned int geometryTypeMask, std::vector< std::string >& shaderNames ) const
+{
+    root.visitChildren( true, [&]( const Spatial& spatial )
+        {
+            if( spatial.isGeometry() )
+            {
+                const Geometry& geom = static_cast< const Geometry& >( spatial );
+                if( ( geom.geometryType & geometryTypeMask ) == geometryType && geom.hasFeature( DEFAULT_ROLE_MATERIAL ) )
+                {
+                    static_cast< const Material& >( geom.feature( DEFAULT_ROLE_MATERIAL ) ).collectShaderNames( shaderNames );
+                }
+            }
+        }
+    );
+}
+
+
 
 }  // namespace LibCarna :: base
 
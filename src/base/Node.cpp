@@ -15,6 +15,7 @@
 #include <LibCarna/base/Node.hpp>
 #include <LibCarna/base/NodeListener.hpp>
 #include <algorithm>
+#include <vector>
 #include <set>
 
 namespace LibCarna
@@ -34,13 +35,15 @@ struct Node::Details
     Details( Node& self );
     Node& self;
 
-    std::set< Spatial* > children;
+    std::vector< Spatial* > children;
     std::set< NodeListener* > listeners;
     
     bool isDying;
     bool isTreeChangeNotified;
     bool isDeletingChildren;
     void notifyTreeChanges( bool inThisSubtree );
+
+    std::size_t changedWorldTransformsCount;
 };
 
 
@@ -49,6 +52,7 @@ Node::Details::Details( Node& self )
     , isDying( false )
     , isTreeChangeNotified( false )
     , isDeletingChildren( false )
+    , changedWorldTransformsCount( 0 )
 {
 }
 
@@ -90,14 +94,14 @@ void Node::Details::notifyTreeChanges( bool inThisSubtree )
         /* Notify the children that the scene's tree structure has changed. Create copy
          * of 'children' s.t. each listener is free to remove its child from the list.
          */
-        const std::set< Spatial* > children( this->children.begin(), this->children.end() );
+        const std::vector< Spatial* > children( this->children );
         for( auto itr = children.begin(); itr != children.end(); ++itr )
         {
-            Node* const child = dynamic_cast< Node* >( *itr );
-            if( child != nullptr )
+            if( ( *itr )->isNode() )
             {
                 /* Denote that this change affects a different subtree.
                  */
+                Node* const child = static_cast< Node* >( *itr );
                 child->pimpl->notifyTreeChanges( false );
             }
         }
@@ -113,7 +117,7 @@ void Node::Details::notifyTreeChanges( bool inThisSubtree )
 // ----------------------------------------------------------------------------------
 
 Node::Node( const std::string& tag )
-    : Spatial( tag )
+    : Spatial( tag, kindNode )
 #pragma warning( push )
 #pragma warning( disable:4355 )
     /* It is okay to use 'this' in class initialization list, as long as it is not
@@ -177,7 +181,9 @@ void Node::invalidate()
 
 bool Node::hasChild( const Spatial& child ) const
 {
-    return pimpl->children.find( const_cast< Spatial* >( &child ) ) != pimpl->children.end();
+    /* The tree is kept consistent, thus it suffices to check the parent.
+     */
+    return child.hasParent() && &child.parent() == this;
 }
 
 
@@ -191,7 +197,7 @@ void Node::attachChild( Spatial* child )
         {
             child->detachFromParent();
         }
-        pimpl->children.insert( child );
+        pimpl->children.push_back( child );
         child->updateParent( *this );
     }
     pimpl->notifyTreeChanges( true );
@@ -200,11 +206,11 @@ void Node::attachChild( Spatial* child )
 
 Spatial* Node::detachChild( Spatial& child )
 {
-    const auto childItr = pimpl->children.find( &child );
+    const auto childItr = std::find( pimpl->children.begin(), pimpl->children.end(), &child );
     if( childItr != pimpl->children.end() )
     {
         LIBCARNA_ASSERT( child.hasParent() && &child.parent() == this );
-        pimpl->children.erase( &child );
+        pimpl->children.erase( childItr );
         child.detachFromParent();
         pimpl->notifyTreeChanges( true );
         return &child;
@@ -235,7 +241,7 @@ void Node::visitChildren( bool recursively, const MutableVisitor& visit )
     {
         Spatial* const spatial = *itr;
         visit( *spatial );
-        if( recursively && dynamic_cast< Node* >( spatial ) != nullptr )
+        if( recursively && spatial->isNode() )
         {
             Node* const node = static_cast< Node* >( spatial );
             node->visitChildren( true, visit );
@@ -250,7 +256,7 @@ void Node::visitChildren( bool recursively, const ImmutableVisitor& visit ) cons
     {
         const Spatial* const spatial = *itr;
         visit( *spatial );
-        if( recursively && dynamic_cast< const Node* >( spatial ) != nullptr )
+        if( recursively && spatial->isNode() )
         {
             const Node* const node = static_cast< const Node* >( spatial );
             node->visitChildren( true, visit );
@@ -268,11 +274,28 @@ std::size_t Node::children() const
 void Node::updateWorldTransform()
 {
     Spatial::updateWorldTransform();
-    visitChildren( false, []( Spatial& child )
+    std::size_t changedWorldTransformsCount = hasWorldTransformChanged() ? 1 : 0;
+    for( auto itr = pimpl->children.begin(); itr != pimpl->children.end(); ++itr )
+    {
+        Spatial& child = **itr;
+        child.updateWorldTransform();
+        if( child.isNode() )
+        {
+            changedWorldTransformsCount += static_cast< const Node& >( child ).changedWorldTransformsCount();
+        }
+        else
+        if( child.hasWorldTransformChanged() )
         {
-            child.updateWorldTransform();
+            ++changedWorldTransformsCount;
         }
-    );
+    }
+    pimpl->changedWorldTransformsCount = changedWorldTransformsCount;
+}
+
+
+std::size_t Node::changedWorldTransformsCount() const
+{
+    return pimpl->changedWorldTransformsCount;
 }
 
 
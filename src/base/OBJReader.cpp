@@ -0,0 +1,457 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#include <LibCarna/base/OBJReader.hpp>
+#include <LibCarna/base/LibCarnaException.hpp>
+#include <LibCarna/base/text.hpp>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace LibCarna
+{
+
+namespace base
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// Types & Globals
+// ----------------------------------------------------------------------------------
+
+/* Denotes face corners, that do not reference a normal.
+ */
+const static uint32_t OBJ_NO_NORMAL = std::numeric_limits< uint32_t >::max();
+
+/* Initial capacity of the hash table, that merges the corners.
+ */
+const static std::size_t OBJ_MIN_TABLE_SIZE = 64;
+
+
+static bool isOBJWhitespace( char c )
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+
+/* Advances 'cursor' to the beginning of the next token within the line and
+ * 'tokenEnd' to its end. Returns 'false' if there is no further token, or if the
+ * remainder of the line is a comment.
+ */
+static bool nextOBJToken( const char*& cursor, const char*& tokenEnd, const char* lineEnd )
+{
+    while( cursor != lineEnd && isOBJWhitespace( *cursor ) )
+    {
+        ++cursor;
+    }
+    tokenEnd = cursor;
+    while( tokenEnd != lineEnd && !isOBJWhitespace( *tokenEnd ) )
+    {
+        ++tokenEnd;
+    }
+    return cursor != lineEnd && *cursor != '#';
+}
+
+
+static bool isOBJToken( const char* first, const char* last, const char* literal )
+{
+    const std::size_t length = std::strlen( literal );
+    return static_cast< std::size_t >( last - first ) == length && std::memcmp( first, literal, length ) == 0;
+}
+
+
+/* Resolves the one-based or, if negative, relative 'index' w.r.t. 'count'. The
+ * range is validated later, since absolute indices may be forward references.
+ */
+static uint32_t resolveOBJIndex( int64_t index, std::size_t count )
+{
+    const int64_t resolved = index > 0 ? index - 1 : static_cast< int64_t >( count ) + index;
+    LIBCARNA_ASSERT_EX( index != 0 && resolved >= 0 && resolved < std::numeric_limits< uint32_t >::max(), "OBJ face references an invalid vertex!" );
+    return static_cast< uint32_t >( resolved );
+}
+
+
+static uint32_t hashOBJCorner( uint64_t key )
+{
+    /* Finalizer of MurmurHash3 for 64-bit keys.
+     */
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDull;
+    key ^= key >> 33;
+    key *= 0xC4CEB9FE1A85EC53ull;
+    key ^= key >> 33;
+    return static_cast< uint32_t >( key );
+}
+
+
+
+// ----------------------------------------------------------------------------------
+// OBJReader :: Details
+// ----------------------------------------------------------------------------------
+
+struct OBJReader::Details
+{
+    Details();
+
+    /* The positions, normals and colors, as they are defined by the statements.
+     */
+    std::vector< math::Vector3f > definedPositions;
+    std::vector< math::Vector3f > definedNormals;
+    std::vector< math::Vector4f > definedColors;
+
+    /* Until the first corner that references a normal is read, the vertices are
+     * the positions and the indices refer to them directly. Afterwards, corners
+     * with equal indices of position and normal are merged into vertices, that are
+     * identified by 'vertexKeys', using a flat hash table with open addressing.
+     * Each slot holds the index of a vertex plus one, or zero if it is empty.
+     */
+    bool hasCornerNormals;
+    std::vector< uint64_t > vertexKeys;
+    std::vector< uint32_t > vertexTable;
+
+    std::vector< math::Vector3f > positions;
+    std::vector< math::Vector3f > normals;
+    std::vector< math::Vector4f > colors;
+    std::vector< uint32_t > indices;
+
+    void clear();
+
+    void readPosition( const char* cursor, const char* lineEnd );
+    void readNormal( const char* cursor, const char* lineEnd );
+    void readFace( const char* cursor, const char* lineEnd );
+    uint32_t readCorner( const char* first, const char* last );
+
+    uint32_t mergeCorner( uint32_t position, uint32_t normal );
+    void growVertexTable();
+
+    void createVertices();
+};
+
+
+OBJReader::Details::Details()
+    : hasCornerNormals( false )
+{
+}
+
+
+void OBJReader::Details::clear()
+{
+    definedPositions.clear();
+    definedNormals.clear();
+    definedColors.clear();
+    hasCornerNormals = false;
+    vertexKeys.clear();
+    vertexTable.clear();
+    positions.clear();
+    normals.clear();
+    colors.clear();
+    indices.clear();
+}
+
+
+void OBJReader::Details::readPosition( const char* cursor, const char* lineEnd )
+{
+    float values[ 7 ];
+    unsigned int valuesCount = 0;
+    for( const char* tokenEnd; nextOBJToken( cursor, tokenEnd, lineEnd ); cursor = tokenEnd )
+    {
+        double value;
+        const bool isValid = valuesCount < 7 && text::parseDouble( cursor, tokenEnd, value );
+        LIBCARNA_ASSERT_EX( isValid, "Malformed OBJ vertex!" );
+        values[ valuesCount++ ] = static_cast< float >( value );
+    }
+    LIBCARNA_ASSERT_EX( valuesCount == 3 || valuesCount == 4 || valuesCount == 6 || valuesCount == 7, "Malformed OBJ vertex!" );
+    definedPositions.push_back( math::Vector3f( values[ 0 ], values[ 1 ], values[ 2 ] ) );
+
+    /* Six components denote a position and color, seven components additionally
+     * have the alpha value.
+     */
+    if( valuesCount >= 6 )
+    {
+        definedColors.resize( definedPositions.size() - 1, math::Vector4f( 1, 1, 1, 1 ) );
+        definedColors.push_back( math::Vector4f( values[ 3 ], values[ 4 ], values[ 5 ], valuesCount == 7 ? values[ 6 ] : 1 ) );
+    }
+}
+
+
+void OBJReader::Details::readNormal( const char* cursor, const char* lineEnd )
+{
+    float values[ 3 ];
+    unsigned int valuesCount = 0;
+    for( const char* tokenEnd; nextOBJToken( cursor, tokenEnd, lineEnd ); cursor = tokenEnd )
+    {
+        double value;
+        const bool isValid = valuesCount < 3 && text::parseDouble( cursor, tokenEnd, value );
+        LIBCARNA_ASSERT_EX( isValid, "Malformed OBJ normal!" );
+        values[ valuesCount++ ] = static_cast< float >( value );
+    }
+    LIBCARNA_ASSERT_EX( valuesCount == 3, "Malformed OBJ normal!" );
+    definedNormals.push_back( math::Vector3f( values[ 0 ], values[ 1 ], values[ 2 ] ) );
+}
+
+
+uint32_t OBJReader::Details::readCorner( const char* first, const char* last )
+{
+    /* Corners are given as 'v', 'v/vt', 'v//vn' or 'v/vt/vn'.
+     */
+    const char* const positionEnd = std::find( first, last, '/' );
+    const char* const texCoordEnd = positionEnd == last ? last : std::find( positionEnd + 1, last, '/' );
+    int64_t index;
+    LIBCARNA_ASSERT_EX( text::parseInt( first, positionEnd, index ), "Malformed OBJ face!" );
+    const uint32_t position = resolveOBJIndex( index, definedPositions.size() );
+
+    uint32_t normal = OBJ_NO_NORMAL;
+    if( texCoordEnd != last && texCoordEnd + 1 != last )
+    {
+        LIBCARNA_ASSERT_EX( text::parseInt( texCoordEnd + 1, last, index ), "Malformed OBJ face!" );
+        normal = resolveOBJIndex( index, definedNormals.size() );
+    }
+    return mergeCorner( position, normal );
+}
+
+
+uint32_t OBJReader::Details::mergeCorner( uint32_t position, uint32_t normal )
+{
+    if( !hasCornerNormals )
+    {
+        if( normal == OBJ_NO_NORMAL )
+        {
+            return position;
+        }
+
+        /* This is the first corner that references a normal, so the corners read
+         * so far must be merged, now that their indices no longer are the vertices.
+         */
+        hasCornerNormals = true;
+        vertexTable.assign( OBJ_MIN_TABLE_SIZE, 0 );
+        for( std::size_t cornerIndex = 0; cornerIndex < indices.size(); ++cornerIndex )
+        {
+            indices[ cornerIndex ] = mergeCorner( indices[ cornerIndex ], OBJ_NO_NORMAL );
+        }
+    }
+
+    const uint64_t key = ( static_cast< uint64_t >( position ) << 32 ) | normal;
+    const std::size_t mask = vertexTable.size() - 1;
+    for( std::size_t slot = hashOBJCorner( key ) & mask;; slot = ( slot + 1 ) & mask )
+    {
+        const uint32_t entry = vertexTable[ slot ];
+        if( entry == 0 )
+        {
+            vertexKeys.push_back( key );
+            vertexTable[ slot ] = static_cast< uint32_t >( vertexKeys.size() );
+            if( vertexKeys.size() * 2 > vertexTable.size() )
+            {
+                growVertexTable();
+            }
+            return static_cast< uint32_t >( vertexKeys.size() - 1 );
+        }
+        if( vertexKeys[ entry - 1 ] == key )
+        {
+            return entry - 1;
+        }
+    }
+}
+
+
+void OBJReader::Details::growVertexTable()
+{
+    /* Keep the table at most half full.
+     */
+    vertexTable.assign( vertexTable.size() * 2, 0 );
+    const std::size_t mask = vertexTable.size() - 1;
+    for( std::size_t vertexIndex = 0; vertexIndex < vertexKeys.size(); ++vertexIndex )
+    {
+        std::size_t slot = hashOBJCorner( vertexKeys[ vertexIndex ] ) & mask;
+        while( vertexTable[ slot ] != 0 )
+        {
+            slot = ( slot + 1 ) & mask;
+        }
+        vertexTable[ slot ] = static_cast< uint32_t >( vertexIndex + 1 );
+    }
+}
+
+
+void OBJReader::Details::readFace( const char* cursor, const char* lineEnd )
+{
+    /* Split the polygon into a triangle fan.
+     */
+    uint32_t firstVertex = 0, previousVertex = 0;
+    unsigned int cornersCount = 0;
+    for( const char* tokenEnd; nextOBJToken( cursor, tokenEnd, lineEnd ); cursor = tokenEnd, ++cornersCount )
+    {
+        const uint32_t vertex = readCorner( cursor, tokenEnd );
+        if( cornersCount == 0 )
+        {
+            firstVertex = vertex;
+        }
+        else
+        if( cornersCount >= 2 )
+        {
+            indices.push_back( firstVertex );
+            indices.push_back( previousVertex );
+            indices.push_back( vertex );
+        }
+        previousVertex = vertex;
+    }
+    LIBCARNA_ASSERT_EX( cornersCount >= 3, "OBJ face has less than three vertices!" );
+}
+
+
+void OBJReader::Details::createVertices()
+{
+    const std::size_t positionsCount = definedPositions.size();
+    if( !definedColors.empty() )
+    {
+        definedColors.resize( positionsCount, math::Vector4f( 1, 1, 1, 1 ) );
+    }
+
+    /* Without normals, the vertices are the positions.
+     */
+    if( !hasCornerNormals )
+    {
+        for( std::size_t cornerIndex = 0; cornerIndex < indices.size(); ++cornerIndex )
+        {
+            LIBCARNA_ASSERT_EX( indices[ cornerIndex ] < positionsCount, "OBJ face references an invalid vertex!" );
+        }
+        positions.swap( definedPositions );
+        colors.swap( definedColors );
+        return;
+    }
+
+    /* Otherwise, the vertices are the merged corners.
+     */
+    positions.reserve( vertexKeys.size() );
+    normals  .reserve( vertexKeys.size() );
+    for( std::size_t vertexIndex = 0; vertexIndex < vertexKeys.size(); ++vertexIndex )
+    {
+        const uint32_t position = static_cast< uint32_t >( vertexKeys[ vertexIndex ] >> 32 );
+        const uint32_t normal   = static_cast< uint32_t >( vertexKeys[ vertexIndex ] );
+        const bool isValid = position < positionsCount && ( normal == OBJ_NO_NORMAL || normal < definedNormals.size() );
+        LIBCARNA_ASSERT_EX( isValid, "OBJ face references an invalid vertex!" );
+        positions.push_back( definedPositions[ position ] );
+        normals.push_back( normal == OBJ_NO_NORMAL ? math::Vector3f( 0, 0, 0 ) : definedNormals[ normal ] );
+        if( !definedColors.empty() )
+        {
+            colors.push_back( definedColors[ position ] );
+        }
+    }
+}
+
+
+
+// ----------------------------------------------------------------------------------
+// OBJReader
+// ----------------------------------------------------------------------------------
+
+OBJReader::OBJReader()
+    : pimpl( new Details() )
+{
+}
+
+
+OBJReader::~OBJReader()
+{
+}
+
+
+void OBJReader::read( const char* data, std::size_t size )
+{
+    pimpl->clear();
+
+    const char* const end = data + size;
+    for( const char* lineBegin = data; lineBegin != end; )
+    {
+        const char* const lineEnd = std::find( lineBegin, end, '\n' );
+        const char* cursor = lineBegin;
+        const char* tokenEnd;
+        if( nextOBJToken( cursor, tokenEnd, lineEnd ) )
+        {
+            if( isOBJToken( cursor, tokenEnd, "v" ) )
+            {
+                pimpl->readPosition( tokenEnd, lineEnd );
+            }
+            else
+            if( isOBJToken( cursor, tokenEnd, "vn" ) )
+            {
+                pimpl->readNormal( tokenEnd, lineEnd );
+            }
+            else
+            if( isOBJToken( cursor, tokenEnd, "f" ) )
+            {
+                pimpl->readFace( tokenEnd, lineEnd );
+            }
+
+            /* Texture coordinates, groups, materials and other statements are
+             * skipped.
+             */
+        }
+        lineBegin = lineEnd == end ? end : lineEnd + 1;
+    }
+
+    pimpl->createVertices();
+}
+
+
+void OBJReader::read( std::istream& stream )
+{
+    std::vector< char > buffer;
+    text::readAll( stream, buffer );
+    read( buffer.empty() ? nullptr : &buffer[ 0 ], buffer.size() );
+}
+
+
+void OBJReader::read( const std::string& path )
+{
+    std::ifstream stream( path, std::ios::in | std::ios::binary );
+    LIBCARNA_ASSERT_EX( stream.is_open(), "Failed to open OBJ file: " << path );
+    read( stream );
+}
+
+
+std::size_t OBJReader::trianglesCount() const
+{
+    return pimpl->indices.size() / 3;
+}
+
+
+const std::vector< math::Vector3f >& OBJReader::positions() const
+{
+    return pimpl->positions;
+}
+
+
+const std::vector< math::Vector3f >& OBJReader::normals() const
+{
+    return pimpl->normals;
+}
+
+
+const std::vector< math::Vector4f >& OBJReader::colors() const
+{
+    return pimpl->colors;
+}
+
+
+const std::vector< uint32_t >& OBJReader::indices() const
+{
+    return pimpl->indices;
+}
+
+
+
+}  // namespace LibCarna :: base
+
+}  // namespace LibCarna
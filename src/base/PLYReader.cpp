@@ -0,0 +1,613 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#include <LibCarna/base/PLYReader.hpp>
+#include <LibCarna/base/LibCarnaException.hpp>
+#include <LibCarna/base/text.hpp>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace LibCarna
+{
+
+namespace base
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// Types & Globals
+// ----------------------------------------------------------------------------------
+
+static bool isPLYWhitespace( char c )
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+
+/* Advances 'cursor' to the beginning of the next token and 'tokenEnd' to its end.
+ * Returns 'false' if there is no further token.
+ */
+static bool nextPLYToken( const char*& cursor, const char*& tokenEnd, const char* end )
+{
+    while( cursor != end && isPLYWhitespace( *cursor ) )
+    {
+        ++cursor;
+    }
+    tokenEnd = cursor;
+    while( tokenEnd != end && !isPLYWhitespace( *tokenEnd ) )
+    {
+        ++tokenEnd;
+    }
+    return cursor != end;
+}
+
+
+static bool isPLYToken( const char* first, const char* last, const char* literal )
+{
+    const std::size_t length = std::strlen( literal );
+    return static_cast< std::size_t >( last - first ) == length && std::memcmp( first, literal, length ) == 0;
+}
+
+
+template< typename ValueType >
+static double decodePLYValue( const unsigned char* bytes )
+{
+    ValueType value;
+    std::memcpy( &value, bytes, sizeof( ValueType ) );
+    return static_cast< double >( value );
+}
+
+
+
+// ----------------------------------------------------------------------------------
+// PLYReader :: Details
+// ----------------------------------------------------------------------------------
+
+struct PLYReader::Details
+{
+    enum Format
+    {
+        ascii,
+        binaryLittleEndian,
+        binaryBigEndian
+    };
+
+    enum Type
+    {
+        int8, uint8, int16, uint16, int32, uint32, float32, float64
+    };
+
+    struct Property
+    {
+        std::string name;
+        Type type;
+        bool isList;
+        Type countType;
+    };
+
+    struct Element
+    {
+        std::string name;
+        std::size_t count;
+        std::vector< Property > properties;
+    };
+
+    Details();
+
+    Format format;
+    std::vector< Element > elements;
+    std::size_t verticesCount;
+
+    /* Position of the decoding within the body of the data.
+     */
+    const char* cursor;
+    const char* end;
+
+    std::vector< math::Vector3f > positions;
+    std::vector< math::Vector3f > normals;
+    std::vector< math::Vector4f > colors;
+    std::vector< uint32_t > indices;
+
+    static bool parseType( const char* first, const char* last, Type& type );
+    static std::size_t sizeOf( Type type );
+
+    void readHeader( const char* data, std::size_t size );
+    double readValue( Type type );
+    uint32_t readIndex( Type type );
+
+    void readVertices( const Element& element );
+    void readFaces( const Element& element );
+    void skipElement( const Element& element );
+};
+
+
+PLYReader::Details::Details()
+    : format( ascii )
+    , verticesCount( 0 )
+    , cursor( nullptr )
+    , end( nullptr )
+{
+}
+
+
+bool PLYReader::Details::parseType( const char* first, const char* last, Type& type )
+{
+    if( isPLYToken( first, last, "char"   ) || isPLYToken( first, last, "int8"    ) ) { type = int8;    return true; }
+    if( isPLYToken( first, last, "uchar"  ) || isPLYToken( first, last, "uint8"   ) ) { type = uint8;   return true; }
+    if( isPLYToken( first, last, "short"  ) || isPLYToken( first, last, "int16"   ) ) { type = int16;   return true; }
+    if( isPLYToken( first, last, "ushort" ) || isPLYToken( first, last, "uint16"  ) ) { type = uint16;  return true; }
+    if( isPLYToken( first, last, "int"    ) || isPLYToken( first, last, "int32"   ) ) { type = int32;   return true; }
+    if( isPLYToken( first, last, "uint"   ) || isPLYToken( first, last, "uint32"  ) ) { type = uint32;  return true; }
+    if( isPLYToken( first, last, "float"  ) || isPLYToken( first, last, "float32" ) ) { type = float32; return true; }
+    if( isPLYToken( first, last, "double" ) || isPLYToken( first, last, "float64" ) ) { type = float64; return true; }
+    return false;
+}
+
+
+std::size_t PLYReader::Details::sizeOf( Type type )
+{
+    switch( type )
+    {
+        case int8   : case uint8  : return 1;
+        case int16  : case uint16 : return 2;
+        case int32  : case uint32 : case float32: return 4;
+        case float64: return 8;
+        default: LIBCARNA_FAIL( "Unknown PLY type." );
+    }
+}
+
+
+void PLYReader::Details::readHeader( const char* data, std::size_t size )
+{
+    end = data + size;
+    elements.clear();
+    verticesCount = 0;
+
+    const char* lineBegin = data;
+    bool isFirstLine = true;
+    bool hasFormat = false;
+    for( ;; )
+    {
+        LIBCARNA_ASSERT_EX( lineBegin != end, "PLY header is incomplete!" );
+        const char* const lineEnd = std::find( lineBegin, end, '\n' );
+        const char* token = lineBegin;
+        const char* tokenEnd;
+        const bool isEmpty = !nextPLYToken( token, tokenEnd, lineEnd );
+        lineBegin = lineEnd == end ? end : lineEnd + 1;
+
+        if( isFirstLine )
+        {
+            LIBCARNA_ASSERT_EX( !isEmpty && isPLYToken( token, tokenEnd, "ply" ), "Data is not PLY!" );
+            isFirstLine = false;
+            continue;
+        }
+        if( isEmpty )
+        {
+            continue;
+        }
+
+        if( isPLYToken( token, tokenEnd, "end_header" ) )
+        {
+            break;
+        }
+        else
+        if( isPLYToken( token, tokenEnd, "format" ) )
+        {
+            token = tokenEnd;
+            nextPLYToken( token, tokenEnd, lineEnd );
+            if( isPLYToken( token, tokenEnd, "ascii" ) )
+            {
+                format = ascii;
+            }
+            else
+            if( isPLYToken( token, tokenEnd, "binary_little_endian" ) )
+            {
+                format = binaryLittleEndian;
+            }
+            else
+            if( isPLYToken( token, tokenEnd, "binary_big_endian" ) )
+            {
+                format = binaryBigEndian;
+            }
+            else
+            {
+                LIBCARNA_FAIL( "Unknown PLY format!" );
+            }
+            hasFormat = true;
+        }
+        else
+        if( isPLYToken( token, tokenEnd, "element" ) )
+        {
+            Element element;
+            token = tokenEnd;
+            LIBCARNA_ASSERT_EX( nextPLYToken( token, tokenEnd, lineEnd ), "Malformed PLY element!" );
+            element.name.assign( token, tokenEnd );
+            token = tokenEnd;
+            int64_t count;
+            const bool isValid = nextPLYToken( token, tokenEnd, lineEnd ) && text::parseInt( token, tokenEnd, count ) && count >= 0;
+            LIBCARNA_ASSERT_EX( isValid, "Malformed PLY element!" );
+            element.count = static_cast< std::size_t >( count );
+            elements.push_back( element );
+        }
+        else
+        if( isPLYToken( token, tokenEnd, "property" ) )
+        {
+            LIBCARNA_ASSERT_EX( !elements.empty(), "PLY property precedes the first element!" );
+            Property property;
+            token = tokenEnd;
+            LIBCARNA_ASSERT_EX( nextPLYToken( token, tokenEnd, lineEnd ), "Malformed PLY property!" );
+            property.isList = isPLYToken( token, tokenEnd, "list" );
+            if( property.isList )
+            {
+                token = tokenEnd;
+                const bool isValid = nextPLYToken( token, tokenEnd, lineEnd ) && parseType( token, tokenEnd, property.countType );
+                LIBCARNA_ASSERT_EX( isValid, "Malformed PLY property!" );
+                token = tokenEnd;
+                nextPLYToken( token, tokenEnd, lineEnd );
+            }
+            else
+            {
+                property.countType = uint8;
+            }
+            LIBCARNA_ASSERT_EX( parseType( token, tokenEnd, property.type ), "Malformed PLY property!" );
+            token = tokenEnd;
+            LIBCARNA_ASSERT_EX( nextPLYToken( token, tokenEnd, lineEnd ), "Malformed PLY property!" );
+            property.name.assign( token, tokenEnd );
+            elements.back().properties.push_back( property );
+        }
+
+        /* Comments and other statements, like 'obj_info', are skipped.
+         */
+    }
+
+    LIBCARNA_ASSERT_EX( hasFormat, "PLY header lacks the format!" );
+    for( auto elementItr = elements.begin(); elementItr != elements.end(); ++elementItr )
+    {
+        if( elementItr->name == "vertex" )
+        {
+            verticesCount = elementItr->count;
+        }
+    }
+    LIBCARNA_ASSERT_EX( verticesCount <= std::numeric_limits< uint32_t >::max(), "PLY data has too many vertices!" );
+    cursor = lineBegin;
+}
+
+
+double PLYReader::Details::readValue( Type type )
+{
+    if( format == ascii )
+    {
+        const char* tokenEnd;
+        double value;
+        const bool isValid = nextPLYToken( cursor, tokenEnd, end ) && text::parseDouble( cursor, tokenEnd, value );
+        LIBCARNA_ASSERT_EX( isValid, "Malformed value in ASCII PLY data!" );
+        cursor = tokenEnd;
+        return value;
+    }
+
+    const std::size_t size = sizeOf( type );
+    LIBCARNA_ASSERT_EX( static_cast< std::size_t >( end - cursor ) >= size, "PLY data is truncated!" );
+    unsigned char bytes[ 8 ];
+    std::memcpy( bytes, cursor, size );
+    cursor += size;
+
+    /* The platforms supported are little-endian.
+     */
+    if( format == binaryBigEndian )
+    {
+        std::reverse( bytes, bytes + size );
+    }
+
+    switch( type )
+    {
+        case int8   : return decodePLYValue< int8_t   >( bytes );
+        case uint8  : return decodePLYValue< uint8_t  >( bytes );
+        case int16  : return decodePLYValue< int16_t  >( bytes );
+        case uint16 : return decodePLYValue< uint16_t >( bytes );
+        case int32  : return decodePLYValue< int32_t  >( bytes );
+        case uint32 : return decodePLYValue< uint32_t >( bytes );
+        case float32: return decodePLYValue< float    >( bytes );
+        case float64: return decodePLYValue< double   >( bytes );
+        default: LIBCARNA_FAIL( "Unknown PLY type." );
+    }
+}
+
+
+uint32_t PLYReader::Details::readIndex( Type type )
+{
+    const double index = readValue( type );
+    LIBCARNA_ASSERT_EX( index >= 0 && index < verticesCount && index == static_cast< uint32_t >( index ), "PLY face references an invalid vertex!" );
+    return static_cast< uint32_t >( index );
+}
+
+
+void PLYReader::Details::readVertices( const Element& element )
+{
+    /* Map the properties to the attributes, i.e. the position (0 to 2), normal
+     * (3 to 5) and color (6 to 9). Unknown properties are mapped to -1.
+     */
+    const static char* const ATTRIBUTE_NAMES[] = { "x", "y", "z", "nx", "ny", "nz", "red", "green", "blue", "alpha" };
+    std::vector< int > attributes( element.properties.size(), -1 );
+    std::vector< double > scales( element.properties.size(), 1 );
+    bool hasNormals = false;
+    bool hasColors  = false;
+    for( std::size_t propertyIndex = 0; propertyIndex < element.properties.size(); ++propertyIndex )
+    {
+        const Property& property = element.properties[ propertyIndex ];
+        if( property.isList )
+        {
+            continue;
+        }
+        for( int attribute = 0; attribute < 10; ++attribute )
+        {
+            if( property.name == ATTRIBUTE_NAMES[ attribute ] )
+            {
+                attributes[ propertyIndex ] = attribute;
+                hasNormals = hasNormals || ( attribute >= 3 && attribute < 6 );
+                hasColors  = hasColors  || attribute >= 6;
+            }
+        }
+
+        /* Integral color components range from zero to the maximum of their type.
+         */
+        switch( property.type )
+        {
+            case uint8 : scales[ propertyIndex ] = 1. / std::numeric_limits< uint8_t  >::max(); break;
+            case uint16: scales[ propertyIndex ] = 1. / std::numeric_limits< uint16_t >::max(); break;
+            case uint32: scales[ propertyIndex ] = 1. / std::numeric_limits< uint32_t >::max(); break;
+            case int8  : scales[ propertyIndex ] = 1. / std::numeric_limits<  int8_t  >::max(); break;
+            case int16 : scales[ propertyIndex ] = 1. / std::numeric_limits<  int16_t >::max(); break;
+            case int32 : scales[ propertyIndex ] = 1. / std::numeric_limits<  int32_t >::max(); break;
+            default: break;
+        }
+    }
+
+    /* Each vertex takes at least one byte, so that a malformed count is detected
+     * before allocating.
+     */
+    LIBCARNA_ASSERT_EX( element.properties.empty() || static_cast< std::size_t >( end - cursor ) >= element.count, "PLY data is truncated!" );
+
+    positions.resize( element.count );
+    normals.resize( hasNormals ? element.count : 0 );
+    colors .resize( hasColors  ? element.count : 0 );
+
+    for( std::size_t vertexIndex = 0; vertexIndex < element.count; ++vertexIndex )
+    {
+        float values[ 10 ] = { 0, 0, 0, 0, 0, 0, 1, 1, 1, 1 };
+        for( std::size_t propertyIndex = 0; propertyIndex < element.properties.size(); ++propertyIndex )
+        {
+            const Property& property = element.properties[ propertyIndex ];
+            if( property.isList )
+            {
+                const std::size_t count = static_cast< std::size_t >( readValue( property.countType ) );
+                for( std::size_t i = 0; i < count; ++i )
+                {
+                    readValue( property.type );
+                }
+                continue;
+            }
+            const double value = readValue( property.type );
+            const int attribute = attributes[ propertyIndex ];
+            if( attribute >= 0 )
+            {
+                values[ attribute ] = static_cast< float >( attribute >= 6 ? value * scales[ propertyIndex ] : value );
+            }
+        }
+
+        positions[ vertexIndex ] = math::Vector3f( values[ 0 ], values[ 1 ], values[ 2 ] );
+        if( hasNormals )
+        {
+            normals[ vertexIndex ] = math::Vector3f( values[ 3 ], values[ 4 ], values[ 5 ] );
+        }
+        if( hasColors )
+        {
+            colors[ vertexIndex ] = math::Vector4f( values[ 6 ], values[ 7 ], values[ 8 ], values[ 9 ] );
+        }
+    }
+}
+
+
+void PLYReader::Details::readFaces( const Element& element )
+{
+    LIBCARNA_ASSERT_EX( element.properties.empty() || static_cast< std::size_t >( end - cursor ) >= element.count, "PLY data is truncated!" );
+    indices.reserve( indices.size() + element.count * 3 );
+    bool hasIndices = false;
+    for( std::size_t faceIndex = 0; faceIndex < element.count; ++faceIndex )
+    {
+        for( auto propertyItr = element.properties.begin(); propertyItr != element.properties.end(); ++propertyItr )
+        {
+            const Property& property = *propertyItr;
+            if( !property.isList )
+            {
+                readValue( property.type );
+                continue;
+            }
+            const std::size_t count = static_cast< std::size_t >( readValue( property.countType ) );
+            if( property.name != "vertex_indices" && property.name != "vertex_index" )
+            {
+                for( std::size_t i = 0; i < count; ++i )
+                {
+                    readValue( property.type );
+                }
+                continue;
+            }
+            hasIndices = true;
+
+            /* Split the polygon into a triangle fan. Faces with less than three
+             * vertices are skipped.
+             */
+            uint32_t first = 0;
+            uint32_t previous = 0;
+            for( std::size_t i = 0; i < count; ++i )
+            {
+                const uint32_t index = readIndex( property.type );
+                if( i == 0 )
+                {
+                    first = index;
+                }
+                else
+                if( i >= 2 )
+                {
+                    indices.push_back( first );
+                    indices.push_back( previous );
+                    indices.push_back( index );
+                }
+                previous = index;
+            }
+        }
+    }
+    LIBCARNA_ASSERT_EX( hasIndices || element.count == 0, "PLY faces lack vertex indices!" );
+}
+
+
+void PLYReader::Details::skipElement( const Element& element )
+{
+    /* Elements of fixed size can be skipped at once in binary data.
+     */
+    if( format != ascii )
+    {
+        std::size_t size = 0;
+        for( auto propertyItr = element.properties.begin(); propertyItr != element.properties.end(); ++propertyItr )
+        {
+            if( propertyItr->isList )
+            {
+                size = 0;
+                break;
+            }
+            size += sizeOf( propertyItr->type );
+        }
+        if( size > 0 )
+        {
+            LIBCARNA_ASSERT_EX( static_cast< std::size_t >( end - cursor ) / size >= element.count, "PLY data is truncated!" );
+            cursor += size * element.count;
+            return;
+        }
+    }
+
+    for( std::size_t itemIndex = 0; itemIndex < element.count; ++itemIndex )
+    {
+        for( auto propertyItr = element.properties.begin(); propertyItr != element.properties.end(); ++propertyItr )
+        {
+            const std::size_t count = propertyItr->isList ? static_cast< std::size_t >( readValue( propertyItr->countType ) ) : 1;
+            for( std::size_t i = 0; i < count; ++i )
+            {
+                readValue( propertyItr->type );
+            }
+        }
+    }
+}
+
+
+
+// ----------------------------------------------------------------------------------
+// PLYReader
+// ----------------------------------------------------------------------------------
+
+PLYReader::PLYReader()
+    : pimpl( new Details() )
+{
+}
+
+
+PLYReader::~PLYReader()
+{
+}
+
+
+void PLYReader::read( const char* data, std::size_t size )
+{
+    pimpl->positions.clear();
+    pimpl->normals.clear();
+    pimpl->colors.clear();
+    pimpl->indices.clear();
+
+    pimpl->readHeader( data, size );
+    for( auto elementItr = pimpl->elements.begin(); elementItr != pimpl->elements.end(); ++elementItr )
+    {
+        if( elementItr->name == "vertex" )
+        {
+            pimpl->readVertices( *elementItr );
+        }
+        else
+        if( elementItr->name == "face" )
+        {
+            pimpl->readFaces( *elementItr );
+        }
+        else
+        {
+            pimpl->skipElement( *elementItr );
+        }
+    }
+}
+
+
+void PLYReader::read( std::istream& stream )
+{
+    std::vector< char > buffer;
+    text::readAll( stream, buffer );
+    read( buffer.empty() ? nullptr : &buffer[ 0 ], buffer.size() );
+}
+
+
+void PLYReader::read( const std::string& path )
+{
+    std::ifstream stream( path, std::ios::in | std::ios::binary );
+    LIBCARNA_ASSERT_EX( stream.is_open(), "Failed to open PLY file: " << path );
+    read( stream );
+}
+
+
+bool PLYReader::isBinary() const
+{
+    return pimpl->format != Details::ascii;
+}
+
+
+std::size_t PLYReader::trianglesCount() const
+{
+    return pimpl->indices.size() / 3;
+}
+
+
+const std::vector< math::Vector3f >& PLYReader::positions() const
+{
+    return pimpl->positions;
+}
+
+
+const std::vector< math::Vector3f >& PLYReader::normals() const
+{
+    return pimpl->normals;
+}
+
+
+const std::vector< math::Vector4f >& PLYReader::colors() const
+{
+    return pimpl->colors;
+}
+
+
+const std::vector< uint32_t >& PLYReader::indices() const
+{
+    return pimpl->indices;
+}
+
+
+
+}  // namespace LibCarna :: base
+
+}  // namespace LibCarna
@@ -0,0 +1,240 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#include <LibCarna/base/RenderQueue.hpp>
+#include <numeric>
+#include <algorithm>
+
+namespace LibCarna
+{
+
+namespace base
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// Types & Globals
+// ----------------------------------------------------------------------------------
+
+/* Below this number of renderables, the overhead of spawning threads outweighs the
+ * benefit.
+ */
+const static std::ptrdiff_t PARALLEL_RENDERABLES_THRESHOLD = 1024;
+
+/* The number of renderables, that are sorted by a single thread before the sorted
+ * blocks are merged. It is fixed, so that the result does not depend on the
+ * number of threads.
+ */
+const static std::size_t SORT_BLOCK_SIZE = 2048;
+
+
+/* Moves the renderable from position order[i] to position i, for each i. The
+ * order is reset to identity.
+ */
+static void permuteRenderables( std::vector< Renderable >& renderables, std::vector< std::size_t >& order )
+{
+    const std::size_t count = renderables.size();
+
+    /* Permute the renderables in-place by following the cycles of the permutation,
+     * so that no renderables need to be allocated.
+     */
+    Renderable temporary( renderables[ 0 ] );
+    for( std::size_t start = 0; start < count; ++start )
+    {
+        if( order[ start ] == start )
+        {
+            continue;
+        }
+        temporary = renderables[ start ];
+        std::size_t position = start;
+        while( order[ position ] != start )
+        {
+            const std::size_t next = order[ position ];
+            renderables[ position ] = renderables[ next ];
+            order[ position ] = position;
+            position = next;
+        }
+        renderables[ position ] = temporary;
+        order[ position ] = position;
+    }
+}
+
+
+
+// ----------------------------------------------------------------------------------
+// sortRenderablesByKeys
+// ----------------------------------------------------------------------------------
+
+void sortRenderablesByKeys( std::vector< Renderable >& renderables, const std::vector< std::uint64_t >& keys )
+{
+    LIBCARNA_ASSERT( renderables.size() == keys.size() );
+    const std::size_t count = renderables.size();
+    if( count < 2 )
+    {
+        return;
+    }
+
+    /* Compute the histograms of all eight 8-bit digits within a single pass.
+     */
+    const unsigned int digitsCount = 8;
+    const unsigned int radix = 256;
+    std::vector< std::size_t > histograms( digitsCount * radix, 0 );
+    for( std::size_t index = 0; index < count; ++index )
+    {
+        for( unsigned int digit = 0; digit < digitsCount; ++digit )
+        {
+            ++histograms[ digit * radix + ( ( keys[ index ] >> ( 8 * digit ) ) & 0xFF ) ];
+        }
+    }
+
+    /* Order the indices of the renderables by their keys, least significant digit
+     * first. Each pass is stable. Digits, that are the same for all keys, are
+     * skipped.
+     */
+    std::vector< std::size_t > order( count );
+    std::vector< std::size_t > buffer( count );
+    std::iota( order.begin(), order.end(), 0 );
+    for( unsigned int digit = 0; digit < digitsCount; ++digit )
+    {
+        const std::size_t* const histogram = &histograms[ digit * radix ];
+        const unsigned int shift = 8 * digit;
+        if( histogram[ ( keys[ 0 ] >> shift ) & 0xFF ] == count )
+        {
+            continue;
+        }
+        std::size_t offsets[ radix ];
+        std::size_t offset = 0;
+        for( unsigned int bucket = 0; bucket < radix; ++bucket )
+        {
+            offsets[ bucket ] = offset;
+            offset += histogram[ bucket ];
+        }
+        for( std::size_t position = 0; position < count; ++position )
+        {
+            const std::size_t index = order[ position ];
+            buffer[ offsets[ ( keys[ index ] >> shift ) & 0xFF ]++ ] = index;
+        }
+        order.swap( buffer );
+    }
+
+    permuteRenderables( renderables, order );
+}
+
+
+
+// ----------------------------------------------------------------------------------
+// sortRenderables
+// ----------------------------------------------------------------------------------
+
+void sortRenderables
+    ( std::vector< Renderable >& renderables
+    , const std::function< bool( const Renderable&, const Renderable& ) >& less )
+{
+    const std::size_t count = renderables.size();
+    if( count < 2 )
+    {
+        return;
+    }
+
+    /* Sort the indices of the renderables instead of the renderables, so that no
+     * renderables need to be copied. Equivalent renderables are ordered by their
+     * indices, what makes the order strict and total.
+     */
+    const auto compare = [ &renderables, &less ]( std::size_t l, std::size_t r )
+    {
+        if( less( renderables[ l ], renderables[ r ] ) )
+        {
+            return true;
+        }
+        else
+        if( less( renderables[ r ], renderables[ l ] ) )
+        {
+            return false;
+        }
+        else
+        {
+            return l < r;
+        }
+    };
+    std::vector< std::size_t > order( count );
+    std::iota( order.begin(), order.end(), 0 );
+
+    /* Sort the blocks.
+     */
+    const std::ptrdiff_t blocksCount = static_cast< std::ptrdiff_t >( ( count + SORT_BLOCK_SIZE - 1 ) / SORT_BLOCK_SIZE );
+    #pragma omp parallel for if( blocksCount > 1 )
+    for( std::ptrdiff_t blockIndex = 0; blockIndex < blocksCount; ++blockIndex )
+    {
+        const std::size_t first = blockIndex * SORT_BLOCK_SIZE;
+        const std::size_t last  = std::min( first + SORT_BLOCK_SIZE, count );
+        std::sort( order.begin() + first, order.begin() + last, compare );
+    }
+
+    /* Merge the sorted blocks pairwise, until a single block remains.
+     */
+    for( std::size_t width = SORT_BLOCK_SIZE; width < count; width *= 2 )
+    {
+        const std::ptrdiff_t mergesCount = static_cast< std::ptrdiff_t >( ( count + 2 * width - 1 ) / ( 2 * width ) );
+        #pragma omp parallel for if( mergesCount > 1 )
+        for( std::ptrdiff_t mergeIndex = 0; mergeIndex < mergesCount; ++mergeIndex )
+        {
+            const std::size_t first  = mergeIndex * 2 * width;
+            const std::size_t middle = std::min( first + width, count );
+            const std::size_t last   = std::min( first + 2 * width, count );
+            std::inplace_merge( order.begin() + first, order.begin() + middle, order.begin() + last, compare );
+        }
+    }
+
+    permuteRenderables( renderables, order );
+}
+
+
+
+// ----------------------------------------------------------------------------------
+// computeModelViewTransforms
+// ----------------------------------------------------------------------------------
+
+void computeModelViewTransforms( std::vector< Renderable >& renderables, const math::Matrix4f& viewTransform )
+{
+    const std::ptrdiff_t count = static_cast< std::ptrdiff_t >( renderables.size() );
+    #pragma omp parallel for if( count >= PARALLEL_RENDERABLES_THRESHOLD )
+    for( std::ptrdiff_t index = 0; index < count; ++index )
+    {
+        Renderable& renderable = renderables[ index ];
+        renderable.setModelViewTransform( viewTransform * renderable.geometry().worldTransform() );
+    }
+}
+
+
+
+// ----------------------------------------------------------------------------------
+// computeEyeDistances
+// ----------------------------------------------------------------------------------
+
+void computeEyeDistances( const std::vector< Renderable >& renderables )
+{
+    const std::ptrdiff_t count = static_cast< std::ptrdiff_t >( renderables.size() );
+    #pragma omp parallel for if( count >= PARALLEL_RENDERABLES_THRESHOLD )
+    for( std::ptrdiff_t index = 0; index < count; ++index )
+    {
+        renderables[ index ].eyeDistance2();
+    }
+}
+
+
+
+}  // namespace LibCarna :: base
+
+}  // namespace LibCarna
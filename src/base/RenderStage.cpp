@@ -132,6 +132,11 @@ void RenderStage::prepareFrame( Node& root )
 }
 
 
+void RenderStage::collectShaderNames( const Node&, std::vector< std::string >& ) const
+{
+}
+
+
 bool RenderStage::isEnabled() const
 {
     return pimpl->enabled;
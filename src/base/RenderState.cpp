@@ -16,6 +16,7 @@
 #include <LibCarna/base/RenderState.hpp>
 #include <LibCarna/base/BlendFunction.hpp>
 #include <LibCarna/base/GLContext.hpp>
+#include <algorithm>
 
 namespace LibCarna
 {
@@ -40,9 +41,23 @@ struct RenderState::Details
     static bool isCurrent( RenderState* self );
     static void assertCurrent( RenderState* self );
 
+    /* Copies the value of 'field' to the render state that mirrors the OpenGL
+     * context. Tells whether the value has changed, i.e. OpenGL must be updated.
+     */
+    template< typename FieldType >
+    bool updateApplied( FieldType Details::*field );
+    bool updateAppliedBlendFunction();
+    bool updateAppliedScissorBox();
+
+    /* Records the state changes that are requested by deriving 'other' from this
+     * render state, or vice versa.
+     */
+    void countRequestedChanges( const Details& other ) const;
+
     bool     depthTest;
     bool     depthWrite;
     int      depthTestFunction;
+    bool     colorWrite;
     bool     blend;
     int      blendFunctionSourceFactor;
     int      blendFunctionDestinationFactor;
@@ -51,6 +66,11 @@ struct RenderState::Details
     bool     frontFaceCCW;
     float    pointSize;
     float    lineWidth;
+    bool     scissorTest;
+    int      scissorX;
+    int      scissorY;
+    int      scissorWidth;
+    int      scissorHeight;
 
 }; // RenderState :: Details
 
@@ -58,6 +78,23 @@ struct RenderState::Details
 RenderState::Details::Details( const RenderState* parent, GLContext* glc )
     : parent( parent )
     , glc( glc )
+    , depthTest( false )
+    , depthWrite( false )
+    , depthTestFunction( 0 )
+    , colorWrite( false )
+    , blend( false )
+    , blendFunctionSourceFactor( 0 )
+    , blendFunctionDestinationFactor( 0 )
+    , blendEquation( 0 )
+    , cullFace( cullNone )
+    , frontFaceCCW( false )
+    , pointSize( 0 )
+    , lineWidth( 0 )
+    , scissorTest( false )
+    , scissorX( 0 )
+    , scissorY( 0 )
+    , scissorWidth( 0 )
+    , scissorHeight( 0 )
 {
 }
 
@@ -82,15 +119,96 @@ void RenderState::Details::assertCurrent( RenderState* self )
 }
 
 
+template< typename FieldType >
+bool RenderState::Details::updateApplied( FieldType Details::*field )
+{
+    Details& applied = *glc->appliedRenderState().pimpl;
+    if( applied.*field == this->*field )
+    {
+        return false;
+    }
+    else
+    {
+        applied.*field = this->*field;
+        glc->record( &GLStatistics::stateChanges );
+        return true;
+    }
+}
+
+
+bool RenderState::Details::updateAppliedBlendFunction()
+{
+    Details& applied = *glc->appliedRenderState().pimpl;
+    if( applied.blendFunctionSourceFactor == blendFunctionSourceFactor && applied.blendFunctionDestinationFactor == blendFunctionDestinationFactor )
+    {
+        return false;
+    }
+    else
+    {
+        applied.blendFunctionSourceFactor = blendFunctionSourceFactor;
+        applied.blendFunctionDestinationFactor = blendFunctionDestinationFactor;
+        glc->record( &GLStatistics::stateChanges );
+        return true;
+    }
+}
+
+
+bool RenderState::Details::updateAppliedScissorBox()
+{
+    Details& applied = *glc->appliedRenderState().pimpl;
+    if( applied.scissorX == scissorX && applied.scissorY == scissorY && applied.scissorWidth == scissorWidth && applied.scissorHeight == scissorHeight )
+    {
+        return false;
+    }
+    else
+    {
+        applied.scissorX = scissorX;
+        applied.scissorY = scissorY;
+        applied.scissorWidth = scissorWidth;
+        applied.scissorHeight = scissorHeight;
+        glc->record( &GLStatistics::stateChanges );
+        return true;
+    }
+}
+
+
+void RenderState::Details::countRequestedChanges( const Details& other ) const
+{
+    if( !glc->isStatisticsEnabled() )
+    {
+        return;
+    }
+    const bool changes[] =
+        { depthTest != other.depthTest
+        , depthWrite != other.depthWrite
+        , depthTestFunction != other.depthTestFunction
+        , colorWrite != other.colorWrite
+        , blend != other.blend
+        , blendFunctionSourceFactor != other.blendFunctionSourceFactor || blendFunctionDestinationFactor != other.blendFunctionDestinationFactor
+        , blendEquation != other.blendEquation
+        , cullFace != other.cullFace
+        , frontFaceCCW != other.frontFaceCCW
+        , pointSize != other.pointSize
+        , lineWidth != other.lineWidth
+        , scissorTest != other.scissorTest
+        , scissorX != other.scissorX || scissorY != other.scissorY || scissorWidth != other.scissorWidth || scissorHeight != other.scissorHeight };
+    const std::size_t changesCount = std::count( changes, changes + sizeof( changes ) / sizeof( bool ), true );
+    glc->record( &GLStatistics::requestedStateChanges, changesCount );
+}
+
+
 
 // ----------------------------------------------------------------------------------
 // RenderState
 // ----------------------------------------------------------------------------------
 
-RenderState::RenderState( GLContext& glc )
+RenderState::RenderState( GLContext& glc, bool isApplied )
     : pimpl( new Details( nullptr, &glc ) )
 {
-    pimpl->glc->pushRenderState( *this );
+    if( !isApplied )
+    {
+        pimpl->glc->pushRenderState( *this );
+    }
 }
 
 
@@ -103,6 +221,7 @@ RenderState::RenderState()
     pimpl->depthTest                      = parent.pimpl->depthTest;
     pimpl->depthWrite                     = parent.pimpl->depthWrite;
     pimpl->depthTestFunction              = parent.pimpl->depthTestFunction;
+    pimpl->colorWrite                     = parent.pimpl->colorWrite;
     pimpl->blend                          = parent.pimpl->blend;
     pimpl->blendFunctionSourceFactor      = parent.pimpl->blendFunctionSourceFactor;
     pimpl->blendFunctionDestinationFactor = parent.pimpl->blendFunctionDestinationFactor;
@@ -111,6 +230,11 @@ RenderState::RenderState()
     pimpl->frontFaceCCW                   = parent.pimpl->frontFaceCCW;
     pimpl->pointSize                      = parent.pimpl->pointSize;
     pimpl->lineWidth                      = parent.pimpl->lineWidth;
+    pimpl->scissorTest                    = parent.pimpl->scissorTest;
+    pimpl->scissorX                       = parent.pimpl->scissorX;
+    pimpl->scissorY                       = parent.pimpl->scissorY;
+    pimpl->scissorWidth                   = parent.pimpl->scissorWidth;
+    pimpl->scissorHeight                  = parent.pimpl->scissorHeight;
 }
 
 
@@ -118,19 +242,11 @@ RenderState::~RenderState()
 {
     if( pimpl->parent != nullptr )
     {
-        const RenderState::Details& parent = *pimpl->parent->pimpl;
-
-        setDepthTest( parent.depthTest );
-        setDepthWrite( parent.depthWrite );
-        setDepthTestFunction( parent.depthTestFunction );
-        setBlend( parent.blend );
-        setBlendFunction( BlendFunction( parent.blendFunctionSourceFactor, parent.blendFunctionDestinationFactor ) );
-        setBlendEquation( parent.blendEquation );
-        setCullFace( parent.cullFace );
-        setFrontFace( parent.frontFaceCCW );
-        setPointSize( parent.pointSize );
-        setLineWidth( parent.lineWidth );
-
+        /* Restoring the previous state is deferred until it is committed, so that
+         * sibling render states, that change the same parts of the state, do not
+         * cause revert-and-reapply cycles.
+         */
+        pimpl->countRequestedChanges( *pimpl->parent->pimpl );
         pimpl->glc->popRenderState();
     }
 }
@@ -138,9 +254,29 @@ RenderState::~RenderState()
 
 void RenderState::commit() const
 {
+    RenderState::Details& applied = *pimpl->glc->appliedRenderState().pimpl;
+    applied.depthTest                      = pimpl->depthTest;
+    applied.depthWrite                     = pimpl->depthWrite;
+    applied.depthTestFunction              = pimpl->depthTestFunction;
+    applied.colorWrite                     = pimpl->colorWrite;
+    applied.blend                          = pimpl->blend;
+    applied.blendFunctionSourceFactor      = pimpl->blendFunctionSourceFactor;
+    applied.blendFunctionDestinationFactor = pimpl->blendFunctionDestinationFactor;
+    applied.blendEquation                  = pimpl->blendEquation;
+    applied.cullFace                       = pimpl->cullFace;
+    applied.frontFaceCCW                   = pimpl->frontFaceCCW;
+    applied.pointSize                      = pimpl->pointSize;
+    applied.lineWidth                      = pimpl->lineWidth;
+    applied.scissorTest                    = pimpl->scissorTest;
+    applied.scissorX                       = pimpl->scissorX;
+    applied.scissorY                       = pimpl->scissorY;
+    applied.scissorWidth                   = pimpl->scissorWidth;
+    applied.scissorHeight                  = pimpl->scissorHeight;
+
     commitDepthTest();
     commitDepthWrite();
     commitDepthTestFunction();
+    commitColorWrite();
     commitBlend();
     commitBlendFunction();
     commitBlendEquation();
@@ -148,6 +284,65 @@ void RenderState::commit() const
     commitFrontFace();
     commitPointSize();
     commitLineWidth();
+    commitScissorTest();
+    commitScissorBox();
+}
+
+
+void RenderState::commitPending() const
+{
+    if( pimpl->updateApplied( &Details::depthTest ) )
+    {
+        commitDepthTest();
+    }
+    if( pimpl->updateApplied( &Details::depthWrite ) )
+    {
+        commitDepthWrite();
+    }
+    if( pimpl->updateApplied( &Details::depthTestFunction ) )
+    {
+        commitDepthTestFunction();
+    }
+    if( pimpl->updateApplied( &Details::colorWrite ) )
+    {
+        commitColorWrite();
+    }
+    if( pimpl->updateApplied( &Details::blend ) )
+    {
+        commitBlend();
+    }
+    if( pimpl->updateAppliedBlendFunction() )
+    {
+        commitBlendFunction();
+    }
+    if( pimpl->updateApplied( &Details::blendEquation ) )
+    {
+        commitBlendEquation();
+    }
+    if( pimpl->updateApplied( &Details::cullFace ) )
+    {
+        commitCullFace();
+    }
+    if( pimpl->updateApplied( &Details::frontFaceCCW ) )
+    {
+        commitFrontFace();
+    }
+    if( pimpl->updateApplied( &Details::pointSize ) )
+    {
+        commitPointSize();
+    }
+    if( pimpl->updateApplied( &Details::lineWidth ) )
+    {
+        commitLineWidth();
+    }
+    if( pimpl->updateApplied( &Details::scissorTest ) )
+    {
+        commitScissorTest();
+    }
+    if( pimpl->updateAppliedScissorBox() )
+    {
+        commitScissorBox();
+    }
 }
 
 
@@ -157,6 +352,10 @@ void RenderState::setDepthTest( bool dt )
     if( dt != pimpl->depthTest )
     {
         pimpl->depthTest = dt;
+        pimpl->glc->record( &GLStatistics::requestedStateChanges );
+    }
+    if( pimpl->updateApplied( &Details::depthTest ) )
+    {
         commitDepthTest();
     }
 }
@@ -168,6 +367,10 @@ void RenderState::setDepthWrite( bool dw )
     if( dw != pimpl->depthWrite )
     {
         pimpl->depthWrite = dw;
+        pimpl->glc->record( &GLStatistics::requestedStateChanges );
+    }
+    if( pimpl->updateApplied( &Details::depthWrite ) )
+    {
         commitDepthWrite();
     }
 }
@@ -179,17 +382,40 @@ void RenderState::setDepthTestFunction( int dtf )
     if( dtf != pimpl->depthTestFunction )
     {
         pimpl->depthTestFunction = dtf;
+        pimpl->glc->record( &GLStatistics::requestedStateChanges );
+    }
+    if( pimpl->updateApplied( &Details::depthTestFunction ) )
+    {
         commitDepthTestFunction();
     }
 }
 
 
+void RenderState::setColorWrite( bool cw )
+{
+    Details::assertCurrent( this );
+    if( cw != pimpl->colorWrite )
+    {
+        pimpl->colorWrite = cw;
+        pimpl->glc->record( &GLStatistics::requestedStateChanges );
+    }
+    if( pimpl->updateApplied( &Details::colorWrite ) )
+    {
+        commitColorWrite();
+    }
+}
+
+
 void RenderState::setBlend( bool b )
 {
     Details::assertCurrent( this );
     if( b != pimpl->blend )
     {
         pimpl->blend = b;
+        pimpl->glc->record( &GLStatistics::requestedStateChanges );
+    }
+    if( pimpl->updateApplied( &Details::blend ) )
+    {
         commitBlend();
     }
 }
@@ -202,6 +428,10 @@ void RenderState::setBlendFunction( const BlendFunction& bf )
     {
         pimpl->blendFunctionSourceFactor = bf.sourceFactor;
         pimpl->blendFunctionDestinationFactor = bf.destinationFactor;
+        pimpl->glc->record( &GLStatistics::requestedStateChanges );
+    }
+    if( pimpl->updateAppliedBlendFunction() )
+    {
         commitBlendFunction();
     }
 }
@@ -213,6 +443,10 @@ void RenderState::setBlendEquation( int be )
     if( be != pimpl->blendEquation )
     {
         pimpl->blendEquation = be;
+        pimpl->glc->record( &GLStatistics::requestedStateChanges );
+    }
+    if( pimpl->updateApplied( &Details::blendEquation ) )
+    {
         commitBlendEquation();
     }
 }
@@ -224,6 +458,10 @@ void RenderState::setCullFace( CullFace cf )
     if( cf != pimpl->cullFace )
     {
         pimpl->cullFace = cf;
+        pimpl->glc->record( &GLStatistics::requestedStateChanges );
+    }
+    if( pimpl->updateApplied( &Details::cullFace ) )
+    {
         commitCullFace();
     }
 }
@@ -235,6 +473,10 @@ void RenderState::setFrontFace( bool ccw )
     if( ccw != pimpl->frontFaceCCW )
     {
         pimpl->frontFaceCCW = ccw;
+        pimpl->glc->record( &GLStatistics::requestedStateChanges );
+    }
+    if( pimpl->updateApplied( &Details::frontFaceCCW ) )
+    {
         commitFrontFace();
     }
 }
@@ -246,6 +488,10 @@ void RenderState::setPointSize( float pointSize )
     if( !( pointSize < 0 && pimpl->pointSize < 0 ) && !base::math::isEqual( pointSize, pimpl->pointSize ) )
     {
         pimpl->pointSize = pointSize;
+        pimpl->glc->record( &GLStatistics::requestedStateChanges );
+    }
+    if( pimpl->updateApplied( &Details::pointSize ) )
+    {
         commitPointSize();
     }
 }
@@ -257,11 +503,48 @@ void RenderState::setLineWidth( float lineWidth )
     if( lineWidth > 0 && !base::math::isEqual( lineWidth, pimpl->lineWidth ) )
     {
         pimpl->lineWidth = lineWidth;
+        pimpl->glc->record( &GLStatistics::requestedStateChanges );
+    }
+    if( pimpl->updateApplied( &Details::lineWidth ) )
+    {
         commitLineWidth();
     }
 }
 
 
+void RenderState::setScissorTest( bool st )
+{
+    Details::assertCurrent( this );
+    if( st != pimpl->scissorTest )
+    {
+        pimpl->scissorTest = st;
+        pimpl->glc->record( &GLStatistics::requestedStateChanges );
+    }
+    if( pimpl->updateApplied( &Details::scissorTest ) )
+    {
+        commitScissorTest();
+    }
+}
+
+
+void RenderState::setScissorBox( int x, int y, int width, int height )
+{
+    Details::assertCurrent( this );
+    if( x != pimpl->scissorX || y != pimpl->scissorY || width != pimpl->scissorWidth || height != pimpl->scissorHeight )
+    {
+        pimpl->scissorX = x;
+        pimpl->scissorY = y;
+        pimpl->scissorWidth = width;
+        pimpl->scissorHeight = height;
+        pimpl->glc->record( &GLStatistics::requestedStateChanges );
+    }
+    if( pimpl->updateAppliedScissorBox() )
+    {
+        commitScissorBox();
+    }
+}
+
+
 void RenderState::commitDepthTest() const
 {
     if( pimpl->depthTest )
@@ -287,6 +570,13 @@ void RenderState::commitDepthTestFunction() const
 }
 
 
+void RenderState::commitColorWrite() const
+{
+    const GLboolean cw = pimpl->colorWrite ? GL_TRUE : GL_FALSE;
+    glColorMask( cw, cw, cw, cw );
+}
+
+
 void RenderState::commitBlend() const
 {
     if( pimpl->blend )
@@ -361,6 +651,25 @@ void RenderState::commitLineWidth() const
 }
 
 
+void RenderState::commitScissorTest() const
+{
+    if( pimpl->scissorTest )
+    {
+        glEnable( GL_SCISSOR_TEST );
+    }
+    else
+    {
+        glDisable( GL_SCISSOR_TEST );
+    }
+}
+
+
+void RenderState::commitScissorBox() const
+{
+    glScissor( pimpl->scissorX, pimpl->scissorY, pimpl->scissorWidth, pimpl->scissorHeight );
+}
+
+
 
 }  // namespace LibCarna :: base
 
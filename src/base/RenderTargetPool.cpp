@@ -0,0 +1,204 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#include <LibCarna/base/RenderTargetPool.hpp>
+#include <LibCarna/base/Texture.hpp>
+#include <algorithm>
+#include <vector>
+
+namespace LibCarna
+{
+
+namespace base
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// RenderTargetPool :: Target
+// ----------------------------------------------------------------------------------
+
+struct RenderTargetPool::Target
+{
+    Target( unsigned int width, unsigned int height, Framebuffer::RenderTextureFormat format );
+
+    const Framebuffer::RenderTextureFormat format;
+    const std::unique_ptr< Texture< 2 > > renderTexture;
+    Framebuffer framebuffer;
+
+    bool isLeased;
+    bool isUsed;
+
+    bool matches( unsigned int width, unsigned int height, Framebuffer::RenderTextureFormat format ) const;
+};
+
+
+RenderTargetPool::Target::Target( unsigned int width, unsigned int height, Framebuffer::RenderTextureFormat format )
+    : format( format )
+    , renderTexture( Framebuffer::createRenderTexture( format ) )
+    , framebuffer( width, height, *renderTexture )
+    , isLeased( false )
+    , isUsed( false )
+{
+}
+
+
+bool RenderTargetPool::Target::matches( unsigned int width, unsigned int height, Framebuffer::RenderTextureFormat format ) const
+{
+    return !isLeased
+        && this->format == format
+        && framebuffer.width () == width
+        && framebuffer.height() == height;
+}
+
+
+
+// ----------------------------------------------------------------------------------
+// RenderTargetPool :: Details
+// ----------------------------------------------------------------------------------
+
+struct RenderTargetPool::Details
+{
+    Details();
+
+    std::vector< std::unique_ptr< Target > > targets;
+    std::size_t createdCount;
+};
+
+
+RenderTargetPool::Details::Details()
+    : createdCount( 0 )
+{
+}
+
+
+
+// ----------------------------------------------------------------------------------
+// RenderTargetPool
+// ----------------------------------------------------------------------------------
+
+RenderTargetPool::RenderTargetPool()
+    : pimpl( new Details() )
+{
+}
+
+
+RenderTargetPool::~RenderTargetPool()
+{
+}
+
+
+RenderTargetPool::Target& RenderTargetPool::acquire( unsigned int width, unsigned int height, Framebuffer::RenderTextureFormat format )
+{
+    const auto targetItr = std::find_if( pimpl->targets.begin(), pimpl->targets.end(),
+        [&]( const std::unique_ptr< Target >& target )
+        {
+            return target->matches( width, height, format );
+        }
+    );
+
+    Target* target;
+    if( targetItr == pimpl->targets.end() )
+    {
+        target = new Target( width, height, format );
+        pimpl->targets.push_back( std::unique_ptr< Target >( target ) );
+        ++pimpl->createdCount;
+    }
+    else
+    {
+        target = targetItr->get();
+    }
+
+    target->isLeased = true;
+    target->isUsed   = true;
+    return *target;
+}
+
+
+std::size_t RenderTargetPool::size() const
+{
+    return pimpl->targets.size();
+}
+
+
+std::size_t RenderTargetPool::leasedCount() const
+{
+    return std::count_if( pimpl->targets.begin(), pimpl->targets.end(),
+        []( const std::unique_ptr< Target >& target )
+        {
+            return target->isLeased;
+        }
+    );
+}
+
+
+std::size_t RenderTargetPool::createdCount() const
+{
+    return pimpl->createdCount;
+}
+
+
+void RenderTargetPool::releaseUnused()
+{
+    pimpl->targets.erase( std::remove_if( pimpl->targets.begin(), pimpl->targets.end(),
+        []( const std::unique_ptr< Target >& target )
+        {
+            return !target->isLeased && !target->isUsed;
+        }
+    ), pimpl->targets.end() );
+
+    for( auto targetItr = pimpl->targets.begin(); targetItr != pimpl->targets.end(); ++targetItr )
+    {
+        ( **targetItr ).isUsed = ( **targetItr ).isLeased;
+    }
+}
+
+
+
+// ----------------------------------------------------------------------------------
+// RenderTargetPool :: Lease
+// ----------------------------------------------------------------------------------
+
+RenderTargetPool::Lease::Lease
+    ( RenderTargetPool& pool
+    , unsigned int width
+    , unsigned int height
+    , Framebuffer::RenderTextureFormat format )
+    : target( pool.acquire( width, height, format ) )
+{
+}
+
+
+RenderTargetPool::Lease::~Lease()
+{
+    target.isLeased = false;
+}
+
+
+Framebuffer& RenderTargetPool::Lease::framebuffer() const
+{
+    return target.framebuffer;
+}
+
+
+Texture< 2 >& RenderTargetPool::Lease::renderTexture() const
+{
+    return *target.renderTexture;
+}
+
+
+
+}  // namespace LibCarna :: base
+
+}  // namespace LibCarna
@@ -14,7 +14,10 @@
 
 #include <LibCarna/base/RenderTask.hpp>
 #include <LibCarna/base/RenderStage.hpp>
+#include <LibCarna/base/FrameRenderer.hpp>
+#include <LibCarna/base/FrameUniformBuffer.hpp>
 #include <LibCarna/base/Framebuffer.hpp>
+#include <LibCarna/base/GLContext.hpp>
 #include <LibCarna/base/Camera.hpp>
 
 namespace LibCarna
@@ -96,11 +99,18 @@ void RenderTask::render( const Viewport& vp, unsigned int clearBuffersMask )
     }
     while( nextRenderStage < renderer.stages() )
     {
-        RenderStage& rs = renderer.stageAt( nextRenderStage );
+        const std::size_t rsIdx = nextRenderStage;
+        RenderStage& rs = renderer.stageAt( rsIdx );
         ++nextRenderStage;
         if( rs.isEnabled() )
         {
+            /* The buffer is updated before each stage, because stages might render
+             * forked tasks with different view transforms in the meantime.
+             */
+            renderer.frameUniforms().update( projection, myViewTransform, vp );
+            const GLStatistics statistics0 = renderer.glContext().statistics();
             renderStage( rs, vp );
+            renderer.recordStageStatistics( rsIdx, renderer.glContext().statistics() - statistics0 );
         }
     }
     vp.done();
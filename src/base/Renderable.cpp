@@ -13,6 +13,11 @@
  */
 
 #include <LibCarna/base/Renderable.hpp>
+#include <LibCarna/base/Geometry.hpp>
+#include <LibCarna/base/Material.hpp>
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
 
 namespace LibCarna
 {
@@ -175,6 +180,124 @@ Renderable& Renderable::operator=( const Renderable& r )
 
 
 
+void Renderable::computeSortKeys
+    ( const std::vector< Renderable >& renderables
+    , std::vector< std::uint64_t >& keys
+    , unsigned int materialRole
+    , unsigned int meshRole
+    , int depthOrder )
+{
+    const bool withDepth = depthOrder != 0;
+    const unsigned int   shaderBits = withDepth ?  8 : 20;
+    const unsigned int     meshBits = withDepth ? 12 : 22;
+    const unsigned int materialBits = withDepth ? 12 : 22;
+    const std::uint64_t   maxShaderNumber = ( std::uint64_t( 1 ) <<   shaderBits ) - 1;
+    const std::uint64_t     maxMeshNumber = ( std::uint64_t( 1 ) <<     meshBits ) - 1;
+    const std::uint64_t maxMaterialNumber = ( std::uint64_t( 1 ) << materialBits ) - 1;
+
+    /* The number zero is reserved for renderables that lack the feature. Each
+     * material is associated with its own number and the number of its shader.
+     */
+    std::unordered_map< std::string, std::uint64_t > shaderNumbers;
+    std::unordered_map< const GeometryFeature*, std::uint64_t > meshNumbers;
+    std::unordered_map< const GeometryFeature*, std::pair< std::uint64_t, std::uint64_t > > materialNumbers;
+
+    /* Consecutive renderables often share their features, especially once they are
+     * ordered, thus the numbers of the last features are looked up first.
+     */
+    const GeometryFeature* lastMaterial = nullptr;
+    const GeometryFeature* lastMesh = nullptr;
+    std::uint64_t lastMaterialNumber = 0;
+    std::uint64_t lastShaderNumber = 0;
+    std::uint64_t lastMeshNumber = 0;
+
+    keys.resize( renderables.size() );
+    for( std::size_t renderableIndex = 0; renderableIndex < renderables.size(); ++renderableIndex )
+    {
+        const Renderable& renderable = renderables[ renderableIndex ];
+        const Geometry& geometry = renderable.geometry();
+        std::uint64_t shaderNumber = 0;
+        std::uint64_t meshNumber = 0;
+        std::uint64_t materialNumber = 0;
+
+        if( geometry.hasFeature( materialRole ) )
+        {
+            const GeometryFeature& material = geometry.feature( materialRole );
+            if( &material != lastMaterial )
+            {
+                const auto materialItr = materialNumbers.find( &material );
+                if( materialItr == materialNumbers.end() )
+                {
+                    lastMaterialNumber = std::min< std::uint64_t >( materialNumbers.size() + 1, maxMaterialNumber );
+                    lastShaderNumber = 0;
+                    const Material* const shaderMaterial = dynamic_cast< const Material* >( &material );
+                    if( shaderMaterial != nullptr )
+                    {
+                        const auto shaderItr = shaderNumbers.find( shaderMaterial->shaderName );
+                        if( shaderItr == shaderNumbers.end() )
+                        {
+                            lastShaderNumber = std::min< std::uint64_t >( shaderNumbers.size() + 1, maxShaderNumber );
+                            shaderNumbers[ shaderMaterial->shaderName ] = lastShaderNumber;
+                        }
+                        else
+                        {
+                            lastShaderNumber = shaderItr->second;
+                        }
+                    }
+                    materialNumbers[ &material ] = std::make_pair( lastMaterialNumber, lastShaderNumber );
+                }
+                else
+                {
+                    lastMaterialNumber = materialItr->second.first;
+                    lastShaderNumber   = materialItr->second.second;
+                }
+                lastMaterial = &material;
+            }
+            materialNumber = lastMaterialNumber;
+            shaderNumber   = lastShaderNumber;
+        }
+
+        if( geometry.hasFeature( meshRole ) )
+        {
+            const GeometryFeature& mesh = geometry.feature( meshRole );
+            if( &mesh != lastMesh )
+            {
+                const auto meshItr = meshNumbers.find( &mesh );
+                if( meshItr == meshNumbers.end() )
+                {
+                    lastMeshNumber = std::min< std::uint64_t >( meshNumbers.size() + 1, maxMeshNumber );
+                    meshNumbers[ &mesh ] = lastMeshNumber;
+                }
+                else
+                {
+                    lastMeshNumber = meshItr->second;
+                }
+                lastMesh = &mesh;
+            }
+            meshNumber = lastMeshNumber;
+        }
+
+        std::uint64_t key = ( shaderNumber << ( meshBits + materialBits ) ) | ( meshNumber << materialBits ) | materialNumber;
+        if( withDepth )
+        {
+            /* The bit patterns of non-negative floats have the same order as their
+             * values, when they are interpreted as unsigned integers.
+             */
+            const float depth = renderable.eyeDistance2();
+            std::uint32_t depthBits;
+            std::memcpy( &depthBits, &depth, sizeof( depthBits ) );
+            if( depthOrder > 0 )
+            {
+                depthBits = ~depthBits;
+            }
+            key |= std::uint64_t( depthBits ) << 32;
+        }
+        keys[ renderableIndex ] = key;
+    }
+}
+
+
+
 }  // namespace LibCarna :: base
 
 }  // namespace LibCarna
@@ -0,0 +1,348 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#include <LibCarna/base/STLReader.hpp>
+#include <LibCarna/base/LibCarnaException.hpp>
+#include <LibCarna/base/text.hpp>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace LibCarna
+{
+
+namespace base
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// Types & Globals
+// ----------------------------------------------------------------------------------
+
+const static std::size_t STL_HEADER_SIZE   = 80;
+const static std::size_t STL_PREAMBLE_SIZE = STL_HEADER_SIZE + 4;
+const static std::size_t STL_TRIANGLE_SIZE = 50;
+const static std::size_t STL_NORMAL_SIZE   = 12;
+
+/* Lower bound of the capacity of the hash table, that merges the corners.
+ */
+const static std::size_t STL_MIN_TABLE_SIZE = 64;
+
+/* Average number of bytes per triangle in ASCII STL, used to estimate the number
+ * of triangles from the data size.
+ */
+const static std::size_t STL_ASCII_BYTES_PER_TRIANGLE = 256;
+
+
+static uint32_t readSTLUInt32( const char* data )
+{
+    /* STL is little-endian, as are the platforms supported.
+     */
+    uint32_t value;
+    std::memcpy( &value, data, sizeof( value ) );
+    return value;
+}
+
+
+static uint32_t hashSTLPosition( float x, float y, float z )
+{
+    uint32_t bits[ 3 ];
+    std::memcpy( &bits[ 0 ], &x, sizeof( float ) );
+    std::memcpy( &bits[ 1 ], &y, sizeof( float ) );
+    std::memcpy( &bits[ 2 ], &z, sizeof( float ) );
+
+    /* Combine the bit patterns and finalize the result like MurmurHash3 does, so
+     * that nearby positions are spread across the table.
+     */
+    uint32_t hash = bits[ 0 ];
+    hash = hash * 0x9E3779B1u ^ bits[ 1 ];
+    hash = hash * 0x9E3779B1u ^ bits[ 2 ];
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6Bu;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35u;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+
+static bool isSTLWhitespace( char c )
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+
+/* Advances 'cursor' to the beginning of the next token and 'tokenEnd' to its end.
+ * Returns 'false' if there is no further token.
+ */
+static bool nextSTLToken( const char*& cursor, const char*& tokenEnd, const char* end )
+{
+    while( cursor != end && isSTLWhitespace( *cursor ) )
+    {
+        ++cursor;
+    }
+    tokenEnd = cursor;
+    while( tokenEnd != end && !isSTLWhitespace( *tokenEnd ) )
+    {
+        ++tokenEnd;
+    }
+    return cursor != end;
+}
+
+
+
+// ----------------------------------------------------------------------------------
+// STLReader :: Details
+// ----------------------------------------------------------------------------------
+
+struct STLReader::Details
+{
+    Details();
+
+    bool isBinary;
+    std::size_t trianglesCount;
+    std::vector< math::Vector3f > positions;
+    std::vector< uint32_t > indices;
+
+    /* Each slot of the hash table holds the index of a vertex plus one, or zero if
+     * the slot is empty. The size of the table is a power of two.
+     */
+    std::vector< uint32_t > table;
+
+    void reset( std::size_t expectedTrianglesCount );
+    void addCorner( float x, float y, float z );
+    void growTable();
+
+    void readBinary( const char* data, std::size_t size );
+    void readASCII( const char* data, std::size_t size );
+};
+
+
+STLReader::Details::Details()
+    : isBinary( false )
+    , trianglesCount( 0 )
+{
+}
+
+
+void STLReader::Details::reset( std::size_t expectedTrianglesCount )
+{
+    /* Closed meshes have about half as many vertices as triangles. The table is
+     * kept at most half full, so that probe sequences stay short.
+     */
+    std::size_t tableSize = STL_MIN_TABLE_SIZE;
+    while( tableSize < expectedTrianglesCount )
+    {
+        tableSize *= 2;
+    }
+    table.assign( tableSize, 0 );
+    positions.clear();
+    positions.reserve( expectedTrianglesCount / 2 + 3 );
+    indices.clear();
+    indices.reserve( expectedTrianglesCount * 3 );
+}
+
+
+void STLReader::Details::addCorner( float x, float y, float z )
+{
+    /* Positive and negative zero compare equal, thus they must hash equally.
+     */
+    x = x == 0 ? 0.f : x;
+    y = y == 0 ? 0.f : y;
+    z = z == 0 ? 0.f : z;
+
+    const std::size_t mask = table.size() - 1;
+    for( std::size_t slot = hashSTLPosition( x, y, z ) & mask;; slot = ( slot + 1 ) & mask )
+    {
+        const uint32_t entry = table[ slot ];
+        if( entry == 0 )
+        {
+            positions.push_back( math::Vector3f( x, y, z ) );
+            table[ slot ] = static_cast< uint32_t >( positions.size() );
+            indices.push_back( static_cast< uint32_t >( positions.size() - 1 ) );
+            if( positions.size() * 2 > table.size() )
+            {
+                growTable();
+            }
+            return;
+        }
+        const math::Vector3f& position = positions[ entry - 1 ];
+        if( position.x() == x && position.y() == y && position.z() == z )
+        {
+            indices.push_back( entry - 1 );
+            return;
+        }
+    }
+}
+
+
+void STLReader::Details::growTable()
+{
+    table.assign( table.size() * 2, 0 );
+    const std::size_t mask = table.size() - 1;
+    for( std::size_t vertexIndex = 0; vertexIndex < positions.size(); ++vertexIndex )
+    {
+        const math::Vector3f& position = positions[ vertexIndex ];
+        std::size_t slot = hashSTLPosition( position.x(), position.y(), position.z() ) & mask;
+        while( table[ slot ] != 0 )
+        {
+            slot = ( slot + 1 ) & mask;
+        }
+        table[ slot ] = static_cast< uint32_t >( vertexIndex + 1 );
+    }
+}
+
+
+void STLReader::Details::readBinary( const char* data, std::size_t size )
+{
+    LIBCARNA_ASSERT_EX( size >= STL_PREAMBLE_SIZE, "STL data is truncated!" );
+    const std::size_t trianglesCount = readSTLUInt32( data + STL_HEADER_SIZE );
+    LIBCARNA_ASSERT_EX( ( size - STL_PREAMBLE_SIZE ) / STL_TRIANGLE_SIZE >= trianglesCount, "STL data is truncated!" );
+
+    reset( trianglesCount );
+    const char* triangle = data + STL_PREAMBLE_SIZE;
+    for( std::size_t triangleIndex = 0; triangleIndex < trianglesCount; ++triangleIndex, triangle += STL_TRIANGLE_SIZE )
+    {
+        float corners[ 9 ];
+        std::memcpy( corners, triangle + STL_NORMAL_SIZE, sizeof( corners ) );
+        addCorner( corners[ 0 ], corners[ 1 ], corners[ 2 ] );
+        addCorner( corners[ 3 ], corners[ 4 ], corners[ 5 ] );
+        addCorner( corners[ 6 ], corners[ 7 ], corners[ 8 ] );
+    }
+    this->trianglesCount = trianglesCount;
+}
+
+
+void STLReader::Details::readASCII( const char* data, std::size_t size )
+{
+    reset( size / STL_ASCII_BYTES_PER_TRIANGLE );
+
+    /* Skip the first line, since the name of the solid is arbitrary text.
+     */
+    const char* const end = data + size;
+    const char* cursor = std::find( data, end, '\n' );
+
+    /* Only the 'vertex' statements are relevant. All other statements, including
+     * the face normals, are skipped.
+     */
+    const char* tokenEnd;
+    while( nextSTLToken( cursor, tokenEnd, end ) )
+    {
+        const bool isVertex = tokenEnd - cursor == 6 && std::memcmp( cursor, "vertex", 6 ) == 0;
+        cursor = tokenEnd;
+        if( isVertex )
+        {
+            float coordinates[ 3 ];
+            for( unsigned int i = 0; i < 3; ++i )
+            {
+                double coordinate;
+                const bool isValid = nextSTLToken( cursor, tokenEnd, end ) && text::parseDouble( cursor, tokenEnd, coordinate );
+                LIBCARNA_ASSERT_EX( isValid, "Malformed vertex in ASCII STL data!" );
+                coordinates[ i ] = static_cast< float >( coordinate );
+                cursor = tokenEnd;
+            }
+            addCorner( coordinates[ 0 ], coordinates[ 1 ], coordinates[ 2 ] );
+        }
+    }
+
+    LIBCARNA_ASSERT_EX( indices.size() % 3 == 0, "ASCII STL data contains an incomplete triangle!" );
+    trianglesCount = indices.size() / 3;
+}
+
+
+
+// ----------------------------------------------------------------------------------
+// STLReader
+// ----------------------------------------------------------------------------------
+
+STLReader::STLReader()
+    : pimpl( new Details() )
+{
+}
+
+
+STLReader::~STLReader()
+{
+}
+
+
+void STLReader::read( const char* data, std::size_t size )
+{
+    /* The size of binary STL is determined by its number of triangles. This is
+     * checked first, because the header of binary STL may also start with 'solid'.
+     */
+    const bool hasBinarySize = size >= STL_PREAMBLE_SIZE
+        && ( size - STL_PREAMBLE_SIZE ) == STL_TRIANGLE_SIZE * readSTLUInt32( data + STL_HEADER_SIZE );
+
+    const char* const end = data + size;
+    const char* const first = std::find_if( data, end, []( char c ) { return !isSTLWhitespace( c ); } );
+    const bool startsWithSolid = end - first >= 5 && std::memcmp( first, "solid", 5 ) == 0;
+
+    pimpl->isBinary = hasBinarySize || !startsWithSolid;
+    if( pimpl->isBinary )
+    {
+        pimpl->readBinary( data, size );
+    }
+    else
+    {
+        pimpl->readASCII( data, size );
+    }
+}
+
+
+void STLReader::read( std::istream& stream )
+{
+    std::vector< char > buffer;
+    text::readAll( stream, buffer );
+    read( buffer.empty() ? nullptr : &buffer[ 0 ], buffer.size() );
+}
+
+
+void STLReader::read( const std::string& path )
+{
+    std::ifstream stream( path, std::ios::in | std::ios::binary );
+    LIBCARNA_ASSERT_EX( stream.is_open(), "Failed to open STL file: " << path );
+    read( stream );
+}
+
+
+bool STLReader::isBinary() const
+{
+    return pimpl->isBinary;
+}
+
+
+std::size_t STLReader::trianglesCount() const
+{
+    return pimpl->trianglesCount;
+}
+
+
+const std::vector< math::Vector3f >& STLReader::positions() const
+{
+    return pimpl->positions;
+}
+
+
+const std::vector< uint32_t >& STLReader::indices() const
+{
+    return pimpl->indices;
+}
+
+
+
+}  // namespace LibCarna :: base
+
+}  // namespace LibCarna
@@ -16,6 +16,7 @@
 #include <LibCarna/base/glError.hpp>
 #include <LibCarna/base/Sampler.hpp>
 #include <LibCarna/base/Texture.hpp>
+#include <LibCarna/base/GLContext.hpp>
 #include <LibCarna/base/LibCarnaException.hpp>
 
 namespace LibCarna
@@ -97,12 +98,13 @@ Sampler::Sampler
 Sampler::~Sampler()
 {
     glDeleteSamplers( 1, &id );
+    GLContext::forgetSampler( id );
 }
 
 
 void Sampler::bind( int unit ) const
 {
-    glBindSampler( unit, id );
+    GLContext::current().bindSampler( unit, id );
 }
 
 
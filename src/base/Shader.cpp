@@ -36,7 +36,7 @@ const unsigned int Shader::TYPE_GEOMETRY_SHADER = GL_GEOMETRY_SHADER;
 const unsigned int Shader::TYPE_FRAGMENT_SHADER = GL_FRAGMENT_SHADER;
 
 
-Shader::Shader( unsigned int type, const std::string& src )
+Shader::Shader( unsigned int type, const std::string& src, bool deferErrorCheck )
     : id( glCreateShader( type ) )
     , type( type )
 {
@@ -49,20 +49,9 @@ Shader::Shader( unsigned int type, const std::string& src )
 
         glShaderSource( id, 1, &pcSrc, &nSrcLength );
         glCompileShader( id );
-
-        // check errors
-
-        GLint nInfoLogLength;
-        glGetShaderiv( id, GL_INFO_LOG_LENGTH, &nInfoLogLength );
-        if( nInfoLogLength > 1 )
+        if( !deferErrorCheck )
         {
-            const std::unique_ptr< GLchar > buf( new GLchar[ nInfoLogLength ] );
-            glGetShaderInfoLog( id, nInfoLogLength, 0, buf.get() );
-            const std::string err( buf.get() );
-            if( err != "No errors." )
-            {
-                throw ShaderCompilationError( err );
-            }
+            checkErrors();
         }
     }
     catch( ... )
@@ -73,6 +62,23 @@ Shader::Shader( unsigned int type, const std::string& src )
 }
 
 
+void Shader::checkErrors() const
+{
+    GLint nInfoLogLength;
+    glGetShaderiv( id, GL_INFO_LOG_LENGTH, &nInfoLogLength );
+    if( nInfoLogLength > 1 )
+    {
+        const std::unique_ptr< GLchar > buf( new GLchar[ nInfoLogLength ] );
+        glGetShaderInfoLog( id, nInfoLogLength, 0, buf.get() );
+        const std::string err( buf.get() );
+        if( err != "No errors." )
+        {
+            throw ShaderCompilationError( err );
+        }
+    }
+}
+
+
 Shader::~Shader()
 {
     release();
@@ -15,8 +15,16 @@
 #include <LibCarna/base/ShaderManager.hpp>
 #include <LibCarna/base/Shader.hpp>
 #include <LibCarna/base/ShaderProgram.hpp>
+#include <LibCarna/base/glew.hpp>
+#include <LibCarna/base/GLContext.hpp>
 #include <LibCarna/base/Log.hpp>
+#include <LibCarna/base/Stopwatch.hpp>
+#include <cctype>
+#include <cstdint>
+#include <fstream>
+#include <set>
 #include <sstream>
+#include <vector>
 
 namespace LibCarna
 {
@@ -26,6 +34,98 @@ namespace base
 
 
 
+// ----------------------------------------------------------------------------------
+// Types & Globals
+// ----------------------------------------------------------------------------------
+
+/* Identifies the files of the program binary cache.
+ */
+const static std::uint32_t PROGRAM_BINARY_MAGIC = 0x4250434C; // "LCPB"
+
+
+/* Computes the 64-bit FNV-1a hash, that in contrast to 'std::hash' is the same
+ * across implementations of the standard library and thus suits persistence.
+ */
+static std::uint64_t hashFNV1a( const std::string& data, std::uint64_t hash = 14695981039346656037ULL )
+{
+    for( const char c : data )
+    {
+        hash ^= static_cast< unsigned char >( c );
+        hash *= 1099511628211ULL;
+    }
+
+    /* Also hash a terminator, so that consecutive strings are delimited.
+     */
+    hash ^= 0xFF;
+    hash *= 1099511628211ULL;
+    return hash;
+}
+
+
+/* Splits the name of a shader variant, like 'dvr[LIGHTING=1]', into the name of
+ * the shader and the macro definitions.
+ */
+static void parseVariantName( const std::string& variantName, std::string& shaderName, ShaderManager::Defines& defines )
+{
+    const std::size_t definesBegin = variantName.find( '[' );
+    if( definesBegin == std::string::npos )
+    {
+        shaderName = variantName;
+        return;
+    }
+    LIBCARNA_ASSERT_EX( variantName.back() == ']', "Malformed shader variant name \"" + variantName + "\"!" );
+    shaderName = variantName.substr( 0, definesBegin );
+    std::stringstream definitions( variantName.substr( definesBegin + 1, variantName.size() - definesBegin - 2 ) );
+    std::string definition;
+    while( std::getline( definitions, definition, ',' ) )
+    {
+        const std::size_t valueBegin = definition.find( '=' );
+        if( valueBegin == std::string::npos )
+        {
+            defines[ definition ] = "";
+        }
+        else
+        {
+            defines[ definition.substr( 0, valueBegin ) ] = definition.substr( valueBegin + 1 );
+        }
+    }
+}
+
+
+/* Inserts the macro definitions into the shader sources. The definitions must
+ * follow the version directive, if there is any.
+ */
+static std::string applyDefines( const std::string& src, const ShaderManager::Defines& defines )
+{
+    if( defines.empty() )
+    {
+        return src;
+    }
+    std::stringstream definitions;
+    for( auto defineItr = defines.begin(); defineItr != defines.end(); ++defineItr )
+    {
+        definitions << "#define " << defineItr->first << " " << defineItr->second << std::endl;
+    }
+    if( src.compare( 0, 8, "#version" ) == 0 )
+    {
+        const std::size_t lineEnd = src.find( '\n' );
+        if( lineEnd == std::string::npos )
+        {
+            return src + "\n" + definitions.str();
+        }
+        else
+        {
+            return src.substr( 0, lineEnd + 1 ) + definitions.str() + src.substr( lineEnd + 1 );
+        }
+    }
+    else
+    {
+        return definitions.str() + src;
+    }
+}
+
+
+
 // ----------------------------------------------------------------------------------
 // ShaderManager :: Details
 // ----------------------------------------------------------------------------------
@@ -41,13 +141,27 @@ struct ShaderManager::Details : public Log::OnShutdownListener
         std::unique_ptr< Shader > fragShader;
         std::unique_ptr< ShaderProgram > shader;
         unsigned int acquisitionsCount;
+        bool isPending;
+        std::uint64_t programBinaryKey;
+        double buildTime;
     };
 
     std::map< std::string, std::string > sources;
     std::map< std::string, ShaderInfo* > loadedShaders;
     std::map< ShaderProgram*, std::string > loadedShaderNames;
+    std::map< std::string, double > shaderBuildTimes;
 
     const ShaderProgram& loadShader( const std::string& name );
+    ShaderInfo* beginLoadShader( const std::string& name );
+    void finishLoadShader( const std::string& name, ShaderInfo& info );
+    void discardShader( const std::string& name );
+    static void enableParallelShaderCompilation();
+
+    std::string programBinaryCacheDirectory;
+    std::size_t programBinaryCacheHitsCount;
+    std::string programBinaryPath( const std::string& name ) const;
+    ShaderProgram* loadProgramBinary( const std::string& name, std::uint64_t key ) const;
+    void saveProgramBinary( const std::string& name, std::uint64_t key, const ShaderProgram& shader ) const;
 
     bool hasLogShutDown;
     void logLeakedShaders() const;
@@ -56,22 +170,123 @@ struct ShaderManager::Details : public Log::OnShutdownListener
 
 
 ShaderManager::Details::Details()
-    : hasLogShutDown( false )
+    : programBinaryCacheHitsCount( 0 )
+    , hasLogShutDown( false )
+{
+}
+
+
+std::string ShaderManager::Details::programBinaryPath( const std::string& name ) const
+{
+    const char lastChar = programBinaryCacheDirectory.back();
+    const bool hasSeparator = lastChar == '/' || lastChar == '\\';
+
+    /* Shader variant names contain characters that are not suitable for file names.
+     */
+    std::string fileName = name;
+    for( auto charItr = fileName.begin(); charItr != fileName.end(); ++charItr )
+    {
+        if( !std::isalnum( static_cast< unsigned char >( *charItr ) ) && *charItr != '-' )
+        {
+            *charItr = '_';
+        }
+    }
+    return programBinaryCacheDirectory + ( hasSeparator ? "" : "/" ) + fileName + ".bin";
+}
+
+
+ShaderProgram* ShaderManager::Details::loadProgramBinary( const std::string& name, std::uint64_t key ) const
+{
+    std::ifstream in( programBinaryPath( name ).c_str(), std::ios::in | std::ios::binary );
+    if( !in )
+    {
+        return nullptr;
+    }
+
+    /* Read the header and verify that the binary matches the sources and the driver.
+     */
+    std::uint32_t magic = 0;
+    std::uint64_t fileKey = 0;
+    std::uint32_t binaryFormat = 0;
+    std::uint32_t binaryLength = 0;
+    in.read( reinterpret_cast< char* >( &magic        ), sizeof( magic        ) );
+    in.read( reinterpret_cast< char* >( &fileKey      ), sizeof( fileKey      ) );
+    in.read( reinterpret_cast< char* >( &binaryFormat ), sizeof( binaryFormat ) );
+    in.read( reinterpret_cast< char* >( &binaryLength ), sizeof( binaryLength ) );
+    if( !in || magic != PROGRAM_BINARY_MAGIC || fileKey != key || binaryLength == 0 )
+    {
+        return nullptr;
+    }
+
+    /* Read the binary.
+     */
+    std::vector< char > binary( binaryLength );
+    in.read( &binary[ 0 ], binaryLength );
+    if( !in )
+    {
+        return nullptr;
+    }
+    return ShaderProgram::createFromBinary( binaryFormat, binary );
+}
+
+
+void ShaderManager::Details::saveProgramBinary( const std::string& name, std::uint64_t key, const ShaderProgram& shader ) const
 {
+    unsigned int binaryFormat;
+    std::vector< char > binary;
+    if( !shader.queryBinary( binaryFormat, binary ) )
+    {
+        return;
+    }
+    const std::string path = programBinaryPath( name );
+    std::ofstream out( path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc );
+    const std::uint32_t magic = PROGRAM_BINARY_MAGIC;
+    const std::uint32_t binaryFormat32 = binaryFormat;
+    const std::uint32_t binaryLength = static_cast< std::uint32_t >( binary.size() );
+    out.write( reinterpret_cast< const char* >( &magic          ), sizeof( magic          ) );
+    out.write( reinterpret_cast< const char* >( &key            ), sizeof( key            ) );
+    out.write( reinterpret_cast< const char* >( &binaryFormat32 ), sizeof( binaryFormat32 ) );
+    out.write( reinterpret_cast< const char* >( &binaryLength   ), sizeof( binaryLength   ) );
+    out.write( &binary[ 0 ], binary.size() );
+    if( !out )
+    {
+        Log::instance().record( Log::warning, "Failed to write shader program binary \"" + path + "\"." );
+    }
 }
 
 
 const ShaderProgram& ShaderManager::Details::loadShader( const std::string& name )
 {
+    ShaderInfo* const info = beginLoadShader( name );
+    try
+    {
+        finishLoadShader( name, *info );
+    }
+    catch( ... )
+    {
+        discardShader( name );
+        throw;
+    }
+    return *info->shader;
+}
+
+
+ShaderManager::Details::ShaderInfo* ShaderManager::Details::beginLoadShader( const std::string& name )
+{
+    const Stopwatch stopwatch;
+    std::string baseName;
+    Defines defines;
+    parseVariantName( name, baseName, defines );
+
     const std::string* srcVertPtr = nullptr;
     const std::string* srcGeomPtr = nullptr;
     const std::string* srcFragPtr = nullptr;
 
     /* Look up the shader sources.
      */
-    const auto srcVertItr = sources.find( name + ".vert" );
-    const auto srcGeomItr = sources.find( name + ".geom" );
-    const auto srcFragItr = sources.find( name + ".frag" );
+    const auto srcVertItr = sources.find( baseName + ".vert" );
+    const auto srcGeomItr = sources.find( baseName + ".geom" );
+    const auto srcFragItr = sources.find( baseName + ".frag" );
     if( srcVertItr != sources.end() && srcFragItr != sources.end() )
     {
         srcVertPtr = &srcVertItr->second;
@@ -79,14 +294,14 @@ const ShaderProgram& ShaderManager::Details::loadShader( const std::string& name
     }
     else
     {
-        srcVertPtr = &res::string( name + "_vert" );
-        srcFragPtr = &res::string( name + "_frag" );
+        srcVertPtr = &res::string( baseName + "_vert" );
+        srcFragPtr = &res::string( baseName + "_frag" );
     }
     
     /* Assure the required sources were found.
      */
-    LIBCARNA_ASSERT_EX( srcVertPtr != nullptr,   "Vertex shader sources \"" + name + "\" not found!" );
-    LIBCARNA_ASSERT_EX( srcFragPtr != nullptr, "Fragment shader sources \"" + name + "\" not found!" );
+    LIBCARNA_ASSERT_EX( srcVertPtr != nullptr,   "Vertex shader sources \"" + baseName + "\" not found!" );
+    LIBCARNA_ASSERT_EX( srcFragPtr != nullptr, "Fragment shader sources \"" + baseName + "\" not found!" );
     
     /* Also look up the optional geometry shader definition.
      */
@@ -96,45 +311,140 @@ const ShaderProgram& ShaderManager::Details::loadShader( const std::string& name
     }
     else
     {
-        const auto srcGeomItr = res::strings.find( name + "_geom" );
+        const auto srcGeomItr = res::strings.find( baseName + "_geom" );
         if( srcGeomItr != res::strings.end() )
         {
             srcGeomPtr = srcGeomItr->second;
         }
     }
     
+    /* Specialize the sources for the requested variant.
+     */
+    const std::string srcVert = applyDefines( *srcVertPtr, defines );
+    const std::string srcFrag = applyDefines( *srcFragPtr, defines );
+    const std::string srcGeom = srcGeomPtr == nullptr ? "" : applyDefines( *srcGeomPtr, defines );
+    
     /* Prepare creation of new shader program.
      */
     ShaderInfo* const info = new ShaderInfo();
     info->acquisitionsCount = 1;
+    info->isPending = false;
+    info->programBinaryKey = 0;
     loadedShaders[ name ] = info;
     ShaderProgram::Factory factory;
 
-    /* Build shader sources for vertex and fragment shader.
-     */
-    const std::string& srcVert = *srcVertPtr;
-    const std::string& srcFrag = *srcFragPtr;
-    
-    info->vertShader.reset( new Shader( Shader::TYPE_VERTEX_SHADER  , srcVert ) );
-    info->fragShader.reset( new Shader( Shader::TYPE_FRAGMENT_SHADER, srcFrag ) );
-    
-    factory.setVertexShader  ( *info->vertShader );
-    factory.setFragmentShader( *info->fragShader );
-    
-    /* Build geometry shader sources if they were found.
-     */
-    if( srcGeomPtr != nullptr )
+    try
+    {
+        /* Try to load the shader program from the cache first. The key identifies
+         * the sources as well as the driver.
+         */
+        if( !programBinaryCacheDirectory.empty() && ShaderProgram::isBinarySupported() )
+        {
+            const GLContext& glc = GLContext::current();
+            info->programBinaryKey = hashFNV1a( glc.vendor() );
+            info->programBinaryKey = hashFNV1a( glc.renderer(), info->programBinaryKey );
+            info->programBinaryKey = hashFNV1a( srcVert, info->programBinaryKey );
+            info->programBinaryKey = hashFNV1a( srcGeom, info->programBinaryKey );
+            info->programBinaryKey = hashFNV1a( srcFrag, info->programBinaryKey );
+            info->shader.reset( loadProgramBinary( name, info->programBinaryKey ) );
+            if( info->shader.get() != nullptr )
+            {
+                ++programBinaryCacheHitsCount;
+                loadedShaderNames[ info->shader.get() ] = name;
+                info->buildTime = stopwatch.result();
+                return info;
+            }
+            factory.setBinaryRetrievable( true );
+        }
+
+        /* Issue the compilation of the vertex and fragment shaders. The results are
+         * not queried before 'finishLoadShader', so that the driver is free to
+         * compile multiple shaders concurrently.
+         */
+        info->vertShader.reset( new Shader( Shader::TYPE_VERTEX_SHADER  , srcVert, true ) );
+        info->fragShader.reset( new Shader( Shader::TYPE_FRAGMENT_SHADER, srcFrag, true ) );
+        
+        factory.setVertexShader  ( *info->vertShader );
+        factory.setFragmentShader( *info->fragShader );
+        
+        /* Build geometry shader sources if they were found.
+         */
+        if( srcGeomPtr != nullptr )
+        {
+            info->geomShader.reset( new Shader( Shader::TYPE_GEOMETRY_SHADER, srcGeom, true ) );
+            factory.setGeometryShader( *info->geomShader );
+        }
+        
+        /* Issue the linking of the shader program.
+         */
+        info->shader.reset( factory.createDeferred() );
+        loadedShaderNames[ info->shader.get() ] = name;
+        info->isPending = true;
+        info->buildTime = stopwatch.result();
+        return info;
+    }
+    catch( ... )
     {
-        const std::string& srcGeom = *srcGeomPtr;
-        info->geomShader.reset( new Shader( Shader::TYPE_GEOMETRY_SHADER, srcGeom ) );
-        factory.setGeometryShader( *info->geomShader );
+        discardShader( name );
+        throw;
     }
-    
-    /* Build the shader program.
+}
+
+
+void ShaderManager::Details::finishLoadShader( const std::string& name, ShaderInfo& info )
+{
+    if( info.isPending )
+    {
+        /* Querying the results blocks until the driver has finished.
+         */
+        const Stopwatch stopwatch;
+        info.vertShader->checkErrors();
+        info.fragShader->checkErrors();
+        if( info.geomShader.get() != nullptr )
+        {
+            info.geomShader->checkErrors();
+        }
+        info.shader->finishLinking();
+        info.isPending = false;
+        if( info.programBinaryKey != 0 )
+        {
+            saveProgramBinary( name, info.programBinaryKey, *info.shader );
+        }
+        info.buildTime += stopwatch.result();
+    }
+    shaderBuildTimes[ name ] = info.buildTime;
+
+    std::stringstream msg;
+    msg << "Shader \"" << name << "\" built in " << info.buildTime * 1000 << " ms.";
+    Log::instance().record( Log::verbose, msg.str() );
+}
+
+
+void ShaderManager::Details::discardShader( const std::string& name )
+{
+    const auto infoItr = loadedShaders.find( name );
+    if( infoItr != loadedShaders.end() )
+    {
+        loadedShaderNames.erase( infoItr->second->shader.get() );
+        delete infoItr->second;
+        loadedShaders.erase( infoItr );
+    }
+}
+
+
+void ShaderManager::Details::enableParallelShaderCompilation()
+{
+    /* Let the driver choose the number of compiler threads.
      */
-    info->shader.reset( factory.create() );
-    loadedShaderNames[ info->shader.get() ] = name;
-    return *info->shader;
+    if( GLEW_KHR_parallel_shader_compile )
+    {
+        glMaxShaderCompilerThreadsKHR( 0xFFFFFFFF );
+    }
+    else
+    if( GLEW_ARB_parallel_shader_compile )
+    {
+        glMaxShaderCompilerThreadsARB( 0xFFFFFFFF );
+    }
 }
 
 
@@ -201,6 +511,58 @@ const ShaderProgram& ShaderManager::acquireShader( const std::string& shaderName
     }
 }
 
+
+const ShaderProgram& ShaderManager::acquireShader( const std::string& shaderName, const Defines& defines )
+{
+    return acquireShader( variantName( shaderName, defines ) );
+}
+
+
+std::string ShaderManager::variantName( const std::string& shaderName, const Defines& defines )
+{
+    if( defines.empty() )
+    {
+        return shaderName;
+    }
+    std::stringstream name;
+    name << shaderName << "[";
+    for( auto defineItr = defines.begin(); defineItr != defines.end(); ++defineItr )
+    {
+        LIBCARNA_ASSERT( !defineItr->first.empty() );
+        name << ( defineItr == defines.begin() ? "" : "," ) << defineItr->first;
+        if( !defineItr->second.empty() )
+        {
+            name << "=" << defineItr->second;
+        }
+    }
+    name << "]";
+    return name.str();
+}
+
+
+bool ShaderManager::hasShader( const std::string& shaderName ) const
+{
+    std::string baseName;
+    Defines defines;
+    parseVariantName( shaderName, baseName, defines );
+    if( pimpl->loadedShaders.find( shaderName ) != pimpl->loadedShaders.end() )
+    {
+        return true;
+    }
+    else
+    if( pimpl->sources.find( baseName + ".vert" ) != pimpl->sources.end()
+        && pimpl->sources.find( baseName + ".frag" ) != pimpl->sources.end() )
+    {
+        return true;
+    }
+    else
+    {
+        return res::strings.find( baseName + "_vert" ) != res::strings.end()
+            && res::strings.find( baseName + "_frag" ) != res::strings.end();
+    }
+}
+
+
 void ShaderManager::releaseShader( const ShaderProgram& shader )
 {
     const auto nameItr = pimpl->loadedShaderNames.find( const_cast< ShaderProgram* >( &shader ) );
@@ -228,6 +590,90 @@ void ShaderManager::removeSource( const std::string& srcName )
 }
 
 
+void ShaderManager::setProgramBinaryCacheDirectory( const std::string& directory )
+{
+    pimpl->programBinaryCacheDirectory = directory;
+}
+
+
+const std::string& ShaderManager::programBinaryCacheDirectory() const
+{
+    return pimpl->programBinaryCacheDirectory;
+}
+
+
+std::size_t ShaderManager::programBinaryCacheHitsCount() const
+{
+    return pimpl->programBinaryCacheHitsCount;
+}
+
+
+std::vector< const ShaderProgram* > ShaderManager::prewarmShaders( const std::vector< std::string >& shaderNames )
+{
+    Details::enableParallelShaderCompilation();
+    std::vector< const ShaderProgram* > shaders;
+    std::vector< std::pair< std::string, Details::ShaderInfo* > > pendingShaders;
+    std::size_t finishedShadersCount = 0;
+    try
+    {
+        /* Issue the compilation of all shaders, before waiting for any of them.
+         */
+        for( auto nameItr = shaderNames.begin(); nameItr != shaderNames.end(); ++nameItr )
+        {
+            const std::string& shaderName = *nameItr;
+            LIBCARNA_ASSERT( !shaderName.empty() );
+            const auto infoItr = pimpl->loadedShaders.find( shaderName );
+            if( infoItr == pimpl->loadedShaders.end() )
+            {
+                Details::ShaderInfo* const info = pimpl->beginLoadShader( shaderName );
+                pendingShaders.push_back( std::make_pair( shaderName, info ) );
+                shaders.push_back( info->shader.get() );
+            }
+            else
+            {
+                ++infoItr->second->acquisitionsCount;
+                shaders.push_back( infoItr->second->shader.get() );
+            }
+        }
+
+        /* Wait for the shaders to finish.
+         */
+        for( ; finishedShadersCount < pendingShaders.size(); ++finishedShadersCount )
+        {
+            const auto& pendingShader = pendingShaders[ finishedShadersCount ];
+            pimpl->finishLoadShader( pendingShader.first, *pendingShader.second );
+        }
+        return shaders;
+    }
+    catch( ... )
+    {
+        /* Discard the shaders that did not finish and release all others.
+         */
+        std::set< const ShaderProgram* > discardedShaders;
+        for( std::size_t pendingShaderIdx = finishedShadersCount; pendingShaderIdx < pendingShaders.size(); ++pendingShaderIdx )
+        {
+            discardedShaders.insert( pendingShaders[ pendingShaderIdx ].second->shader.get() );
+            pimpl->discardShader( pendingShaders[ pendingShaderIdx ].first );
+        }
+        for( auto shaderItr = shaders.begin(); shaderItr != shaders.end(); ++shaderItr )
+        {
+            if( discardedShaders.find( *shaderItr ) == discardedShaders.end() )
+            {
+                releaseShader( **shaderItr );
+            }
+        }
+        throw;
+    }
+}
+
+
+double ShaderManager::shaderBuildTime( const std::string& shaderName ) const
+{
+    const auto timeItr = pimpl->shaderBuildTimes.find( shaderName );
+    return timeItr == pimpl->shaderBuildTimes.end() ? 0 : timeItr->second;
+}
+
+
 
 }  // namespace LibCarna :: base
 
@@ -16,7 +16,11 @@
 #include <LibCarna/base/ShaderProgram.hpp>
 #include <LibCarna/base/Shader.hpp>
 #include <LibCarna/base/ShaderCompilationError.hpp>
+#include <LibCarna/base/FrameUniformBuffer.hpp>
 #include <LibCarna/base/Log.hpp>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
 
 namespace LibCarna
 {
@@ -26,6 +30,21 @@ namespace base
 
 
 
+// ----------------------------------------------------------------------------------
+// Types & Globals
+// ----------------------------------------------------------------------------------
+
+static std::size_t uniformLocationQueries = 0;
+
+
+static GLint queryUniformLocation( GLuint programId, const std::string& name )
+{
+    ++uniformLocationQueries;
+    return glGetUniformLocation( programId, name.c_str() );
+}
+
+
+
 // ----------------------------------------------------------------------------------
 // ShaderProgram :: Factory :: Details
 // ----------------------------------------------------------------------------------
@@ -35,6 +54,7 @@ struct ShaderProgram::Factory::Details
     const Shader* vertShader;
     const Shader* geomShader;
     const Shader* fragShader;
+    bool binaryRetrievable;
     Details();
 };
 
@@ -43,6 +63,7 @@ ShaderProgram::Factory::Details::Details()
     : vertShader( nullptr )
     , geomShader( nullptr )
     , fragShader( nullptr )
+    , binaryRetrievable( false )
 {
 }
 
@@ -84,28 +105,18 @@ void ShaderProgram::Factory::setFragmentShader( const Shader& shader )
 }
 
 
+void ShaderProgram::Factory::setBinaryRetrievable( bool binaryRetrievable )
+{
+    pimpl->binaryRetrievable = binaryRetrievable;
+}
+
+
 ShaderProgram* ShaderProgram::Factory::create() const
 {
-    LIBCARNA_ASSERT_EX( pimpl->vertShader != nullptr, "No vertex shader set!" );
-    LIBCARNA_ASSERT_EX( pimpl->fragShader != nullptr, "No fragment shader set!" );
-    
-    ShaderProgram* const shaderProgram = new ShaderProgram();
+    ShaderProgram* const shaderProgram = createDeferred();
     try
     {
-        /* Compose the shader program.
-         */
-        const unsigned int id = shaderProgram->id;
-        glAttachShader( id, pimpl->vertShader->id );
-        glAttachShader( id, pimpl->fragShader->id );
-        if( pimpl->geomShader != nullptr )
-        {
-            glAttachShader( id, pimpl->geomShader->id );
-        }
-        
-        /* Link the shader program.
-         */
-        glLinkProgram( id );
-        shaderProgram->checkErrors();
+        shaderProgram->finishLinking();
         return shaderProgram;
     }
     catch( ... )
@@ -116,13 +127,66 @@ ShaderProgram* ShaderProgram::Factory::create() const
 }
 
 
+ShaderProgram* ShaderProgram::Factory::createDeferred() const
+{
+    LIBCARNA_ASSERT_EX( pimpl->vertShader != nullptr, "No vertex shader set!" );
+    LIBCARNA_ASSERT_EX( pimpl->fragShader != nullptr, "No fragment shader set!" );
+    
+    ShaderProgram* const shaderProgram = new ShaderProgram();
+
+    /* Compose the shader program.
+     */
+    const unsigned int id = shaderProgram->id;
+    glAttachShader( id, pimpl->vertShader->id );
+    glAttachShader( id, pimpl->fragShader->id );
+    if( pimpl->geomShader != nullptr )
+    {
+        glAttachShader( id, pimpl->geomShader->id );
+    }
+    
+    /* Link the shader program.
+     */
+    if( pimpl->binaryRetrievable && isBinarySupported() )
+    {
+        glProgramParameteri( id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE );
+    }
+    glLinkProgram( id );
+    return shaderProgram;
+}
+
+
+
+// ----------------------------------------------------------------------------------
+// ShaderProgram :: Details
+// ----------------------------------------------------------------------------------
+
+struct ShaderProgram::Details
+{
+    Details();
+
+    std::unordered_map< std::string, int > uniformLocations;
+
+    const void* uniformsOwner;
+    std::uint64_t uniformsOwnerRevision;
+    std::vector< int > uniformsOwnerLocations;
+};
+
+
+ShaderProgram::Details::Details()
+    : uniformsOwner( nullptr )
+    , uniformsOwnerRevision( 0 )
+{
+}
+
+
 
 // ----------------------------------------------------------------------------------
 // ShaderProgram
 // ----------------------------------------------------------------------------------
 
 ShaderProgram::ShaderProgram()
-    : id( glCreateProgram() )
+    : pimpl( new Details() )
+    , id( glCreateProgram() )
 {
 }
 
@@ -151,6 +215,172 @@ void ShaderProgram::checkErrors() const
 }
 
 
+void ShaderProgram::finishLinking()
+{
+    checkErrors();
+    reflect();
+}
+
+
+void ShaderProgram::reflect()
+{
+    /* Connect the uniform block of the frame uniforms to the buffer, if the shader
+     * program uses it.
+     */
+    const GLuint frameUniformsIndex = glGetUniformBlockIndex( id, FrameUniformBuffer::BLOCK_NAME.c_str() );
+    if( frameUniformsIndex != GL_INVALID_INDEX )
+    {
+        glUniformBlockBinding( id, frameUniformsIndex, FrameUniformBuffer::BINDING_POINT );
+    }
+
+    /* Query the locations of the active uniforms.
+     */
+    GLint uniformsCount = 0;
+    GLint maxNameLength = 0;
+    glGetProgramiv( id, GL_ACTIVE_UNIFORMS, &uniformsCount );
+    glGetProgramiv( id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength );
+    std::vector< GLchar > nameBuffer( std::max( maxNameLength, 1 ) );
+    for( GLint uniformIndex = 0; uniformIndex < uniformsCount; ++uniformIndex )
+    {
+        GLint size;
+        GLenum type;
+        GLsizei nameLength;
+        glGetActiveUniform( id, uniformIndex, static_cast< GLsizei >( nameBuffer.size() ), &nameLength, &size, &type, &nameBuffer[ 0 ] );
+        const std::string name( &nameBuffer[ 0 ], nameLength );
+
+        /* Uniforms of uniform blocks have no locations.
+         */
+        const GLint location = queryUniformLocation( id, name );
+        if( location == -1 )
+        {
+            continue;
+        }
+        pimpl->uniformLocations[ name ] = location;
+
+        /* Arrays are reported by the name of their first element. Each element can
+         * be addressed individually, and the array also by its plain name.
+         */
+        const std::string::size_type bracket = name.rfind( "[0]" );
+        if( bracket != std::string::npos && bracket + 3 == name.size() )
+        {
+            const std::string arrayName = name.substr( 0, bracket );
+            pimpl->uniformLocations[ arrayName ] = location;
+            for( GLint elementIndex = 1; elementIndex < size; ++elementIndex )
+            {
+                const std::string elementName = arrayName + "[" + std::to_string( elementIndex ) + "]";
+                const GLint elementLocation = queryUniformLocation( id, elementName );
+                if( elementLocation != -1 )
+                {
+                    pimpl->uniformLocations[ elementName ] = elementLocation;
+                }
+            }
+        }
+    }
+}
+
+
+int ShaderProgram::uniformLocation( const std::string& name ) const
+{
+    const auto locationItr = pimpl->uniformLocations.find( name );
+    if( locationItr == pimpl->uniformLocations.end() )
+    {
+        return -1;
+    }
+    else
+    {
+        return locationItr->second;
+    }
+}
+
+
+void ShaderProgram::setUniformsOwner( const void* owner, std::uint64_t revision, const std::vector< int >& locations ) const
+{
+    pimpl->uniformsOwner = owner;
+    pimpl->uniformsOwnerRevision = revision;
+    pimpl->uniformsOwnerLocations = locations;
+}
+
+
+bool ShaderProgram::isUniformsOwner( const void* owner, std::uint64_t revision ) const
+{
+    return owner != nullptr && pimpl->uniformsOwner == owner && pimpl->uniformsOwnerRevision == revision;
+}
+
+
+void ShaderProgram::revokeUniformsOwner( int location ) const
+{
+    if( pimpl->uniformsOwner != nullptr
+        && std::find( pimpl->uniformsOwnerLocations.begin(), pimpl->uniformsOwnerLocations.end(), location ) != pimpl->uniformsOwnerLocations.end() )
+    {
+        pimpl->uniformsOwner = nullptr;
+        pimpl->uniformsOwnerLocations.clear();
+    }
+}
+
+
+bool ShaderProgram::isBinarySupported()
+{
+    if( !GLEW_VERSION_4_1 && !GLEW_ARB_get_program_binary )
+    {
+        return false;
+    }
+    GLint binaryFormatsCount = 0;
+    glGetIntegerv( GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormatsCount );
+    return binaryFormatsCount > 0;
+}
+
+
+bool ShaderProgram::queryBinary( unsigned int& binaryFormat, std::vector< char >& binary ) const
+{
+    if( !isBinarySupported() )
+    {
+        return false;
+    }
+    GLint binaryLength = 0;
+    glGetProgramiv( id, GL_PROGRAM_BINARY_LENGTH, &binaryLength );
+    if( binaryLength <= 0 )
+    {
+        return false;
+    }
+    binary.resize( binaryLength );
+    GLenum format = 0;
+    GLsizei writtenLength = 0;
+    glGetProgramBinary( id, binaryLength, &writtenLength, &format, &binary[ 0 ] );
+    binary.resize( writtenLength );
+    binaryFormat = format;
+    return writtenLength > 0;
+}
+
+
+ShaderProgram* ShaderProgram::createFromBinary( unsigned int binaryFormat, const std::vector< char >& binary )
+{
+    if( binary.empty() || !isBinarySupported() )
+    {
+        return nullptr;
+    }
+    ShaderProgram* const shaderProgram = new ShaderProgram();
+    glProgramBinary( shaderProgram->id, binaryFormat, &binary[ 0 ], static_cast< GLsizei >( binary.size() ) );
+
+    /* The driver rejects binaries, that it is no longer compatible with.
+     */
+    GLint linkStatus = GL_FALSE;
+    glGetProgramiv( shaderProgram->id, GL_LINK_STATUS, &linkStatus );
+    if( linkStatus != GL_TRUE )
+    {
+        delete shaderProgram;
+        return nullptr;
+    }
+    shaderProgram->reflect();
+    return shaderProgram;
+}
+
+
+std::size_t ShaderProgram::uniformLocationQueriesCount()
+{
+    return uniformLocationQueries;
+}
+
+
 ShaderProgram::~ShaderProgram()
 {
     if( id )
@@ -14,6 +14,7 @@
 
 #include <LibCarna/base/glew.hpp>
 #include <LibCarna/base/ShaderUniform.hpp>
+#include <LibCarna/base/ShaderProgram.hpp>
 
 namespace LibCarna
 {
@@ -40,18 +41,20 @@ ShaderUniformBase::~ShaderUniformBase()
 
 int ShaderUniformBase::location( const ShaderProgram& shader ) const
 {
-    const GLint location = glGetUniformLocation( shader.id, name.c_str() );
-    return location;
+    return shader.uniformLocation( name );
 }
 
 
 bool ShaderUniformBase::upload() const
 {
     GLContext& glc = GLContext::current();
-    const int loc = location( glc.shader() );
+    const ShaderProgram& shader = glc.shader();
+    const int loc = location( shader );
     if( loc != NULL_UNIFORM_LOCATION )
     {
+        shader.revokeUniformsOwner( loc );
         uploadTo( loc );
+        glc.record( &GLStatistics::uniformUploads );
         return true;
     }
     else
@@ -61,6 +64,12 @@ bool ShaderUniformBase::upload() const
 }
 
 
+bool ShaderUniformBase::hasSameValue( const ShaderUniformBase& ) const
+{
+    return false;
+}
+
+
 
 // ----------------------------------------------------------------------------------
 // uploadUniform
@@ -29,7 +29,27 @@ namespace base
 // ----------------------------------------------------------------------------------
 
 Spatial::Spatial( const std::string& tag )
-    : myParent( nullptr )
+    : myKind( kindSpatial )
+    , myParent( nullptr )
+    , myWorldTransformRevision( 0 )
+    , myParentWorldTransformRevision( 0 )
+    , isWorldTransformValid( false )
+    , myWorldTransformChanged( false )
+    , localTransform( math::identity4f() )
+    , myUserData( nullptr )
+    , movable( true )
+    , myTag( tag )
+{
+}
+
+
+Spatial::Spatial( const std::string& tag, Kind kind )
+    : myKind( kind )
+    , myParent( nullptr )
+    , myWorldTransformRevision( 0 )
+    , myParentWorldTransformRevision( 0 )
+    , isWorldTransformValid( false )
+    , myWorldTransformChanged( false )
     , localTransform( math::identity4f() )
     , myUserData( nullptr )
     , movable( true )
@@ -45,9 +65,15 @@ Spatial::~Spatial()
 
 void Spatial::updateParent( Node& parent )
 {
+    /* Node::hasChild is answered through 'myParent', thus it cannot be used to
+     * check the consistency of the tree here. Instead, make sure that the spatial
+     * was detached from its previous parent, so that it is not listed among the
+     * children of two nodes.
+     */
     LIBCARNA_ASSERT( &parent != this );
-    LIBCARNA_ASSERT( parent.hasChild( *this ) );
+    LIBCARNA_ASSERT( !hasParent() );
     myParent = &parent;
+    isWorldTransformValid = false;
 }
 
 
@@ -63,6 +89,7 @@ Spatial* Spatial::detachFromParent()
     {
         Spatial* const result = myParent->detachChild( *this );
         myParent = nullptr;
+        isWorldTransformValid = false;
         return result;
     }
     else
@@ -94,9 +121,8 @@ Node& Spatial::findRoot()
     }
     else
     {
-        Node* const node = dynamic_cast< Node* >( this );
-        LIBCARNA_ASSERT( node != nullptr );
-        return *node;
+        LIBCARNA_ASSERT( isNode() );
+        return static_cast< Node& >( *this );
     }
 }
 
@@ -109,22 +135,37 @@ const Node& Spatial::findRoot() const
     }
     else
     {
-        const Node* const node = dynamic_cast< const Node* >( this );
-        LIBCARNA_ASSERT( node != nullptr );
-        return *node;
+        LIBCARNA_ASSERT( isNode() );
+        return static_cast< const Node& >( *this );
     }
 }
 
 
 void Spatial::updateWorldTransform()
 {
-    if( hasParent() )
-    {
-        myWorldTransform = myParent->worldTransform() * localTransform;
-    }
-    else
+    /* The 'localTransform' attribute may be written directly, thus its changes are
+     * detected by comparing it to the value that was used the last time. Changes of
+     * the parent are detected through its revision number.
+     */
+    const std::size_t parentWorldTransformRevision = hasParent() ? myParent->myWorldTransformRevision : 0;
+    myWorldTransformChanged = !isWorldTransformValid
+        || parentWorldTransformRevision != myParentWorldTransformRevision
+        || localTransform != myLastLocalTransform;
+
+    if( myWorldTransformChanged )
     {
-        myWorldTransform = localTransform;
+        if( hasParent() )
+        {
+            myWorldTransform = myParent->worldTransform() * localTransform;
+        }
+        else
+        {
+            myWorldTransform = localTransform;
+        }
+        myLastLocalTransform = localTransform;
+        myParentWorldTransformRevision = parentWorldTransformRevision;
+        isWorldTransformValid = true;
+        ++myWorldTransformRevision;
     }
 }
 
@@ -135,6 +176,18 @@ const math::Matrix4f& Spatial::worldTransform() const
 }
 
 
+bool Spatial::hasWorldTransformChanged() const
+{
+    return myWorldTransformChanged;
+}
+
+
+void Spatial::invalidateWorldTransform()
+{
+    isWorldTransformValid = false;
+}
+
+
 void Spatial::removeUserData()
 {
     myUserData = nullptr;
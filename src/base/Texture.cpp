@@ -15,6 +15,7 @@
 #include <LibCarna/base/glew.hpp>
 #include <LibCarna/base/glError.hpp>
 #include <LibCarna/base/Texture.hpp>
+#include <LibCarna/base/GLContext.hpp>
 #include <LibCarna/base/LibCarnaException.hpp>
 #include <LibCarna/base/text.hpp>
 
@@ -46,24 +47,21 @@ static unsigned int createGLTextureObject()
 template< >
 void bindGLTextureObject< 1 >( unsigned int unit, unsigned int id )
 {
-    glActiveTexture( GL_TEXTURE0 + unit );
-    glBindTexture( GL_TEXTURE_1D, id );
+    GLContext::current().bindTexture( unit, GL_TEXTURE_1D, id );
 }
 
 
 template< >
 void bindGLTextureObject< 2 >( unsigned int unit, unsigned int id )
 {
-    glActiveTexture( GL_TEXTURE0 + unit );
-    glBindTexture( GL_TEXTURE_2D, id );
+    GLContext::current().bindTexture( unit, GL_TEXTURE_2D, id );
 }
 
 
 template< >
 void bindGLTextureObject< 3 >( unsigned int unit, unsigned int id )
 {
-    glActiveTexture( GL_TEXTURE0 + unit );
-    glBindTexture( GL_TEXTURE_3D, id );
+    GLContext::current().bindTexture( unit, GL_TEXTURE_3D, id );
 }
 
 
@@ -83,6 +81,70 @@ static void checkGLTextureDataParameters( int& internalFormat, int& pixelFormat,
 
 
 
+// ----------------------------------------------------------------------------------
+// computeGLTextureDataSize
+// ----------------------------------------------------------------------------------
+
+static std::size_t computeGLTextureDataSize( std::size_t texelsCount, int pixelFormat, int bufferType, const void* bufferPtr )
+{
+    if( bufferPtr == NULL )
+    {
+        return 0;
+    }
+
+    std::size_t componentsCount;
+    switch( pixelFormat )
+    {
+
+    case GL_RG:
+    case GL_RG_INTEGER:
+        componentsCount = 2;
+        break;
+
+    case GL_RGB:
+    case GL_BGR:
+    case GL_RGB_INTEGER:
+        componentsCount = 3;
+        break;
+
+    case GL_RGBA:
+    case GL_BGRA:
+    case GL_RGBA_INTEGER:
+        componentsCount = 4;
+        break;
+
+    default:
+        componentsCount = 1;
+        break;
+
+    }
+
+    std::size_t componentSize;
+    switch( bufferType )
+    {
+
+    case GL_BYTE:
+    case GL_UNSIGNED_BYTE:
+        componentSize = 1;
+        break;
+
+    case GL_SHORT:
+    case GL_UNSIGNED_SHORT:
+    case GL_HALF_FLOAT:
+        componentSize = 2;
+        break;
+
+    default:
+        componentSize = 4;
+        break;
+
+    }
+
+    return texelsCount * componentsCount * componentSize;
+}
+
+
+
 // ----------------------------------------------------------------------------------
 // TextureBase
 // ----------------------------------------------------------------------------------
@@ -96,6 +158,7 @@ TextureBase::TextureBase()
 TextureBase::~TextureBase()
 {
     glDeleteTextures( 1, &id );
+    GLContext::forgetTexture( id );
 }
 
 
@@ -118,6 +181,8 @@ void TextureBase::uploadGLTextureData
     glTexImage1D( GL_TEXTURE_1D, 0, internalFormat, size.x()
                 , 0, pixelFormat, bufferType, bufferPtr );
     REPORT_GL_ERROR;
+    GLContext::current().record( &GLStatistics::uploadedTextureBytes
+        , computeGLTextureDataSize( size.x(), pixelFormat, bufferType, bufferPtr ) );
 }
 
 
@@ -131,6 +196,8 @@ void TextureBase::uploadGLTextureData
     checkGLTextureDataParameters( internalFormat, pixelFormat, bufferType, bufferPtr );
     glTexImage2D( GL_TEXTURE_2D, 0, internalFormat, size.x(), size.y(), 0, pixelFormat, bufferType, bufferPtr );
     REPORT_GL_ERROR;
+    GLContext::current().record( &GLStatistics::uploadedTextureBytes
+        , computeGLTextureDataSize( std::size_t( size.x() ) * size.y(), pixelFormat, bufferType, bufferPtr ) );
 }
 
 
@@ -151,6 +218,8 @@ void TextureBase::uploadGLTextureData
     glTexImage3D( GL_TEXTURE_3D, 0, internalFormat, size.x(), size.y(), size.z(), 0, pixelFormat, bufferType, bufferPtr );
     glPixelStorei( GL_UNPACK_ALIGNMENT, unpackAlignment );
     REPORT_GL_ERROR;
+    GLContext::current().record( &GLStatistics::uploadedTextureBytes
+        , computeGLTextureDataSize( std::size_t( size.x() ) * size.y() * size.z(), pixelFormat, bufferType, bufferPtr ) );
 }
 
 
@@ -13,7 +13,12 @@
  */
 
 #include <LibCarna/base/text.hpp>
+#include <LibCarna/base/LibCarnaException.hpp>
+#include <algorithm>
+#include <cmath>
 #include <fstream>
+#include <iterator>
+#include <limits>
 
 namespace LibCarna
 {
@@ -37,6 +42,156 @@ std::string cat( const std::string& fileName )
 }
 
 
+void readAll( std::istream& stream, std::vector< char >& buffer )
+{
+    const std::istream::pos_type begin = stream.tellg();
+    stream.seekg( 0, std::ios::end );
+    const std::istream::pos_type end = stream.tellg();
+    if( begin != std::istream::pos_type( -1 ) && end != std::istream::pos_type( -1 ) && end >= begin )
+    {
+        stream.seekg( begin );
+        buffer.resize( static_cast< std::size_t >( end - begin ) );
+        if( !buffer.empty() )
+        {
+            stream.read( &buffer[ 0 ], buffer.size() );
+            LIBCARNA_ASSERT_EX( static_cast< std::size_t >( stream.gcount() ) == buffer.size(), "Failed to read stream!" );
+        }
+    }
+    else
+    {
+        /* The stream is not seekable, e.g. a pipe.
+         */
+        stream.clear();
+        buffer.assign( std::istreambuf_iterator< char >( stream ), std::istreambuf_iterator< char >() );
+    }
+    LIBCARNA_ASSERT_EX( !stream.bad(), "Failed to read stream!" );
+}
+
+
+bool parseDouble( const char* first, const char* last, double& value )
+{
+    const char* cursor = first;
+    const bool negative = cursor != last && *cursor == '-';
+    if( cursor != last && ( *cursor == '-' || *cursor == '+' ) )
+    {
+        ++cursor;
+    }
+
+    /* Accumulate up to 19 significant digits, which fit into 64 bits. Further
+     * digits only affect the exponent.
+     */
+    uint64_t mantissa = 0;
+    int exponent = 0;
+    unsigned int digitsCount = 0;
+    unsigned int significantDigitsCount = 0;
+    for( bool fraction = false; cursor != last; ++cursor )
+    {
+        if( *cursor >= '0' && *cursor <= '9' )
+        {
+            ++digitsCount;
+            if( significantDigitsCount < 19 )
+            {
+                mantissa = mantissa * 10 + ( *cursor - '0' );
+                significantDigitsCount += mantissa > 0 ? 1 : 0;
+                exponent -= fraction ? 1 : 0;
+            }
+            else
+            {
+                exponent += fraction ? 0 : 1;
+            }
+        }
+        else
+        if( *cursor == '.' && !fraction )
+        {
+            fraction = true;
+        }
+        else
+        {
+            break;
+        }
+    }
+    if( digitsCount == 0 )
+    {
+        return false;
+    }
+
+    /* Parse the exponent.
+     */
+    if( cursor != last && ( *cursor == 'e' || *cursor == 'E' ) )
+    {
+        ++cursor;
+        const bool negativeExponent = cursor != last && *cursor == '-';
+        if( cursor != last && ( *cursor == '-' || *cursor == '+' ) )
+        {
+            ++cursor;
+        }
+        if( cursor == last )
+        {
+            return false;
+        }
+        int explicitExponent = 0;
+        for( ; cursor != last && *cursor >= '0' && *cursor <= '9'; ++cursor )
+        {
+            explicitExponent = std::min( explicitExponent * 10 + ( *cursor - '0' ), 1000 );
+        }
+        exponent += negativeExponent ? -explicitExponent : explicitExponent;
+    }
+    if( cursor != last )
+    {
+        return false;
+    }
+
+    /* Dividing by a power of ten is more accurate than multiplying by its inverse.
+     */
+    double result = static_cast< double >( mantissa );
+    if( exponent < 0 )
+    {
+        result /= std::pow( 10.0, -exponent );
+    }
+    else
+    {
+        result *= std::pow( 10.0, exponent );
+    }
+    value = negative ? -result : result;
+    return true;
+}
+
+
+bool parseInt( const char* first, const char* last, int64_t& value )
+{
+    const char* cursor = first;
+    const bool negative = cursor != last && *cursor == '-';
+    if( cursor != last && ( *cursor == '-' || *cursor == '+' ) )
+    {
+        ++cursor;
+    }
+    if( cursor == last )
+    {
+        return false;
+    }
+
+    const uint64_t limit = static_cast< uint64_t >( std::numeric_limits< int64_t >::max() );
+    uint64_t magnitude = 0;
+    for( ; cursor != last; ++cursor )
+    {
+        if( *cursor < '0' || *cursor > '9' )
+        {
+            return false;
+        }
+        /* Check for overflow before it happens.
+         */
+        const unsigned int digit = *cursor - '0';
+        if( magnitude > ( limit - digit ) / 10 )
+        {
+            return false;
+        }
+        magnitude = magnitude * 10 + digit;
+    }
+    value = negative ? -static_cast< int64_t >( magnitude ) : static_cast< int64_t >( magnitude );
+    return true;
+}
+
+
 
 }  // namespace LibCarna :: base :: text
 
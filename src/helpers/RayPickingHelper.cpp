@@ -0,0 +1,218 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#include <LibCarna/helpers/RayPickingHelper.hpp>
+#include <LibCarna/base/Node.hpp>
+#include <LibCarna/base/Geometry.hpp>
+#include <LibCarna/base/ManagedMesh.hpp>
+#include <LibCarna/base/IntensityVolume.hpp>
+#include <LibCarna/base/math/Ray.hpp>
+#include <algorithm>
+#include <limits>
+#include <map>
+
+namespace LibCarna
+{
+
+namespace helpers
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// RayPickingHelper :: Details
+// ----------------------------------------------------------------------------------
+
+struct RayPickingHelper::Details
+{
+    struct GeometryTypeInfo
+    {
+        unsigned int role;
+        bool isVolume;
+        float threshold;
+        IntensitiesSelector selectIntensities;
+    };
+
+    std::map< unsigned int, GeometryTypeInfo > geometryTypes;
+
+    static bool pickVolume
+        ( const base::IntensityVolume& volume
+        , float threshold
+        , const base::math::Ray3f& rayModel
+        , base::math::Vector3f& hitModel );
+};
+
+
+bool RayPickingHelper::Details::pickVolume
+    ( const base::IntensityVolume& volume
+    , float threshold
+    , const base::math::Ray3f& rayModel
+    , base::math::Vector3f& hitModel )
+{
+    /* The unit cube that is centered in the model space origin spans the volume,
+     * from the center of its first voxel to the center of its last voxel. Thus the
+     * model space location p corresponds to the voxel coordinates (p + 0.5) * (n - 1).
+     */
+    const base::math::Vector3f voxelScale = ( volume.size.cast< float >() - base::math::Vector3f( 1, 1, 1 ) ).cwiseMax( 1 );
+    const base::math::Vector3f origin    = ( rayModel.origin + base::math::Vector3f( 0.5f, 0.5f, 0.5f ) ).cwiseProduct( voxelScale );
+    const base::math::Vector3f direction = rayModel.direction.cwiseProduct( voxelScale );
+
+    /* Compute where the ray enters and leaves the voxels.
+     */
+    const base::math::Vector3f lower = base::math::Vector3f( -0.5f, -0.5f, -0.5f );
+    const base::math::Vector3f upper = volume.size.cast< float >() - base::math::Vector3f( 0.5f, 0.5f, 0.5f );
+    const base::math::Vector3f inverseDirection = direction.cwiseInverse();
+    const base::math::Vector3f t1 = ( lower - origin ).cwiseProduct( inverseDirection );
+    const base::math::Vector3f t2 = ( upper - origin ).cwiseProduct( inverseDirection );
+    const float tEnter = std::max( t1.cwiseMin( t2 ).maxCoeff(), 0.f );
+    const float tLeave = t1.cwiseMax( t2 ).minCoeff();
+    if( !( tEnter <= tLeave ) )
+    {
+        return false;
+    }
+
+    /* March the ray at half the voxel size.
+     */
+    const float tStep = 0.5f / direction.norm();
+    const base::math::Vector3ui maxVoxel = volume.size - base::math::Vector3ui( 1, 1, 1 );
+    for( float t = tEnter; t <= tLeave; t += tStep )
+    {
+        const base::math::Vector3f position = origin + direction * t;
+        const base::math::Vector3ui voxel = base::math::round_ui( base::math::Vector3f( position.cwiseMax( 0.f ) ) ).cwiseMin( maxVoxel );
+        if( volume( voxel ) > threshold )
+        {
+            hitModel = rayModel.origin + rayModel.direction * t;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+
+// ----------------------------------------------------------------------------------
+// RayPickingHelper
+// ----------------------------------------------------------------------------------
+
+RayPickingHelper::RayPickingHelper()
+    : pimpl( new Details() )
+{
+}
+
+
+RayPickingHelper::~RayPickingHelper()
+{
+}
+
+
+void RayPickingHelper::putMeshGeometryType( unsigned int geometryType, unsigned int meshRole )
+{
+    Details::GeometryTypeInfo& info = pimpl->geometryTypes[ geometryType ];
+    info.role = meshRole;
+    info.isVolume = false;
+    info.selectIntensities = IntensitiesSelector();
+}
+
+
+void RayPickingHelper::putVolumeGeometryType
+    ( unsigned int geometryType
+    , unsigned int intensitiesRole
+    , float threshold
+    , const IntensitiesSelector& selectIntensities )
+{
+    Details::GeometryTypeInfo& info = pimpl->geometryTypes[ geometryType ];
+    info.role = intensitiesRole;
+    info.isVolume = true;
+    info.threshold = threshold;
+    info.selectIntensities = selectIntensities;
+}
+
+
+void RayPickingHelper::removeGeometryType( unsigned int geometryType )
+{
+    pimpl->geometryTypes.erase( geometryType );
+}
+
+
+void RayPickingHelper::clearGeometryTypes()
+{
+    pimpl->geometryTypes.clear();
+}
+
+
+const base::Geometry* RayPickingHelper::pick
+    ( const base::Node& root
+    , const base::math::Ray3f& ray
+    , base::math::Vector3f& hitLocation ) const
+{
+    const base::Geometry* hitGeometry = nullptr;
+    float hitDistance = std::numeric_limits< float >::infinity();
+    root.visitChildren( true, [&]( const base::Spatial& spatial )
+        {
+            if( !spatial.isGeometry() )
+            {
+                return;
+            }
+            const base::Geometry& geom = static_cast< const base::Geometry& >( spatial );
+            const auto infoItr = pimpl->geometryTypes.find( geom.geometryType );
+            if( infoItr == pimpl->geometryTypes.end() || !geom.hasFeature( infoItr->second.role ) )
+            {
+                return;
+            }
+            const Details::GeometryTypeInfo& info = infoItr->second;
+            const base::GeometryFeature& feature = geom.feature( info.role );
+
+            /* Transform the ray from world space to model space.
+             */
+            const base::math::Matrix4f modelTransform = geom.worldTransform().inverse();
+            base::math::Ray3f rayModel;
+            rayModel.origin    = base::math::vector3< float, 4 >( modelTransform * base::math::vector4( ray.origin, 1 ) );
+            rayModel.direction = base::math::vector3< float, 4 >( modelTransform * base::math::vector4( ray.direction, 0 ) );
+
+            bool isHit = false;
+            base::math::Vector3f hitModel;
+            if( info.isVolume )
+            {
+                const base::IntensityVolume* const volume = info.selectIntensities( feature );
+                isHit = volume != nullptr && Details::pickVolume( *volume, info.threshold, rayModel, hitModel );
+            }
+            else
+            {
+                const base::ManagedMeshBase* const mesh = dynamic_cast< const base::ManagedMeshBase* >( &feature );
+                isHit = mesh != nullptr && mesh->computeRayHit( hitModel, rayModel );
+            }
+
+            /* Keep the hit that is close-most to the ray origin.
+             */
+            if( isHit )
+            {
+                const base::math::Vector3f hitWorld = base::math::vector3< float, 4 >( geom.worldTransform() * base::math::vector4( hitModel, 1 ) );
+                const float distance = ( hitWorld - ray.origin ).norm();
+                if( distance < hitDistance )
+                {
+                    hitDistance = distance;
+                    hitGeometry = &geom;
+                    hitLocation = hitWorld;
+                }
+            }
+        }
+    );
+    return hitGeometry;
+}
+
+
+
+}  // namespace LibCarna :: helpers
+
+}  // namespace LibCarna
@@ -16,6 +16,7 @@
 #include <LibCarna/presets/CompositionStage.hpp>
 #include <LibCarna/base/FrameRenderer.hpp>
 #include <LibCarna/base/Framebuffer.hpp>
+#include <LibCarna/base/RenderTargetPool.hpp>
 #include <LibCarna/base/Texture.hpp>
 #include <LibCarna/base/ShaderManager.hpp>
 #include <LibCarna/base/ShaderUniform.hpp>
@@ -40,8 +41,6 @@ struct CompositionStage::Details
     CompositionMode compositionMode;
     bool swap;
 
-    std::unique_ptr< base::Texture< 2 > > intermediateRenderTexture;
-    std::unique_ptr< base::Framebuffer  > intermediateBuffer;
     const base::ShaderProgram* interleaveShader;
     
     void renderInterleaved
@@ -94,10 +93,11 @@ void CompositionStage::Details::renderInterleavedPass
 {
     LIBCARNA_ASSERT( interleaveShader != nullptr );
     
-    /* Render to intermediate buffer.
+    /* Render to intermediate buffer, that is leased from the frame renderer.
      */
-    const base::Viewport framebufferViewport( *intermediateBuffer );
-    LIBCARNA_RENDER_TO_FRAMEBUFFER( *intermediateBuffer,
+    const base::RenderTargetPool::Lease intermediate( rt.renderer.renderTargets(), rt.renderer.viewport().width(), rt.renderer.viewport().height() );
+    const base::Viewport framebufferViewport( intermediate.framebuffer() );
+    LIBCARNA_RENDER_TO_FRAMEBUFFER( intermediate.framebuffer(),
         
         glClearColor( 0, 0, 0, 0 );
         rt.renderer.glContext().clearBuffers( base::GLContext::COLOR_BUFFER_BIT | base::GLContext::DEPTH_BUFFER_BIT );
@@ -111,7 +111,7 @@ void CompositionStage::Details::renderInterleavedPass
     rs.setDepthTest( false );
     rs.setDepthWrite( false );
     const static unsigned int UNIT = base::TextureBase::SETUP_UNIT + 1;
-    intermediateRenderTexture->bind( UNIT );
+    intermediate.renderTexture().bind( UNIT );
     rt.renderer.glContext().setShader( *interleaveShader );
     base::ShaderUniform< int >( "mod2result", isFirstInvocation ? 0 : 1 ).upload();
     base::FrameRenderer::RenderTextureParams params( UNIT );
@@ -187,23 +187,10 @@ void CompositionStage::setCompositionMode( CompositionMode compositionMode )
 void CompositionStage::reshape( base::FrameRenderer& fr, unsigned int width, unsigned int height )
 {
     base::RenderStage::reshape( fr, width, height );
-    if( pimpl->intermediateBuffer.get() == nullptr )
+    if( pimpl->interleaveShader == nullptr )
     {
-        /* Initialize buffers.
-         */
-        pimpl->intermediateRenderTexture.reset( base::Framebuffer::createRenderTexture() );
-        pimpl->intermediateBuffer.reset( new base::Framebuffer( width, height, *pimpl->intermediateRenderTexture ) );
-
-        /* Acquire other resources.
-         */
         pimpl->interleaveShader = &base::ShaderManager::instance().acquireShader( "interleave" );
     }
-    else
-    {
-        /* Reshape buffers.
-         */
-        pimpl->intermediateBuffer->resize( width, height );
-    }
 }
 
 
@@ -235,6 +222,12 @@ void CompositionStage::prepareFrame( base::Node& root )
 }
 
 
+void CompositionStage::collectShaderNames( const base::Node&, std::vector< std::string >& shaderNames ) const
+{
+    shaderNames.push_back( "interleave" );
+}
+
+
 
 }  // namespace LibCarna :: presets
 
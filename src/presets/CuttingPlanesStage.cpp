@@ -229,9 +229,8 @@ void CuttingPlanesStage::render( const base::Renderable& volume )
     
     /* Upload volume-specific uniforms that are equal for all planes.
      */
-    const base::math::Matrix4f modelViewProjection = pimpl->renderTask->projection * volume.modelViewTransform();
     const base::math::Matrix4f modelTexture = texture.textureCoordinatesCorrection * base::math::translation4f( 0.5f, 0.5f, 0.5f );
-    base::ShaderUniform< base::math::Matrix4f >( "modelViewProjection", modelViewProjection ).upload();
+    base::ShaderUniform< base::math::Matrix4f >( "modelView", volume.modelViewTransform() ).upload();
     base::ShaderUniform< base::math::Matrix4f >( "modelTexture", modelTexture ).upload();
     base::ShaderUniform< int >( "intensities", Details::VOLUME_TEXTURE_UNIT ).upload();
 
@@ -323,6 +322,12 @@ void CuttingPlanesStage::renderPass
 }
 
 
+void CuttingPlanesStage::collectShaderNames( const base::Node&, std::vector< std::string >& shaderNames ) const
+{
+    shaderNames.push_back( "cutting_plane" );
+}
+
+
 
 }  // namespace LibCarna :: presets
 
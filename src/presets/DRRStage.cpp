@@ -16,6 +16,7 @@
 #include <LibCarna/base/glew.hpp>
 #include <LibCarna/base/ShaderManager.hpp>
 #include <LibCarna/base/Framebuffer.hpp>
+#include <LibCarna/base/RenderTargetPool.hpp>
 #include <LibCarna/base/Viewport.hpp>
 #include <LibCarna/base/RenderState.hpp>
 #include <LibCarna/base/ShaderUniform.hpp>
@@ -46,9 +47,6 @@ struct DRRStage::Details
     float upperMultiplier;
     bool renderInverse;
 
-    std::unique_ptr< base::Texture< 2 > > accumulationColorBuffer;
-    std::unique_ptr< base::Framebuffer  > accumulationFrameBuffer;
-
     const base::ShaderProgram* exponentialShader;
 
     static inline float huvToIntensity( base::HUV huv )
@@ -178,14 +176,6 @@ void DRRStage::setRenderingInverse( bool inverse )
 }
 
 
-void DRRStage::reshape( base::FrameRenderer& fr, unsigned int width, unsigned int height )
-{
-    base::RenderStage::reshape( fr, width, height );
-    pimpl->accumulationColorBuffer.reset( base::Framebuffer::createRenderTexture( true ) );
-    pimpl->accumulationFrameBuffer.reset( new base::Framebuffer( width, height, *pimpl->accumulationColorBuffer ) );
-}
-
-
 unsigned int DRRStage::loadVideoResources()
 {
     pimpl->exponentialShader = &base::ShaderManager::instance().acquireShader( "drr_exponential" );
@@ -203,23 +193,25 @@ void DRRStage::renderPass
     base::RenderState rs;
     rs.setBlend( true );
 
-    /* Copy depth buffer from output to the accumulation frame buffer.
+    /* Lease the accumulation frame buffer and provide the depth buffer of the output
+     * to it. The depth buffer is not written by the accumulation pass. The integral
+     * is a single channel, that is accumulated in full precision, so that it stays
+     * accurate along long rays.
      */
-    const base::Viewport framebufferViewport( *pimpl->accumulationFrameBuffer );
-    const unsigned int outputFramebufferId = base::Framebuffer::currentId();
-    base::Framebuffer::copyDepthAttachment
-        ( outputFramebufferId
-        , pimpl->accumulationFrameBuffer->id
-        , outputViewport
-        , framebufferViewport );
+    const base::RenderTargetPool::Lease accumulation
+        ( rt.renderer.renderTargets(), rt.renderer.viewport().width(), rt.renderer.viewport().height(), base::Framebuffer::r32f );
+    const base::Viewport framebufferViewport( accumulation.framebuffer() );
+    const base::Framebuffer::SharedDepthAttachment depth( accumulation.framebuffer(), outputViewport );
 
     /* First, evaluate the integral by rendering to the accumulation buffer.
      */
-    LIBCARNA_RENDER_TO_FRAMEBUFFER( *pimpl->accumulationFrameBuffer,
+    LIBCARNA_RENDER_TO_FRAMEBUFFER( accumulation.framebuffer(),
 
-        /* Configure OpenGL state for accumulation pass.
+        /* Configure OpenGL state for accumulation pass. The slices must not write
+         * to the depth buffer, since it might be the one of the output.
          */
         base::RenderState rs;
+        rs.setDepthWrite( false );
         rs.setBlendFunction( base::BlendFunction( GL_ONE, GL_ONE ) );
 
         glClearColor( 0, 0, 0, 0 );
@@ -238,7 +230,7 @@ void DRRStage::renderPass
     rt.renderer.glContext().setShader( *pimpl->exponentialShader );
     base::ShaderUniform< float >( "baseIntensity", pimpl->baseIntensity ).upload();
     base::ShaderUniform< int >( "renderInverse", pimpl->renderInverse ? 1 : 0 ).upload();
-    pimpl->accumulationColorBuffer->bind( 0 );
+    accumulation.renderTexture().bind( 0 );
     base::FrameRenderer::RenderTextureParams params( 0 );
     params.useDefaultShader = false;
     params.textureUniformName = "integralMap";
@@ -291,6 +283,14 @@ void DRRStage::configureShader( const base::Renderable& renderable )
 }
 
 
+void DRRStage::collectShaderNames( const base::Node& root, std::vector< std::string >& shaderNames ) const
+{
+    VolumeRenderingStage::collectShaderNames( root, shaderNames );
+    shaderNames.push_back( "drr_accumulation" );
+    shaderNames.push_back( "drr_exponential" );
+}
+
+
 
 }  // namespace LibCarna :: presets
 
@@ -17,12 +17,15 @@
 #include <LibCarna/base/glew.hpp>
 #include <LibCarna/base/ShaderManager.hpp>
 #include <LibCarna/base/Framebuffer.hpp>
+#include <LibCarna/base/RenderTargetPool.hpp>
 #include <LibCarna/base/Viewport.hpp>
 #include <LibCarna/base/RenderState.hpp>
 #include <LibCarna/base/ShaderUniform.hpp>
 #include <LibCarna/base/math.hpp>
 #include <LibCarna/base/LibCarnaException.hpp>
 #include <LibCarna/base/Log.hpp>
+#include <LibCarna/base/Node.hpp>
+#include <LibCarna/base/Geometry.hpp>
 #include <algorithm>
 
 namespace LibCarna
@@ -40,24 +43,37 @@ namespace presets
 struct DVRStage::Details
 {
     Details();
-    std::unique_ptr< base::Texture< 2 > > accumulationColorBuffer;
-    std::unique_ptr< base::Framebuffer  > accumulationFrameBuffer;
     
     const static unsigned int COLORMAP_TEXTURE_UNIT = base::Texture< 0 >::SETUP_UNIT + 1;
     
     float translucency;
     float diffuseLight;
     bool isLightingUsed;
+
+    /* The variant of the shader with lighting is acquired on demand, while the
+     * variant without lighting is acquired through 'acquireShader'.
+     */
+    const base::ShaderProgram* lightingShader;
+    static std::string shaderName( bool lighting );
 };
 
 
 DVRStage::Details::Details()
     : translucency( DEFAULT_TRANSLUCENCY )
     , diffuseLight( DEFAULT_DIFFUSE_LIGHT )
+    , lightingShader( nullptr )
 {
 }
 
 
+std::string DVRStage::Details::shaderName( bool lighting )
+{
+    base::ShaderManager::Defines defines;
+    defines[ "LIGHTING" ] = lighting ? "1" : "0";
+    return base::ShaderManager::variantName( "dvr", defines );
+}
+
+
 
 // ----------------------------------------------------------------------------------
 // DVRStage
@@ -78,6 +94,10 @@ DVRStage::DVRStage( unsigned int geometryType, unsigned int colorMapResolution )
 DVRStage::~DVRStage()
 {
     activateGLContext();
+    if( pimpl->lightingShader != nullptr )
+    {
+        base::ShaderManager::instance().releaseShader( *pimpl->lightingShader );
+    }
 }
 
 
@@ -113,14 +133,6 @@ bool DVRStage::isLightingUsed() const
 }
 
 
-void DVRStage::reshape( base::FrameRenderer& fr, unsigned int width, unsigned int height )
-{
-    base::RenderStage::reshape( fr, width, height );
-    pimpl->accumulationColorBuffer.reset( base::Framebuffer::createRenderTexture( true ) );
-    pimpl->accumulationFrameBuffer.reset( new base::Framebuffer( width, height, *pimpl->accumulationColorBuffer ) );
-}
-
-
 unsigned int DVRStage::loadVideoResources()
 {
     VolumeRenderingStage::loadVideoResources();
@@ -142,24 +154,24 @@ void DVRStage::renderPass
     base::RenderState rs;
     rs.setBlend( true );
 
-    /* Copy depth buffer from output to the accumulation frame buffer.
+    /* Lease the accumulation frame buffer and provide the depth buffer of the output
+     * to it. The depth buffer is not written by the accumulation pass.
      */
-    const base::Viewport framebufferViewport( *pimpl->accumulationFrameBuffer );
-    const unsigned int outputFramebufferId = base::Framebuffer::currentId();
-    base::Framebuffer::copyDepthAttachment
-        ( outputFramebufferId
-        , pimpl->accumulationFrameBuffer->id
-        , outputViewport
-        , framebufferViewport );
-
-    /* We will render to a dedicated render target first, s.t. the depth buffer is
-     * not contaminated by the slices.
+    const base::RenderTargetPool::Lease accumulation
+        ( rt.renderer.renderTargets(), rt.renderer.viewport().width(), rt.renderer.viewport().height(), base::Framebuffer::rgba16f );
+    const base::Viewport framebufferViewport( accumulation.framebuffer() );
+    const base::Framebuffer::SharedDepthAttachment depth( accumulation.framebuffer(), outputViewport );
+
+    /* We will render to a dedicated render target first, s.t. the slices are
+     * accumulated before they are blended with the output.
      */
-    LIBCARNA_RENDER_TO_FRAMEBUFFER( *pimpl->accumulationFrameBuffer,
+    LIBCARNA_RENDER_TO_FRAMEBUFFER( accumulation.framebuffer(),
 
-        /* Configure OpenGL state for accumulation pass.
+        /* Configure OpenGL state for accumulation pass. The slices must not write
+         * to the depth buffer, since it might be the one of the output.
          */
         base::RenderState rs;
+        rs.setDepthWrite( false );
         rs.setBlendFunction( base::BlendFunction( GL_ONE, GL_ONE_MINUS_SRC_ALPHA ) );
 
         glClearColor( 0, 0, 0, 0 );
@@ -176,7 +188,7 @@ void DVRStage::renderPass
     rs.setDepthTest( false );
     rs.setDepthWrite( false );
     rs.setBlendFunction( base::BlendFunction( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA ) );
-    pimpl->accumulationColorBuffer->bind( 0 );
+    accumulation.renderTexture().bind( 0 );
     base::FrameRenderer::RenderTextureParams params( 0 );
     rt.renderer.renderTexture( params );
 }
@@ -200,7 +212,26 @@ void DVRStage::createVolumeSamplers( const std::function< void( unsigned int, ba
 
 const base::ShaderProgram& DVRStage::acquireShader()
 {
-    return base::ShaderManager::instance().acquireShader( "dvr" );
+    return base::ShaderManager::instance().acquireShader( Details::shaderName( false ) );
+}
+
+
+const base::ShaderProgram& DVRStage::selectShader( const base::Renderable& renderable )
+{
+    /* Only volumes with normal maps are lit.
+     */
+    if( renderable.geometry().hasFeature( ROLE_NORMALS ) )
+    {
+        if( pimpl->lightingShader == nullptr )
+        {
+            pimpl->lightingShader = &base::ShaderManager::instance().acquireShader( Details::shaderName( true ) );
+        }
+        return *pimpl->lightingShader;
+    }
+    else
+    {
+        return VolumeRenderingStage::selectShader( renderable );
+    }
 }
 
 
@@ -260,20 +291,38 @@ void DVRStage::configureShader( const base::Renderable& renderable )
         const base::math::Matrix3f modelView = renderable.modelViewTransform().block< 3, 3 >( 0, 0 );
         const base::math::Matrix3f normalsView = ( modelView * normalsToModel ).inverse().transpose();
         
-        /* Upload the normals transformation matrix and enable lighting.
+        /* Upload the normals transformation matrix. Lighting is enabled by the
+         * shader variant, that was selected for the renderable.
          */
         base::ShaderUniform< base::math::Matrix3f >( "normalsView", normalsView ).upload();
-        base::ShaderUniform< int >( "lightingEnabled", 1 ).upload();
         
         /* Denote that lighting was used for rendering.
          */
         pimpl->isLightingUsed = true;
     }
-    else
+}
+
+
+void DVRStage::collectShaderNames( const base::Node& root, std::vector< std::string >& shaderNames ) const
+{
+    VolumeRenderingStage::collectShaderNames( root, shaderNames );
+    shaderNames.push_back( Details::shaderName( false ) );
+
+    /* The shader with lighting is only required if any volume has a normal map.
+     */
+    bool isLightingRequired = false;
+    root.visitChildren( true, [&]( const base::Spatial& spatial )
+        {
+            if( spatial.isGeometry() )
+            {
+                const base::Geometry& geom = static_cast< const base::Geometry& >( spatial );
+                isLightingRequired = isLightingRequired || ( ( geom.geometryType & geometryTypeMask ) == geometryType && geom.hasFeature( ROLE_NORMALS ) );
+            }
+        }
+    );
+    if( isLightingRequired )
     {
-        /* Disable lighting.
-         */
-        base::ShaderUniform< int >( "lightingEnabled", 0 ).upload();
+        shaderNames.push_back( Details::shaderName( true ) );
     }
 }
 
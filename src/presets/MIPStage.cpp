@@ -17,6 +17,7 @@
 #include <LibCarna/base/ShaderManager.hpp>
 #include <LibCarna/base/ShaderUniform.hpp>
 #include <LibCarna/base/Framebuffer.hpp>
+#include <LibCarna/base/RenderTargetPool.hpp>
 #include <LibCarna/base/Viewport.hpp>
 #include <LibCarna/base/RenderState.hpp>
 #include <LibCarna/base/math.hpp>
@@ -41,9 +42,6 @@ struct MIPStage::Details
 
     Details();
 
-    std::unique_ptr< base::Texture< 2 > > projectionColorBuffer;
-    std::unique_ptr< base::Framebuffer  > projectionFrameBuffer;
-
     const base::ShaderProgram* colorizationShader;
     
     const static unsigned int COLORMAP_TEXTURE_UNIT = base::Texture< 0 >::SETUP_UNIT + 1;
@@ -81,14 +79,6 @@ MIPStage::~MIPStage()
 }
 
 
-void MIPStage::reshape( base::FrameRenderer& fr, unsigned int width, unsigned int height )
-{
-    base::RenderStage::reshape( fr, width, height );
-    pimpl->projectionColorBuffer.reset( base::Framebuffer::createRenderTexture( true ) );
-    pimpl->projectionFrameBuffer.reset( new base::Framebuffer( width, height, *pimpl->projectionColorBuffer ) );
-}
-
-
 unsigned int MIPStage::loadVideoResources()
 {
     pimpl->colorizationShader = &base::ShaderManager::instance().acquireShader( "mip_colorization" );
@@ -109,19 +99,18 @@ void MIPStage::renderPass
     rs.setDepthTest( false );
     rs.setDepthWrite( false );
 
-    /* Copy depth buffer from output to dedicated frame buffer.
+    /* Lease dedicated frame buffer and provide the depth buffer of the output to it.
+     * The depth buffer is not written by the projection pass. The projected
+     * intensity is a single channel.
      */
-    const base::Viewport framebufferViewport( *pimpl->projectionFrameBuffer );
-    const unsigned int outputFramebufferId = base::Framebuffer::currentId();
-    base::Framebuffer::copyDepthAttachment
-        ( outputFramebufferId
-        , pimpl->projectionFrameBuffer->id
-        , outputViewport
-        , framebufferViewport );
+    const base::RenderTargetPool::Lease projection
+        ( rt.renderer.renderTargets(), rt.renderer.viewport().width(), rt.renderer.viewport().height(), base::Framebuffer::r16f );
+    const base::Viewport framebufferViewport( projection.framebuffer() );
+    const base::Framebuffer::SharedDepthAttachment depth( projection.framebuffer(), outputViewport );
 
     /* First render the projection of the intensities into the dedicated framebuffer.
      */
-    LIBCARNA_RENDER_TO_FRAMEBUFFER( *pimpl->projectionFrameBuffer,
+    LIBCARNA_RENDER_TO_FRAMEBUFFER( projection.framebuffer(),
 
         base::RenderState rs;
         rs.setBlendEquation( GL_MAX );
@@ -146,7 +135,7 @@ void MIPStage::renderPass
     base::ShaderUniform< float >( "maxIntensity", colorMap.maximumIntensity() ).upload();
     colorMap.bind( Details::COLORMAP_TEXTURE_UNIT );
 
-    pimpl->projectionColorBuffer->bind( 0 );
+    projection.renderTexture().bind( 0 );
     base::FrameRenderer::RenderTextureParams params( 0 );
     params.useDefaultShader = false;
     params.textureUniformName = "mip";
@@ -195,6 +184,14 @@ void MIPStage::configureShader( const base::Renderable& renderable )
 }
 
 
+void MIPStage::collectShaderNames( const base::Node& root, std::vector< std::string >& shaderNames ) const
+{
+    VolumeRenderingStage::collectShaderNames( root, shaderNames );
+    shaderNames.push_back( "mip" );
+    shaderNames.push_back( "mip_colorization" );
+}
+
+
 
 }  // namespace LibCarna :: VolumeRenderings
 
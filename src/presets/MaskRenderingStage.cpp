@@ -7,6 +7,7 @@
 #include <LibCarna/base/glew.hpp>
 #include <LibCarna/base/ShaderManager.hpp>
 #include <LibCarna/base/Framebuffer.hpp>
+#include <LibCarna/base/RenderTargetPool.hpp>
 #include <LibCarna/base/Viewport.hpp>
 #include <LibCarna/base/RenderState.hpp>
 #include <LibCarna/base/ShaderUniform.hpp>
@@ -33,11 +34,14 @@ struct MaskRenderingStage::Details
     base::Color color;
     bool filling;
 
-    std::unique_ptr< base::Texture< 2 > > accumulationColorBuffer;
-    std::unique_ptr< base::Framebuffer  > accumulationFrameBuffer;
-
     const base::ShaderProgram* edgeDetectShader;
 
+    /* The variant of the shader that ignores the color is acquired on demand, while
+     * the variant that uses the color is acquired through 'acquireShader'.
+     */
+    const base::ShaderProgram* ignoreColorShader;
+    static std::string shaderName( bool ignoreColor );
+
     base::math::Vector2f textureSteps;
 
     std::unique_ptr< base::Sampler > labelMapSampler;
@@ -49,7 +53,16 @@ MaskRenderingStage::Details::Details()
     : color( MaskRenderingStage::DEFAULT_COLOR )
     , filling( MaskRenderingStage::DEFAULT_FILLING )
     , edgeDetectShader( nullptr )
+    , ignoreColorShader( nullptr )
+{
+}
+
+
+std::string MaskRenderingStage::Details::shaderName( bool ignoreColor )
 {
+    base::ShaderManager::Defines defines;
+    defines[ "IGNORE_COLOR" ] = ignoreColor ? "1" : "0";
+    return base::ShaderManager::variantName( "mr", defines );
 }
 
 
@@ -78,6 +91,11 @@ MaskRenderingStage::~MaskRenderingStage()
         activateGLContext();
         base::ShaderManager::instance().releaseShader( *pimpl->edgeDetectShader );
     }
+    if( pimpl->ignoreColorShader != nullptr )
+    {
+        activateGLContext();
+        base::ShaderManager::instance().releaseShader( *pimpl->ignoreColorShader );
+    }
 }
 
 
@@ -108,8 +126,6 @@ void MaskRenderingStage::setFilling( bool filling )
 void MaskRenderingStage::reshape( base::FrameRenderer& fr, unsigned int width, unsigned int height )
 {
     base::RenderStage::reshape( fr, width, height );
-    pimpl->accumulationColorBuffer.reset( base::Framebuffer::createRenderTexture( true ) );
-    pimpl->accumulationFrameBuffer.reset( new base::Framebuffer( width, height, *pimpl->accumulationColorBuffer ) );
     pimpl->textureSteps = base::math::Vector2f( 1.f / ( width - 1 ), 1.f / ( height - 1 ) );
 }
 
@@ -131,10 +147,12 @@ void MaskRenderingStage::renderPass
 {
     if( !pimpl->filling )
     {
-        /* First, render the projected mask intensities.
+        /* First, render the projected mask intensities to a leased frame buffer.
          */
-        const base::Viewport framebufferViewport( *pimpl->accumulationFrameBuffer );
-        LIBCARNA_RENDER_TO_FRAMEBUFFER( *pimpl->accumulationFrameBuffer,
+        const base::RenderTargetPool::Lease accumulation
+            ( rt.renderer.renderTargets(), rt.renderer.viewport().width(), rt.renderer.viewport().height(), base::Framebuffer::rgba16f );
+        const base::Viewport framebufferViewport( accumulation.framebuffer() );
+        LIBCARNA_RENDER_TO_FRAMEBUFFER( accumulation.framebuffer(),
 
             /* Configure OpenGL state for accumulation pass.
              */
@@ -170,7 +188,7 @@ void MaskRenderingStage::renderPass
             params.useDefaultSampler = false;
             pimpl->labelMapSampler->bind( params.unit );
         }
-        pimpl->accumulationColorBuffer->bind( 0 );
+        accumulation.renderTexture().bind( 0 );
         rt.renderer.renderTexture( params );
     }
     else
@@ -197,7 +215,24 @@ void MaskRenderingStage::createVolumeSamplers( const std::function< void( unsign
 
 const base::ShaderProgram& MaskRenderingStage::acquireShader()
 {
-    return base::ShaderManager::instance().acquireShader( "mr" );
+    return base::ShaderManager::instance().acquireShader( Details::shaderName( false ) );
+}
+
+
+const base::ShaderProgram& MaskRenderingStage::selectShader( const base::Renderable& renderable )
+{
+    if( pimpl->filling )
+    {
+        return VolumeRenderingStage::selectShader( renderable );
+    }
+    else
+    {
+        if( pimpl->ignoreColorShader == nullptr )
+        {
+            pimpl->ignoreColorShader = &base::ShaderManager::instance().acquireShader( Details::shaderName( true ) );
+        }
+        return *pimpl->ignoreColorShader;
+    }
 }
 
 
@@ -217,7 +252,6 @@ const std::string& MaskRenderingStage::uniformName( unsigned int role ) const
 
 void MaskRenderingStage::configureShader()
 {
-    base::ShaderUniform< bool >( "ignoreColor", !pimpl->filling ).upload();
     if( pimpl->filling )
     {
         base::ShaderUniform< base::math::Vector4f >( "color", pimpl->color ).upload();
@@ -231,6 +265,18 @@ void MaskRenderingStage::configureShader( const base::Renderable& renderable )
 }
 
 
+void MaskRenderingStage::collectShaderNames( const base::Node& root, std::vector< std::string >& shaderNames ) const
+{
+    VolumeRenderingStage::collectShaderNames( root, shaderNames );
+    shaderNames.push_back( Details::shaderName( false ) );
+    if( !pimpl->filling )
+    {
+        shaderNames.push_back( Details::shaderName( true ) );
+    }
+    shaderNames.push_back( "mr_edgedetect" );
+}
+
+
 
 }  // namespace LibCarna :: presets
 
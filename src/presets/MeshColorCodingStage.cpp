@@ -12,6 +12,7 @@
  * 
  */
 
+#include <LibCarna/base/glew.hpp>
 #include <LibCarna/presets/MeshColorCodingStage.hpp>
 #include <LibCarna/base/ShaderManager.hpp>
 #include <LibCarna/base/ShaderUniform.hpp>
@@ -20,6 +21,7 @@
 #include <LibCarna/base/Viewport.hpp>
 #include <LibCarna/base/Framebuffer.hpp>
 #include <LibCarna/base/Log.hpp>
+#include <algorithm>
 #include <map>
 #include <vector>
 #include <climits>
@@ -60,6 +62,35 @@ struct MeshColorCodingStage::Details
     unsigned int vpOffsetX;
     unsigned int vpOffsetY;
 
+    /* Maps frame coordinates to the coordinates of the color-coding framebuffer.
+     * Returns 'false' if the frame coordinates are outside the viewport.
+     */
+    bool toFramebufferCoordinates( unsigned int& x, unsigned int& y, const base::Framebuffer& fbo ) const;
+
+    bool lazy;
+    std::vector< base::math::Vector2ui > requestedPicks;
+
+    /* Holds the picks, that are read back from the color-coding framebuffer.
+     */
+    struct PickBatch
+    {
+        PickBatch();
+        std::vector< base::math::Vector2ui > locations;
+        std::vector< bool > isInsideViewport;
+        std::vector< const base::Geometry* > geometryById;
+        GLsync fence;
+    };
+
+    PickBatch pickBatch;
+
+    struct Pick
+    {
+        base::math::Vector2ui location;
+        const base::Geometry* geometry;
+    };
+
+    std::vector< Pick > resolvedPicks;
+
 }; // MeshColorCodingStage :: Details
 
 
@@ -71,10 +102,40 @@ const  base::Color MeshColorCodingStage::Details::  NULL_GEOMETRY_COLOR( 0, 0, 0
 MeshColorCodingStage::Details::Details()
     : myActivationPassIndex( 0u )
     , nextColorCodingId( Details::FIRST_COLOR_CODING_ID )
+    , lazy( false )
 {
 }
 
 
+MeshColorCodingStage::Details::PickBatch::PickBatch()
+    : fence( nullptr )
+{
+}
+
+
+bool MeshColorCodingStage::Details::toFramebufferCoordinates( unsigned int& x, unsigned int& y, const base::Framebuffer& fbo ) const
+{
+    if( x < vpOffsetX || y < vpOffsetY )
+    {
+        return false;
+    }
+    else
+    {
+        x = x - vpOffsetX;
+        y = y - vpOffsetY;
+        if( x >= fbo.width() || y >= fbo.height() )
+        {
+            return false;
+        }
+        else
+        {
+            y = fbo.height() - 1 - y;
+            return true;
+        }
+    }
+}
+
+
 unsigned int MeshColorCodingStage::Details::colorToId( const base::Color& color )
 {
     unsigned int key = color.a;
@@ -108,10 +169,17 @@ struct MeshColorCodingStage::VideoResources
 
     VideoResources( const base::ShaderProgram& shader, unsigned int w, unsigned int h );
 
+    ~VideoResources();
+
     const base::ShaderProgram& shader;
     std::unique_ptr< base::Texture< 2 > > renderTexture;
     base::Framebuffer fbo;
 
+    /* Pixel buffer object, that the picked pixels are read back to.
+     */
+    GLuint pickBuffer;
+    std::size_t pickBufferSize;
+
 }; // MeshColorCodingStage :: VideoResources
 
 
@@ -119,7 +187,18 @@ MeshColorCodingStage::VideoResources::VideoResources( const base::ShaderProgram&
     : shader( shader )
     , renderTexture( base::Framebuffer::createRenderTexture() )
     , fbo( w, h, *renderTexture )
+    , pickBuffer( 0 )
+    , pickBufferSize( 0 )
+{
+}
+
+
+MeshColorCodingStage::VideoResources::~VideoResources()
 {
+    if( pickBuffer != 0 )
+    {
+        glDeleteBuffers( 1, &pickBuffer );
+    }
 }
 
 
@@ -140,6 +219,10 @@ MeshColorCodingStage::~MeshColorCodingStage()
     if( vr.get() != nullptr )
     {
         activateGLContext();
+        if( pimpl->pickBatch.fence != nullptr )
+        {
+            glDeleteSync( pimpl->pickBatch.fence );
+        }
         base::ShaderManager::instance().releaseShader( vr->shader );
     }
 }
@@ -163,39 +246,176 @@ base::Aggregation< const base::Geometry > MeshColorCodingStage::pick( unsigned i
     {
         /* Apply viewport offset to picking coordinates.
          */
-        if( x < pimpl->vpOffsetX || y < pimpl->vpOffsetY )
+        if( !pimpl->toFramebufferCoordinates( x, y, vr->fbo ) )
         {
             Log::instance().record( Log::debug, "MeshColorCodingStage::pick queried outside viewport." );
             return Aggregation< const Geometry >::NULL_PTR;
         }
         else
         {
-            x = x - pimpl->vpOffsetX;
-            y = y - pimpl->vpOffsetY;
-
-            if( x >= vr->fbo.width() || y >= vr->fbo.height() )
+            Framebuffer::MinimalBinding binding( vr->fbo );
+            const Color color = binding.readPixel( x, y );
+            if( color == Details::NULL_GEOMETRY_COLOR )
             {
-                Log::instance().record( Log::debug, "MeshColorCodingStage::pick queried outside viewport." );
                 return Aggregation< const Geometry >::NULL_PTR;
             }
             else
             {
-                y = vr->fbo.height() - 1 - y;
-                Framebuffer::MinimalBinding binding( vr->fbo );
-                const Color color = binding.readPixel( x, y );
-                if( color == Details::NULL_GEOMETRY_COLOR )
-                {
-                    return Aggregation< const Geometry >::NULL_PTR;
-                }
-                else
-                {
-                    const unsigned int id = Details::colorToId( color );
-                    LIBCARNA_ASSERT( id < pimpl->geometryById.size() );
-                    return Aggregation< const Geometry >( *pimpl->geometryById[ id ] );
-                }
+                const unsigned int id = Details::colorToId( color );
+                LIBCARNA_ASSERT( id < pimpl->geometryById.size() );
+                return Aggregation< const Geometry >( *pimpl->geometryById[ id ] );
+            }
+        }
+    }
+}
+
+
+void MeshColorCodingStage::setLazy( bool lazy )
+{
+    pimpl->lazy = lazy;
+}
+
+
+bool MeshColorCodingStage::isLazy() const
+{
+    return pimpl->lazy;
+}
+
+
+void MeshColorCodingStage::requestPick( unsigned int x, unsigned int y )
+{
+    pimpl->requestedPicks.push_back( base::math::Vector2ui( x, y ) );
+}
+
+
+void MeshColorCodingStage::requestPick( const base::math::Vector2ui& v )
+{
+    requestPick( v.x(), v.y() );
+}
+
+
+std::size_t MeshColorCodingStage::pendingPicks() const
+{
+    return pimpl->requestedPicks.size() + pimpl->pickBatch.locations.size() + pimpl->resolvedPicks.size();
+}
+
+
+void MeshColorCodingStage::finishPickBatch( bool wait )
+{
+    Details::PickBatch& batch = pimpl->pickBatch;
+    if( batch.fence == nullptr )
+    {
+        return;
+    }
+
+    /* Check whether the read back has completed. Each attempt to wait is bounded
+     * by one second.
+     */
+    const static GLuint64 WAIT_TIMEOUT = 1000000000;
+    GLenum status;
+    do
+    {
+        status = glClientWaitSync( batch.fence, GL_SYNC_FLUSH_COMMANDS_BIT, wait ? WAIT_TIMEOUT : 0 );
+        LIBCARNA_ASSERT_EX( status != GL_WAIT_FAILED, "Waiting for pick readback failed." );
+    }
+    while( wait && status == GL_TIMEOUT_EXPIRED );
+    if( status == GL_TIMEOUT_EXPIRED )
+    {
+        return;
+    }
+    glDeleteSync( batch.fence );
+    batch.fence = nullptr;
+
+    /* Map the picked colors to the geometry nodes.
+     */
+    glBindBuffer( GL_PIXEL_PACK_BUFFER, vr->pickBuffer );
+    const unsigned char* const colors = static_cast< const unsigned char* >
+        ( glMapBufferRange( GL_PIXEL_PACK_BUFFER, 0, 4 * batch.locations.size(), GL_MAP_READ_BIT ) );
+    LIBCARNA_ASSERT_EX( colors != nullptr, "Mapping the pick buffer failed." );
+    for( std::size_t pickIdx = 0; pickIdx < batch.locations.size(); ++pickIdx )
+    {
+        Details::Pick pick;
+        pick.location = batch.locations[ pickIdx ];
+        pick.geometry = nullptr;
+        if( batch.isInsideViewport[ pickIdx ] )
+        {
+            const unsigned char* const color = colors + 4 * pickIdx;
+            const base::Color colorValue( color[ 0 ], color[ 1 ], color[ 2 ], color[ 3 ] );
+            if( !( colorValue == Details::NULL_GEOMETRY_COLOR ) )
+            {
+                const unsigned int id = Details::colorToId( colorValue );
+                LIBCARNA_ASSERT( id < batch.geometryById.size() );
+                pick.geometry = batch.geometryById[ id ];
             }
         }
+        pimpl->resolvedPicks.push_back( pick );
+    }
+    glUnmapBuffer( GL_PIXEL_PACK_BUFFER );
+    glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+
+    batch.locations.clear();
+    batch.isInsideViewport.clear();
+    batch.geometryById.clear();
+}
+
+
+void MeshColorCodingStage::issuePickBatch()
+{
+    using namespace base;
+    Details::PickBatch& batch = pimpl->pickBatch;
+    LIBCARNA_ASSERT( batch.fence == nullptr );
+
+    /* Ensure the pick buffer is large enough.
+     */
+    const std::size_t pickBufferSize = 4 * pimpl->requestedPicks.size();
+    if( vr->pickBuffer == 0 )
+    {
+        glGenBuffers( 1, &vr->pickBuffer );
+    }
+    glBindBuffer( GL_PIXEL_PACK_BUFFER, vr->pickBuffer );
+    if( vr->pickBufferSize < pickBufferSize )
+    {
+        vr->pickBufferSize = pickBufferSize;
+        glBufferData( GL_PIXEL_PACK_BUFFER, pickBufferSize, nullptr, GL_STREAM_READ );
+    }
+
+    /* Read back the picked pixels asynchronously.
+     */
+    Framebuffer::MinimalBinding binding( vr->fbo );
+    glReadBuffer( GL_COLOR_ATTACHMENT0 );
+    for( std::size_t pickIdx = 0; pickIdx < pimpl->requestedPicks.size(); ++pickIdx )
+    {
+        unsigned int x = pimpl->requestedPicks[ pickIdx ].x();
+        unsigned int y = pimpl->requestedPicks[ pickIdx ].y();
+        const bool isInsideViewport = pimpl->toFramebufferCoordinates( x, y, vr->fbo );
+        if( isInsideViewport )
+        {
+            glReadPixels( x, y, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, reinterpret_cast< void* >( 4 * pickIdx ) );
+        }
+        batch.locations.push_back( pimpl->requestedPicks[ pickIdx ] );
+        batch.isInsideViewport.push_back( isInsideViewport );
     }
+    glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+    batch.fence = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+    batch.geometryById = pimpl->geometryById;
+    pimpl->requestedPicks.clear();
+}
+
+
+std::size_t MeshColorCodingStage::resolvePicks( const PickCallback& callback, bool wait )
+{
+    if( vr.get() != nullptr )
+    {
+        activateGLContext();
+        finishPickBatch( wait );
+    }
+    const std::vector< Details::Pick > resolvedPicks( pimpl->resolvedPicks );
+    pimpl->resolvedPicks.clear();
+    for( auto pickItr = resolvedPicks.begin(); pickItr != resolvedPicks.end(); ++pickItr )
+    {
+        callback( pickItr->location, pickItr->geometry );
+    }
+    return resolvedPicks.size();
 }
 
 
@@ -216,6 +436,23 @@ void MeshColorCodingStage::renderPass( const base::math::Matrix4f& viewTransform
     using namespace base;
     if( renderedPassesCount() == activationPassIndex() )
     {
+        /* The pick buffer is reused, thus the previous batch must be finished. If its
+         * read back has not completed yet, the requested picks are deferred to the
+         * next frame, instead of waiting.
+         */
+        if( vr.get() != nullptr )
+        {
+            finishPickBatch( false );
+        }
+        const bool isPickBatchPending = pimpl->pickBatch.fence != nullptr;
+
+        /* The lazy mode skips the pass, unless picks are requested.
+         */
+        if( pimpl->lazy && ( pimpl->requestedPicks.empty() || isPickBatchPending ) )
+        {
+            return;
+        }
+
         if( vr.get() == nullptr )
         {
             const ShaderProgram& shader = ShaderManager::instance().acquireShader( "unshaded" );
@@ -232,15 +469,54 @@ void MeshColorCodingStage::renderPass( const base::math::Matrix4f& viewTransform
          */
         rt.renderer.glContext().setShader( vr->shader );
 
-        /* Do the rendering.
+        /* The lazy mode restricts the rendering to the region, that spans all of the
+         * requested picks.
          */
-        Viewport fboViewport( vp, 0, 0, vr->fbo.width(), vr->fbo.height() );
-        fboViewport.makeActive();
-        LIBCARNA_RENDER_TO_FRAMEBUFFER( vr->fbo,
-            rt.renderer.glContext().clearBuffers( GLContext::COLOR_BUFFER_BIT | GLContext::DEPTH_BUFFER_BIT );
-            GeometryStage< void >::renderPass( viewTransform, rt, vp );
-        );
-        fboViewport.done();
+        RenderState rs;
+        bool scissor = false;
+        if( pimpl->lazy )
+        {
+            unsigned int minX = vr->fbo.width(), minY = vr->fbo.height(), maxX = 0, maxY = 0;
+            for( auto pickItr = pimpl->requestedPicks.begin(); pickItr != pimpl->requestedPicks.end(); ++pickItr )
+            {
+                unsigned int x = pickItr->x();
+                unsigned int y = pickItr->y();
+                if( pimpl->toFramebufferCoordinates( x, y, vr->fbo ) )
+                {
+                    minX = std::min( minX, x );
+                    minY = std::min( minY, y );
+                    maxX = std::max( maxX, x );
+                    maxY = std::max( maxY, y );
+                    scissor = true;
+                }
+            }
+            if( scissor )
+            {
+                rs.setScissorTest( true );
+                rs.setScissorBox( minX, minY, maxX - minX + 1, maxY - minY + 1 );
+            }
+        }
+
+        /* Do the rendering. If all picks are outside the viewport in lazy mode,
+         * there is nothing to render.
+         */
+        if( scissor || !pimpl->lazy )
+        {
+            Viewport fboViewport( vp, 0, 0, vr->fbo.width(), vr->fbo.height() );
+            fboViewport.makeActive();
+            LIBCARNA_RENDER_TO_FRAMEBUFFER( vr->fbo,
+                rt.renderer.glContext().clearBuffers( GLContext::COLOR_BUFFER_BIT | GLContext::DEPTH_BUFFER_BIT );
+                GeometryStage< void >::renderPass( viewTransform, rt, vp );
+            );
+            fboViewport.done();
+        }
+
+        /* Read back the requested picks.
+         */
+        if( !pimpl->requestedPicks.empty() && !isPickBatchPending )
+        {
+            issuePickBatch();
+        }
 
         /* Denote that rendering is finished.
          */
@@ -282,9 +558,7 @@ void MeshColorCodingStage::render( const base::Renderable& renderable )
         /* Setup the shader.
          */
         ShaderUniform< math::Vector4f >( "color", Details::idToColor( pimpl->nextColorCodingId ) ).upload();
-        ShaderUniform< math::Matrix4f >
-            ( "modelViewProjection"
-            , pimpl->renderTask->projection * renderable.modelViewTransform() ).upload();
+        ShaderUniform< math::Matrix4f >( "modelView", renderable.modelViewTransform() ).upload();
 
         /* Do the rendering.
          */
@@ -311,6 +585,7 @@ void MeshColorCodingStage::reshape( base::FrameRenderer& fr, unsigned int width,
     base::RenderStage::reshape( fr, width, height );
     if( vr.get() != nullptr )
     {
+        finishPickBatch( true );
         vr.reset( new VideoResources( vr->shader, width, height ) );
     }
 }
@@ -343,6 +618,12 @@ void MeshColorCodingStage::clearGeometryTypes()
 }
 
 
+void MeshColorCodingStage::collectShaderNames( const base::Node&, std::vector< std::string >& shaderNames ) const
+{
+    shaderNames.push_back( "unshaded" );
+}
+
+
 
 }  // namespace LibCarna :: presets
 
@@ -17,6 +17,7 @@
 #include <LibCarna/base/RenderState.hpp>
 #include <LibCarna/base/RenderTask.hpp>
 #include <LibCarna/base/Framebuffer.hpp>
+#include <LibCarna/base/RenderTargetPool.hpp>
 #include <LibCarna/base/Viewport.hpp>
 #include <set>
 
@@ -58,19 +59,15 @@ OccludedRenderingStage::Details::Details()
 struct OccludedRenderingStage::VideoResources
 {
 
-    VideoResources( const base::ShaderProgram& shader, unsigned int w, unsigned int h );
+    VideoResources( const base::ShaderProgram& shader );
 
     const base::ShaderProgram& shader;
-    const std::unique_ptr< base::Texture< 2 > > renderTexture;
-    base::Framebuffer fbo;
 
 }; // OccludedRenderingStage::VideoResources
 
 
-OccludedRenderingStage::VideoResources::VideoResources( const base::ShaderProgram& shader, unsigned int w, unsigned int h )
+OccludedRenderingStage::VideoResources::VideoResources( const base::ShaderProgram& shader )
     : shader( shader )
-    , renderTexture( base::Framebuffer::createRenderTexture() )
-    , fbo( w, h, *renderTexture )
 {
 }
 
@@ -172,20 +169,25 @@ void OccludedRenderingStage::renderPass
     if( vr.get() == nullptr )
     {
         const ShaderProgram& shader = ShaderManager::instance().acquireShader( "unshaded" );
-        vr.reset( new VideoResources( shader, vp.width(), vp.height() ) );
+        vr.reset( new VideoResources( shader ) );
     }
 
-    /* Fork the render task.
+    /* Lease the render target and fork the render task. The stages rendered by the
+     * forked task lease their targets while this one is still leased, thus they
+     * are handed out different ones.
      */
-    OccludedRenderTask rtFork( *this, rt, vr->fbo );
+    const RenderTargetPool::Lease target( rt.renderer.renderTargets(), rt.renderer.viewport().width(), rt.renderer.viewport().height() );
+    Framebuffer& fbo = target.framebuffer();
+    OccludedRenderTask rtFork( *this, rt, fbo );
 
-    /* Provide the depth buffer to the forked task.
+    /* Provide a copy of the depth buffer to the forked task. It cannot be shared,
+     * because the stages rendered by the forked task write to it.
      */
-    const Viewport forkViewport( vp, 0, 0, vr->fbo.width(), vr->fbo.height() );
+    const Viewport forkViewport( vp, 0, 0, fbo.width(), fbo.height() );
     const unsigned int outputFramebufferId = base::Framebuffer::currentId();
-    LIBCARNA_RENDER_TO_FRAMEBUFFER( vr->fbo,
+    LIBCARNA_RENDER_TO_FRAMEBUFFER( fbo,
 
-        base::Framebuffer::copyDepthAttachment( outputFramebufferId, vr->fbo.id, vp, forkViewport );
+        base::Framebuffer::copyDepthAttachment( outputFramebufferId, fbo.id, vp, forkViewport );
 
         /* Configure render state.
          */
@@ -207,7 +209,7 @@ void OccludedRenderingStage::renderPass
     rs.setDepthTest( false );
     base::FrameRenderer::RenderTextureParams params( 0 );
     params.alphaFactor = pimpl->occlusionTranslucency;
-    vr->renderTexture->bind( 0 );
+    target.renderTexture().bind( 0 );
     rt.renderer.renderTexture( params );
 }
 
@@ -217,16 +219,6 @@ void OccludedRenderingStage::prepareFrame( base::Node& root )
 }
 
 
-void OccludedRenderingStage::reshape( base::FrameRenderer& fr, unsigned int width, unsigned int height )
-{
-    RenderStage::reshape( fr, width, height );
-    if( vr.get() != nullptr )
-    {
-        vr.reset( new VideoResources( vr->shader, width, height ) );
-    }
-}
-
-
 void OccludedRenderingStage::setOcclusionTranslucency( float occlusionTranslucency )
 {
     pimpl->occlusionTranslucency = occlusionTranslucency;
@@ -239,6 +231,12 @@ float OccludedRenderingStage::occlusionTranslucency() const
 }
 
 
+void OccludedRenderingStage::collectShaderNames( const base::Node&, std::vector< std::string >& shaderNames ) const
+{
+    shaderNames.push_back( "unshaded" );
+}
+
+
 
 }  // namespace LibCarna :: presets
 
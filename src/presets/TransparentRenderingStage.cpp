@@ -28,7 +28,7 @@ namespace presets
 // ----------------------------------------------------------------------------------
 
 TransparentRenderingStage::TransparentRenderingStage( unsigned int geometryType )
-    : MeshRenderingStage< base::Renderable::BackToFront >::MeshRenderingStage( geometryType )
+    : MeshRenderingStage( geometryType )
 {
 }
 
@@ -46,7 +46,7 @@ void TransparentRenderingStage::renderPass
 
     /* Do the rendering.
      */
-    base::MeshRenderingStage< base::Renderable::BackToFront >::renderPass( viewTransform, rt, vp );
+    MeshRenderingStage::renderPass( viewTransform, rt, vp );
 }
 
 
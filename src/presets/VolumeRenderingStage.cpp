@@ -19,9 +19,12 @@
 #include <LibCarna/base/Vertex.hpp>
 #include <LibCarna/base/IndexBuffer.hpp>
 #include <LibCarna/base/ShaderManager.hpp>
+#include <LibCarna/base/GLContext.hpp>
 #include <LibCarna/base/RenderState.hpp>
 #include <LibCarna/base/ShaderUniform.hpp>
 #include <LibCarna/base/Log.hpp>
+#include <LibCarna/base/Geometry.hpp>
+#include <LibCarna/base/glew.hpp>
 #include <LibCarna/base/math.hpp>
 #include <LibCarna/base/text.hpp>
 
@@ -46,6 +49,11 @@ struct VolumeRenderingStage::Details
     unsigned int sampleRate;
     bool stepLengthRequired;
     unsigned int firstVolumeUnit;
+    bool occlusionCulling;
+    std::size_t occludedSegmentsCount;
+    std::size_t passIndex;
+
+    void issueOcclusionQueries( VolumeRenderingStage& self );
 };
 
 
@@ -54,6 +62,9 @@ VolumeRenderingStage::Details::Details()
     , viewPort( nullptr )
     , sampleRate( DEFAULT_SAMPLE_RATE )
     , stepLengthRequired( true )
+    , occlusionCulling( false )
+    , occludedSegmentsCount( 0 )
+    , passIndex( 0 )
 {
 }
 
@@ -72,6 +83,28 @@ struct VolumeRenderingStage::VideoResources
     
     typedef base::Mesh< base::PVertex, uint16_t > SlicesMesh;
     SlicesMesh& slicesMesh( unsigned int sampleRate );
+
+    struct OcclusionQuery
+    {
+        OcclusionQuery();
+        ~OcclusionQuery();
+
+        const unsigned int id;
+        bool isPending;
+        bool isOccluded;
+        bool isUsed;
+    };
+
+    typedef base::Mesh< base::PVertex, uint8_t > BoundingBoxMesh;
+    const base::ShaderProgram* occlusionShader;
+    std::unique_ptr< BoundingBoxMesh > boundingBoxMesh;
+
+    /* The queries are identified by the index of the pass and the segment, so that
+     * the results of different views are not mixed up.
+     */
+    typedef std::pair< std::size_t, const base::Geometry* > OcclusionQueryKey;
+    std::map< OcclusionQueryKey, std::unique_ptr< OcclusionQuery > > occlusionQueries;
+    static BoundingBoxMesh* createBoundingBoxMesh();
     
 private:
 
@@ -81,8 +114,32 @@ private:
 };
 
 
+static unsigned int createOcclusionQuery()
+{
+    unsigned int id;
+    glGenQueries( 1, &id );
+    return id;
+}
+
+
+VolumeRenderingStage::VideoResources::OcclusionQuery::OcclusionQuery()
+    : id( createOcclusionQuery() )
+    , isPending( false )
+    , isOccluded( false )
+    , isUsed( false )
+{
+}
+
+
+VolumeRenderingStage::VideoResources::OcclusionQuery::~OcclusionQuery()
+{
+    glDeleteQueries( 1, &id );
+}
+
+
 VolumeRenderingStage::VideoResources::VideoResources( const base::ShaderProgram& shader, unsigned int sampleRate )
     : shader( shader )
+    , occlusionShader( nullptr )
     , mySampleRate( sampleRate + 1 )
 {
     /* Create the slices mesh.
@@ -91,6 +148,48 @@ VolumeRenderingStage::VideoResources::VideoResources( const base::ShaderProgram&
 }
 
 
+VolumeRenderingStage::VideoResources::BoundingBoxMesh* VolumeRenderingStage::VideoResources::createBoundingBoxMesh()
+{
+    /* The mesh covers the box [-0,5; +0.5]^3 in model space. The winding order of
+     * the faces is irrelevant, since the mesh is rendered without face culling.
+     */
+    std::vector< typename BoundingBoxMesh::Vertex > vertices( 8 );
+    for( unsigned int cornerIdx = 0; cornerIdx < 8; ++cornerIdx )
+    {
+        vertices[ cornerIdx ].x = ( cornerIdx & 1 ) ? +0.5f : -0.5f;
+        vertices[ cornerIdx ].y = ( cornerIdx & 2 ) ? +0.5f : -0.5f;
+        vertices[ cornerIdx ].z = ( cornerIdx & 4 ) ? +0.5f : -0.5f;
+    }
+    const typename BoundingBoxMesh::Index indices[] =
+    {
+        0, 1, 3,  3, 2, 0,  // -z
+        4, 5, 7,  7, 6, 4,  // +z
+        0, 1, 5,  5, 4, 0,  // -y
+        2, 3, 7,  7, 6, 2,  // +y
+        0, 2, 6,  6, 4, 0,  // -x
+        1, 3, 7,  7, 5, 1   // +x
+    };
+
+    /* Create vertex buffer.
+     */
+    typedef base::VertexBuffer< BoundingBoxMesh::Vertex > VBuffer;
+    VBuffer* const vertexBuffer = new VBuffer();
+    vertexBuffer->copy( &vertices.front(), vertices.size() );
+
+    /* Create index buffer.
+     */
+    typedef base::IndexBuffer< BoundingBoxMesh::Index > IBuffer;
+    IBuffer* const indexBuffer = new IBuffer( base::IndexBufferBase::PRIMITIVE_TYPE_TRIANGLES );
+    indexBuffer->copy( indices, 36 );
+
+    /* Create the mesh.
+     */
+    return new BoundingBoxMesh
+        ( new base::Composition< base::VertexBufferBase >( vertexBuffer )
+        , new base::Composition< base:: IndexBufferBase >(  indexBuffer ) );
+}
+
+
 VolumeRenderingStage::VideoResources::SlicesMesh* VolumeRenderingStage::VideoResources::createSlicesMesh( unsigned int sampleRate )
 {
     /* The mesh is constructed in model space. The box [-0,5; +0.5]^3 defines the
@@ -208,6 +307,10 @@ VolumeRenderingStage::~VolumeRenderingStage()
         /* Release main shader.
          */
         base::ShaderManager::instance().releaseShader( vr->shader );
+        if( vr->occlusionShader != nullptr )
+        {
+            base::ShaderManager::instance().releaseShader( *vr->occlusionShader );
+        }
 
         /* Release texture samplers.
          */
@@ -224,6 +327,28 @@ void VolumeRenderingStage::render( const base::Renderable& renderable )
     using base::math::Matrix4f;
     using base::math::Vector4f;
 
+    /* Skip segments whose bounding boxes were found to be occluded.
+     */
+    if( pimpl->occlusionCulling )
+    {
+        const auto queryItr = vr->occlusionQueries.find( VideoResources::OcclusionQueryKey( pimpl->passIndex, &renderable.geometry() ) );
+        if( queryItr != vr->occlusionQueries.end() && queryItr->second->isOccluded )
+        {
+            ++pimpl->occludedSegmentsCount;
+            return;
+        }
+    }
+
+    /* Switch to the shader that is required for the segment.
+     */
+    const base::ShaderProgram& shader = selectShader( renderable );
+    base::GLContext& glc = pimpl->renderTask->renderer.glContext();
+    if( &glc.shader() != &shader )
+    {
+        glc.setShader( shader );
+        configureShader();
+    }
+
     /* Hereinafter the term 'model' is identified with 'segment'.
      */
     const Matrix4f& modelView = renderable.modelViewTransform();
@@ -330,9 +455,16 @@ void VolumeRenderingStage::render( const base::Renderable& renderable )
         ( anyTexture == nullptr ? base::math::identity4f() : anyTexture->textureCoordinatesCorrection )
         * base::math::translation4f( 0.5f, 0.5f, 0.5f );
 
-    /* Upload matrices to the shader and set the texture samplers properly.
+    /* Upload matrices to the shader and set the texture samplers properly. The
+     * built-in shaders concatenate the model-view matrix with the projection matrix
+     * from the frame uniforms, custom shaders might use the concatenation instead.
+     * The concatenation is only worth computing if the shader actually uses it.
      */
-    base::ShaderUniform< Matrix4f >( "modelViewProjection", pimpl->renderTask->projection * modelView ).upload();
+    base::ShaderUniform< Matrix4f >( "modelView", modelView ).upload();
+    if( shader.uniformLocation( "modelViewProjection" ) >= 0 )
+    {
+        base::ShaderUniform< Matrix4f >( "modelViewProjection", pimpl->renderTask->projection * modelView ).upload();
+    }
     base::ShaderUniform< Matrix4f >( "modelTexture", modelTexture ).upload();
     base::ShaderUniform< Matrix4f >( "tangentModel", tangentModel * base::math::scaling4f( scale ) ).upload();
     for( unsigned int samplerOffset = 0; samplerOffset < roles.size(); ++samplerOffset )
@@ -354,6 +486,12 @@ void VolumeRenderingStage::render( const base::Renderable& renderable )
 }
 
 
+const base::ShaderProgram& VolumeRenderingStage::selectShader( const base::Renderable& )
+{
+    return vr->shader;
+}
+
+
 unsigned int VolumeRenderingStage::loadVideoResources()
 {
     const base::ShaderProgram& shader = acquireShader();
@@ -368,6 +506,13 @@ unsigned int VolumeRenderingStage::loadVideoResources()
 }
 
 
+void VolumeRenderingStage::prepareFrame( base::Node& root )
+{
+    base::GeometryStage< base::Renderable::BackToFront >::prepareFrame( root );
+    pimpl->passIndex = 0;
+}
+
+
 void VolumeRenderingStage::renderPass
     ( const base::math::Matrix4f& vt
     , base::RenderTask& rt
@@ -383,6 +528,7 @@ void VolumeRenderingStage::renderPass
 
     pimpl->renderTask = &rt;
     pimpl->viewPort = &vp;
+    pimpl->occludedSegmentsCount = 0;
     
     /* Do the rendering.
      */
@@ -391,6 +537,107 @@ void VolumeRenderingStage::renderPass
     /* There is no guarantee that 'renderTask' will be valid later.
      */
     pimpl->renderTask = nullptr;
+    ++pimpl->passIndex;
+}
+
+
+void VolumeRenderingStage::Details::issueOcclusionQueries( VolumeRenderingStage& self )
+{
+    VideoResources* const vr = self.vr.get();
+    if( !occlusionCulling )
+    {
+        /* Drop the queries that were issued while occlusion culling was enabled.
+         */
+        vr->occlusionQueries.clear();
+        return;
+    }
+
+    if( vr->occlusionShader == nullptr )
+    {
+        vr->occlusionShader = &base::ShaderManager::instance().acquireShader( "unshaded" );
+        vr->boundingBoxMesh.reset( VideoResources::createBoundingBoxMesh() );
+    }
+
+    /* Render the bounding boxes against the depth buffer, but write neither to the
+     * depth buffer nor to the color buffer.
+     */
+    base::RenderState rs;
+    rs.setDepthTest( true );
+    rs.setDepthWrite( false );
+    rs.setCullFace( base::RenderState::cullNone );
+    rs.setColorWrite( false );
+    renderTask->renderer.glContext().setShader( *vr->occlusionShader );
+
+    while( !self.rq.isEmpty() )
+    {
+        const base::Renderable& renderable = self.rq.poll();
+        std::unique_ptr< VideoResources::OcclusionQuery >& query = vr->occlusionQueries[ VideoResources::OcclusionQueryKey( passIndex, &renderable.geometry() ) ];
+        if( query.get() == nullptr )
+        {
+            query.reset( new VideoResources::OcclusionQuery() );
+        }
+        query->isUsed = true;
+
+        /* Fetch the result of the query issued previously, but only if it is
+         * available already, so that we never have to wait for the GPU.
+         */
+        if( query->isPending )
+        {
+            GLuint isAvailable = GL_FALSE;
+            glGetQueryObjectuiv( query->id, GL_QUERY_RESULT_AVAILABLE, &isAvailable );
+            if( isAvailable == GL_TRUE )
+            {
+                GLuint anySamplesPassed = GL_TRUE;
+                glGetQueryObjectuiv( query->id, GL_QUERY_RESULT, &anySamplesPassed );
+                query->isOccluded = anySamplesPassed == GL_FALSE;
+                query->isPending  = false;
+            }
+        }
+
+        /* Issue a new query if the previous one is finished.
+         */
+        if( !query->isPending )
+        {
+            base::ShaderUniform< base::math::Matrix4f >( "modelView", renderable.modelViewTransform() ).upload();
+            glBeginQuery( GL_ANY_SAMPLES_PASSED, query->id );
+            vr->boundingBoxMesh->render();
+            glEndQuery( GL_ANY_SAMPLES_PASSED );
+            query->isPending = true;
+        }
+    }
+    self.rq.rewind();
+
+    renderTask->renderer.glContext().setShader( vr->shader );
+
+    /* Release the queries of segments that are no longer rendered by this pass.
+     */
+    const auto passEnd = vr->occlusionQueries.lower_bound( VideoResources::OcclusionQueryKey( passIndex + 1, nullptr ) );
+    for( auto queryItr = vr->occlusionQueries.lower_bound( VideoResources::OcclusionQueryKey( passIndex, nullptr ) ); queryItr != passEnd; )
+    {
+        if( queryItr->second->isUsed )
+        {
+            queryItr->second->isUsed = false;
+            ++queryItr;
+        }
+        else
+        {
+            vr->occlusionQueries.erase( queryItr++ );
+        }
+    }
+}
+
+
+void VolumeRenderingStage::buildRenderQueues( base::Node& root, const base::math::Matrix4f& viewTransform )
+{
+    base::GeometryStage< base::Renderable::BackToFront >::buildRenderQueues( root, viewTransform );
+    pimpl->issueOcclusionQueries( *this );
+}
+
+
+void VolumeRenderingStage::updateRenderQueues( const base::math::Matrix4f& viewTransform )
+{
+    base::GeometryStage< base::Renderable::BackToFront >::updateRenderQueues( viewTransform );
+    pimpl->issueOcclusionQueries( *this );
 }
 
 
@@ -407,6 +654,33 @@ unsigned int VolumeRenderingStage::sampleRate() const
 }
 
 
+void VolumeRenderingStage::setOcclusionCullingEnabled( bool occlusionCulling )
+{
+    pimpl->occlusionCulling = occlusionCulling;
+}
+
+
+bool VolumeRenderingStage::isOcclusionCullingEnabled() const
+{
+    return pimpl->occlusionCulling;
+}
+
+
+std::size_t VolumeRenderingStage::occludedSegmentsCount() const
+{
+    return pimpl->occludedSegmentsCount;
+}
+
+
+void VolumeRenderingStage::collectShaderNames( const base::Node&, std::vector< std::string >& shaderNames ) const
+{
+    if( isOcclusionCullingEnabled() )
+    {
+        shaderNames.push_back( "unshaded" );
+    }
+}
+
+
 
 }  // namespace LibCarna :: presets
 
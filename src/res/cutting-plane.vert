@@ -15,7 +15,14 @@
  */
 
 uniform mat4 planeTangentModel;
-uniform mat4 modelViewProjection;
+layout( std140 ) uniform FrameUniforms
+{
+    mat4 projection;
+    mat4 viewTransform;
+    vec4 viewport;
+};
+
+uniform mat4 modelView;
 
 layout( location = 0 ) in vec4 inPosition;
 
@@ -29,6 +36,6 @@ out vec4 modelSpaceCoordinates;
 void main()
 {
     modelSpaceCoordinates = planeTangentModel * inPosition;
-    vec4 clippingCoordinates = modelViewProjection * modelSpaceCoordinates;
+    vec4 clippingCoordinates = projection * modelView * modelSpaceCoordinates;
     gl_Position = clippingCoordinates;
 }
@@ -24,7 +24,16 @@ uniform mat3      normalsView;
 uniform float     stepLength;
 uniform float     translucency;
 uniform float     diffuseLight;
-uniform int       lightingEnabled;
+
+/* Lighting is either enabled at compile time, by defining LIGHTING as 0 or 1, or at
+ * runtime, through the `lightingEnabled` uniform. In the former case, the unused
+ * branch and its texture fetch are eliminated by the compiler.
+ */
+#ifdef LIGHTING
+const int lightingEnabled = LIGHTING;
+#else
+uniform int lightingEnabled;
+#endif
 
 in vec4 modelSpaceCoordinates;
 
@@ -16,9 +16,17 @@
 
 uniform sampler3D mask;
 uniform mat4      modelTexture;
-uniform bool      ignoreColor;
 uniform vec4      color;
 
+/* Whether the color is ignored is either decided at compile time, by defining
+ * IGNORE_COLOR as 0 or 1, or at runtime, through the `ignoreColor` uniform.
+ */
+#ifdef IGNORE_COLOR
+const bool ignoreColor = IGNORE_COLOR == 1;
+#else
+uniform bool ignoreColor;
+#endif
+
 in vec4 modelSpaceCoordinates;
 
 layout( location = 0 ) out vec4 _gl_FragColor;
@@ -0,0 +1,33 @@
+#version 330
+
+/*
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+layout( std140 ) uniform FrameUniforms
+{
+    mat4 projection;
+    mat4 viewTransform;
+    vec4 viewport;
+};
+
+layout( location = 0 ) in vec4 inPosition;
+
+layout( location = 4 ) in mat4 instanceModelView;
+layout( location = 8 ) in mat4 instanceNormalsView;
+layout( location = 12 ) in vec4 instanceColor;
+
+out vec4 vertexColor;
+
+
+// ----------------------------------------------------------------------------------
+// Vertex Procedure
+// ----------------------------------------------------------------------------------
+
+void main()
+{
+    vec4 clippingCoordinates = projection * instanceModelView * inPosition;
+    gl_Position = clippingCoordinates;
+    vertexColor = instanceColor;
+}
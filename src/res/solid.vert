@@ -14,7 +14,14 @@
  * 
  */
 
-uniform mat4 modelViewProjection;
+layout( std140 ) uniform FrameUniforms
+{
+    mat4 projection;
+    mat4 viewTransform;
+    vec4 viewport;
+};
+
+uniform mat4 modelView;
 
 out vec4 normal;
 
@@ -28,7 +35,7 @@ layout( location = 1 ) in vec4 inNormal;
 
 void main()
 {
-    vec4 clippingCoordinates = modelViewProjection * inPosition;
+    vec4 clippingCoordinates = projection * modelView * inPosition;
     gl_Position = clippingCoordinates;
     normal = inNormal;
 }
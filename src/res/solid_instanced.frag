@@ -0,0 +1,23 @@
+#version 330
+
+/*
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+in vec4 normal;
+in vec4 color;
+
+layout( location = 0 ) out vec4 _gl_FragColor;
+
+
+// ----------------------------------------------------------------------------------
+// Fragment Procedure
+// ----------------------------------------------------------------------------------
+
+void main()
+{
+    vec3 lightDirection = vec3( 0, 0, -1 );
+    float diffuseLightAmount = max( 0, -dot( normalize( normal.xyz ), lightDirection ) );
+    _gl_FragColor = vec4( color.rgb * diffuseLightAmount, color.a );
+}
@@ -14,7 +14,14 @@
  * 
  */
 
-uniform mat4 modelViewProjection;
+layout( std140 ) uniform FrameUniforms
+{
+    mat4 projection;
+    mat4 viewTransform;
+    vec4 viewport;
+};
+
+uniform mat4 modelView;
 
 layout( location = 0 ) in vec4 inPosition;
 
@@ -25,6 +32,6 @@ layout( location = 0 ) in vec4 inPosition;
 
 void main()
 {
-    vec4 clippingCoordinates = modelViewProjection * inPosition;
+    vec4 clippingCoordinates = projection * modelView * inPosition;
     gl_Position = clippingCoordinates;
 }
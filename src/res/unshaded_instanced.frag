@@ -0,0 +1,20 @@
+#version 330
+
+/*
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+in vec4 color;
+
+layout( location = 0 ) out vec4 _gl_FragColor;
+
+
+// ----------------------------------------------------------------------------------
+// Fragment Procedure
+// ----------------------------------------------------------------------------------
+
+void main()
+{
+    _gl_FragColor = color;
+}
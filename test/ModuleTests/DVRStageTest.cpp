@@ -16,8 +16,13 @@
 #include <LibCarna/base/Node.hpp>
 #include <LibCarna/base/FrameRenderer.hpp>
 #include <LibCarna/base/BufferedIntensityVolume.hpp>
+#include <LibCarna/base/Geometry.hpp>
+#include <LibCarna/base/Material.hpp>
+#include <LibCarna/base/MeshFactory.hpp>
+#include <LibCarna/base/Vertex.hpp>
 #include <LibCarna/helpers/VolumeGridHelper.hpp>
 #include <LibCarna/presets/DVRStage.hpp>
+#include <LibCarna/presets/OpaqueRenderingStage.hpp>
 
 
 
@@ -161,3 +166,66 @@ void DVRStageTest::test_withColorMapLimits()
     renderer->render( *cam, *root );
     VERIFY_FRAMEBUFFER( *testFramebuffer );
 }
+
+
+void DVRStageTest::test_withOcclusionCulling()
+{
+    /* Add volume data to scene.
+     */
+    typedef helpers::VolumeGridHelper< base::IntensityVolumeUInt16, base::NormalMap3DInt8 > GridHelper;
+    GridHelper gridHelper( data->size );
+    gridHelper.loadIntensities( *data );
+    root->attachChild( gridHelper.createNode( GEOMETRY_TYPE_VOLUMETRIC, GridHelper::Spacing( dataSpacings ) ) );
+
+    /* Configure DVR stage (should be equivalent to `test_withLighting`).
+     */
+    dvr->colorMap.writeLinearSegment( base::HUV( -400 ).intensity(), base::HUV(   0 ).intensity(), base::Color:: BLUE_NO_ALPHA, base::Color:: BLUE );
+    dvr->colorMap.writeLinearSegment( base::HUV(    0 ).intensity(), base::HUV( 400 ).intensity(), base::Color::GREEN_NO_ALPHA, base::Color::GREEN );
+    dvr->setSampleRate( 1000 );
+    dvr->setTranslucency( 2 );
+    dvr->setOcclusionCullingEnabled( true );
+
+    /* Render twice, so that the results of the occlusion queries are used. Nothing
+     * occludes the volume, thus the rendering must not change.
+     */
+    renderer->render( *cam, *root );
+    renderer->render( *cam, *root );
+    QCOMPARE( dvr->occludedSegmentsCount(), static_cast< std::size_t >( 0 ) );
+    testFramebuffer->verifyFramebuffer( "DVRStageTest/withLighting.png", "DVRStageTest/withOcclusionCulling.png" );
+}
+
+
+void DVRStageTest::test_withOpaqueGeometry()
+{
+    /* Add volume data to scene.
+     */
+    test_withoutLighting();
+
+    /* Render an opaque box at the center of the volume after it. The output is a
+     * framebuffer object, so its depth buffer is shared with the accumulation pass
+     * of the DVR stage. The slices must not write to it, or they would occlude the
+     * box.
+     */
+    presets::OpaqueRenderingStage* const opaque = new presets::OpaqueRenderingStage( GEOMETRY_TYPE_OPAQUE );
+    renderer->appendStage( opaque );
+
+    base::ManagedMeshBase& boxMesh = base::MeshFactory< base::PVertex >::createBox( 40, 40, 40 );
+    base::Material& redMaterial = base::Material::create( "unshaded" );
+    redMaterial.setParameter( "color", base::math::Vector4f( 1, 0, 0, 1 ) );
+    base::Geometry* const box = new base::Geometry( GEOMETRY_TYPE_OPAQUE );
+    box->putFeature( presets::OpaqueRenderingStage::DEFAULT_ROLE_MESH, boxMesh );
+    box->putFeature( presets::OpaqueRenderingStage::DEFAULT_ROLE_MATERIAL, redMaterial );
+    boxMesh.release();
+    redMaterial.release();
+    root->attachChild( box );
+
+    renderer->render( *cam, *root );
+
+    /* The center of the frame must show the box.
+     */
+    unsigned char pixel[ 4 ];
+    glReadPixels( testFramebuffer->width() / 2, testFramebuffer->height() / 2, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixel );
+    QCOMPARE( static_cast< int >( pixel[ 0 ] ), 255 );
+    QCOMPARE( static_cast< int >( pixel[ 1 ] ),   0 );
+    QCOMPARE( static_cast< int >( pixel[ 2 ] ),   0 );
+}
@@ -66,11 +66,16 @@ private slots:
 
     void test_withColorMapLimits();
 
+    void test_withOcclusionCulling();
+
+    void test_withOpaqueGeometry();
+
  // ---------------------------------------------------------------------------------
 
 private:
 
     const static unsigned int GEOMETRY_TYPE_VOLUMETRIC = 0;
+    const static unsigned int GEOMETRY_TYPE_OPAQUE     = 1;
 
     std::unique_ptr< QGLContextHolder > qglContextHolder;
     std::unique_ptr< TestFramebuffer > testFramebuffer;
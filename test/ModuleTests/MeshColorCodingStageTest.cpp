@@ -204,3 +204,45 @@ void MeshColorCodingStageTest::test_atInvalidFrameLocations()
         (  mccs->pick( renderer->width() * 2, renderer->height() * 2 )
         == base::Aggregation< const base::Geometry >::NULL_PTR );
 }
+
+
+void MeshColorCodingStageTest::test_requestPick()
+{
+    scene->resetCamTransform();
+    scene->cam().localTransform = base::math::rotation4f( 0, 1, 0, base::math::deg2rad( 90 ) ) * scene->cam().localTransform;
+    scene->root->updateWorldTransform();
+
+    const base::math::Vector2ui locationRed     = computeFrameLocation( *objRed   );
+    const base::math::Vector2ui locationGreen   = computeFrameLocation( *objGreen );
+    const base::math::Vector2ui locationBetween = ( locationRed + locationGreen ) / 2;
+
+    /* In lazy mode, the picks are read back by the frame that follows the requests.
+     */
+    mccs->setLazy( true );
+    mccs->requestPick( locationRed );
+    mccs->requestPick( locationGreen );
+    mccs->requestPick( locationBetween );
+    QCOMPARE( mccs->pendingPicks(), static_cast< std::size_t >( 3 ) );
+    renderer->render( scene->cam(), *scene->root );
+
+    /* The picks must be resolved in the order they were requested.
+     */
+    std::vector< base::math::Vector2ui > locations;
+    std::vector< const base::Geometry* > geometries;
+    mccs->resolvePicks( [&]( const base::math::Vector2ui& location, const base::Geometry* geometry )
+        {
+            locations.push_back( location );
+            geometries.push_back( geometry );
+        }
+        , true );
+    mccs->setLazy( false );
+
+    QCOMPARE( mccs->pendingPicks(), static_cast< std::size_t >( 0 ) );
+    QCOMPARE( geometries.size(), static_cast< std::size_t >( 3 ) );
+    QVERIFY( locations[ 0 ] == locationRed     );
+    QVERIFY( locations[ 1 ] == locationGreen   );
+    QVERIFY( locations[ 2 ] == locationBetween );
+    QCOMPARE( geometries[ 0 ], static_cast< const base::Geometry* >( objRed   ) );
+    QCOMPARE( geometries[ 1 ], static_cast< const base::Geometry* >( objGreen ) );
+    QCOMPARE( geometries[ 2 ], static_cast< const base::Geometry* >( nullptr ) );
+}
@@ -68,6 +68,8 @@ private slots:
 
     void test_atInvalidFrameLocations();
 
+    void test_requestPick();
+
  // ---------------------------------------------------------------------------------
 
 private:
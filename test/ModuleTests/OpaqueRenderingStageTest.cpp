@@ -20,6 +20,10 @@
 #include <LibCarna/base/Material.hpp>
 #include <LibCarna/base/Mesh.hpp>
 #include <LibCarna/base/MeshFactory.hpp>
+#include <LibCarna/base/ShaderProgram.hpp>
+#include <LibCarna/base/FrameUniformBuffer.hpp>
+#include <LibCarna/base/GLContext.hpp>
+#include <LibCarna/base/RenderState.hpp>
 
 
 
@@ -52,7 +56,7 @@ void OpaqueRenderingStageTest::initTestCase()
     greenMaterial.setParameter( "color", base::math::Vector4f( 0, 1, 0, 1 ) );
 
     base::Geometry* const box1 = new base::Geometry( GEOMETRY_TYPE_OPAQUE );
-    base::Geometry* const box2 = new base::Geometry( GEOMETRY_TYPE_OPAQUE );
+    box2 = new base::Geometry( GEOMETRY_TYPE_OPAQUE );
 
     box1->putFeature( presets::OpaqueRenderingStage::DEFAULT_ROLE_MESH, boxMesh );
     box2->putFeature( presets::OpaqueRenderingStage::DEFAULT_ROLE_MESH, boxMesh );
@@ -106,3 +110,130 @@ void OpaqueRenderingStageTest::test_fromBack()
     renderer->render( scene->cam(), *scene->root );
     VERIFY_FRAMEBUFFER( *testFramebuffer );
 }
+
+
+void OpaqueRenderingStageTest::test_sceneChange()
+{
+    /* Render without the second box first, so that the render queue is built
+     * without it. Re-attaching the box must invalidate the persistent queue.
+     */
+    scene->resetCamTransform();
+    scene->root->detachChild( *box2 );
+    renderer->render( scene->cam(), *scene->root );
+    scene->root->attachChild( box2 );
+    renderer->render( scene->cam(), *scene->root );
+    testFramebuffer->verifyFramebuffer( "OpaqueRenderingStageTest/fromFront.png", "OpaqueRenderingStageTest/sceneChange.png" );
+}
+
+
+void OpaqueRenderingStageTest::test_uniformLocationQueries()
+{
+    /* The shaders are linked when the first frame is rendered. No uniform locations
+     * must be queried from OpenGL afterwards.
+     */
+    scene->resetCamTransform();
+    renderer->render( scene->cam(), *scene->root );
+    const std::size_t uniformLocationQueriesCount = base::ShaderProgram::uniformLocationQueriesCount();
+    renderer->render( scene->cam(), *scene->root );
+    renderer->render( scene->cam(), *scene->root );
+    QCOMPARE( base::ShaderProgram::uniformLocationQueriesCount(), uniformLocationQueriesCount );
+}
+
+
+void OpaqueRenderingStageTest::test_frameUniforms()
+{
+    /* The frame uniforms must only be written when the camera changes.
+     */
+    scene->resetCamTransform();
+    renderer->render( scene->cam(), *scene->root );
+    const std::size_t uploadsCount = renderer->frameUniforms().uploadsCount();
+    renderer->render( scene->cam(), *scene->root );
+    QCOMPARE( renderer->frameUniforms().uploadsCount(), uploadsCount );
+
+    scene->cam().localTransform = base::math::rotation4f( 0, 1, 0, base::math::deg2rad( 180 ) ) * scene->cam().localTransform;
+    renderer->render( scene->cam(), *scene->root );
+    QCOMPARE( renderer->frameUniforms().uploadsCount(), uploadsCount + 1 );
+    testFramebuffer->verifyFramebuffer( "OpaqueRenderingStageTest/fromBack.png", "OpaqueRenderingStageTest/frameUniforms.png" );
+}
+
+
+void OpaqueRenderingStageTest::test_materialUploads()
+{
+    /* Add more boxes, that share the mesh and the material of the second box, and
+     * render them without instancing, so that the material is activated per box.
+     */
+    std::vector< base::Geometry* > boxes;
+    for( int boxIdx = 0; boxIdx < 8; ++boxIdx )
+    {
+        base::Geometry* const box = new base::Geometry( GEOMETRY_TYPE_OPAQUE );
+        box->putFeature( presets::OpaqueRenderingStage::DEFAULT_ROLE_MESH    , box2->feature( presets::OpaqueRenderingStage::DEFAULT_ROLE_MESH     ) );
+        box->putFeature( presets::OpaqueRenderingStage::DEFAULT_ROLE_MATERIAL, box2->feature( presets::OpaqueRenderingStage::DEFAULT_ROLE_MATERIAL ) );
+        box->localTransform = base::math::translation4f( +10 + 10 * boxIdx, +10, +40 );
+        scene->root->attachChild( box );
+        boxes.push_back( box );
+    }
+    opaque->setInstancingEnabled( false );
+
+    /* Each material must upload its parameters at most once per frame, since the
+     * render queue is ordered by materials.
+     */
+    scene->resetCamTransform();
+    renderer->render( scene->cam(), *scene->root );
+    const std::size_t uploadsCount = base::Material::parameterUploadsCount();
+    renderer->render( scene->cam(), *scene->root );
+    QVERIFY( base::Material::parameterUploadsCount() - uploadsCount <= 2 );
+
+    opaque->setInstancingEnabled( true );
+    for( auto boxItr = boxes.begin(); boxItr != boxes.end(); ++boxItr )
+    {
+        delete scene->root->detachChild( **boxItr );
+    }
+}
+
+
+void OpaqueRenderingStageTest::test_stateChanges()
+{
+    base::GLContext& glc = renderer->glContext();
+    glc.makeCurrent();
+    glc.setStatisticsEnabled( true );
+    const base::GLStatistics statistics0 = glc.statistics();
+
+    /* Sibling render states, that set the same line width, must not revert and
+     * re-apply it: The line width is set once and restored once.
+     */
+    for( int rsIdx = 0; rsIdx < 10; ++rsIdx )
+    {
+        base::RenderState rs;
+        rs.setLineWidth( 2 );
+    }
+    glc.commitRenderState();
+    const base::GLStatistics statistics = glc.statistics() - statistics0;
+    glc.setStatisticsEnabled( false );
+    QCOMPARE( statistics.stateChanges, static_cast< std::size_t >( 2 ) );
+    QCOMPARE( statistics.suppressedStateChanges(), static_cast< std::size_t >( 18 ) );
+
+    /* Deferred state changes must not affect the rendered frames.
+     */
+    scene->resetCamTransform();
+    renderer->render( scene->cam(), *scene->root );
+    testFramebuffer->verifyFramebuffer( "OpaqueRenderingStageTest/fromFront.png", "OpaqueRenderingStageTest/stateChanges.png" );
+}
+
+
+void OpaqueRenderingStageTest::test_frameStatistics()
+{
+    renderer->glContext().setStatisticsEnabled( true );
+    scene->resetCamTransform();
+    renderer->render( scene->cam(), *scene->root );
+    renderer->glContext().setStatisticsEnabled( false );
+
+    /* Each box consists of twelve triangles.
+     */
+    const base::FrameRenderer::FrameStatistics& statistics = renderer->frameStatistics();
+    QCOMPARE( statistics.stages.size(), renderer->stages() );
+    QVERIFY( statistics.total.drawCalls > 0 );
+    QVERIFY( statistics.total.primitives >= 12 * statistics.total.drawCalls );
+    QVERIFY( statistics.total.uniformUploads > 0 );
+    QCOMPARE( statistics.stages[ 0 ].drawCalls, statistics.total.drawCalls );
+    QCOMPARE( statistics.stages[ 0 ].primitives, statistics.total.primitives );
+}
@@ -63,6 +63,18 @@ private slots:
 
     void test_fromBack();
 
+    void test_sceneChange();
+
+    void test_uniformLocationQueries();
+
+    void test_frameUniforms();
+
+    void test_materialUploads();
+
+    void test_stateChanges();
+
+    void test_frameStatistics();
+
  // ---------------------------------------------------------------------------------
 
 private:
@@ -75,6 +87,7 @@ private:
     std::unique_ptr< base::FrameRenderer > renderer;
     
     presets::OpaqueRenderingStage* opaque;
+    base::Geometry* box2;
 
 }; // OpaqueRenderingStageTest
 
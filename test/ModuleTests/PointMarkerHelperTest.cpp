@@ -120,3 +120,34 @@ void PointMarkerHelperTest::test_fixed_color()
     renderer->render( *cam, *root );
     VERIFY_FRAMEBUFFER( *testFramebuffer );
 }
+
+
+void PointMarkerHelperTest::test_instancing()
+{
+    helpers::PointMarkerHelper markers( GEOMETRY_TYPE_OPAQUE );
+
+    const float maxOffset = 300;
+    const unsigned int markersCount = 10;
+    for( unsigned int i = 0; i < markersCount; ++i )
+    {
+        const float x = -maxOffset + i * 2 * maxOffset / ( markersCount - 1 );
+        base::Geometry* const marker = markers.createPointMarker();
+        marker->localTransform = base::math::translation4f( x, 0, 0 );
+        root->attachChild( marker );
+    }
+
+    /* The markers differ only by their colors, thus they are rendered using a
+     * single instanced draw call.
+     */
+    renderer->render( *cam, *root );
+    QCOMPARE( opaque->drawCallsCount(), static_cast< std::size_t >( 1 ) );
+    testFramebuffer->verifyFramebuffer( "PointMarkerHelperTest/multiple.png", "PointMarkerHelperTest/instancing.png" );
+
+    /* Verify that the same is rendered without instancing.
+     */
+    opaque->setInstancingEnabled( false );
+    renderer->render( *cam, *root );
+    opaque->setInstancingEnabled( true );
+    QCOMPARE( opaque->drawCallsCount(), static_cast< std::size_t >( markersCount ) );
+    testFramebuffer->verifyFramebuffer( "PointMarkerHelperTest/multiple.png", "PointMarkerHelperTest/instancing.png" );
+}
@@ -63,6 +63,8 @@ private slots:
 
     void test_fixed_color();
 
+    void test_instancing();
+
  // ---------------------------------------------------------------------------------
 
 private:
@@ -0,0 +1,212 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#include "ShaderManagerTest.hpp"
+#include <LibCarna/base/ShaderManager.hpp>
+#include <LibCarna/base/ShaderProgram.hpp>
+#include <LibCarna/base/ShaderCompilationError.hpp>
+#include <QDir>
+#include <QFile>
+
+
+
+// ----------------------------------------------------------------------------------
+// Types & Globals
+// ----------------------------------------------------------------------------------
+
+const static std::string VERTEX_SHADER_SOURCE =
+    "#version 330\n"
+    "layout( location = 0 ) in vec4 inPosition;\n"
+    "void main() { gl_Position = inPosition; }\n";
+
+const static std::string FRAGMENT_SHADER_SOURCE =
+    "#version 330\n"
+    "uniform vec4 color;\n"
+    "layout( location = 0 ) out vec4 _gl_FragColor;\n"
+    "void main() { _gl_FragColor = color; }\n";
+
+
+
+// ----------------------------------------------------------------------------------
+// ShaderManagerTest
+// ----------------------------------------------------------------------------------
+
+void ShaderManagerTest::initTestCase()
+{
+    qglContextHolder.reset( new QGLContextHolder() );
+}
+
+
+void ShaderManagerTest::cleanupTestCase()
+{
+    qglContextHolder.reset();
+}
+
+
+void ShaderManagerTest::init()
+{
+}
+
+
+void ShaderManagerTest::cleanup()
+{
+    base::ShaderManager& shaderManager = base::ShaderManager::instance();
+    shaderManager.setProgramBinaryCacheDirectory( "" );
+    shaderManager.removeSource( "programBinaryCacheTest.vert" );
+    shaderManager.removeSource( "programBinaryCacheTest.frag" );
+    shaderManager.removeSource( "prewarmTest1.vert" );
+    shaderManager.removeSource( "prewarmTest1.frag" );
+    shaderManager.removeSource( "prewarmTest2.vert" );
+    shaderManager.removeSource( "prewarmTest2.frag" );
+    shaderManager.removeSource( "prewarmTestBroken.vert" );
+    shaderManager.removeSource( "prewarmTestBroken.frag" );
+    shaderManager.removeSource( "variantsTest.vert" );
+    shaderManager.removeSource( "variantsTest.frag" );
+}
+
+
+void ShaderManagerTest::test_programBinaryCache()
+{
+    if( !base::ShaderProgram::isBinarySupported() )
+    {
+        QSKIP( "Program binaries are not supported by the OpenGL context." );
+    }
+
+    /* Start with an empty cache.
+     */
+    const QString directory = QDir::temp().filePath( "LibCarnaShaderManagerTest" );
+    QDir().mkpath( directory );
+    QFile::remove( QDir( directory ).filePath( "programBinaryCacheTest.bin" ) );
+
+    base::ShaderManager& shaderManager = base::ShaderManager::instance();
+    shaderManager.setProgramBinaryCacheDirectory( directory.toStdString() );
+    shaderManager.setSource( "programBinaryCacheTest.vert", VERTEX_SHADER_SOURCE );
+    shaderManager.setSource( "programBinaryCacheTest.frag", FRAGMENT_SHADER_SOURCE );
+    const std::size_t hitsCount = shaderManager.programBinaryCacheHitsCount();
+
+    /* The first acquisition builds the shader from its sources.
+     */
+    shaderManager.releaseShader( shaderManager.acquireShader( "programBinaryCacheTest" ) );
+    QCOMPARE( shaderManager.programBinaryCacheHitsCount(), hitsCount );
+
+    /* The second acquisition loads the shader from the cache.
+     */
+    const base::ShaderProgram& shader = shaderManager.acquireShader( "programBinaryCacheTest" );
+    QCOMPARE( shaderManager.programBinaryCacheHitsCount(), hitsCount + 1 );
+    QVERIFY( shader.uniformLocation( "color" ) != -1 );
+    shaderManager.releaseShader( shader );
+
+    /* Changing the sources must invalidate the cached binary.
+     */
+    shaderManager.setSource( "programBinaryCacheTest.frag", FRAGMENT_SHADER_SOURCE + "\n" );
+    shaderManager.releaseShader( shaderManager.acquireShader( "programBinaryCacheTest" ) );
+    QCOMPARE( shaderManager.programBinaryCacheHitsCount(), hitsCount + 1 );
+}
+
+
+void ShaderManagerTest::test_prewarmShaders()
+{
+    base::ShaderManager& shaderManager = base::ShaderManager::instance();
+    shaderManager.setSource( "prewarmTest1.vert", VERTEX_SHADER_SOURCE );
+    shaderManager.setSource( "prewarmTest1.frag", FRAGMENT_SHADER_SOURCE );
+    shaderManager.setSource( "prewarmTest2.vert", VERTEX_SHADER_SOURCE );
+    shaderManager.setSource( "prewarmTest2.frag", FRAGMENT_SHADER_SOURCE + "\n" );
+
+    /* Prewarming tells the shaders in the requested order, also for duplicates.
+     */
+    std::vector< std::string > shaderNames;
+    shaderNames.push_back( "prewarmTest1" );
+    shaderNames.push_back( "prewarmTest2" );
+    shaderNames.push_back( "prewarmTest1" );
+    const std::vector< const base::ShaderProgram* > shaders = shaderManager.prewarmShaders( shaderNames );
+    QCOMPARE( shaders.size(), static_cast< std::size_t >( 3 ) );
+    QVERIFY( shaders[ 0 ] != shaders[ 1 ] );
+    QCOMPARE( shaders[ 0 ], shaders[ 2 ] );
+    QVERIFY( shaders[ 0 ]->uniformLocation( "color" ) != -1 );
+    QVERIFY( shaders[ 1 ]->uniformLocation( "color" ) != -1 );
+    QVERIFY( shaderManager.shaderBuildTime( "prewarmTest1" ) > 0 );
+    QVERIFY( shaderManager.shaderBuildTime( "prewarmTest2" ) > 0 );
+
+    /* Acquiring a prewarmed shader does not build it again.
+     */
+    const base::ShaderProgram& shader = shaderManager.acquireShader( "prewarmTest1" );
+    QCOMPARE( &shader, shaders[ 0 ] );
+    shaderManager.releaseShader( shader );
+    for( auto shaderItr = shaders.begin(); shaderItr != shaders.end(); ++shaderItr )
+    {
+        shaderManager.releaseShader( **shaderItr );
+    }
+
+    /* A shader that fails to build must not leave any other shader acquired.
+     */
+    shaderManager.setSource( "prewarmTestBroken.vert", VERTEX_SHADER_SOURCE );
+    shaderManager.setSource( "prewarmTestBroken.frag", "#version 330\nvoid main() { undefined(); }\n" );
+    shaderNames.push_back( "prewarmTestBroken" );
+    QVERIFY_EXCEPTION_THROWN(
+        shaderManager.prewarmShaders( shaderNames ),
+        base::ShaderCompilationError
+    );
+
+    /* Without their sources, only loaded shaders are available.
+     */
+    shaderManager.removeSource( "prewarmTest1.vert" );
+    shaderManager.removeSource( "prewarmTest2.vert" );
+    shaderManager.removeSource( "prewarmTestBroken.vert" );
+    QVERIFY( !shaderManager.hasShader( "prewarmTest1" ) );
+    QVERIFY( !shaderManager.hasShader( "prewarmTest2" ) );
+    QVERIFY( !shaderManager.hasShader( "prewarmTestBroken" ) );
+}
+
+
+void ShaderManagerTest::test_shaderVariants()
+{
+    base::ShaderManager& shaderManager = base::ShaderManager::instance();
+    shaderManager.setSource( "variantsTest.vert", VERTEX_SHADER_SOURCE );
+    shaderManager.setSource( "variantsTest.frag",
+        "#version 330\n"
+        "#if USE_COLOR\n"
+        "uniform vec4 color;\n"
+        "#else\n"
+        "const vec4 color = vec4( 1, 1, 1, 1 );\n"
+        "#endif\n"
+        "layout( location = 0 ) out vec4 _gl_FragColor;\n"
+        "void main() { _gl_FragColor = color; }\n" );
+
+    /* The variants are named after their definitions.
+     */
+    base::ShaderManager::Defines colorDefines;
+    base::ShaderManager::Defines noColorDefines;
+    colorDefines  [ "USE_COLOR" ] = "1";
+    noColorDefines[ "USE_COLOR" ] = "0";
+    QCOMPARE( base::ShaderManager::variantName( "variantsTest", colorDefines ), std::string( "variantsTest[USE_COLOR=1]" ) );
+    QCOMPARE( base::ShaderManager::variantName( "variantsTest", base::ShaderManager::Defines() ), std::string( "variantsTest" ) );
+    QVERIFY( shaderManager.hasShader( "variantsTest[USE_COLOR=1]" ) );
+
+    /* Each variant is built separately and specialized by its definitions.
+     */
+    const base::ShaderProgram& colorShader   = shaderManager.acquireShader( "variantsTest", colorDefines );
+    const base::ShaderProgram& noColorShader = shaderManager.acquireShader( "variantsTest", noColorDefines );
+    QVERIFY( &colorShader != &noColorShader );
+    QVERIFY( colorShader.uniformLocation( "color" ) != -1 );
+    QCOMPARE( noColorShader.uniformLocation( "color" ), -1 );
+
+    /* Variants can also be acquired by their names.
+     */
+    const base::ShaderProgram& shader = shaderManager.acquireShader( "variantsTest[USE_COLOR=1]" );
+    QCOMPARE( &shader, &colorShader );
+
+    shaderManager.releaseShader( shader );
+    shaderManager.releaseShader( colorShader );
+    shaderManager.releaseShader( noColorShader );
+}
@@ -0,0 +1,79 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#pragma once
+
+#include <LibCarna/LibCarna.hpp>
+
+namespace LibCarna
+{
+
+namespace testing
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// ShaderManagerTest
+// ----------------------------------------------------------------------------------
+
+/** \brief
+  * Module-tests of the \ref LibCarna::base::ShaderManager class.
+  *
+  * \author Leonid Kostrykin
+  */
+class ShaderManagerTest : public QObject
+{
+
+    Q_OBJECT
+
+private slots:
+
+    /** \brief  Called before the first test function is executed.
+      */
+    void initTestCase();
+
+    /** \brief  Called after the last test function is executed.
+      */
+    void cleanupTestCase();
+
+    /** \brief  Called before each test function is executed
+      */
+    void init();
+
+    /** \brief  Called after each test function is executed
+      */
+    void cleanup();
+
+ // ---------------------------------------------------------------------------------
+
+    void test_programBinaryCache();
+
+    void test_prewarmShaders();
+
+    void test_shaderVariants();
+
+ // ---------------------------------------------------------------------------------
+
+private:
+
+    std::unique_ptr< QGLContextHolder > qglContextHolder;
+
+}; // ShaderManagerTest
+
+
+
+}  // namespace testing
+
+}  // namespace LibCarna
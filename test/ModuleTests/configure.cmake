@@ -13,6 +13,7 @@ list( APPEND TESTS
 		DVRStageTest
         MaskRenderingStageTest
 		PointMarkerHelperTest
+		ShaderManagerTest
 	)
 
 list( APPEND TESTS_QOBJECT_HEADERS
@@ -27,6 +28,7 @@ list( APPEND TESTS_QOBJECT_HEADERS
 		ModuleTests/DVRStageTest.hpp
 		ModuleTests/MaskRenderingStageTest.hpp
 		ModuleTests/PointMarkerHelperTest.hpp
+		ModuleTests/ShaderManagerTest.hpp
 	)
 
 list( APPEND TESTS_HEADERS
@@ -45,4 +47,5 @@ list( APPEND TESTS_SOURCES
 		ModuleTests/DVRStageTest.cpp
 		ModuleTests/MaskRenderingStageTest.cpp
 		ModuleTests/PointMarkerHelperTest.cpp
+		ModuleTests/ShaderManagerTest.cpp
 	)
@@ -0,0 +1,266 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#include "BoundingVolumeHierarchyTest.hpp"
+#include <LibCarna/base/BoundingVolumeHierarchy.hpp>
+#include <LibCarna/base/BoundingSphere.hpp>
+#include <LibCarna/base/BoundingBox.hpp>
+#include <LibCarna/base/BoundingVolume.hpp>
+#include <LibCarna/base/Node.hpp>
+#include <LibCarna/base/Geometry.hpp>
+#include <LibCarna/base/math.hpp>
+#include <LibCarna/base/math/Ray.hpp>
+#include <set>
+
+namespace LibCarna
+{
+
+namespace testing
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// Types & Globals
+// ----------------------------------------------------------------------------------
+
+/* Bounding volume that relies on the default implementations.
+ */
+class PointBoundingVolume : public base::BoundingVolume
+{
+
+public:
+
+    virtual void computeClosemostPoint( base::math::Vector3f& out, const base::math::Vector3f& ) const override
+    {
+        out = base::math::Vector3f( 0, 0, 0 );
+    }
+
+}; // PointBoundingVolume
+
+
+
+// ----------------------------------------------------------------------------------
+// BoundingVolumeHierarchyTest
+// ----------------------------------------------------------------------------------
+
+void BoundingVolumeHierarchyTest::initTestCase()
+{
+}
+
+
+void BoundingVolumeHierarchyTest::cleanupTestCase()
+{
+}
+
+
+void BoundingVolumeHierarchyTest::init()
+{
+    /* Three unit spheres along the x-axis, a box above the first sphere, and a
+     * geometry without bounding volume.
+     */
+    root.reset( new base::Node() );
+    for( unsigned int sphereIdx = 0; sphereIdx < 3; ++sphereIdx )
+    {
+        spheres[ sphereIdx ] = new base::Geometry( GEOMETRY_TYPE );
+        spheres[ sphereIdx ]->localTransform = base::math::translation4f( 5.f * sphereIdx, 0, 0 );
+        spheres[ sphereIdx ]->setBoundingVolume( new base::BoundingSphere( 1 ) );
+        root->attachChild( spheres[ sphereIdx ] );
+    }
+
+    box = new base::Geometry( GEOMETRY_TYPE );
+    box->localTransform = base::math::translation4f( 0, 5, 0 );
+    box->setBoundingVolume( new base::BoundingBox( 2, 2, 2 ) );
+    root->attachChild( box );
+
+    unbounded = new base::Geometry( GEOMETRY_TYPE );
+    root->attachChild( unbounded );
+
+    root->updateWorldTransform();
+    bvh.reset( new base::BoundingVolumeHierarchy( *root ) );
+    bvh->update();
+}
+
+
+void BoundingVolumeHierarchyTest::cleanup()
+{
+    bvh.reset();
+    root.reset();
+}
+
+
+void BoundingVolumeHierarchyTest::test_update()
+{
+    QCOMPARE( bvh->size(), static_cast< std::size_t >( 4 ) );
+    QCOMPARE( bvh->updatedGeometriesCount(), static_cast< std::size_t >( 4 ) );
+
+    /* Nothing has changed since the hierarchy was built.
+     */
+    root->updateWorldTransform();
+    bvh->update();
+    QCOMPARE( bvh->size(), static_cast< std::size_t >( 4 ) );
+    QCOMPARE( bvh->updatedGeometriesCount(), static_cast< std::size_t >( 0 ) );
+}
+
+
+void BoundingVolumeHierarchyTest::test_update_refit()
+{
+    /* Move the last sphere below the first one.
+     */
+    spheres[ 2 ]->localTransform = base::math::translation4f( 0, -5, 0 );
+    root->updateWorldTransform();
+    bvh->update();
+    QCOMPARE( bvh->size(), static_cast< std::size_t >( 4 ) );
+    QCOMPARE( bvh->updatedGeometriesCount(), static_cast< std::size_t >( 1 ) );
+
+    base::math::Ray3f ray;
+    ray.origin    = base::math::Vector3f( 0, -5, 10 );
+    ray.direction = base::math::Vector3f( 0,  0, -1 );
+    base::math::Vector3f hitLocation;
+    QCOMPARE( bvh->queryRay( hitLocation, ray ), spheres[ 2 ] );
+    QVERIFY( base::math::isEqual( hitLocation, base::math::Vector3f( 0, -5, 1 ) ) );
+
+    ray.origin = base::math::Vector3f( 10, 0, 10 );
+    QVERIFY( bvh->queryRay( hitLocation, ray ) == nullptr );
+}
+
+
+void BoundingVolumeHierarchyTest::test_update_rebuild()
+{
+    base::Geometry* const sphere = new base::Geometry( GEOMETRY_TYPE );
+    sphere->localTransform = base::math::translation4f( 0, -5, 0 );
+    sphere->setBoundingVolume( new base::BoundingSphere( 1 ) );
+    root->attachChild( sphere );
+    root->updateWorldTransform();
+    bvh->update();
+    QCOMPARE( bvh->size(), static_cast< std::size_t >( 5 ) );
+
+    base::math::Ray3f ray;
+    ray.origin    = base::math::Vector3f( 0, -5, 10 );
+    ray.direction = base::math::Vector3f( 0,  0, -1 );
+    base::math::Vector3f hitLocation;
+    QCOMPARE( bvh->queryRay( hitLocation, ray ), sphere );
+}
+
+
+void BoundingVolumeHierarchyTest::test_queryRay()
+{
+    base::math::Ray3f ray;
+    base::math::Vector3f hitLocation;
+
+    /* Hit the middle sphere from the front.
+     */
+    ray.origin    = base::math::Vector3f( 5, 0, 10 );
+    ray.direction = base::math::Vector3f( 0, 0, -1 );
+    QCOMPARE( bvh->queryRay( hitLocation, ray ), spheres[ 1 ] );
+    QVERIFY( base::math::isEqual( hitLocation, base::math::Vector3f( 5, 0, 1 ) ) );
+
+    /* Hit the box from the front.
+     */
+    ray.origin = base::math::Vector3f( 0, 5, 10 );
+    QCOMPARE( bvh->queryRay( hitLocation, ray ), box );
+    QVERIFY( base::math::isEqual( hitLocation, base::math::Vector3f( 0, 5, 1 ) ) );
+
+    /* Hit the close-most of the three spheres.
+     */
+    ray.origin    = base::math::Vector3f( -10, 0, 0 );
+    ray.direction = base::math::Vector3f(   1, 0, 0 );
+    QCOMPARE( bvh->queryRay( hitLocation, ray ), spheres[ 0 ] );
+    QVERIFY( base::math::isEqual( hitLocation, base::math::Vector3f( -1, 0, 0 ) ) );
+
+    ray.origin    = base::math::Vector3f( 20, 0, 0 );
+    ray.direction = base::math::Vector3f( -1, 0, 0 );
+    QCOMPARE( bvh->queryRay( hitLocation, ray ), spheres[ 2 ] );
+    QVERIFY( base::math::isEqual( hitLocation, base::math::Vector3f( 11, 0, 0 ) ) );
+}
+
+
+void BoundingVolumeHierarchyTest::test_queryRay_miss()
+{
+    base::math::Ray3f ray;
+    base::math::Vector3f hitLocation;
+
+    /* Pass between the spheres.
+     */
+    ray.origin    = base::math::Vector3f( 2.5f, 0, 10 );
+    ray.direction = base::math::Vector3f( 0, 0, -1 );
+    QVERIFY( bvh->queryRay( hitLocation, ray ) == nullptr );
+
+    /* Point away from the spheres.
+     */
+    ray.origin    = base::math::Vector3f( 5, 0, 10 );
+    ray.direction = base::math::Vector3f( 0, 0, 1 );
+    QVERIFY( bvh->queryRay( hitLocation, ray ) == nullptr );
+
+    /* Pass the middle sphere within its axis-aligned box.
+     */
+    ray.origin    = base::math::Vector3f( 5.9f, 0.9f, 10 );
+    ray.direction = base::math::Vector3f( 0, 0, -1 );
+    QVERIFY( bvh->queryRay( hitLocation, ray ) == nullptr );
+}
+
+
+void BoundingVolumeHierarchyTest::test_queryFrustum()
+{
+    /* The frustum encloses the first two spheres, but neither the last one nor the
+     * box. The geometry without bounding volume is never culled.
+     */
+    const base::math::Matrix4f viewProjection = base::math::ortho4f( -2, 7, -2, 2, -100, 100 );
+    std::set< const base::Geometry* > visible;
+    bvh->queryFrustum( viewProjection, [&visible]( const base::Geometry& geom )
+        {
+            QVERIFY( visible.insert( &geom ).second );
+        }
+    );
+    QCOMPARE( visible.size(), static_cast< std::size_t >( 3 ) );
+    QVERIFY( visible.count( spheres[ 0 ] ) == 1 );
+    QVERIFY( visible.count( spheres[ 1 ] ) == 1 );
+    QVERIFY( visible.count( unbounded ) == 1 );
+}
+
+
+void BoundingVolumeHierarchyTest::test_defaultBoundingVolume()
+{
+    /* Bounding volumes that do not implement 'computeAxisAlignedBox' are never
+     * culled, and they are never hit by rays.
+     */
+    base::Geometry* const point = new base::Geometry( GEOMETRY_TYPE );
+    point->localTransform = base::math::translation4f( 0, 0, 5 );
+    point->setBoundingVolume( new PointBoundingVolume() );
+    root->attachChild( point );
+    root->updateWorldTransform();
+    bvh->update();
+    QCOMPARE( bvh->size(), static_cast< std::size_t >( 4 ) );
+
+    const base::math::Matrix4f viewProjection = base::math::ortho4f( -2, 7, -2, 2, -1, 1 );
+    std::set< const base::Geometry* > visible;
+    bvh->queryFrustum( viewProjection, [&visible]( const base::Geometry& geom )
+        {
+            visible.insert( &geom );
+        }
+    );
+    QVERIFY( visible.count( point ) == 1 );
+
+    base::math::Ray3f ray;
+    ray.origin    = base::math::Vector3f( 0, 0, 10 );
+    ray.direction = base::math::Vector3f( 0, 0, -1 );
+    base::math::Vector3f hitLocation;
+    QCOMPARE( bvh->queryRay( hitLocation, ray ), spheres[ 0 ] );
+}
+
+
+
+}  // namespace LibCarna :: testing
+
+}  // namespace LibCarna
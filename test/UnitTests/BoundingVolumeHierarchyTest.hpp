@@ -0,0 +1,97 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#pragma once
+
+#include <LibCarna/LibCarna.hpp>
+
+namespace LibCarna
+{
+
+namespace testing
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// BoundingVolumeHierarchyTest
+// ----------------------------------------------------------------------------------
+
+/** \brief
+  * Unit-tests of the \ref LibCarna::base::BoundingVolumeHierarchy class.
+  *
+  * \author Leonid Kostrykin
+  */
+class BoundingVolumeHierarchyTest : public QObject
+{
+
+    Q_OBJECT
+
+private slots:
+
+    /** \brief
+      * Called before the first test function is executed.
+      */
+    void initTestCase();
+
+    /** \brief
+      * Called after the last test function is executed.
+      */
+    void cleanupTestCase();
+
+    /** \brief
+      * Called before each test function is executed.
+      */
+    void init();
+
+    /** \brief
+      * Called after each test function is executed.
+      */
+    void cleanup();
+
+ // ----------------------------------------------------------------------------------
+
+    void test_update();
+
+    void test_update_refit();
+
+    void test_update_rebuild();
+
+    void test_queryRay();
+
+    void test_queryRay_miss();
+
+    void test_queryFrustum();
+
+    void test_defaultBoundingVolume();
+
+ // ----------------------------------------------------------------------------------
+
+private:
+
+    const static unsigned int GEOMETRY_TYPE = 0;
+
+    std::unique_ptr< base::Node > root;
+    std::unique_ptr< base::BoundingVolumeHierarchy > bvh;
+    base::Geometry* spheres[ 3 ];
+    base::Geometry* box;
+    base::Geometry* unbounded;
+    
+}; // BoundingVolumeHierarchyTest
+
+
+
+}  // namespace LibCarna :: testing
+
+}  // namespace LibCarna
@@ -0,0 +1,118 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#include "FramebufferReadbackTest.hpp"
+#include <LibCarna/base/FramebufferReadback.hpp>
+#include <LibCarna/base/Framebuffer.hpp>
+#include <LibCarna/base/Texture.hpp>
+#include <vector>
+
+namespace LibCarna
+{
+
+namespace testing
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// FramebufferReadbackTest
+// ----------------------------------------------------------------------------------
+
+void FramebufferReadbackTest::initTestCase()
+{
+}
+
+
+void FramebufferReadbackTest::cleanupTestCase()
+{
+}
+
+
+void FramebufferReadbackTest::init()
+{
+    qglContextHolder.reset( new QGLContextHolder() );
+}
+
+
+void FramebufferReadbackTest::cleanup()
+{
+    qglContextHolder.reset();
+}
+
+
+void FramebufferReadbackTest::test_read()
+{
+    const unsigned int width  = 64;
+    const unsigned int height = 32;
+    base::Texture< 2 > renderTexture( GL_RGBA8, GL_RGBA );
+    base::Framebuffer fbo( width, height, renderTexture );
+    base::Framebuffer::MinimalBinding binding( fbo );
+    glReadBuffer( GL_COLOR_ATTACHMENT0_EXT );
+
+    std::vector< std::size_t > frameIndices;
+    std::size_t mismatchingFrames = 0;
+
+    /* Each frame is cleared with a different red component, so that the pixels
+     * tell which frame they belong to. Read more frames than there are pixel
+     * buffer objects, so that the ring is wrapped around.
+     */
+    {
+        base::FramebufferReadback readback( width, height, base::FramebufferReadback::rgba8, 2,
+            [&]( std::size_t frameIndex, const void* pixels )
+            {
+                frameIndices.push_back( frameIndex );
+                const unsigned char* const bytes = static_cast< const unsigned char* >( pixels );
+                const unsigned char red = static_cast< unsigned char >( 50 * frameIndex );
+                for( std::size_t pixelIdx = 0; pixelIdx < width * height; ++pixelIdx )
+                {
+                    if( bytes[ 4 * pixelIdx + 0 ] != red
+                     || bytes[ 4 * pixelIdx + 1 ] != 255
+                     || bytes[ 4 * pixelIdx + 2 ] != 0
+                     || bytes[ 4 * pixelIdx + 3 ] != 255 )
+                    {
+                        ++mismatchingFrames;
+                        break;
+                    }
+                }
+            }
+        );
+        QCOMPARE( readback.frameSize(), static_cast< std::size_t >( width * height * 4 ) );
+        for( std::size_t frameIdx = 0; frameIdx < 5; ++frameIdx )
+        {
+            glClearColor( 50 * frameIdx / 255.f, 1, 0, 1 );
+            glClear( GL_COLOR_BUFFER_BIT );
+            QCOMPARE( readback.read(), frameIdx );
+            QVERIFY( readback.pendingFrames() <= 2 );
+            readback.poll();
+        }
+        readback.finish();
+        QCOMPARE( readback.pendingFrames(), static_cast< std::size_t >( 0 ) );
+    }
+
+    /* All frames must be delivered in order.
+     */
+    QCOMPARE( frameIndices.size(), static_cast< std::size_t >( 5 ) );
+    for( std::size_t frameIdx = 0; frameIdx < frameIndices.size(); ++frameIdx )
+    {
+        QCOMPARE( frameIndices[ frameIdx ], frameIdx );
+    }
+    QCOMPARE( mismatchingFrames, static_cast< std::size_t >( 0 ) );
+}
+
+
+
+}  // namespace LibCarna :: testing
+
+}  // namespace LibCarna
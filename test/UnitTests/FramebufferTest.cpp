@@ -0,0 +1,124 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#include "FramebufferTest.hpp"
+#include <LibCarna/base/Framebuffer.hpp>
+#include <LibCarna/base/Texture.hpp>
+#include <LibCarna/base/Viewport.hpp>
+
+namespace LibCarna
+{
+
+namespace testing
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// Types & Globals
+// ----------------------------------------------------------------------------------
+
+static GLint queryDepthAttachment( base::Framebuffer& fbo )
+{
+    GLint name;
+    base::Framebuffer::MinimalBinding binding( fbo );
+    glGetFramebufferAttachmentParameteriv( GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_FRAMEBUFFER_ATTACHMENT_OBJECT_NAME, &name );
+    return name;
+}
+
+
+
+// ----------------------------------------------------------------------------------
+// FramebufferTest
+// ----------------------------------------------------------------------------------
+
+void FramebufferTest::initTestCase()
+{
+}
+
+
+void FramebufferTest::cleanupTestCase()
+{
+}
+
+
+void FramebufferTest::init()
+{
+    qglContextHolder.reset( new QGLContextHolder() );
+}
+
+
+void FramebufferTest::cleanup()
+{
+    qglContextHolder.reset();
+}
+
+
+void FramebufferTest::test_sharedDepthAttachment()
+{
+    base::Texture< 2 > outputTexture( GL_RGBA8, GL_RGBA );
+    base::Texture< 2 > targetTexture( GL_RGBA16F, GL_RGBA );
+    base::Framebuffer output( 64, 32, outputTexture );
+    base::Framebuffer target( 64, 32, targetTexture );
+    const GLint outputDepth = queryDepthAttachment( output );
+    const GLint targetDepth = queryDepthAttachment( target );
+    QVERIFY( outputDepth != targetDepth );
+    {
+        base::Framebuffer::MinimalBinding binding( output );
+        const base::Framebuffer::SharedDepthAttachment depth( target, base::Viewport( output ) );
+        QVERIFY( depth.isShared() );
+        QCOMPARE( queryDepthAttachment( target ), outputDepth );
+        QCOMPARE( base::Framebuffer::currentId(), output.id );
+    }
+
+    /* The own depth buffer must be re-attached afterwards.
+     */
+    QCOMPARE( queryDepthAttachment( target ), targetDepth );
+}
+
+
+void FramebufferTest::test_copiedDepthAttachment()
+{
+    base::Texture< 2 > outputTexture( GL_RGBA8, GL_RGBA );
+    base::Texture< 2 > targetTexture( GL_RGBA16F, GL_RGBA );
+    base::Framebuffer output( 64, 32, outputTexture );
+    base::Framebuffer target( 32, 32, targetTexture );
+    const GLint targetDepth = queryDepthAttachment( target );
+
+    /* The depth buffer must be copied, if the sizes of the framebuffers differ.
+     */
+    base::Framebuffer::MinimalBinding binding( output );
+    {
+        const base::Viewport outputViewport( output );
+        const base::Framebuffer::SharedDepthAttachment depth( target, outputViewport );
+        QVERIFY( !depth.isShared() );
+        QCOMPARE( queryDepthAttachment( target ), targetDepth );
+    }
+
+    /* The depth buffer must be copied, if it is only partially covered.
+     */
+    target.resize( 64, 32 );
+    {
+        const base::Viewport outputViewport( output, 16, 0, 32, 32 );
+        const base::Framebuffer::SharedDepthAttachment depth( target, outputViewport );
+        QVERIFY( !depth.isShared() );
+        QCOMPARE( queryDepthAttachment( target ), targetDepth );
+    }
+}
+
+
+
+}  // namespace LibCarna :: testing
+
+}  // namespace LibCarna
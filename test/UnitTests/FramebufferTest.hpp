@@ -0,0 +1,78 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#pragma once
+
+namespace LibCarna
+{
+
+namespace testing
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// FramebufferTest
+// ----------------------------------------------------------------------------------
+
+/** \brief
+  * Unit-tests of the \ref LibCarna::base::Framebuffer class.
+  *
+  * \author Leonid Kostrykin
+  */
+class FramebufferTest : public QObject
+{
+
+    Q_OBJECT
+
+private slots:
+
+    /** \brief
+      * Called before the first test function is executed.
+      */
+    void initTestCase();
+
+    /** \brief
+      * Called after the last test function is executed.
+      */
+    void cleanupTestCase();
+
+    /** \brief
+      * Called before each test function is executed.
+      */
+    void init();
+
+    /** \brief
+      * Called after each test function is executed.
+      */
+    void cleanup();
+
+ // ----------------------------------------------------------------------------------
+
+    void test_sharedDepthAttachment();
+
+    void test_copiedDepthAttachment();
+
+ // ---------------------------------------------------------------------------------
+
+private:
+    std::unique_ptr< QGLContextHolder > qglContextHolder;
+    
+}; // FramebufferTest
+
+
+
+}  // namespace LibCarna :: testing
+
+}  // namespace LibCarna
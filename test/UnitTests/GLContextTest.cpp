@@ -5,6 +5,7 @@
 
 #include "GLContextTest.hpp"
 #include <LibCarna/base/GLContext.hpp>
+#include <LibCarna/base/Texture.hpp>
 
 namespace LibCarna
 {
@@ -54,6 +55,32 @@ void GLContextTest::test_renderer()
 }
 
 
+void GLContextTest::test_textureBindings()
+{
+    GLint activeTexture, textureBinding;
+    std::unique_ptr< base::Texture< 2 > > texture1( new base::Texture< 2 >( GL_RGBA8, GL_RGBA ) );
+    base::Texture< 2 > texture2( GL_RGBA8, GL_RGBA );
+
+    /* Binding a texture, that is already bound, must still activate its unit.
+     */
+    texture1->bind( 1 );
+    texture2.bind( 2 );
+    texture1->bind( 1 );
+    glGetIntegerv( GL_ACTIVE_TEXTURE, &activeTexture );
+    glGetIntegerv( GL_TEXTURE_BINDING_2D, &textureBinding );
+    QCOMPARE( activeTexture, static_cast< GLint >( GL_TEXTURE0 + 1 ) );
+    QCOMPARE( textureBinding, static_cast< GLint >( texture1->id ) );
+
+    /* Deleted textures must be forgotten, since their names might be reused.
+     */
+    texture1.reset();
+    base::Texture< 2 > texture3( GL_RGBA8, GL_RGBA );
+    texture3.bind( 1 );
+    glGetIntegerv( GL_TEXTURE_BINDING_2D, &textureBinding );
+    QCOMPARE( textureBinding, static_cast< GLint >( texture3.id ) );
+}
+
+
 
 }  // namespace LibCarna :: testing
 
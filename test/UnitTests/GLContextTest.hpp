@@ -55,6 +55,8 @@ private slots:
     
     void test_renderer();
 
+    void test_textureBindings();
+
  // ---------------------------------------------------------------------------------
 
 private:
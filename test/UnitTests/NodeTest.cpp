@@ -0,0 +1,264 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#include "NodeTest.hpp"
+#include <LibCarna/base/Node.hpp>
+#include <LibCarna/base/Geometry.hpp>
+#include <LibCarna/base/RenderQueue.hpp>
+#include <LibCarna/base/math.hpp>
+#include <vector>
+
+namespace LibCarna
+{
+
+namespace testing
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// NodeTest
+// ----------------------------------------------------------------------------------
+
+void NodeTest::initTestCase()
+{
+}
+
+
+void NodeTest::cleanupTestCase()
+{
+}
+
+
+void NodeTest::init()
+{
+    root.reset( new base::Node() );
+    pivot = new base::Node();
+    leaf1 = new base::Spatial();
+    leaf2 = new base::Spatial();
+    root->attachChild( pivot );
+    pivot->attachChild( leaf1 );
+    pivot->attachChild( leaf2 );
+
+    pivot->localTransform = base::math::translation4f( 1, 2, 3 );
+    leaf1->localTransform = base::math::scaling4f( 2 );
+    leaf2->localTransform = base::math::translation4f( 0, 0, -1 );
+}
+
+
+void NodeTest::cleanup()
+{
+    root.reset();
+}
+
+
+void NodeTest::createLargeScene()
+{
+    for( unsigned int pivotIdx = 0; pivotIdx < LARGE_SCENE_PIVOTS; ++pivotIdx )
+    {
+        base::Node* const pivot = new base::Node();
+        pivot->localTransform = base::math::translation4f( 0, 0, pivotIdx );
+        root->attachChild( pivot );
+        for( unsigned int childIdx = 0; childIdx < LARGE_SCENE_PIVOT_CHILDREN; ++childIdx )
+        {
+            base::Geometry* const geometry = new base::Geometry( GEOMETRY_TYPE );
+            geometry->localTransform = base::math::translation4f( childIdx, 0, 0 );
+            pivot->attachChild( geometry );
+        }
+    }
+}
+
+
+void NodeTest::test_updateWorldTransform()
+{
+    root->updateWorldTransform();
+    QCOMPARE( root->changedWorldTransformsCount(), static_cast< std::size_t >( 4 ) );
+    QVERIFY( leaf1->hasWorldTransformChanged() );
+    QVERIFY( leaf2->hasWorldTransformChanged() );
+    QVERIFY( leaf1->worldTransform() == base::math::Matrix4f( pivot->localTransform * leaf1->localTransform ) );
+    QVERIFY( leaf2->worldTransform() == base::math::Matrix4f( pivot->localTransform * leaf2->localTransform ) );
+}
+
+
+void NodeTest::test_updateWorldTransform_unchanged()
+{
+    root->updateWorldTransform();
+    root->updateWorldTransform();
+    QCOMPARE( root->changedWorldTransformsCount(), static_cast< std::size_t >( 0 ) );
+    QVERIFY( !pivot->hasWorldTransformChanged() );
+    QVERIFY( !leaf1->hasWorldTransformChanged() );
+    QVERIFY( leaf1->worldTransform() == base::math::Matrix4f( pivot->localTransform * leaf1->localTransform ) );
+
+    /* Enforce recomputation of a single spatial.
+     */
+    leaf2->invalidateWorldTransform();
+    root->updateWorldTransform();
+    QCOMPARE( root->changedWorldTransformsCount(), static_cast< std::size_t >( 1 ) );
+    QVERIFY( leaf2->hasWorldTransformChanged() );
+}
+
+
+void NodeTest::test_updateWorldTransform_localTransform()
+{
+    root->updateWorldTransform();
+
+    /* Changing a leaf affects only the leaf itself.
+     */
+    leaf1->localTransform = base::math::scaling4f( 3 );
+    root->updateWorldTransform();
+    QCOMPARE( root->changedWorldTransformsCount(), static_cast< std::size_t >( 1 ) );
+    QVERIFY( leaf1->worldTransform() == base::math::Matrix4f( pivot->localTransform * leaf1->localTransform ) );
+
+    /* Changing an inner node affects its whole subtree.
+     */
+    pivot->localTransform = base::math::translation4f( 3, 2, 1 );
+    root->updateWorldTransform();
+    QCOMPARE( root->changedWorldTransformsCount(), static_cast< std::size_t >( 3 ) );
+    QCOMPARE( pivot->changedWorldTransformsCount(), static_cast< std::size_t >( 3 ) );
+    QVERIFY( leaf1->worldTransform() == base::math::Matrix4f( pivot->localTransform * leaf1->localTransform ) );
+    QVERIFY( leaf2->worldTransform() == base::math::Matrix4f( pivot->localTransform * leaf2->localTransform ) );
+}
+
+
+void NodeTest::test_updateWorldTransform_reattach()
+{
+    root->updateWorldTransform();
+
+    /* Moving a spatial to another parent requires recomputation.
+     */
+    root->attachChild( leaf1 );
+    root->updateWorldTransform();
+    QCOMPARE( root->changedWorldTransformsCount(), static_cast< std::size_t >( 1 ) );
+    QVERIFY( leaf1->worldTransform() == base::math::Matrix4f( leaf1->localTransform ) );
+}
+
+
+void NodeTest::test_updateWorldTransform_directWrite()
+{
+    root->updateWorldTransform();
+    root->updateWorldTransform();
+
+    /* Writing the local transformation directly is noticed without invalidation.
+     */
+    leaf2->localTransform = base::math::translation4f( 0, 0, -2 );
+    root->updateWorldTransform();
+    QCOMPARE( root->changedWorldTransformsCount(), static_cast< std::size_t >( 1 ) );
+    QVERIFY( leaf2->worldTransform() == base::math::Matrix4f( pivot->localTransform * leaf2->localTransform ) );
+
+    /* The next update resets the changed spatials.
+     */
+    root->updateWorldTransform();
+    QCOMPARE( root->changedWorldTransformsCount(), static_cast< std::size_t >( 0 ) );
+    QVERIFY( !leaf2->hasWorldTransformChanged() );
+}
+
+
+void NodeTest::test_attachChild_order()
+{
+    base::Spatial* const leaf3 = new base::Spatial();
+    pivot->attachChild( leaf3 );
+    QVERIFY( pivot->hasChild( *leaf3 ) );
+    QVERIFY( !root->hasChild( *leaf3 ) );
+
+    std::vector< const base::Spatial* > children;
+    pivot->visitChildren( false, [&children]( const base::Spatial& child )
+        {
+            children.push_back( &child );
+        }
+    );
+    QCOMPARE( children.size(), static_cast< std::size_t >( 3 ) );
+    QCOMPARE( children[ 0 ], static_cast< const base::Spatial* >( leaf1 ) );
+    QCOMPARE( children[ 1 ], static_cast< const base::Spatial* >( leaf2 ) );
+    QCOMPARE( children[ 2 ], static_cast< const base::Spatial* >( leaf3 ) );
+}
+
+
+void NodeTest::test_detachChild_order()
+{
+    base::Spatial* const leaf3 = new base::Spatial();
+    pivot->attachChild( leaf3 );
+
+    const std::unique_ptr< base::Spatial > detached( pivot->detachChild( *leaf1 ) );
+    QCOMPARE( detached.get(), leaf1 );
+    QVERIFY( !leaf1->hasParent() );
+    QVERIFY( !pivot->hasChild( *leaf1 ) );
+    QCOMPARE( pivot->detachChild( *leaf1 ), static_cast< base::Spatial* >( nullptr ) );
+
+    std::vector< const base::Spatial* > children;
+    pivot->visitChildren( false, [&children]( const base::Spatial& child )
+        {
+            children.push_back( &child );
+        }
+    );
+    QCOMPARE( children.size(), static_cast< std::size_t >( 2 ) );
+    QCOMPARE( children[ 0 ], static_cast< const base::Spatial* >( leaf2 ) );
+    QCOMPARE( children[ 1 ], static_cast< const base::Spatial* >( leaf3 ) );
+}
+
+
+void NodeTest::test_benchmark_visitChildren()
+{
+    createLargeScene();
+    std::size_t geometriesCount = 0;
+    QBENCHMARK
+    {
+        geometriesCount = 0;
+        root->visitChildren( true, [&geometriesCount]( const base::Spatial& spatial )
+            {
+                if( spatial.isGeometry() )
+                {
+                    ++geometriesCount;
+                }
+            }
+        );
+    }
+    QCOMPARE( geometriesCount, static_cast< std::size_t >( LARGE_SCENE_PIVOTS * LARGE_SCENE_PIVOT_CHILDREN ) );
+}
+
+
+void NodeTest::test_benchmark_updateWorldTransform()
+{
+    createLargeScene();
+    root->updateWorldTransform();
+    QBENCHMARK
+    {
+        root->updateWorldTransform();
+    }
+    QCOMPARE( root->changedWorldTransformsCount(), static_cast< std::size_t >( 0 ) );
+}
+
+
+void NodeTest::test_benchmark_RenderQueue_build()
+{
+    createLargeScene();
+    root->updateWorldTransform();
+    base::RenderQueue< void > rq( GEOMETRY_TYPE );
+    QBENCHMARK
+    {
+        rq.build( *root, base::math::identity4f() );
+    }
+    std::size_t renderablesCount = 0;
+    while( !rq.isEmpty() )
+    {
+        rq.poll();
+        ++renderablesCount;
+    }
+    QCOMPARE( renderablesCount, static_cast< std::size_t >( LARGE_SCENE_PIVOTS * LARGE_SCENE_PIVOT_CHILDREN ) );
+}
+
+
+
+}  // namespace LibCarna :: testing
+
+}  // namespace LibCarna
@@ -0,0 +1,110 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#pragma once
+
+#include <LibCarna/LibCarna.hpp>
+
+namespace LibCarna
+{
+
+namespace testing
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// NodeTest
+// ----------------------------------------------------------------------------------
+
+/** \brief
+  * Unit-tests of the \ref LibCarna::base::Node class.
+  *
+  * \author Leonid Kostrykin
+  */
+class NodeTest : public QObject
+{
+
+    Q_OBJECT
+
+private slots:
+
+    /** \brief
+      * Called before the first test function is executed.
+      */
+    void initTestCase();
+
+    /** \brief
+      * Called after the last test function is executed.
+      */
+    void cleanupTestCase();
+
+    /** \brief
+      * Called before each test function is executed.
+      */
+    void init();
+
+    /** \brief
+      * Called after each test function is executed.
+      */
+    void cleanup();
+
+ // ----------------------------------------------------------------------------------
+
+    void test_updateWorldTransform();
+
+    void test_updateWorldTransform_unchanged();
+
+    void test_updateWorldTransform_localTransform();
+
+    void test_updateWorldTransform_reattach();
+
+    void test_updateWorldTransform_directWrite();
+
+    void test_attachChild_order();
+
+    void test_detachChild_order();
+
+    void test_benchmark_visitChildren();
+
+    void test_benchmark_updateWorldTransform();
+
+    void test_benchmark_RenderQueue_build();
+
+ // ----------------------------------------------------------------------------------
+
+private:
+
+    const static unsigned int GEOMETRY_TYPE = 0;
+    const static unsigned int LARGE_SCENE_PIVOTS = 100;
+    const static unsigned int LARGE_SCENE_PIVOT_CHILDREN = 100;
+
+    /** \brief
+      * Attaches \ref LARGE_SCENE_PIVOTS nodes to \ref root, each with
+      * \ref LARGE_SCENE_PIVOT_CHILDREN geometry nodes attached.
+      */
+    void createLargeScene();
+
+    std::unique_ptr< base::Node > root;
+    base::Node* pivot;
+    base::Spatial* leaf1;
+    base::Spatial* leaf2;
+    
+}; // NodeTest
+
+
+
+}  // namespace LibCarna :: testing
+
+}  // namespace LibCarna
@@ -0,0 +1,203 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#include "OBJReaderTest.hpp"
+
+namespace LibCarna
+{
+
+namespace testing
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// Types & Globals
+// ----------------------------------------------------------------------------------
+
+static void verifyOBJIndices( const base::OBJReader& reader, const std::vector< uint32_t >& expectedIndices )
+{
+    QCOMPARE( reader.trianglesCount(), expectedIndices.size() / 3 );
+    QCOMPARE( reader.indices().size(), expectedIndices.size() );
+    for( std::size_t i = 0; i < expectedIndices.size(); ++i )
+    {
+        QCOMPARE( reader.indices()[ i ], expectedIndices[ i ] );
+    }
+}
+
+
+
+// ----------------------------------------------------------------------------------
+// OBJReaderTest
+// ----------------------------------------------------------------------------------
+
+void OBJReaderTest::initTestCase()
+{
+}
+
+
+void OBJReaderTest::cleanupTestCase()
+{
+}
+
+
+void OBJReaderTest::init()
+{
+    reader.reset( new base::OBJReader() );
+}
+
+
+void OBJReaderTest::cleanup()
+{
+    reader.reset();
+}
+
+
+void OBJReaderTest::test_positions()
+{
+    const std::string data =
+        "# quad\r\n"
+        "mtllib quad.mtl\r\n"
+        "o quad\r\n"
+        "v 0 0 0\r\n"
+        "v 1 0 0\r\n"
+        "v 1.0 1e0 0\r\n"
+        "v 0 1 0 1\r\n"
+        "vt 0 0\r\n"
+        "usemtl default\r\n"
+        "s off\r\n"
+        "f 1/1 2/1 3/1 4/1 # polygon\r\n";
+    reader->read( data.data(), data.size() );
+
+    /* Without normals, the vertices are the positions.
+     */
+    QCOMPARE( reader->positions().size(), static_cast< std::size_t >( 4 ) );
+    QCOMPARE( reader->positions()[ 2 ], base::math::Vector3f( 1, 1, 0 ) );
+    QVERIFY( reader->normals().empty() );
+    QVERIFY( reader->colors().empty() );
+
+    /* The polygon is split into a triangle fan.
+     */
+    const uint32_t expectedIndices[] = { 0, 1, 2, 0, 2, 3 };
+    verifyOBJIndices( *reader, std::vector< uint32_t >( expectedIndices, expectedIndices + 6 ) );
+}
+
+
+void OBJReaderTest::test_normals()
+{
+    /* Two triangles, that share positions, but not normals.
+     */
+    const std::string data =
+        "v 0 0 0\n"
+        "v 1 0 0\n"
+        "v 0 1 0\n"
+        "vn 0 0 1\n"
+        "vn 0 0 -1\n"
+        "f 1//1 2//1 3//1\n"
+        "f 1//2 3//2 2//2\n"
+        "f 3//1 1//1 2//1\n";
+    reader->read( data.data(), data.size() );
+
+    /* Each unique pair of position and normal is a vertex.
+     */
+    QCOMPARE( reader->positions().size(), static_cast< std::size_t >( 6 ) );
+    QCOMPARE( reader->normals().size(), static_cast< std::size_t >( 6 ) );
+    QCOMPARE( reader->positions()[ 4 ], base::math::Vector3f( 0, 1, 0 ) );
+    QCOMPARE( reader->normals()[ 0 ], base::math::Vector3f( 0, 0,  1 ) );
+    QCOMPARE( reader->normals()[ 4 ], base::math::Vector3f( 0, 0, -1 ) );
+
+    const uint32_t expectedIndices[] = { 0, 1, 2, 3, 4, 5, 2, 0, 1 };
+    verifyOBJIndices( *reader, std::vector< uint32_t >( expectedIndices, expectedIndices + 9 ) );
+}
+
+
+void OBJReaderTest::test_normals_partial()
+{
+    /* The first face has no normals, so its corners are merged once the second
+     * face is read.
+     */
+    const std::string data =
+        "v 0 0 0\n"
+        "v 1 0 0\n"
+        "v 0 1 0\n"
+        "vn 0 0 1\n"
+        "f 1 2 3\n"
+        "f 3//1 2//1 1\n";
+    reader->read( data.data(), data.size() );
+
+    QCOMPARE( reader->positions().size(), static_cast< std::size_t >( 5 ) );
+    QCOMPARE( reader->normals().size(), static_cast< std::size_t >( 5 ) );
+    QCOMPARE( reader->positions()[ 3 ], base::math::Vector3f( 0, 1, 0 ) );
+    QCOMPARE( reader->normals()[ 0 ], base::math::Vector3f( 0, 0, 0 ) );
+    QCOMPARE( reader->normals()[ 4 ], base::math::Vector3f( 0, 0, 1 ) );
+
+    const uint32_t expectedIndices[] = { 0, 1, 2, 3, 4, 0 };
+    verifyOBJIndices( *reader, std::vector< uint32_t >( expectedIndices, expectedIndices + 6 ) );
+}
+
+
+void OBJReaderTest::test_colors()
+{
+    const std::string data =
+        "v 0 0 0 1 0 0\n"
+        "v 1 0 0\n"
+        "v 0 1 0 0 0 1\n"
+        "f 1 2 3\n";
+    reader->read( data.data(), data.size() );
+
+    /* Positions without colors are white.
+     */
+    QCOMPARE( reader->colors().size(), static_cast< std::size_t >( 3 ) );
+    QCOMPARE( reader->colors()[ 0 ], base::math::Vector4f( 1, 0, 0, 1 ) );
+    QCOMPARE( reader->colors()[ 1 ], base::math::Vector4f( 1, 1, 1, 1 ) );
+    QCOMPARE( reader->colors()[ 2 ], base::math::Vector4f( 0, 0, 1, 1 ) );
+}
+
+
+void OBJReaderTest::test_relativeIndices()
+{
+    const std::string data =
+        "v 0 0 0\n"
+        "v 1 0 0\n"
+        "v 0 1 0\n"
+        "f -3 -2 -1\n"
+        "v 1 1 0\n"
+        "f -3 -1 -2\n";
+    reader->read( data.data(), data.size() );
+
+    const uint32_t expectedIndices[] = { 0, 1, 2, 1, 3, 2 };
+    verifyOBJIndices( *reader, std::vector< uint32_t >( expectedIndices, expectedIndices + 6 ) );
+}
+
+
+void OBJReaderTest::test_malformed()
+{
+    const std::string invalidIndex = "v 0 0 0\nv 1 0 0\nf 1 2 3\n";
+    QVERIFY_EXCEPTION_THROWN( reader->read( invalidIndex.data(), invalidIndex.size() ), base::AssertionFailure );
+
+    const std::string zeroIndex = "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 0 1 2\n";
+    QVERIFY_EXCEPTION_THROWN( reader->read( zeroIndex.data(), zeroIndex.size() ), base::AssertionFailure );
+
+    const std::string invalidVertex = "v 0 zero 0\n";
+    QVERIFY_EXCEPTION_THROWN( reader->read( invalidVertex.data(), invalidVertex.size() ), base::AssertionFailure );
+
+    const std::string degenerateFace = "v 0 0 0\nv 1 0 0\nf 1 2\n";
+    QVERIFY_EXCEPTION_THROWN( reader->read( degenerateFace.data(), degenerateFace.size() ), base::AssertionFailure );
+}
+
+
+
+}  // namespace LibCarna :: testing
+
+}  // namespace LibCarna
@@ -0,0 +1,88 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#pragma once
+
+#include <LibCarna/base/OBJReader.hpp>
+
+namespace LibCarna
+{
+
+namespace testing
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// OBJReaderTest
+// ----------------------------------------------------------------------------------
+
+/** \brief
+  * Unit-tests of the \ref LibCarna::base::OBJReader class.
+  *
+  * \author Leonid Kostrykin
+  */
+class OBJReaderTest : public QObject
+{
+
+    Q_OBJECT
+
+private slots:
+
+    /** \brief
+      * Called before the first test function is executed.
+      */
+    void initTestCase();
+
+    /** \brief
+      * Called after the last test function is executed.
+      */
+    void cleanupTestCase();
+
+    /** \brief
+      * Called before each test function is executed.
+      */
+    void init();
+
+    /** \brief
+      * Called after each test function is executed.
+      */
+    void cleanup();
+
+ // ----------------------------------------------------------------------------------
+
+    void test_positions();
+
+    void test_normals();
+
+    void test_normals_partial();
+
+    void test_colors();
+
+    void test_relativeIndices();
+
+    void test_malformed();
+
+ // ---------------------------------------------------------------------------------
+
+private:
+    std::unique_ptr< base::OBJReader > reader;
+    
+}; // OBJReaderTest
+
+
+
+}  // namespace LibCarna :: testing
+
+}  // namespace LibCarna
@@ -0,0 +1,289 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#include "PLYReaderTest.hpp"
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+namespace LibCarna
+{
+
+namespace testing
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// Types & Globals
+// ----------------------------------------------------------------------------------
+
+/* Appends the binary representation of 'value' to 'data'.
+ */
+template< typename ValueType >
+static void appendPLYValue( std::string& data, ValueType value, bool bigEndian )
+{
+    char bytes[ sizeof( ValueType ) ];
+    std::memcpy( bytes, &value, sizeof( ValueType ) );
+    if( bigEndian )
+    {
+        std::reverse( bytes, bytes + sizeof( ValueType ) );
+    }
+    data.append( bytes, sizeof( ValueType ) );
+}
+
+
+/* Encodes a quad with normals as binary PLY. The quad is a single polygon, that
+ * is preceded by an element, which is to be skipped.
+ */
+static std::string createBinaryPLYQuad( bool bigEndian )
+{
+    std::string data = std::string()
+        + "ply\n"
+        + "format " + ( bigEndian ? "binary_big_endian" : "binary_little_endian" ) + " 1.0\n"
+        + "comment quad\n"
+        + "element vertex 4\n"
+        + "property float x\n"
+        + "property float y\n"
+        + "property double z\n"
+        + "property float nx\n"
+        + "property float ny\n"
+        + "property float nz\n"
+        + "element edge 1\n"
+        + "property int vertex1\n"
+        + "property int vertex2\n"
+        + "element face 1\n"
+        + "property list uchar uint vertex_indices\n"
+        + "end_header\n";
+
+    const float positions[] = { 0, 0, 0,  1, 0, 0,  1, 1, 0,  0, 1, 0 };
+    for( unsigned int vertexIndex = 0; vertexIndex < 4; ++vertexIndex )
+    {
+        appendPLYValue< float  >( data, positions[ 3 * vertexIndex + 0 ], bigEndian );
+        appendPLYValue< float  >( data, positions[ 3 * vertexIndex + 1 ], bigEndian );
+        appendPLYValue< double >( data, positions[ 3 * vertexIndex + 2 ], bigEndian );
+        appendPLYValue< float  >( data, 0, bigEndian );
+        appendPLYValue< float  >( data, 0, bigEndian );
+        appendPLYValue< float  >( data, 1, bigEndian );
+    }
+    appendPLYValue< int32_t >( data, 0, bigEndian );
+    appendPLYValue< int32_t >( data, 1, bigEndian );
+    appendPLYValue< uint8_t >( data, 4, bigEndian );
+    for( uint32_t index = 0; index < 4; ++index )
+    {
+        appendPLYValue< uint32_t >( data, index, bigEndian );
+    }
+    return data;
+}
+
+
+static void verifyPLYQuad( const base::PLYReader& reader )
+{
+    QCOMPARE( reader.trianglesCount(), static_cast< std::size_t >( 2 ) );
+    QCOMPARE( reader.positions().size(), static_cast< std::size_t >( 4 ) );
+    QCOMPARE( reader.positions()[ 0 ], base::math::Vector3f( 0, 0, 0 ) );
+    QCOMPARE( reader.positions()[ 1 ], base::math::Vector3f( 1, 0, 0 ) );
+    QCOMPARE( reader.positions()[ 2 ], base::math::Vector3f( 1, 1, 0 ) );
+    QCOMPARE( reader.positions()[ 3 ], base::math::Vector3f( 0, 1, 0 ) );
+
+    /* The polygon is split into a triangle fan.
+     */
+    const uint32_t expectedIndices[] = { 0, 1, 2, 0, 2, 3 };
+    QCOMPARE( reader.indices().size(), static_cast< std::size_t >( 6 ) );
+    for( std::size_t i = 0; i < 6; ++i )
+    {
+        QCOMPARE( reader.indices()[ i ], expectedIndices[ i ] );
+    }
+}
+
+
+
+// ----------------------------------------------------------------------------------
+// PLYReaderTest
+// ----------------------------------------------------------------------------------
+
+void PLYReaderTest::initTestCase()
+{
+}
+
+
+void PLYReaderTest::cleanupTestCase()
+{
+}
+
+
+void PLYReaderTest::init()
+{
+    reader.reset( new base::PLYReader() );
+}
+
+
+void PLYReaderTest::cleanup()
+{
+    reader.reset();
+}
+
+
+void PLYReaderTest::test_ascii()
+{
+    const std::string data =
+        "ply\r\n"
+        "format ascii 1.0\r\n"
+        "element vertex 4\r\n"
+        "property float x\r\n"
+        "property float y\r\n"
+        "property float z\r\n"
+        "property uchar red\r\n"
+        "property uchar green\r\n"
+        "property uchar blue\r\n"
+        "element face 2\r\n"
+        "property list uchar int vertex_index\r\n"
+        "end_header\r\n"
+        "0 0 0 255 0 0\r\n"
+        "1 0 0 0 255 0\r\n"
+        "1.0 1e0 0 0 0 255\r\n"
+        "0 1 -0.0 255 255 255\r\n"
+        "3 0 1 2\r\n"
+        "3 0 2 3\r\n";
+    reader->read( data.data(), data.size() );
+    QVERIFY( !reader->isBinary() );
+    verifyPLYQuad( *reader );
+
+    /* Integral colors are normalized.
+     */
+    QVERIFY( reader->normals().empty() );
+    QCOMPARE( reader->colors().size(), static_cast< std::size_t >( 4 ) );
+    QCOMPARE( reader->colors()[ 0 ], base::math::Vector4f( 1, 0, 0, 1 ) );
+    QCOMPARE( reader->colors()[ 1 ], base::math::Vector4f( 0, 1, 0, 1 ) );
+    QCOMPARE( reader->colors()[ 2 ], base::math::Vector4f( 0, 0, 1, 1 ) );
+    QCOMPARE( reader->colors()[ 3 ], base::math::Vector4f( 1, 1, 1, 1 ) );
+}
+
+
+void PLYReaderTest::test_binaryLittleEndian()
+{
+    const std::string data = createBinaryPLYQuad( false );
+    reader->read( data.data(), data.size() );
+    QVERIFY( reader->isBinary() );
+    verifyPLYQuad( *reader );
+    QVERIFY( reader->colors().empty() );
+    QCOMPARE( reader->normals().size(), static_cast< std::size_t >( 4 ) );
+    QCOMPARE( reader->normals()[ 3 ], base::math::Vector3f( 0, 0, 1 ) );
+}
+
+
+void PLYReaderTest::test_binaryBigEndian()
+{
+    const std::string data = createBinaryPLYQuad( true );
+    reader->read( data.data(), data.size() );
+    QVERIFY( reader->isBinary() );
+    verifyPLYQuad( *reader );
+    QCOMPARE( reader->normals().size(), static_cast< std::size_t >( 4 ) );
+    QCOMPARE( reader->normals()[ 3 ], base::math::Vector3f( 0, 0, 1 ) );
+}
+
+
+void PLYReaderTest::test_skippedElements()
+{
+    /* The faces precede the vertices and unknown properties are interleaved.
+     */
+    const std::string data =
+        "ply\n"
+        "format ascii 1.0\n"
+        "obj_info skipped\n"
+        "element face 1\n"
+        "property uchar flags\n"
+        "property list uchar float texcoord\n"
+        "property list uchar uint vertex_indices\n"
+        "element vertex 4\n"
+        "property float x\n"
+        "property float quality\n"
+        "property float y\n"
+        "property float z\n"
+        "element material 1\n"
+        "property list uchar uchar name\n"
+        "end_header\n"
+        "7 2 0.5 0.5 4 0 1 2 3\n"
+        "0 9 0 0\n"
+        "1 9 0 0\n"
+        "1 9 1 0\n"
+        "0 9 1 0\n"
+        "3 1 2 3\n";
+    reader->read( data.data(), data.size() );
+    verifyPLYQuad( *reader );
+}
+
+
+void PLYReaderTest::test_malformed()
+{
+    const std::string binary = createBinaryPLYQuad( false );
+    QVERIFY_EXCEPTION_THROWN( reader->read( binary.data(), binary.size() - 1 ), base::AssertionFailure );
+
+    const std::string notPLY = "solid quad\n";
+    QVERIFY_EXCEPTION_THROWN( reader->read( notPLY.data(), notPLY.size() ), base::AssertionFailure );
+
+    const std::string invalidIndex =
+        "ply\nformat ascii 1.0\nelement vertex 1\nproperty float x\nproperty float y\nproperty float z\n"
+        "element face 1\nproperty list uchar int vertex_indices\nend_header\n0 0 0\n3 0 0 1\n";
+    QVERIFY_EXCEPTION_THROWN( reader->read( invalidIndex.data(), invalidIndex.size() ), base::AssertionFailure );
+}
+
+
+void PLYReaderTest::test_benchmark_binary()
+{
+    /* Create a grid of 400 x 400 quads, i.e. 320k triangles.
+     */
+    const uint32_t gridSize = 400;
+    const uint32_t verticesPerEdge = gridSize + 1;
+    std::stringstream header;
+    header
+        << "ply\n"
+        << "format binary_little_endian 1.0\n"
+        << "element vertex " << verticesPerEdge * verticesPerEdge << "\n"
+        << "property float x\nproperty float y\nproperty float z\n"
+        << "property float nx\nproperty float ny\nproperty float nz\n"
+        << "element face " << gridSize * gridSize << "\n"
+        << "property list uchar uint vertex_indices\n"
+        << "end_header\n";
+    std::string data = header.str();
+    for( uint32_t y = 0; y < verticesPerEdge; ++y )
+    for( uint32_t x = 0; x < verticesPerEdge; ++x )
+    {
+        const float vertex[] = { static_cast< float >( x ), static_cast< float >( y ), 0, 0, 0, 1 };
+        data.append( reinterpret_cast< const char* >( vertex ), sizeof( vertex ) );
+    }
+    for( uint32_t y = 0; y < gridSize; ++y )
+    for( uint32_t x = 0; x < gridSize; ++x )
+    {
+        const uint32_t face[] =
+            { x + y * verticesPerEdge, x + 1 + y * verticesPerEdge
+            , x + 1 + ( y + 1 ) * verticesPerEdge, x + ( y + 1 ) * verticesPerEdge };
+        data.push_back( 4 );
+        data.append( reinterpret_cast< const char* >( face ), sizeof( face ) );
+    }
+
+    QBENCHMARK
+    {
+        reader->read( data.data(), data.size() );
+    }
+
+    QCOMPARE( reader->trianglesCount(), static_cast< std::size_t >( 2 * gridSize * gridSize ) );
+    QCOMPARE( reader->positions().size(), static_cast< std::size_t >( verticesPerEdge * verticesPerEdge ) );
+}
+
+
+
+}  // namespace LibCarna :: testing
+
+}  // namespace LibCarna
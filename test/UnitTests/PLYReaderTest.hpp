@@ -0,0 +1,88 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#pragma once
+
+#include <LibCarna/base/PLYReader.hpp>
+
+namespace LibCarna
+{
+
+namespace testing
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// PLYReaderTest
+// ----------------------------------------------------------------------------------
+
+/** \brief
+  * Unit-tests of the \ref LibCarna::base::PLYReader class.
+  *
+  * \author Leonid Kostrykin
+  */
+class PLYReaderTest : public QObject
+{
+
+    Q_OBJECT
+
+private slots:
+
+    /** \brief
+      * Called before the first test function is executed.
+      */
+    void initTestCase();
+
+    /** \brief
+      * Called after the last test function is executed.
+      */
+    void cleanupTestCase();
+
+    /** \brief
+      * Called before each test function is executed.
+      */
+    void init();
+
+    /** \brief
+      * Called after each test function is executed.
+      */
+    void cleanup();
+
+ // ----------------------------------------------------------------------------------
+
+    void test_ascii();
+
+    void test_binaryLittleEndian();
+
+    void test_binaryBigEndian();
+
+    void test_skippedElements();
+
+    void test_malformed();
+
+    void test_benchmark_binary();
+
+ // ---------------------------------------------------------------------------------
+
+private:
+    std::unique_ptr< base::PLYReader > reader;
+    
+}; // PLYReaderTest
+
+
+
+}  // namespace LibCarna :: testing
+
+}  // namespace LibCarna
@@ -0,0 +1,184 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#include "RayPickingHelperTest.hpp"
+#include <LibCarna/helpers/RayPickingHelper.hpp>
+#include <LibCarna/helpers/VolumeGridHelper.hpp>
+#include <LibCarna/base/BufferedIntensityVolume.hpp>
+#include <LibCarna/base/Node.hpp>
+#include <LibCarna/base/Geometry.hpp>
+#include <LibCarna/base/MeshFactory.hpp>
+#include <LibCarna/base/Vertex.hpp>
+#include <LibCarna/base/math.hpp>
+#include <LibCarna/base/math/Ray.hpp>
+
+namespace LibCarna
+{
+
+namespace testing
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// RayPickingHelperTest
+// ----------------------------------------------------------------------------------
+
+void RayPickingHelperTest::initTestCase()
+{
+}
+
+
+void RayPickingHelperTest::cleanupTestCase()
+{
+}
+
+
+void RayPickingHelperTest::init()
+{
+    /* Create two boxes, one behind the other, when looking along the negative
+     * z-axis. The second box is bigger.
+     */
+    root.reset( new base::Node() );
+    base::ManagedMeshBase& boxMesh = base::MeshFactory< base::PVertex >::createBox( 2, 2, 2 );
+    box1 = new base::Geometry( GEOMETRY_TYPE_OPAQUE );
+    box2 = new base::Geometry( GEOMETRY_TYPE_OPAQUE );
+    box1->putFeature( ROLE_MESH, boxMesh );
+    box2->putFeature( ROLE_MESH, boxMesh );
+    boxMesh.release();
+    box2->localTransform = base::math::translation4f( 0, 0, -10 ) * base::math::scaling4f( 3 );
+    root->attachChild( box1 );
+    root->attachChild( box2 );
+    root->updateWorldTransform();
+
+    picking.reset( new helpers::RayPickingHelper() );
+    picking->putMeshGeometryType( GEOMETRY_TYPE_OPAQUE, ROLE_MESH );
+}
+
+
+void RayPickingHelperTest::cleanup()
+{
+    picking.reset();
+    root.reset();
+}
+
+
+void RayPickingHelperTest::test_pickMesh()
+{
+    base::math::Ray3f ray;
+    base::math::Vector3f hitLocation;
+
+    /* Hit the front box.
+     */
+    ray.origin    = base::math::Vector3f( 0.5f, 0, 10 );
+    ray.direction = base::math::Vector3f( 0, 0, -1 );
+    QCOMPARE( picking->pick( *root, ray, hitLocation ), box1 );
+    QVERIFY( base::math::isEqual( hitLocation, base::math::Vector3f( 0.5f, 0, 1 ) ) );
+
+    /* Pass the front box and hit the back box.
+     */
+    ray.origin = base::math::Vector3f( 2, 0, 10 );
+    QCOMPARE( picking->pick( *root, ray, hitLocation ), box2 );
+    QVERIFY( base::math::isEqual( hitLocation, base::math::Vector3f( 2, 0, -7 ) ) );
+
+    /* Hit the back box from behind.
+     */
+    ray.origin    = base::math::Vector3f( 0, 0, -20 );
+    ray.direction = base::math::Vector3f( 0, 0, 1 );
+    QCOMPARE( picking->pick( *root, ray, hitLocation ), box2 );
+    QVERIFY( base::math::isEqual( hitLocation, base::math::Vector3f( 0, 0, -13 ) ) );
+}
+
+
+void RayPickingHelperTest::test_pickMesh_miss()
+{
+    base::math::Ray3f ray;
+    base::math::Vector3f hitLocation;
+
+    ray.origin    = base::math::Vector3f( 5, 0, 10 );
+    ray.direction = base::math::Vector3f( 0, 0, -1 );
+    QVERIFY( picking->pick( *root, ray, hitLocation ) == nullptr );
+
+    ray.origin    = base::math::Vector3f( 0, 0, 10 );
+    ray.direction = base::math::Vector3f( 0, 0, 1 );
+    QVERIFY( picking->pick( *root, ray, hitLocation ) == nullptr );
+}
+
+
+void RayPickingHelperTest::test_pickVolume()
+{
+    /* Create a volume, whose voxels are only set for x >= 20. Force it to be
+     * partitioned into multiple segments.
+     */
+    typedef helpers::VolumeGridHelper< base::IntensityVolumeUInt16 > GridHelper;
+    GridHelper gridHelper( base::math::Vector3ui( 32, 32, 32 ), 16 * 16 * 16 * sizeof( uint16_t ) );
+    gridHelper.loadIntensities( []( const base::math::Vector3ui& voxel )
+        {
+            return voxel.x() >= 20 ? 1.f : 0.f;
+        }
+    );
+    QVERIFY( gridHelper.grid().segmentCounts.x() > 1 );
+
+    base::Node* const volume = new base::Node();
+    volume->attachChild( gridHelper.createNode( GEOMETRY_TYPE_VOLUMETRIC, GridHelper::Spacing( base::math::Vector3f( 1, 1, 1 ) ) ) );
+    volume->localTransform = base::math::translation4f( 0, 0, 50 );
+    root->attachChild( volume );
+    root->updateWorldTransform();
+    picking->putVolumeGeometryType< base::IntensityVolumeUInt16 >( GEOMETRY_TYPE_VOLUMETRIC, GridHelper::DEFAULT_ROLE_INTENSITIES, 0.5f );
+
+    /* The volume spans 31 units, thus the voxel x = 20 is centered at 4.5 along
+     * the x-axis. Its nearest-neighbor footprint begins at 4.
+     */
+    base::math::Ray3f ray;
+    base::math::Vector3f hitLocation;
+    ray.origin    = base::math::Vector3f( -100, 0.2f, 50.3f );
+    ray.direction = base::math::Vector3f( 1, 0, 0 );
+    const base::Geometry* const hitGeometry = picking->pick( *root, ray, hitLocation );
+    QVERIFY( hitGeometry != nullptr );
+    QCOMPARE( hitGeometry->geometryType, GEOMETRY_TYPE_VOLUMETRIC );
+    QVERIFY( hitLocation.x() >= 4.f && hitLocation.x() <= 4.5f );
+    QVERIFY( base::math::isEqual( hitLocation.y(), 0.2f ) );
+    QVERIFY( base::math::isEqual( hitLocation.z(), 50.3f ) );
+
+    /* The empty part of the volume is not hit.
+     */
+    ray.direction = base::math::Vector3f( -1, 0, 0 );
+    ray.origin    = base::math::Vector3f( 3, 0.2f, 50.3f );
+    QVERIFY( picking->pick( *root, ray, hitLocation ) == nullptr );
+
+    /* Delete the volume node before its data.
+     */
+    delete root->detachChild( *volume );
+}
+
+
+void RayPickingHelperTest::test_removeGeometryType()
+{
+    base::math::Ray3f ray;
+    base::math::Vector3f hitLocation;
+    ray.origin    = base::math::Vector3f( 0, 0, 10 );
+    ray.direction = base::math::Vector3f( 0, 0, -1 );
+
+    picking->removeGeometryType( GEOMETRY_TYPE_OPAQUE );
+    QVERIFY( picking->pick( *root, ray, hitLocation ) == nullptr );
+
+    picking->putMeshGeometryType( GEOMETRY_TYPE_OPAQUE, ROLE_MESH );
+    QCOMPARE( picking->pick( *root, ray, hitLocation ), box1 );
+}
+
+
+
+}  // namespace LibCarna :: testing
+
+}  // namespace LibCarna
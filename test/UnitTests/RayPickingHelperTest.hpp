@@ -0,0 +1,92 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#pragma once
+
+#include <LibCarna/LibCarna.hpp>
+
+namespace LibCarna
+{
+
+namespace testing
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// RayPickingHelperTest
+// ----------------------------------------------------------------------------------
+
+/** \brief
+  * Unit-tests of the \ref LibCarna::helpers::RayPickingHelper class.
+  *
+  * \author Leonid Kostrykin
+  */
+class RayPickingHelperTest : public QObject
+{
+
+    Q_OBJECT
+
+private slots:
+
+    /** \brief
+      * Called before the first test function is executed.
+      */
+    void initTestCase();
+
+    /** \brief
+      * Called after the last test function is executed.
+      */
+    void cleanupTestCase();
+
+    /** \brief
+      * Called before each test function is executed.
+      */
+    void init();
+
+    /** \brief
+      * Called after each test function is executed.
+      */
+    void cleanup();
+
+ // ----------------------------------------------------------------------------------
+
+    void test_pickMesh();
+
+    void test_pickMesh_miss();
+
+    void test_pickVolume();
+
+    void test_removeGeometryType();
+
+ // ----------------------------------------------------------------------------------
+
+private:
+
+    const static unsigned int GEOMETRY_TYPE_OPAQUE     = 1;
+    const static unsigned int GEOMETRY_TYPE_VOLUMETRIC = 2;
+    const static unsigned int ROLE_MESH = 0;
+
+    std::unique_ptr< base::Node > root;
+    std::unique_ptr< helpers::RayPickingHelper > picking;
+    base::Geometry* box1;
+    base::Geometry* box2;
+    
+}; // RayPickingHelperTest
+
+
+
+}  // namespace LibCarna :: testing
+
+}  // namespace LibCarna
@@ -0,0 +1,285 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#include "RenderQueueTest.hpp"
+#include <LibCarna/base/RenderQueue.hpp>
+#include <LibCarna/base/Node.hpp>
+#include <LibCarna/base/Geometry.hpp>
+#include <LibCarna/base/Material.hpp>
+#include <LibCarna/base/MeshFactory.hpp>
+#include <LibCarna/base/Vertex.hpp>
+#include <LibCarna/base/math.hpp>
+#include <algorithm>
+#include <set>
+#include <tuple>
+
+namespace LibCarna
+{
+
+namespace testing
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// Types & Globals
+// ----------------------------------------------------------------------------------
+
+typedef std::tuple< std::string, const base::GeometryFeature*, const base::GeometryFeature* > StateKey;
+
+
+static StateKey stateKeyOf( const base::Renderable& renderable, unsigned int meshRole, unsigned int materialRole )
+{
+    const base::Material& material = static_cast< const base::Material& >( renderable.geometry().feature( materialRole ) );
+    return StateKey( material.shaderName, &renderable.geometry().feature( meshRole ), &material );
+}
+
+
+
+// ----------------------------------------------------------------------------------
+// RenderQueueTest
+// ----------------------------------------------------------------------------------
+
+void RenderQueueTest::initTestCase()
+{
+}
+
+
+void RenderQueueTest::cleanupTestCase()
+{
+}
+
+
+void RenderQueueTest::init()
+{
+    root.reset( new base::Node() );
+}
+
+
+void RenderQueueTest::cleanup()
+{
+    root.reset();
+}
+
+
+void RenderQueueTest::createScene( unsigned int geometriesCount )
+{
+    base::ManagedMeshBase* const meshes[] =
+        { &base::MeshFactory< base::PVertex >::createBox( 1, 1, 1 )
+        , &base::MeshFactory< base::PVertex >::createPoint() };
+    base::Material* const materials[] =
+        { &base::Material::create( "solid" )
+        , &base::Material::create( "unshaded" )
+        , &base::Material::create( "solid" ) };
+
+    /* Each four consecutive geometries have the same distance to the origin.
+     */
+    for( unsigned int geometryIdx = 0; geometryIdx < geometriesCount; ++geometryIdx )
+    {
+        base::Geometry* const geometry = new base::Geometry( GEOMETRY_TYPE );
+        geometry->putFeature( ROLE_MESH, *meshes[ ( geometryIdx / 3 ) % 2 ] );
+        geometry->putFeature( ROLE_MATERIAL, *materials[ geometryIdx % 3 ] );
+        geometry->localTransform = base::math::translation4f( 0, 0, -static_cast< float >( ( geometryIdx * 7919 ) % geometriesCount / 4 ) );
+        root->attachChild( geometry );
+    }
+    root->updateWorldTransform();
+
+    for( base::ManagedMeshBase* mesh : meshes )
+    {
+        mesh->release();
+    }
+    for( base::Material* material : materials )
+    {
+        material->release();
+    }
+}
+
+
+void RenderQueueTest::test_StateOrder()
+{
+    createScene( 100 );
+    base::RenderQueue< base::Renderable::StateOrder< ROLE_MATERIAL, ROLE_MESH > > rq( GEOMETRY_TYPE );
+    rq.build( *root, base::math::identity4f() );
+
+    /* Verify that renderables with the same shader are grouped, and within those,
+     * renderables with the same mesh and material.
+     */
+    std::set< std::string > finishedShaders;
+    std::set< StateKey > finishedStates;
+    StateKey state = stateKeyOf( rq.first(), ROLE_MESH, ROLE_MATERIAL );
+    std::size_t renderablesCount = 0;
+    while( !rq.isEmpty() )
+    {
+        const StateKey nextState = stateKeyOf( rq.poll(), ROLE_MESH, ROLE_MATERIAL );
+        if( nextState != state )
+        {
+            finishedStates.insert( state );
+            QVERIFY( finishedStates.find( nextState ) == finishedStates.end() );
+            if( std::get< 0 >( nextState ) != std::get< 0 >( state ) )
+            {
+                finishedShaders.insert( std::get< 0 >( state ) );
+                QVERIFY( finishedShaders.find( std::get< 0 >( nextState ) ) == finishedShaders.end() );
+            }
+            state = nextState;
+        }
+        ++renderablesCount;
+    }
+    QCOMPARE( renderablesCount, static_cast< std::size_t >( 100 ) );
+    QCOMPARE( finishedStates.size() + 1, static_cast< std::size_t >( 6 ) );
+}
+
+
+void RenderQueueTest::test_DepthStateOrder()
+{
+    createScene( 100 );
+    base::RenderQueue< base::Renderable::DepthStateOrder< +1, ROLE_MATERIAL, ROLE_MESH > > rq( GEOMETRY_TYPE );
+    rq.build( *root, base::math::identity4f() );
+
+    /* Verify the back-to-front order. Renderables with the same depth must be grouped
+     * by their states.
+     */
+    float eyeDistance2 = rq.first().eyeDistance2();
+    std::set< StateKey > finishedStates;
+    StateKey state = stateKeyOf( rq.first(), ROLE_MESH, ROLE_MATERIAL );
+    while( !rq.isEmpty() )
+    {
+        const base::Renderable& renderable = rq.poll();
+        const StateKey nextState = stateKeyOf( renderable, ROLE_MESH, ROLE_MATERIAL );
+        QVERIFY( renderable.eyeDistance2() <= eyeDistance2 );
+        if( renderable.eyeDistance2() < eyeDistance2 )
+        {
+            finishedStates.clear();
+        }
+        else
+        if( nextState != state )
+        {
+            finishedStates.insert( state );
+            QVERIFY( finishedStates.find( nextState ) == finishedStates.end() );
+        }
+        eyeDistance2 = renderable.eyeDistance2();
+        state = nextState;
+    }
+
+    /* Verify the front-to-back order after the view has changed.
+     */
+    base::RenderQueue< base::Renderable::DepthStateOrder< -1, ROLE_MATERIAL, ROLE_MESH > > rqReverse( GEOMETRY_TYPE );
+    rqReverse.build( *root, base::math::identity4f() );
+    rqReverse.updateModelViewTransforms( base::math::translation4f( 0, 0, 100 ) );
+    eyeDistance2 = rqReverse.first().eyeDistance2();
+    while( !rqReverse.isEmpty() )
+    {
+        const base::Renderable& renderable = rqReverse.poll();
+        QVERIFY( renderable.eyeDistance2() >= eyeDistance2 );
+        eyeDistance2 = renderable.eyeDistance2();
+    }
+}
+
+
+void RenderQueueTest::test_deterministicOrder()
+{
+    createScene( LARGE_SCENE_GEOMETRIES );
+    const base::math::Matrix4f viewTransform = base::math::translation4f( 0, 0, 100 );
+
+    /* Compute the expected order serially: Geometries of equal depth must retain
+     * the order of the scene graph traversal.
+     */
+    std::vector< const base::Geometry* > expected;
+    root->visitChildren( true, [&expected]( const base::Spatial& spatial )
+        {
+            expected.push_back( static_cast< const base::Geometry* >( &spatial ) );
+        }
+    );
+    const auto eyeDistance2 = [&viewTransform]( const base::Geometry* geometry )
+    {
+        return base::math::translationDistance2( viewTransform * geometry->worldTransform() );
+    };
+    std::stable_sort( expected.begin(), expected.end(),
+        [&eyeDistance2]( const base::Geometry* l, const base::Geometry* r )
+        {
+            return eyeDistance2( l ) > eyeDistance2( r );
+        }
+    );
+
+    /* Verify the order after building and after updating the queue.
+     */
+    base::RenderQueue< base::Renderable::BackToFront > rq( GEOMETRY_TYPE );
+    rq.build( *root, viewTransform );
+    for( unsigned int pass = 0; pass < 2; ++pass )
+    {
+        for( const base::Geometry* geometry : expected )
+        {
+            QCOMPARE( &rq.poll().geometry(), geometry );
+        }
+        QVERIFY( rq.isEmpty() );
+        rq.rewind();
+        rq.updateModelViewTransforms( viewTransform );
+    }
+}
+
+
+void RenderQueueTest::test_benchmark_BackToFront()
+{
+    createScene( LARGE_SCENE_GEOMETRIES );
+    base::RenderQueue< base::Renderable::BackToFront > rq( GEOMETRY_TYPE );
+    rq.build( *root, base::math::identity4f() );
+    QBENCHMARK
+    {
+        rq.updateModelViewTransforms( base::math::identity4f() );
+    }
+    QVERIFY( rq.last().eyeDistance2() <= rq.first().eyeDistance2() );
+}
+
+
+void RenderQueueTest::test_benchmark_DepthStateOrder()
+{
+    createScene( LARGE_SCENE_GEOMETRIES );
+    base::RenderQueue< base::Renderable::DepthStateOrder< +1, ROLE_MATERIAL, ROLE_MESH > > rq( GEOMETRY_TYPE );
+    rq.build( *root, base::math::identity4f() );
+    QBENCHMARK
+    {
+        rq.updateModelViewTransforms( base::math::identity4f() );
+    }
+    QVERIFY( rq.last().eyeDistance2() <= rq.first().eyeDistance2() );
+    QVERIFY( rq.sortTime() > 0 );
+}
+
+
+void RenderQueueTest::test_benchmark_StateOrder()
+{
+    createScene( LARGE_SCENE_GEOMETRIES );
+    base::RenderQueue< base::Renderable::StateOrder< ROLE_MATERIAL, ROLE_MESH > > rq( GEOMETRY_TYPE );
+    QBENCHMARK
+    {
+        rq.build( *root, base::math::identity4f() );
+    }
+    QVERIFY( rq.sortTime() > 0 );
+}
+
+
+void RenderQueueTest::test_benchmark_build()
+{
+    createScene( LARGE_SCENE_GEOMETRIES );
+    base::RenderQueue< base::Renderable::BackToFront > rq( GEOMETRY_TYPE );
+    QBENCHMARK
+    {
+        rq.build( *root, base::math::identity4f() );
+    }
+    QVERIFY( rq.last().eyeDistance2() <= rq.first().eyeDistance2() );
+}
+
+
+
+}  // namespace LibCarna :: testing
+
+}  // namespace LibCarna
@@ -0,0 +1,102 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#pragma once
+
+#include <LibCarna/LibCarna.hpp>
+
+namespace LibCarna
+{
+
+namespace testing
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// RenderQueueTest
+// ----------------------------------------------------------------------------------
+
+/** \brief
+  * Unit-tests of the \ref LibCarna::base::RenderQueue class.
+  *
+  * \author Leonid Kostrykin
+  */
+class RenderQueueTest : public QObject
+{
+
+    Q_OBJECT
+
+private slots:
+
+    /** \brief
+      * Called before the first test function is executed.
+      */
+    void initTestCase();
+
+    /** \brief
+      * Called after the last test function is executed.
+      */
+    void cleanupTestCase();
+
+    /** \brief
+      * Called before each test function is executed.
+      */
+    void init();
+
+    /** \brief
+      * Called after each test function is executed.
+      */
+    void cleanup();
+
+ // ----------------------------------------------------------------------------------
+
+    void test_StateOrder();
+
+    void test_DepthStateOrder();
+
+    void test_deterministicOrder();
+
+    void test_benchmark_BackToFront();
+
+    void test_benchmark_DepthStateOrder();
+
+    void test_benchmark_StateOrder();
+
+    void test_benchmark_build();
+
+ // ----------------------------------------------------------------------------------
+
+private:
+
+    const static unsigned int GEOMETRY_TYPE = 0;
+    const static unsigned int ROLE_MESH = 0;
+    const static unsigned int ROLE_MATERIAL = 1;
+    const static unsigned int LARGE_SCENE_GEOMETRIES = 10000;
+
+    /** \brief
+      * Attaches \a geometriesCount geometry nodes to \ref root. Their meshes,
+      * materials, and distances to the origin are interleaved.
+      */
+    void createScene( unsigned int geometriesCount );
+
+    std::unique_ptr< base::Node > root;
+    
+}; // RenderQueueTest
+
+
+
+}  // namespace LibCarna :: testing
+
+}  // namespace LibCarna
@@ -0,0 +1,140 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#include "RenderTargetPoolTest.hpp"
+#include <LibCarna/base/Framebuffer.hpp>
+#include <LibCarna/base/Texture.hpp>
+
+namespace LibCarna
+{
+
+namespace testing
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// RenderTargetPoolTest
+// ----------------------------------------------------------------------------------
+
+void RenderTargetPoolTest::initTestCase()
+{
+}
+
+
+void RenderTargetPoolTest::cleanupTestCase()
+{
+}
+
+
+void RenderTargetPoolTest::init()
+{
+    qglContextHolder.reset( new QGLContextHolder() );
+    pool.reset( new base::RenderTargetPool() );
+}
+
+
+void RenderTargetPoolTest::cleanup()
+{
+    pool.reset();
+    qglContextHolder.reset();
+}
+
+
+void RenderTargetPoolTest::test_sequentialLeases()
+{
+    unsigned int firstId;
+    {
+        const base::RenderTargetPool::Lease lease( *pool, 64, 32, base::Framebuffer::rgba16f );
+        QCOMPARE( lease.framebuffer().width (), 64u );
+        QCOMPARE( lease.framebuffer().height(), 32u );
+        QCOMPARE( pool->leasedCount(), static_cast< std::size_t >( 1 ) );
+        firstId = lease.framebuffer().id;
+    }
+    QCOMPARE( pool->leasedCount(), static_cast< std::size_t >( 0 ) );
+
+    /* Leases, that do not overlap in time, must share the same target.
+     */
+    const base::RenderTargetPool::Lease lease( *pool, 64, 32, base::Framebuffer::rgba16f );
+    QCOMPARE( lease.framebuffer().id, firstId );
+    QCOMPARE( pool->size(), static_cast< std::size_t >( 1 ) );
+    QCOMPARE( pool->createdCount(), static_cast< std::size_t >( 1 ) );
+}
+
+
+void RenderTargetPoolTest::test_nestedLeases()
+{
+    const base::RenderTargetPool::Lease outer( *pool, 64, 32 );
+    {
+        const base::RenderTargetPool::Lease inner( *pool, 64, 32 );
+        QVERIFY( &inner.framebuffer() != &outer.framebuffer() );
+        QVERIFY( inner.renderTexture().id != outer.renderTexture().id );
+        QCOMPARE( pool->leasedCount(), static_cast< std::size_t >( 2 ) );
+    }
+    QCOMPARE( pool->size(), static_cast< std::size_t >( 2 ) );
+}
+
+
+void RenderTargetPoolTest::test_formatsAndSizes()
+{
+    {
+        const base::RenderTargetPool::Lease lease( *pool, 64, 32, base::Framebuffer::rgba8 );
+    }
+    {
+        const base::RenderTargetPool::Lease lease( *pool, 64, 32, base::Framebuffer::rgba16f );
+        QCOMPARE( lease.renderTexture().internalFormat, static_cast< int >( GL_RGBA16F ) );
+    }
+    {
+        const base::RenderTargetPool::Lease lease( *pool, 32, 64, base::Framebuffer::r32f );
+        QCOMPARE( lease.renderTexture().internalFormat, static_cast< int >( GL_R32F ) );
+        QCOMPARE( lease.renderTexture().pixelFormat, static_cast< int >( GL_RED ) );
+    }
+    QCOMPARE( pool->size(), static_cast< std::size_t >( 3 ) );
+}
+
+
+void RenderTargetPoolTest::test_releaseUnused()
+{
+    {
+        const base::RenderTargetPool::Lease lease1( *pool, 64, 32 );
+        const base::RenderTargetPool::Lease lease2( *pool, 64, 32 );
+    }
+
+    /* Both targets were leased since the pool was created.
+     */
+    pool->releaseUnused();
+    QCOMPARE( pool->size(), static_cast< std::size_t >( 2 ) );
+
+    /* Only one target was leased since the last call.
+     */
+    {
+        const base::RenderTargetPool::Lease lease( *pool, 64, 32 );
+    }
+    pool->releaseUnused();
+    QCOMPARE( pool->size(), static_cast< std::size_t >( 1 ) );
+
+    /* Leased targets must not be released.
+     */
+    const base::RenderTargetPool::Lease lease( *pool, 64, 32 );
+    pool->releaseUnused();
+    pool->releaseUnused();
+    QCOMPARE( pool->size(), static_cast< std::size_t >( 1 ) );
+    QCOMPARE( pool->createdCount(), static_cast< std::size_t >( 2 ) );
+}
+
+
+
+}  // namespace LibCarna :: testing
+
+}  // namespace LibCarna
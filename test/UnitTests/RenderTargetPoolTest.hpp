@@ -0,0 +1,85 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#pragma once
+
+#include <LibCarna/base/RenderTargetPool.hpp>
+
+namespace LibCarna
+{
+
+namespace testing
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// RenderTargetPoolTest
+// ----------------------------------------------------------------------------------
+
+/** \brief
+  * Unit-tests of the \ref LibCarna::base::RenderTargetPool class.
+  *
+  * \author Leonid Kostrykin
+  */
+class RenderTargetPoolTest : public QObject
+{
+
+    Q_OBJECT
+
+private slots:
+
+    /** \brief
+      * Called before the first test function is executed.
+      */
+    void initTestCase();
+
+    /** \brief
+      * Called after the last test function is executed.
+      */
+    void cleanupTestCase();
+
+    /** \brief
+      * Called before each test function is executed.
+      */
+    void init();
+
+    /** \brief
+      * Called after each test function is executed.
+      */
+    void cleanup();
+
+ // ----------------------------------------------------------------------------------
+
+    void test_sequentialLeases();
+
+    void test_nestedLeases();
+
+    void test_formatsAndSizes();
+
+    void test_releaseUnused();
+
+ // ---------------------------------------------------------------------------------
+
+private:
+    std::unique_ptr< QGLContextHolder > qglContextHolder;
+    std::unique_ptr< base::RenderTargetPool > pool;
+    
+}; // RenderTargetPoolTest
+
+
+
+}  // namespace LibCarna :: testing
+
+}  // namespace LibCarna
@@ -0,0 +1,206 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#include "STLReaderTest.hpp"
+#include <cstring>
+#include <sstream>
+
+namespace LibCarna
+{
+
+namespace testing
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// Types & Globals
+// ----------------------------------------------------------------------------------
+
+/* Encodes the triangles, given by nine coordinates each, as binary STL.
+ */
+static std::string createBinarySTL( const std::vector< float >& coordinates, const std::string& header = "binary" )
+{
+    std::string data( 84, '\0' );
+    std::memcpy( &data[ 0 ], header.data(), std::min< std::size_t >( header.size(), 80 ) );
+    const uint32_t trianglesCount = static_cast< uint32_t >( coordinates.size() / 9 );
+    std::memcpy( &data[ 80 ], &trianglesCount, 4 );
+    for( uint32_t triangleIndex = 0; triangleIndex < trianglesCount; ++triangleIndex )
+    {
+        data.append( 12, '\0' );
+        data.append( reinterpret_cast< const char* >( &coordinates[ 9 * triangleIndex ] ), 36 );
+        data.append(  2, '\0' );
+    }
+    return data;
+}
+
+
+/* Two triangles, that form a quad.
+ */
+const static float STL_QUAD_COORDINATES[] =
+    { 0, 0, 0,  1, 0, 0,  1, 1, 0
+    , 0, 0, 0,  1, 1, 0,  0, 1, 0 };
+
+const static std::vector< float > STL_QUAD( STL_QUAD_COORDINATES, STL_QUAD_COORDINATES + 18 );
+
+
+static void verifySTLQuad( const base::STLReader& reader )
+{
+    QCOMPARE( reader.trianglesCount(), static_cast< std::size_t >( 2 ) );
+    QCOMPARE( reader.positions().size(), static_cast< std::size_t >( 4 ) );
+    QCOMPARE( reader.indices().size(), static_cast< std::size_t >( 6 ) );
+
+    /* Vertices are ordered by their first occurrence.
+     */
+    QCOMPARE( reader.positions()[ 0 ], base::math::Vector3f( 0, 0, 0 ) );
+    QCOMPARE( reader.positions()[ 1 ], base::math::Vector3f( 1, 0, 0 ) );
+    QCOMPARE( reader.positions()[ 2 ], base::math::Vector3f( 1, 1, 0 ) );
+    QCOMPARE( reader.positions()[ 3 ], base::math::Vector3f( 0, 1, 0 ) );
+
+    const uint32_t expectedIndices[] = { 0, 1, 2, 0, 2, 3 };
+    for( std::size_t i = 0; i < 6; ++i )
+    {
+        QCOMPARE( reader.indices()[ i ], expectedIndices[ i ] );
+    }
+}
+
+
+
+// ----------------------------------------------------------------------------------
+// STLReaderTest
+// ----------------------------------------------------------------------------------
+
+void STLReaderTest::initTestCase()
+{
+}
+
+
+void STLReaderTest::cleanupTestCase()
+{
+}
+
+
+void STLReaderTest::init()
+{
+    reader.reset( new base::STLReader() );
+}
+
+
+void STLReaderTest::cleanup()
+{
+    reader.reset();
+}
+
+
+void STLReaderTest::test_binary()
+{
+    const std::string data = createBinarySTL( STL_QUAD );
+    reader->read( data.data(), data.size() );
+    QVERIFY( reader->isBinary() );
+    verifySTLQuad( *reader );
+}
+
+
+void STLReaderTest::test_binaryWithSolidHeader()
+{
+    /* Some exporters write binary STL with a header, that starts with 'solid'.
+     */
+    const std::string data = createBinarySTL( STL_QUAD, "solid quad" );
+    reader->read( data.data(), data.size() );
+    QVERIFY( reader->isBinary() );
+    verifySTLQuad( *reader );
+}
+
+
+void STLReaderTest::test_binaryStream()
+{
+    std::istringstream stream( createBinarySTL( STL_QUAD ) );
+    reader->read( stream );
+    QVERIFY( reader->isBinary() );
+    verifySTLQuad( *reader );
+}
+
+
+void STLReaderTest::test_ascii()
+{
+    const std::string data =
+        "solid quad\n"
+        "  facet normal 0 0 1\n"
+        "    outer loop\n"
+        "      vertex 0 0 0\n"
+        "      vertex 1.0e+0 0 0\n"
+        "      vertex 1 1 0\n"
+        "    endloop\n"
+        "  endfacet\n"
+        "  facet normal 0 0 1\n"
+        "    outer loop\n"
+        "      vertex 0 0 -0\n"
+        "      vertex 1 1. 0\n"
+        "      vertex 0.0 10E-1 0\n"
+        "    endloop\n"
+        "  endfacet\n"
+        "endsolid quad\n";
+    reader->read( data.data(), data.size() );
+    QVERIFY( !reader->isBinary() );
+    verifySTLQuad( *reader );
+}
+
+
+void STLReaderTest::test_malformed()
+{
+    const std::string binary = createBinarySTL( STL_QUAD );
+    QVERIFY_EXCEPTION_THROWN( reader->read( binary.data(), binary.size() - 50 ), base::AssertionFailure );
+    QVERIFY_EXCEPTION_THROWN( reader->read( binary.data(), 42 ), base::AssertionFailure );
+
+    const std::string ascii1 = "solid quad\n facet normal 0 0 1\n outer loop\n vertex 0 zero 0\n";
+    QVERIFY_EXCEPTION_THROWN( reader->read( ascii1.data(), ascii1.size() ), base::AssertionFailure );
+
+    const std::string ascii2 = "solid quad\n facet normal 0 0 1\n outer loop\n vertex 0 0 0\n vertex 1 0 0\n endloop\n";
+    QVERIFY_EXCEPTION_THROWN( reader->read( ascii2.data(), ascii2.size() ), base::AssertionFailure );
+}
+
+
+void STLReaderTest::test_benchmark_binary()
+{
+    /* Create a grid of 400 x 400 quads, i.e. 320k triangles.
+     */
+    const unsigned int gridSize = 400;
+    std::vector< float > coordinates;
+    coordinates.reserve( gridSize * gridSize * 18 );
+    for( unsigned int y = 0; y < gridSize; ++y )
+    for( unsigned int x = 0; x < gridSize; ++x )
+    {
+        for( std::size_t i = 0; i < STL_QUAD.size(); i += 3 )
+        {
+            coordinates.push_back( STL_QUAD[ i + 0 ] + x );
+            coordinates.push_back( STL_QUAD[ i + 1 ] + y );
+            coordinates.push_back( STL_QUAD[ i + 2 ] );
+        }
+    }
+    const std::string data = createBinarySTL( coordinates );
+
+    QBENCHMARK
+    {
+        reader->read( data.data(), data.size() );
+    }
+
+    QCOMPARE( reader->trianglesCount(), static_cast< std::size_t >( 2 * gridSize * gridSize ) );
+    QCOMPARE( reader->positions().size(), static_cast< std::size_t >( ( gridSize + 1 ) * ( gridSize + 1 ) ) );
+}
+
+
+
+}  // namespace LibCarna :: testing
+
+}  // namespace LibCarna
@@ -7,8 +7,19 @@ list( APPEND TESTS
         ColorMapTest
 		ColorTest
 		HUVTest
+		NodeTest
+		BoundingVolumeHierarchyTest
+		RayPickingHelperTest
+		RenderQueueTest
 		VolumeGridHelperTest
         GLContextTest
+        RenderTargetPoolTest
+        FramebufferTest
+        FramebufferReadbackTest
+        STLReaderTest
+        PLYReaderTest
+        OBJReaderTest
+        textTest
 	)
 
 list( APPEND TESTS_QOBJECT_HEADERS
@@ -18,8 +29,19 @@ list( APPEND TESTS_QOBJECT_HEADERS
 		UnitTests/ColorMapTest.hpp
 		UnitTests/ColorTest.hpp
 		UnitTests/HUVTest.hpp
+		UnitTests/NodeTest.hpp
+		UnitTests/BoundingVolumeHierarchyTest.hpp
+		UnitTests/RayPickingHelperTest.hpp
+		UnitTests/RenderQueueTest.hpp
 		UnitTests/VolumeGridHelperTest.hpp
         UnitTests/GLContextTest.hpp
+        UnitTests/RenderTargetPoolTest.hpp
+        UnitTests/FramebufferTest.hpp
+        UnitTests/FramebufferReadbackTest.hpp
+        UnitTests/STLReaderTest.hpp
+        UnitTests/PLYReaderTest.hpp
+        UnitTests/OBJReaderTest.hpp
+        UnitTests/textTest.hpp
 	)
 
 list( APPEND TESTS_HEADERS
@@ -33,6 +55,17 @@ list( APPEND TESTS_SOURCES
 		UnitTests/ColorMapTest.cpp
 		UnitTests/ColorTest.cpp
 		UnitTests/HUVTest.cpp
+		UnitTests/NodeTest.cpp
+		UnitTests/BoundingVolumeHierarchyTest.cpp
+		UnitTests/RayPickingHelperTest.cpp
+		UnitTests/RenderQueueTest.cpp
 		UnitTests/VolumeGridHelperTest.cpp
         UnitTests/GLContextTest.cpp
+        UnitTests/RenderTargetPoolTest.cpp
+        UnitTests/FramebufferTest.cpp
+        UnitTests/FramebufferReadbackTest.cpp
+        UnitTests/STLReaderTest.cpp
+        UnitTests/PLYReaderTest.cpp
+        UnitTests/OBJReaderTest.cpp
+        UnitTests/textTest.cpp
 	)
@@ -14,6 +14,8 @@
 
 #include "mathTest.hpp"
 #include <LibCarna/base/math.hpp>
+#include <LibCarna/base/math/Ray.hpp>
+#include <LibCarna/base/math/RaySphereHitTest.hpp>
 
 namespace LibCarna
 {
@@ -272,6 +274,44 @@ void mathTest::test_LIBCARNA_FOR_VECTOR3UI()
 };
 
 
+void mathTest::test_RaySphereHitTest()
+{
+    using namespace LibCarna::base;
+    math::Ray< math::Vector3f > ray;
+    math::RaySphereHitTest< math::Vector3f > hitTest;
+    QVERIFY( !hitTest.hitExists() );
+
+    /* Ray from outside towards the sphere hits the front.
+     */
+    ray.origin    = math::Vector3f( 0, 0, 10 );
+    ray.direction = math::Vector3f( 0, 0, -1 );
+    hitTest.compute( ray, 2 );
+    QVERIFY( hitTest.hitExists() );
+    QVERIFY( math::isEqual( hitTest.hitLocation(), math::Vector3f( 0, 0, 2 ) ) );
+
+    /* Ray from inside the sphere hits the back.
+     */
+    ray.origin = math::Vector3f( 0, 0, 0 );
+    hitTest.compute( ray, 2 );
+    QVERIFY( hitTest.hitExists() );
+    QVERIFY( math::isEqual( hitTest.hitLocation(), math::Vector3f( 0, 0, -2 ) ) );
+
+    /* Ray away from the sphere misses it.
+     */
+    ray.origin    = math::Vector3f( 0, 0, 10 );
+    ray.direction = math::Vector3f( 0, 0, 1 );
+    hitTest.compute( ray, 2 );
+    QVERIFY( !hitTest.hitExists() );
+
+    /* Ray passing the sphere misses it.
+     */
+    ray.origin    = math::Vector3f( 3, 0, 10 );
+    ray.direction = math::Vector3f( 0, 0, -1 );
+    hitTest.compute( ray, 2 );
+    QVERIFY( !hitTest.hitExists() );
+}
+
+
 
 }  // namespace LibCarna :: testing
 
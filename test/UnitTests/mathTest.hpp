@@ -129,6 +129,11 @@ private slots:
       * Test cases for \ref LibCarna::base::math::LIBCARNA_FOR_VECTOR3UI
       */
     void test_LIBCARNA_FOR_VECTOR3UI();
+
+    /** \brief
+      * Test cases for \ref LibCarna::base::math::RaySphereHitTest
+      */
+    void test_RaySphereHitTest();
     
 }; // mathTest
 
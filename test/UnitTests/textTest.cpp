@@ -0,0 +1,115 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#include "textTest.hpp"
+#include <LibCarna/base/text.hpp>
+#include <cstring>
+
+namespace LibCarna
+{
+
+namespace testing
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// Types & Globals
+// ----------------------------------------------------------------------------------
+
+static bool parseInt( const char* text, int64_t& value )
+{
+    return base::text::parseInt( text, text + std::strlen( text ), value );
+}
+
+
+static bool parseDouble( const char* text, double& value )
+{
+    return base::text::parseDouble( text, text + std::strlen( text ), value );
+}
+
+
+
+// ----------------------------------------------------------------------------------
+// textTest
+// ----------------------------------------------------------------------------------
+
+void textTest::initTestCase()
+{
+}
+
+
+void textTest::cleanupTestCase()
+{
+}
+
+
+void textTest::init()
+{
+}
+
+
+void textTest::cleanup()
+{
+}
+
+
+void textTest::test_parseInt()
+{
+    int64_t value = 0;
+    QVERIFY( parseInt( "42", value ) );
+    QCOMPARE( value, static_cast< int64_t >( 42 ) );
+    QVERIFY( parseInt( "-7", value ) );
+    QCOMPARE( value, static_cast< int64_t >( -7 ) );
+    QVERIFY( parseInt( "+0", value ) );
+    QCOMPARE( value, static_cast< int64_t >( 0 ) );
+
+    QVERIFY( !parseInt( "", value ) );
+    QVERIFY( !parseInt( "-", value ) );
+    QVERIFY( !parseInt( "4x", value ) );
+    QVERIFY( !parseInt( "1.5", value ) );
+}
+
+
+void textTest::test_parseInt_overflow()
+{
+    int64_t value = 0;
+    QVERIFY( parseInt( "9223372036854775807", value ) );
+    QCOMPARE( value, static_cast< int64_t >( 9223372036854775807LL ) );
+    QVERIFY( parseInt( "-9223372036854775807", value ) );
+    QCOMPARE( value, static_cast< int64_t >( -9223372036854775807LL ) );
+
+    QVERIFY( !parseInt( "9223372036854775808", value ) );
+    QVERIFY( !parseInt( "20000000000000000000", value ) );
+    QVERIFY( !parseInt( "184467440737095516160", value ) );
+}
+
+
+void textTest::test_parseDouble()
+{
+    double value = 0;
+    QVERIFY( parseDouble( "1.5", value ) );
+    QCOMPARE( value, 1.5 );
+    QVERIFY( parseDouble( "-2e3", value ) );
+    QCOMPARE( value, -2000. );
+
+    QVERIFY( !parseDouble( "", value ) );
+    QVERIFY( !parseDouble( "abc", value ) );
+}
+
+
+
+}  // namespace LibCarna :: testing
+
+}  // namespace LibCarna
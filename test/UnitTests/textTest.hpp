@@ -0,0 +1,84 @@
+/*
+ *  Copyright (C) 2010 - 2016 Leonid Kostrykin
+ *
+ *  Chair of Medical Engineering (mediTEC)
+ *  RWTH Aachen University
+ *  Pauwelsstr. 20
+ *  52074 Aachen
+ *  Germany
+ * 
+ * 
+ *  Copyright (C) 2021 - 2025 Leonid Kostrykin
+ * 
+ */
+
+#pragma once
+
+namespace LibCarna
+{
+
+namespace testing
+{
+
+
+
+// ----------------------------------------------------------------------------------
+// textTest
+// ----------------------------------------------------------------------------------
+
+/** \brief
+  * Unit-tests of the \ref LibCarna::base::text namespace.
+  *
+  * \author Leonid Kostrykin
+  */
+class textTest : public QObject
+{
+
+    Q_OBJECT
+
+private slots:
+
+    /** \brief
+      * Called before the first test function is executed.
+      */
+    void initTestCase();
+
+    /** \brief
+      * Called after the last test function is executed.
+      */
+    void cleanupTestCase();
+
+    /** \brief
+      * Called before each test function is executed.
+      */
+    void init();
+
+    /** \brief
+      * Called after each test function is executed.
+      */
+    void cleanup();
+
+ // ----------------------------------------------------------------------------------
+
+    /** \brief
+      * Test cases for \ref LibCarna::base::text::parseInt
+      */
+    void test_parseInt();
+
+    /** \brief
+      * Test cases for \ref LibCarna::base::text::parseInt with out-of-range input
+      */
+    void test_parseInt_overflow();
+
+    /** \brief
+      * Test cases for \ref LibCarna::base::text::parseDouble
+      */
+    void test_parseDouble();
+
+}; // textTest
+
+
+
+}  // namespace LibCarna :: testing
+
+}  // namespace LibCarna